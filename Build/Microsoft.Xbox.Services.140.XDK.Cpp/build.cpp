@@ -2,14 +2,17 @@
 
 #include "..\..\Source\Services\Achievements\achievement.cpp"
 #include "..\..\Source\Services\Achievements\achievements_result.cpp"
+#include "..\..\Source\Services\Achievements\achievements_reader.cpp"
 #include "..\..\Source\Services\Achievements\achievement_media_asset.cpp"
 #include "..\..\Source\Services\Achievements\achievement_progression.cpp"
 #include "..\..\Source\Services\Achievements\achievement_requirement.cpp"
 #include "..\..\Source\Services\Achievements\achievement_reward.cpp"
 #include "..\..\Source\Services\Achievements\achievement_service.cpp"
+#include "..\..\Source\Services\Achievements\achievement_summary.cpp"
 #include "..\..\Source\Services\Achievements\achievement_time_window.cpp"
 #include "..\..\Source\Services\Achievements\achievement_title_association.cpp"
 #include "..\..\Source\Services\Common\xbox_live_context_impl.cpp"
+#include "..\..\Source\Services\Common\xbox_live_context_startup_profiler.cpp"
 #include "..\..\Source\Services\Common\Desktop\XboxLiveContext_Desktop.cpp"
 #include "..\..\Source\Services\EntertainmentProfile\entertainment_profile.cpp"
 #include "..\..\Source\Services\EntertainmentProfile\entertainment_profile_list_contains_item_result.cpp"
@@ -19,6 +22,7 @@
 #include "..\..\Source\Services\GameServerPlatform\game_server_image_set.cpp"
 #include "..\..\Source\Services\GameServerPlatform\game_server_metadata_result.cpp"
 #include "..\..\Source\Services\GameServerPlatform\game_server_platform_service.cpp"
+#include "..\..\Source\Services\GameServerPlatform\game_server_allocation_tracker.cpp"
 #include "..\..\Source\Services\GameServerPlatform\game_server_port_mapping.cpp"
 #include "..\..\Source\Services\GameServerPlatform\game_server_ticket_status.cpp"
 #include "..\..\Source\Services\GameServerPlatform\game_variant.cpp"
@@ -26,7 +30,10 @@
 #include "..\..\Source\Services\GameServerPlatform\quality_of_service_server.cpp"
 #include "..\..\Source\Services\Leaderboard\leaderboard_column.cpp"
 #include "..\..\Source\Services\Leaderboard\leaderboard_result.cpp"
+#include "..\..\Source\Services\Leaderboard\leaderboard_cursor.cpp"
 #include "..\..\Source\Services\Leaderboard\leaderboard_row.cpp"
+#include "..\..\Source\Services\Leaderboard\social_leaderboard_table.cpp"
+#include "..\..\Source\Services\Leaderboard\leaderboard_rank_cache.cpp"
 #include "..\..\Source\Services\Leaderboard\leaderboard_serializers.cpp"
 #include "..\..\Source\Services\Leaderboard\leaderboard_service.cpp"
 #include "..\..\Source\Services\Marketplace\browse_catalog_result.cpp"
@@ -50,6 +57,7 @@
 #include "..\..\Source\Services\Misc\contextual_search_configured_stat.cpp"
 #include "..\..\Source\Services\Misc\contextual_search_service.cpp"
 #include "..\..\Source\Services\Misc\string_service.cpp"
+#include "..\..\Source\Services\Misc\string_verify_batcher.cpp"
 #include "..\..\Source\Services\Misc\verify_string_result.cpp"
 #include "..\..\Source\Services\Multiplayer\multiplayer_activity_details.cpp"
 #include "..\..\Source\Services\Multiplayer\multiplayer_activity_handle_post_request.cpp"
@@ -88,6 +96,7 @@
 #include "..\..\Source\Services\Multiplayer\Manager\multiplayer_client_manager.cpp"
 #include "..\..\Source\Services\Multiplayer\Manager\multiplayer_client_pending_reader.cpp"
 #include "..\..\Source\Services\Multiplayer\Manager\multiplayer_client_pending_request.cpp"
+#include "..\..\Source\Services\Multiplayer\Manager\multiplayer_commit_queue.cpp"
 #include "..\..\Source\Services\Multiplayer\Manager\multiplayer_event.cpp"
 #include "..\..\Source\Services\Multiplayer\Manager\multiplayer_game_client.cpp"
 #include "..\..\Source\Services\Multiplayer\Manager\multiplayer_game_session.cpp"
@@ -99,6 +108,7 @@
 #include "..\..\Source\Services\Multiplayer\Manager\multiplayer_manager_utils.cpp"
 #include "..\..\Source\Services\Multiplayer\Manager\multiplayer_member.cpp"
 #include "..\..\Source\Services\Multiplayer\Manager\multiplayer_session_writer.cpp"
+#include "..\..\Source\Services\Multiplayer\Manager\multiplayer_session_tap_coalescer.cpp"
 #include "..\..\Source\Services\Multiplayer\Manager\perform_qos_measurements_event_args.cpp"
 #include "..\..\Source\Services\Multiplayer\Manager\session_property_changed_event_args.cpp"
 #include "..\..\Source\Services\Multiplayer\Manager\tournament_game_session_ready_event_args.cpp"
@@ -131,6 +141,7 @@
 #include "..\..\Source\Services\Social\profile_service.cpp"
 #include "..\..\Source\Services\Social\reputation_feedback_request.cpp"
 #include "..\..\Source\Services\Social\reputation_service.cpp"
+#include "..\..\Source\Services\Social\reputation_feedback_aggregator.cpp"
 #include "..\..\Source\Services\Social\social_relationship_change_event_args.cpp"
 #include "..\..\Source\Services\Social\social_relationship_change_subscription.cpp"
 #include "..\..\Source\Services\Social\social_service.cpp"
@@ -143,6 +154,8 @@
 #include "..\..\Source\Services\Social\Manager\social_event.cpp"
 #include "..\..\Source\Services\Social\Manager\social_graph.cpp"
 #include "..\..\Source\Services\Social\Manager\social_manager.cpp"
+#include "..\..\Source\Services\Social\Manager\social_string_pool.cpp"
+#include "..\..\Source\Services\Social\Manager\social_user_store.cpp"
 #include "..\..\Source\Services\Social\Manager\title_history.cpp"
 #include "..\..\Source\Services\Social\Manager\xbox_social_user.cpp"
 #include "..\..\Source\Services\Social\Manager\xbox_social_user_group.cpp"
@@ -151,6 +164,7 @@
 #include "..\..\Source\Services\Stats\statistic.cpp"
 #include "..\..\Source\Services\Stats\statistic_change_event_args.cpp"
 #include "..\..\Source\Services\Stats\statistic_change_subscription.cpp"
+#include "..\..\Source\Services\Stats\statistic_change_subscription_multiplexer.cpp"
 #include "..\..\Source\Services\Stats\user_statistics_result.cpp"
 #include "..\..\Source\Services\Stats\user_statistics_service.cpp"
 #include "..\..\Source\Services\Stats\user_statistics_service_impl.cpp"
@@ -170,11 +184,14 @@
 #include "..\..\Source\Services\Tournaments\tournament_team_result.cpp"
 #include "..\..\Source\Shared\errors.cpp"
 #include "..\..\Source\Shared\http_call_impl.cpp"
+#include "..\..\Source\Shared\http_call_rate_limiter.cpp"
+#include "..\..\Source\Shared\qos_prober.cpp"
 #include "..\..\Source\Shared\http_call_request_message.cpp"
 #include "..\..\Source\Shared\http_call_response.cpp"
 #include "..\..\Source\Shared\http_client.cpp"
 #include "..\..\Source\Shared\local_config.cpp"
 #include "..\..\Source\Shared\service_call_logger.cpp"
+#include "..\..\Source\Shared\service_call_metrics.cpp"
 #include "..\..\Source\Shared\service_call_logger_data.cpp"
 #include "..\..\Source\Shared\service_call_logger_protocol.cpp"
 #include "..\..\Source\Shared\service_call_logging_config.cpp"
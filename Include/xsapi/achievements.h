@@ -545,6 +545,67 @@ private:
     achievement_progression m_progression;
 };
 
+/// <summary>
+/// A compact view of an achievement holding only the fields needed to list a player's achievement history.
+/// Summaries read from the same title share a single copy of the service configuration ID.
+/// </summary>
+class achievement_summary
+{
+public:
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    achievement_summary(
+        _In_ const achievement& achievementItem,
+        _In_ uint32_t titleId,
+        _In_ std::shared_ptr<const string_t> serviceConfigurationId
+        );
+
+    /// <summary>
+    /// The achievement ID.
+    /// </summary>
+    _XSAPIIMP const string_t& id() const;
+
+    /// <summary>
+    /// The ID of the service configuration set associated with the achievement.
+    /// </summary>
+    _XSAPIIMP const string_t& service_configuration_id() const;
+
+    /// <summary>
+    /// The ID of the title the achievement was read for.
+    /// </summary>
+    _XSAPIIMP uint32_t title_id() const;
+
+    /// <summary>
+    /// The localized achievement name.
+    /// </summary>
+    _XSAPIIMP const string_t& name() const;
+
+    /// <summary>
+    /// The state of a user's progress towards the earning of the achievement.
+    /// </summary>
+    _XSAPIIMP achievement_progress_state progress_state() const;
+
+    /// <summary>
+    /// The timestamp when the achievement was first unlocked.
+    /// </summary>
+    _XSAPIIMP const utility::datetime& time_unlocked() const;
+
+    /// <summary>
+    /// Whether or not the achievement is secret.
+    /// </summary>
+    _XSAPIIMP bool is_secret() const;
+
+private:
+    string_t m_id;
+    std::shared_ptr<const string_t> m_serviceConfigurationId;
+    string_t m_name;
+    utility::datetime m_timeUnlocked;
+    uint32_t m_titleId;
+    achievement_progress_state m_progressState;
+    bool m_isSecret;
+};
+
 /// <summary>
 /// Represents a collection of Achievement class objects returned by a request.
 /// </summary>
@@ -718,6 +779,64 @@ public:
         _In_ const string_t& achievementId
         );
 
+    /// <summary>
+    /// Reads every page of a player's achievements for each of the specified titles, handing each page
+    /// to pageHandler as it arrives.
+    /// </summary>
+    /// <param name="xboxUserId">The Xbox User ID of the player.</param>
+    /// <param name="titleIds">The title IDs to read achievements for.</param>
+    /// <param name="type">The achievement type to retrieve.</param>
+    /// <param name="unlockedOnly">Indicates whether to return unlocked achievements only.</param>
+    /// <param name="orderby">Controls how the list of achievements is ordered.</param>
+    /// <param name="maxItemsPerPage">The maximum number of achievements each page can contain.  Pass 0 to use
+    /// the service default.</param>
+    /// <param name="maxConcurrentTitles">The maximum number of titles queried at the same time.</param>
+    /// <param name="pageHandler">Called once per page with the title ID and the page. Calls are never concurrent,
+    /// and pages of a title are delivered in order. Pages of different titles may interleave.</param>
+    /// <remarks>
+    /// Returns a task&lt;T&gt; object that represents the state of the asynchronous operation.
+    /// The task completes once every page has been handled, or with the first error encountered.
+    ///
+    /// The next page of a title is requested as soon as the previous page arrives, so pageHandler
+    /// runs while the following request is in flight.
+    ///
+    /// This method calls V2 GET /users/xuid({xuid})/achievements
+    /// </remarks>
+    _XSAPIIMP pplx::task<xbox::services::xbox_live_result<void>> read_achievements_for_title_ids(
+        _In_ const string_t& xboxUserId,
+        _In_ const std::vector<uint32_t>& titleIds,
+        _In_ achievement_type type,
+        _In_ bool unlockedOnly,
+        _In_ achievement_order_by orderBy,
+        _In_ uint32_t maxItemsPerPage,
+        _In_ uint32_t maxConcurrentTitles,
+        _In_ std::function<void(uint32_t titleId, const achievements_result& page)> pageHandler
+        );
+
+    /// <summary>
+    /// Returns a compact summary of all of a player's achievements for the specified titles.
+    /// </summary>
+    /// <param name="xboxUserId">The Xbox User ID of the player.</param>
+    /// <param name="titleIds">The title IDs to read achievements for.</param>
+    /// <param name="type">The achievement type to retrieve.</param>
+    /// <param name="unlockedOnly">Indicates whether to return unlocked achievements only.</param>
+    /// <param name="orderby">Controls how the list of achievements is ordered within each title.</param>
+    /// <returns>The achievement summaries, grouped by title in the order of titleIds.</returns>
+    /// <remarks>
+    /// Returns a task&lt;T&gt; object that represents the state of the asynchronous operation.
+    ///
+    /// Titles are queried concurrently, bounded by xbox_live_context_settings::max_concurrent_batch_requests.
+    ///
+    /// This method calls V2 GET /users/xuid({xuid})/achievements
+    /// </remarks>
+    _XSAPIIMP pplx::task<xbox::services::xbox_live_result<std::vector<achievement_summary>>> get_achievement_summaries_for_title_ids(
+        _In_ const string_t& xboxUserId,
+        _In_ const std::vector<uint32_t>& titleIds,
+        _In_ achievement_type type,
+        _In_ bool unlockedOnly,
+        _In_ achievement_order_by orderBy
+        );
+
     achievement_service() {};
 
     achievement_service(
@@ -728,6 +847,8 @@ public:
         );
 
 private:
+    static const uint32_t MAX_ACHIEVEMENTS_PER_SUMMARY_PAGE = 100;
+
     pplx::task<xbox::services::xbox_live_result<achievements_result>> get_achievements(
         _In_ const string_t& xboxUserId,
         _In_ const std::vector<uint32_t>& titleIds,
@@ -16,6 +16,8 @@ namespace xbox { namespace services {
     /// </summary>
     namespace game_server_platform {
 
+class game_server_allocation_tracker;
+
 /// <summary>Defines a set of values used to indicate the the fulfillment state.</summary>
 enum class game_server_fulfillment_state
 {
@@ -872,6 +874,38 @@ public:
         _In_ const string_t& sessionId
         );
 
+    /// <summary>
+    /// Waits for a cluster allocation ticket to leave the queued state, polling its status as needed.
+    /// </summary>
+    /// <param name="gameServerTitleId">Title ID of the game server.</param>
+    /// <param name="ticketId">The ticket id the cluster was allocated with.</param>
+    /// <returns>GameServerTicketStatus object once the ticket is active, aborted or in error</returns>
+    /// <remarks>
+    /// Tickets tracked through the same game_server_platform_service share one polling timer. Each ticket is polled
+    /// at intervals that grow until the typical allocation time is near and are short around it.
+    /// Tracking a ticket that is already being tracked shares its polls.
+    /// Calls V6 GET titles/{titleId}/tickets/{ticketId}/status.
+    /// </remarks>
+    _XSAPIIMP pplx::task<xbox::services::xbox_live_result<game_server_ticket_status>> track_ticket_status(
+        _In_ uint32_t gameServerTitleId,
+        _In_ const string_t& ticketId
+        );
+
+    /// <summary>
+    /// Waits for a session host allocation to leave the queued state, polling its status as needed.
+    /// </summary>
+    /// <param name="gameServerTitleId">Title ID of the game server</param>
+    /// <param name="sessionId">The session id passed to allocate_session_host.</param>
+    /// <returns>allocation_result object once the allocation is fulfilled or aborted</returns>
+    /// <remarks>
+    /// Polls the same way as track_ticket_status, sharing its timer.
+    /// Calls V8 POST /titles/{gameServerTitleId}/sessionhosts
+    /// </remarks>
+    _XSAPIIMP pplx::task<xbox::services::xbox_live_result<allocation_result>> track_session_host_allocation(
+        _In_ uint32_t gameServerTitleId,
+        _In_ const string_t& sessionId
+        );
+
 private:
     game_server_platform_service() {}
 
@@ -913,6 +947,7 @@ private:
     std::shared_ptr<xbox::services::user_context> m_userContext;
     std::shared_ptr<xbox::services::xbox_live_context_settings> m_xboxLiveContextSettings;
     std::shared_ptr<xbox::services::xbox_live_app_config> m_appConfig;
+    std::shared_ptr<game_server_allocation_tracker> m_allocationTracker;
 
     friend xbox_live_context_impl;
 };
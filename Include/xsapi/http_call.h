@@ -275,6 +275,30 @@ public:
     /// </summary>
     virtual void set_request_body(_In_ const std::vector<uint8_t>& value) = 0;
 
+    /// <summary>
+    /// Sets the request body to a range of a shared buffer. The bytes are streamed straight out of
+    /// the buffer when the request is sent, so the buffer must not be modified until the call completes.
+    /// Implementations that don't override this copy the range into a byte array body instead.
+    /// </summary>
+    virtual void set_request_body(
+        _In_ std::shared_ptr<const std::vector<uint8_t>> buffer,
+        _In_ size_t offset,
+        _In_ size_t length
+        )
+    {
+        if (buffer == nullptr || offset >= buffer->size())
+        {
+            set_request_body(std::vector<uint8_t>());
+            return;
+        }
+
+        if (length > buffer->size() - offset)
+        {
+            length = buffer->size() - offset;
+        }
+        set_request_body(std::vector<uint8_t>(buffer->begin() + offset, buffer->begin() + offset + length));
+    }
+
     /// <summary>
     /// Sets a custom header.
     /// </summary>
@@ -29,7 +29,12 @@ enum http_request_message_type
     /// <summary>
     /// The message is of type vector, and acts as a memory buffer.
     /// </summary>
-    vector_message
+    vector_message,
+
+    /// <summary>
+    /// The message is a range of a shared buffer, and is sent without being copied.
+    /// </summary>
+    buffer_view_message
 };
 
 /// <summary>
@@ -52,6 +57,15 @@ public:
     /// Internal function
     /// </summary>
     http_call_request_message(_In_ std::vector<unsigned char> messageVector);
+
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    http_call_request_message(
+        _In_ std::shared_ptr<const std::vector<unsigned char>> messageBuffer,
+        _In_ size_t offset,
+        _In_ size_t length
+        );
     
     /// <summary>
     /// The http request message if it is a string type.
@@ -63,6 +77,16 @@ public:
     /// </summary>
     _XSAPIIMP const std::vector<unsigned char>& request_message_vector() const;
 
+    /// <summary>
+    /// The bytes of the http request message if it is a buffer or a buffer view, otherwise null.
+    /// </summary>
+    _XSAPIIMP const unsigned char* request_message_buffer() const;
+
+    /// <summary>
+    /// The size in bytes of the http request message if it is a buffer or a buffer view.
+    /// </summary>
+    _XSAPIIMP size_t request_message_buffer_size() const;
+
     /// <summary>
     /// The type of message.
     /// </summary>
@@ -70,6 +94,9 @@ public:
 
 private:
     std::vector<unsigned char> m_requestMessageVector;
+    std::shared_ptr<const std::vector<unsigned char>> m_requestMessageBuffer;
+    size_t m_requestMessageBufferOffset;
+    size_t m_requestMessageBufferLength;
     string_t m_requestMessageString;
     http_request_message_type m_httpRequestMessageType;
 };
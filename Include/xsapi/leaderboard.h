@@ -12,6 +12,9 @@
 #include "types.h"
 #include <cstdint>
 #include <vector>
+#include <chrono>
+#include <deque>
+#include <mutex>
 #include "xbox_live_app_config.h"
 
 #define NO_SKIP_XUID (_T(""))
@@ -34,6 +37,7 @@ namespace xbox { namespace services {
 struct leaderboard_global_query;
 struct leaderboard_social_query;
 class leaderboard_result;
+class leaderboard_rank_cache;
 
 /// <summary>Enumerates the data type of a leaderboard statistic.</summary>
 enum class leaderboard_stat_type
@@ -227,10 +231,21 @@ public:
     /// </summary>
     void _Parse_additional_columns(const std::vector<string_t>& additionalColumnNames);
 
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    void _Set_next_rank(uint32_t nextRank);
+
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    void _Set_rank_cache(std::shared_ptr<leaderboard_rank_cache> rankCache);
+
 private:
     string_t m_displayName;
     uint32_t m_totalRowCount;
     string_t m_continuationToken;
+    uint32_t m_nextRank;
     std::vector<leaderboard_column> m_columns;
     std::vector<leaderboard_row> m_rows;
 
@@ -240,6 +255,178 @@ private:
 
     std::shared_ptr<leaderboard_global_query> m_globalQuery;
     std::shared_ptr<leaderboard_social_query> m_socialQuery;
+    std::shared_ptr<leaderboard_rank_cache> m_rankCache;
+};
+
+/// <summary>
+/// Pages through a leaderboard, fetching the next pages in the background so that
+/// they are ready by the time they are requested.
+/// </summary>
+class leaderboard_cursor : public std::enable_shared_from_this<leaderboard_cursor>
+{
+public:
+    /// <summary>
+    /// Creates a cursor that continues after the given page.
+    /// </summary>
+    /// <param name="firstPage">The page returned by one of the leaderboard_service get_leaderboard calls.</param>
+    /// <param name="maxItems">The maximum number of items in each subsequent page.</param>
+    /// <param name="prefetchPageCount">The number of pages to keep fetched ahead of the caller.</param>
+    /// <remarks>
+    /// The cursor must be owned by a std::shared_ptr, for example created with std::make_shared.
+    /// Prefetching starts on the first call to get_next.
+    /// </remarks>
+    _XSAPIIMP leaderboard_cursor(
+        _In_ const leaderboard_result& firstPage,
+        _In_ uint32_t maxItems,
+        _In_ uint32_t prefetchPageCount = 2
+        );
+
+    /// <summary>
+    /// Indicates if there are more pages to be returned by get_next.
+    /// </summary>
+    _XSAPIIMP bool has_next() const;
+
+    /// <summary>
+    /// Returns the next page.  If the page has already been prefetched the task completes immediately.
+    /// Each call also tops up the prefetched pages.
+    /// </summary>
+    /// <returns>
+    /// Returns a concurrency::task&lt;T&gt; object that represents the state of the asynchronous operation.
+    /// The result is the next leaderboard_result page, or an out_of_range error if there are no more pages.
+    /// </returns>
+    _XSAPIIMP pplx::task<xbox_live_result<leaderboard_result>> get_next();
+
+    /// <summary>
+    /// The number of pages that have been fetched but not yet returned by get_next.
+    /// </summary>
+    _XSAPIIMP uint32_t prefetched_page_count() const;
+
+private:
+    void prefetch_if_needed();
+    void on_page_fetched(_In_ xbox_live_result<leaderboard_result> page);
+
+    uint32_t m_maxItems;
+    uint32_t m_prefetchPageCount;
+    leaderboard_result m_lastFetchedPage;
+    bool m_fetchInProgress;
+    bool m_prefetchPaused;
+    std::deque<xbox_live_result<leaderboard_result>> m_fetchedPages;
+    std::deque<pplx::task_completion_event<xbox_live_result<leaderboard_result>>> m_waitingCallers;
+    mutable std::mutex m_lock;
+};
+
+/// <summary>
+/// Several stats for the members of a social group, joined by player into one table.
+/// Each stat is kept as its own array of numeric values, indexed by row, so the table can be
+/// re-sorted by any stat locally without going back to the service.
+/// </summary>
+class social_leaderboard_table
+{
+public:
+    /// <summary>
+    /// Creates an empty table with a column for each stat.
+    /// </summary>
+    _XSAPIIMP social_leaderboard_table(
+        _In_ std::vector<string_t> statNames = std::vector<string_t>()
+        );
+
+    /// <summary>
+    /// The stat for each column, in the order they were requested.
+    /// </summary>
+    _XSAPIIMP const std::vector<string_t>& stat_names() const;
+
+    /// <summary>
+    /// The index of a stat's column, or -1 if the table has no column for it.
+    /// </summary>
+    _XSAPIIMP int column_index(_In_ const string_t& statName) const;
+
+    /// <summary>
+    /// The number of players in the table.
+    /// </summary>
+    _XSAPIIMP size_t row_count() const;
+
+    /// <summary>
+    /// The index of a player's row, or -1 if the player isn't in the table.
+    /// </summary>
+    _XSAPIIMP int row_index(_In_ const string_t& xboxUserId) const;
+
+    /// <summary>
+    /// The Xbox user ID of the player in a row.
+    /// </summary>
+    _XSAPIIMP const string_t& xbox_user_id(_In_ size_t row) const;
+
+    /// <summary>
+    /// The Gamertag of the player in a row.
+    /// </summary>
+    _XSAPIIMP const string_t& gamertag(_In_ size_t row) const;
+
+    /// <summary>
+    /// Whether the player in a row has a value for a stat. Players missing from a stat's leaderboard have none.
+    /// </summary>
+    _XSAPIIMP bool has_value(_In_ size_t row, _In_ size_t column) const;
+
+    /// <summary>
+    /// The value of a stat for the player in a row, or 0 if the player has none.
+    /// </summary>
+    _XSAPIIMP double value(_In_ size_t row, _In_ size_t column) const;
+
+    /// <summary>
+    /// The values of a stat for every row, indexed by row.
+    /// </summary>
+    _XSAPIIMP const std::vector<double>& column_values(_In_ size_t column) const;
+
+    /// <summary>
+    /// The rows in the current sort order. Until sort_by is called this is the order of the first stat
+    /// as returned by the service.
+    /// </summary>
+    _XSAPIIMP const std::vector<uint32_t>& sorted_rows() const;
+
+    /// <summary>
+    /// The column the table is sorted by.
+    /// </summary>
+    _XSAPIIMP size_t sort_column() const;
+
+    /// <summary>
+    /// Whether the table is sorted highest value first.
+    /// </summary>
+    _XSAPIIMP bool is_sorted_descending() const;
+
+    /// <summary>
+    /// Re-sorts the rows by a stat. Rows without a value for the stat come last, and ties keep row order.
+    /// </summary>
+    _XSAPIIMP void sort_by(_In_ size_t column, _In_ bool descending = true);
+
+    /// <summary>
+    /// Updates a player's value for a stat, such as after writing it through stats_manager, and moves the
+    /// row to its new place if the table is sorted by that stat. Players not in the table are added.
+    /// </summary>
+    /// <returns>False if the table has no column for the stat.</returns>
+    _XSAPIIMP bool update_value(
+        _In_ const string_t& xboxUserId,
+        _In_ const string_t& gamertag,
+        _In_ const string_t& statName,
+        _In_ double value
+        );
+
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    void _Add_column_rows(_In_ size_t column, _In_ const leaderboard_result& result);
+
+private:
+    uint32_t add_row(_In_ const string_t& xboxUserId, _In_ const string_t& gamertag);
+    bool sorts_before(_In_ uint32_t row1, _In_ uint32_t row2) const;
+
+    std::vector<string_t> m_statNames;
+    std::vector<string_t> m_xboxUserIds;
+    std::vector<string_t> m_gamertags;
+    std::unordered_map<string_t, uint32_t> m_rowIndices;
+    std::vector<std::vector<double>> m_columnValues;
+    std::vector<std::vector<uint8_t>> m_columnHasValues;
+    std::vector<uint32_t> m_sortedRows;
+    size_t m_sortColumn;
+    bool m_sortDescending;
+    bool m_isSorted;
 };
 
 /// <summary>
@@ -536,6 +723,46 @@ public:
         _In_ uint32_t maxItems = 0
         );
 
+    /// <summary>
+    /// Get several stats for the members of a social group as one table, joined by player.
+    /// </summary>
+    /// <param name="xuid">The Xbox user ID of the requesting user.</param>
+    /// <param name="scid">The service configuration ID (SCID) of the title</param>
+    /// <param name="statNames">The names of the statistics to include, one column each.</param>
+    /// <param name="socialGroup">The name of the group of users to get get leaderboard results for.  
+    /// You can pass either "Favorites" or "People"</param>
+    /// <param name="maxItems">The maximum number of players to retrieve for each statistic. If this value is 0, the server defaults to 10. (Optional)</param>
+    /// <returns>A social_leaderboard_table with a column for each statistic</returns>
+    /// <remarks>
+    /// Returns a concurrency::task&lt;T&gt; object that represents the state of the asynchronous operation.
+    /// The leaderboard for each statistic is requested at the same time, and the first page of each is used.
+    ///
+    /// Calls V1 GET 
+    /// https://leaderboards.xboxlive.com/users/xuid({xuid})/scids/{scid}/stats/{statname}/people/{all|favorites}
+    /// once for each statistic
+    /// </remarks>
+    _XSAPIIMP pplx::task<xbox_live_result<social_leaderboard_table>> get_social_leaderboard_table(
+        _In_ const string_t& xuid,
+        _In_ const string_t& scid,
+        _In_ const std::vector<string_t>& statNames,
+        _In_ const string_t& socialGroup,
+        _In_ uint32_t maxItems = 0
+        );
+
+    /// <summary>
+    /// Gets how long leaderboard rows are kept in the rank cache.  Zero means the cache is disabled.
+    /// </summary>
+    _XSAPIIMP std::chrono::seconds rank_cache_expiry() const;
+
+    /// <summary>
+    /// Sets how long leaderboard rows are kept in the rank cache.  The default is zero, which disables the cache.
+    ///
+    /// When enabled, every page fetched for a leaderboard (or a stat and social group) is cached by rank.
+    /// A later skip to rank request whose whole window is already cached and not expired is served locally
+    /// without calling the service.  Pages fetched with a leaderboard_cursor populate the same cache.
+    /// </summary>
+    _XSAPIIMP void set_rank_cache_expiry(_In_ std::chrono::seconds expiry);
+
 private:
     leaderboard_service() {}
 
@@ -576,6 +803,7 @@ private:
     std::shared_ptr<xbox::services::user_context> m_userContext;
     std::shared_ptr<xbox::services::xbox_live_context_settings> m_xboxLiveContextSettings;
     std::shared_ptr<xbox::services::xbox_live_app_config> m_appConfig;
+    std::shared_ptr<leaderboard_rank_cache> m_rankCache;
 
     friend leaderboard_result;
     friend xbox_live_context_impl;
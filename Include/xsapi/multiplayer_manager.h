@@ -1372,6 +1372,41 @@ public:
     /// <returns>A list of all callback events for the game to handle. Empty if no events are triggered during this update.</returns>
     _XSAPIIMP std::vector<multiplayer_event> do_work();
 
+    /// <summary>
+    /// Registers a handler that do_work() calls for each event of the given type.
+    /// Handlers are called on the thread calling do_work(), after do_work() has finished updating the sessions.
+    /// </summary>
+    /// <param name="eventType">The type of event to handle.</param>
+    /// <param name="handler">The function to call with each event of that type.</param>
+    /// <returns>A function_context that can be used to remove the handler.</returns>
+    _XSAPIIMP function_context add_event_handler(
+        _In_ multiplayer_event_type eventType,
+        _In_ std::function<void(const multiplayer_event&)> handler
+        );
+
+    /// <summary>
+    /// Removes a handler registered with add_event_handler().
+    /// </summary>
+    /// <param name="context">The function_context returned when the handler was registered.</param>
+    _XSAPIIMP void remove_event_handler(
+        _In_ function_context context
+        );
+
+    /// <summary>
+    /// Sets which event types do_work() returns. By default it returns every type, and passing
+    /// every type restores that default. Session changes of types that are neither returned nor
+    /// have a handler are not turned into events; other events of those types are dropped.
+    /// </summary>
+    /// <param name="eventTypes">The event types for do_work() to return.</param>
+    _XSAPIIMP void set_returned_event_types(
+        _In_ const std::vector<multiplayer_event_type>& eventTypes
+        );
+
+    /// <summary>
+    /// The number of events of each type the last do_work() delivered, whether returned or passed to handlers.
+    /// </summary>
+    _XSAPIIMP std::map<multiplayer_event_type, uint32_t> last_event_counts() const;
+
     /// <summary>
     /// Represents a lobby session used for managing members that are local to this device and your invited friends.
     /// When a member accepts a game invite, they will be added to the lobby and the game session (if it exists).
@@ -1545,6 +1580,28 @@ public:
         _In_ std::shared_ptr<std::vector<xbox::services::multiplayer::multiplayer_quality_of_service_measurements>> measurements
         );
 
+    /// <summary>
+    /// Has the multiplayer manager measure QoS to the other matched members itself, instead of raising
+    /// perform_qos_measurements. Each member is probed over UDP and its latency, packet loss and estimated
+    /// bandwidth are uploaded as if set_quality_of_service_measurements had been called.
+    /// The members' QoS endpoints must echo the probes back unchanged.
+    /// Call after initialize(). The perform_qos_measurements event is still raised if no member can be resolved.
+    /// </summary>
+    /// <param name="addressResolver">Maps a member's secure device address to the "host:port" of its QoS endpoint,
+    /// or returns an empty string if the member can't be probed.</param>
+    /// <param name="probeCount">The number of latency probes sent to each member.</param>
+    /// <param name="timeout">How long to wait for replies after the last probe is sent.</param>
+    _XSAPIIMP void enable_built_in_quality_of_service_measurements(
+        _In_ std::function<string_t(const string_t& secureDeviceAddress)> addressResolver,
+        _In_ uint32_t probeCount = 8,
+        _In_ std::chrono::milliseconds timeout = std::chrono::milliseconds(1000)
+        );
+
+    /// <summary>
+    /// Goes back to raising perform_qos_measurements for the title to measure QoS itself.
+    /// </summary>
+    _XSAPIIMP void disable_built_in_quality_of_service_measurements();
+
     /// <summary>
     /// Indicates who can join your game via the lobby.
     /// </summary>
@@ -1627,11 +1684,25 @@ private:
     multiplayer_manager(multiplayer_manager const&);
     void operator=(multiplayer_manager const&);
     
+    struct event_handler
+    {
+        multiplayer_event_type eventType;
+        std::function<void(const multiplayer_event&)> handler;
+    };
+
     bool m_isDirty;
     void set_multiplayer_game_session(_In_ std::shared_ptr<multiplayer_game_session> gameSession);
     void set_multiplayer_lobby_session(_In_ std::shared_ptr<multiplayer_lobby_session> multiplayerLobby);
 
+    // Called with m_lock held
+    std::vector<multiplayer_event> collect_events();
+    uint32_t wanted_event_types() const;
+
     mutable std::mutex m_lock;
+    std::map<function_context, event_handler> m_eventHandlers;
+    function_context m_eventHandlerCounter;
+    uint32_t m_returnedEventTypes;
+    std::map<multiplayer_event_type, uint32_t> m_lastEventCounts;
     xbox::services::multiplayer::manager::joinability m_joinability;
     std::shared_ptr<multiplayer_lobby_session> m_multiplayerLobbySession;
     std::shared_ptr<multiplayer_game_session> m_multiplayerGameSession;
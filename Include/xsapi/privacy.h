@@ -299,6 +299,16 @@ private:
         _In_ const string_t& xboxUserId
         );
 
+    static pplx::task<xbox_live_result<std::vector<multiple_permissions_check_result>>> check_multiple_permissions_batch(
+        _In_ const std::shared_ptr<xbox::services::user_context>& userContext,
+        _In_ const std::shared_ptr<xbox::services::xbox_live_context_settings>& xboxLiveContextSettings,
+        _In_ const std::shared_ptr<xbox::services::xbox_live_app_config>& appConfig,
+        _In_ const std::vector<string_t>& permissionIds,
+        _In_ const std::vector<string_t>& targetXboxUserIds
+        );
+
+    static const size_t MAX_TARGET_USERS_PER_BATCH_REQUEST = 100;
+
     std::shared_ptr<xbox::services::user_context> m_userContext;
     std::shared_ptr<xbox::services::xbox_live_context_settings> m_xboxLiveContextSettings;
     std::shared_ptr<xbox::services::xbox_live_app_config> m_appConfig;
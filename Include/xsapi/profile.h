@@ -166,6 +166,13 @@ namespace social {
             _In_ std::shared_ptr<XBOX_LIVE_NAMESPACE::xbox_live_app_config> appConfig
             );
 
+        static pplx::task<XBOX_LIVE_NAMESPACE::xbox_live_result<std::vector<xbox_user_profile>>> get_user_profiles_batch(
+            _In_ const std::shared_ptr<XBOX_LIVE_NAMESPACE::user_context>& userContext,
+            _In_ const std::shared_ptr<XBOX_LIVE_NAMESPACE::xbox_live_context_settings>& xboxLiveContextSettings,
+            _In_ const std::shared_ptr<XBOX_LIVE_NAMESPACE::xbox_live_app_config>& appConfig,
+            _In_ const std::vector<string_t>& xboxUserIds
+            );
+
         static const string_t settings_query();
 
         static const string_t pathandquery_user_profiles_for_social_group(
@@ -180,6 +187,8 @@ namespace social {
 
         static const string_t SETTINGS_QUERY;
 
+        static const size_t MAX_USERS_PER_BATCH_REQUEST = 100;
+
         static std::mutex m_settingsLock;
         std::shared_ptr<XBOX_LIVE_NAMESPACE::user_context> m_userContext;
         std::shared_ptr<XBOX_LIVE_NAMESPACE::xbox_live_context_settings> m_xboxLiveContextSettings;
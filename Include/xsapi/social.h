@@ -22,6 +22,7 @@ namespace xbox { namespace services {
     namespace social {
 
 class social_service_impl;
+class reputation_feedback_aggregator;
 
 enum class xbox_social_relationship_filter
 {
@@ -586,6 +587,69 @@ private:
     string_t m_evidenceResourceId;
 };
 
+/// <summary>
+/// Counters for the reputation feedback queued through reputation_service::queue_reputation_feedback
+/// </summary>
+struct reputation_feedback_queue_stats
+{
+    reputation_feedback_queue_stats() :
+        itemsQueued(0),
+        itemsDeduplicated(0),
+        itemsSubmitted(0),
+        itemsFailed(0),
+        batchesSent(0),
+        batchesRetried(0),
+        pendingItems(0),
+        inFlightItems(0),
+        peakPendingItems(0)
+    {
+    }
+
+    /// <summary>
+    /// Feedback items accepted into the queue, not counting duplicates
+    /// </summary>
+    uint64_t itemsQueued;
+
+    /// <summary>
+    /// Feedback items dropped because the same report was already queued or submitted within the dedup window
+    /// </summary>
+    uint64_t itemsDeduplicated;
+
+    /// <summary>
+    /// Feedback items the service accepted
+    /// </summary>
+    uint64_t itemsSubmitted;
+
+    /// <summary>
+    /// Feedback items that could not be submitted, including after retries
+    /// </summary>
+    uint64_t itemsFailed;
+
+    /// <summary>
+    /// Batch feedback requests made, including retries
+    /// </summary>
+    uint64_t batchesSent;
+
+    /// <summary>
+    /// Batch feedback requests that were retried after a throttling, timeout or network error
+    /// </summary>
+    uint64_t batchesRetried;
+
+    /// <summary>
+    /// Feedback items waiting for the next batch
+    /// </summary>
+    size_t pendingItems;
+
+    /// <summary>
+    /// Feedback items in batches that have been sent or are waiting to be retried
+    /// </summary>
+    size_t inFlightItems;
+
+    /// <summary>
+    /// The most feedback items that have waited for a batch at once
+    /// </summary>
+    size_t peakPendingItems;
+};
 
 /// <summary>
 /// Manages the reputation service.
@@ -621,6 +685,30 @@ public:
         _In_ const std::vector< reputation_feedback_item >& feedbackItems
         );
 
+    /// <summary>
+    /// Queues reputation feedback on a user to be submitted together with other feedback queued on this
+    /// reputation_service. Feedback is sent through the batch feedback endpoint once enough items are queued
+    /// or shortly after the first item is queued, and batches that fail with a throttling, timeout or network
+    /// error are retried with backoff. Repeating the same report on the same user from the same session within
+    /// a few minutes doesn't submit it again.
+    /// </summary>
+    /// <param name="feedbackItem">The reputation feedback to submit.</param>
+    /// <returns>The async object for notifying when the batch holding the feedback has been submitted.</returns>
+    /// <remarks>Calls V101 POST /users/batchfeedback</remarks>
+    _XSAPIIMP pplx::task<xbox_live_result<void>> queue_reputation_feedback(
+        _In_ const reputation_feedback_item& feedbackItem
+        );
+
+    /// <summary>
+    /// Submits any queued reputation feedback right away, such as when a match ends.
+    /// </summary>
+    _XSAPIIMP void flush_reputation_feedback();
+
+    /// <summary>
+    /// Returns counters for the feedback queued through queue_reputation_feedback.
+    /// </summary>
+    _XSAPIIMP reputation_feedback_queue_stats feedback_queue_stats() const;
+
 private:
     reputation_service() {};
 
@@ -633,6 +721,14 @@ private:
     std::shared_ptr<xbox::services::user_context> m_userContext;
     std::shared_ptr<xbox::services::xbox_live_context_settings> m_xboxLiveContextSettings;
     std::shared_ptr<xbox::services::xbox_live_app_config> m_appConfig;
+    std::shared_ptr<reputation_feedback_aggregator> m_feedbackAggregator;
+
+    static pplx::task<xbox_live_result<void>> send_batch_reputation_feedback(
+        _In_ const std::shared_ptr<xbox::services::user_context>& userContext,
+        _In_ const std::shared_ptr<xbox::services::xbox_live_context_settings>& xboxLiveContextSettings,
+        _In_ const std::shared_ptr<xbox::services::xbox_live_app_config>& appConfig,
+        _In_ const std::vector< reputation_feedback_item >& feedbackItems
+        );
 
     string_t reputation_feedback_subpath(
         _In_ const string_t& xboxUserId
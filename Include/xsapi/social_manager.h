@@ -41,6 +41,7 @@ class social_graph;
 struct xbox_social_user_context;
 struct user_group_status_change;
 enum class change_list_enum;
+struct pooled_string_entry;
 
 static const uint32_t GAMERSCORE_CHAR_SIZE = 16;
 static const uint32_t GAMERTAG_CHAR_SIZE = 16;
@@ -167,6 +168,33 @@ enum class social_user_group_type
     user_list_type
 };
 
+/// <summary>
+/// Internal class
+/// A reference to a string in the social manager string pool. Equal strings held by any user, buffer
+/// or graph share a single copy, which is freed when the last reference to it goes away.
+/// </summary>
+class pooled_string
+{
+public:
+    pooled_string();
+
+    /// <summary>
+    /// Adds the first maxLength characters of value to the pool, or references them if they are already there
+    /// </summary>
+    pooled_string(_In_ const string_t& value, _In_ size_t maxLength);
+
+    pooled_string(_In_ const pooled_string& other);
+
+    pooled_string& operator=(_In_ const pooled_string& other);
+
+    ~pooled_string();
+
+    const char_t* c_str() const;
+
+private:
+    pooled_string_entry* m_entry;
+};
+
 /// <summary>
 /// Data about whether the user has played the title
 /// </summary>
@@ -249,9 +277,9 @@ public:
         );
 
 private:
-    char_t m_primaryColor[COLOR_CHAR_SIZE];
-    char_t m_secondaryColor[COLOR_CHAR_SIZE];
-    char_t m_tertiaryColor[COLOR_CHAR_SIZE];
+    pooled_string m_primaryColor;
+    pooled_string m_secondaryColor;
+    pooled_string m_tertiaryColor;
 };
 
 /// <summary>
@@ -312,7 +340,7 @@ private:
     bool m_isNull;
     xbox::services::presence::presence_device_type m_deviceType;
     uint32_t m_titleId;
-    char_t m_presenceText[RICH_PRESENCE_CHAR_SIZE];
+    pooled_string m_presenceText;
 };
 
 /// <summary>
@@ -376,6 +404,11 @@ public:
     /// </summary>
     void _Set_xbox_user_id(_In_ uint64_t xboxUserId);
 
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    uint64_t _Fingerprint() const;
+
     /// <summary>
     /// Internal function
     /// </summary>
@@ -385,8 +418,11 @@ public:
         );
 
 private:
+    void update_fingerprint();
+
     xbox::services::presence::user_presence_state m_userState;
     uint64_t m_xboxUserId;
+    uint64_t m_fingerprint;
     social_manager_presence_title_record m_presenceVec[NUM_PRESENCE_RECORDS];
 
     friend class user_buffers_holder;
@@ -394,6 +430,7 @@ private:
 
 /// <summary>
 /// Xbox Social User that contains profile, presence, preferred color, and title history data
+/// The strings it returns stay valid for as long as the xbox_social_user they came from.
 /// </summary>
 class xbox_social_user
 {
@@ -491,17 +528,20 @@ public:
     static xbox_live_result<xbox_social_user> _Deserialize(_In_ const web::json::value& json);
 
 private:
+    void update_profile_fingerprint();
+
     bool m_isFavorite;
     bool m_isFollowingCaller;
     bool m_isFollowedByCaller;
     bool m_useAvatar;
     uint64_t m_xboxUserIdAsInt;
-    char_t m_gamerscore[GAMERSCORE_CHAR_SIZE];
-    char_t m_gamertag[GAMERTAG_CHAR_SIZE];
-    char_t m_xboxUserId[XBOX_USER_ID_CHAR_SIZE];
-    char_t m_displayName[DISPLAY_NAME_CHAR_SIZE];
-    char_t m_realName[REAL_NAME_CHAR_SIZE];
-    char_t m_displayPicUrlRaw[DISPLAY_PIC_URL_RAW_CHAR_SIZE];
+    uint64_t m_profileFingerprint;
+    pooled_string m_gamerscore;
+    pooled_string m_gamertag;
+    pooled_string m_xboxUserId;
+    pooled_string m_displayName;
+    pooled_string m_realName;
+    pooled_string m_displayPicUrlRaw;
     xbox::services::social::manager::title_history m_titleHistory;
     xbox::services::social::manager::preferred_color m_preferredColor;
     xbox::services::social::manager::social_manager_presence_record m_presenceRecord;
@@ -774,6 +814,19 @@ private:
     std::shared_ptr<xbox_social_user_group> m_socialUserGroup;
 };
 
+/// <summary>
+/// Internal struct
+/// How long one local user's graph and social user groups took in the last call to do_work
+/// </summary>
+struct social_graph_work_timing
+{
+    string_t xboxUserId;
+    std::chrono::microseconds graphTime;
+    std::chrono::microseconds userGroupsTime;
+    size_t eventCount;
+    bool processedInParallel;
+};
+
 /// <summary>
 /// Social Manager that handles core logic
 /// </summary>
@@ -814,6 +867,23 @@ public:
     /// <returns> The list of what has changed in between social graph updates</returns>
     _XSAPIIMP std::vector<social_event> do_work();
 
+    /// <summary>
+    /// Whether do_work should update each local user's social graph and social user groups on its own
+    /// task and wait for them all, rather than one after another on the calling thread.
+    /// Worth enabling with several local users; it is off by default.
+    /// </summary>
+    /// <param name="processInParallel">Whether or not local users should be processed in parallel</param>
+    _XSAPIIMP void set_parallel_graph_processing(_In_ bool processInParallel);
+
+    /// <summary>
+    /// Whether users that are in more than one local user's social graph should share presence subscriptions
+    /// and presence polling, rather than each local user's graph subscribing to and polling them separately.
+    /// It is off by default and can only be changed while there are no local users.
+    /// </summary>
+    /// <param name="shareAcrossLocalUsers">Whether or not users should be shared between local users' graphs</param>
+    /// <returns>An xbox_live_result to report any potential error</returns>
+    _XSAPIIMP xbox_live_result<void> set_social_user_sharing(_In_ bool shareAcrossLocalUsers);
+
     /// <summary>
     /// Constructs a social Xbox Social User Group, which is a collection of users with social information
     /// The result of a user group being loaded will be triggered through the social_user_group_loaded event in do_work
@@ -884,6 +954,11 @@ public:
     /// </summary>
     void _Log_state();
 
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    std::vector<social_graph_work_timing> _Graph_work_timings();
+
 #if defined(XSAPI_CPPWINRT)
 #if TV_API
     _XSAPIIMP virtual xbox_live_result<void> add_local_user(
@@ -929,6 +1004,8 @@ protected:
     
     social_manager();
 
+    void do_graph_work_in_parallel(_Inout_ std::vector<social_event>& socialEvents);
+
     std::vector<social_event> m_eventQueue;
     std::vector<xbox_live_user_t> m_localUserList;
     xsapi_internal_unordered_map(string_t, std::shared_ptr<xbox_social_user_group>) m_xboxSocialUserGroups;
@@ -936,6 +1013,8 @@ protected:
     xsapi_internal_unordered_map(string_t, std::shared_ptr<social_graph>) m_localGraphs;
     std::mutex m_socialMangerLock;
     std::mutex m_socialManagerEventLock;
+    bool m_processGraphsInParallel;
+    std::vector<social_graph_work_timing> m_graphWorkTimings;
 
     static std::shared_ptr<social_manager> m_socialManager;
     friend class xbox_social_user_group;
@@ -138,6 +138,19 @@ public:
     /// </summary>
     _XSAPIIMP void set_diagnostics_trace_level(_In_ xbox_services_diagnostics_trace_level value);
 
+    /// <summary>
+    /// Indicates whether service calls are smoothed on the client to stay within the per user service rate limits.
+    /// </summary>
+    _XSAPIIMP bool enable_client_side_rate_limiting() const;
+
+    /// <summary>
+    /// Sets whether service calls are smoothed on the client to stay within the per user service rate limits.
+    /// When enabled, calls that would exceed an endpoint's burst or sustained limit are held back until the
+    /// limit allows them instead of being sent and throttled. Calls made by the title are released ahead of
+    /// background refreshes made by the social and stats managers. Disabled by default.
+    /// </summary>
+    _XSAPIIMP void set_enable_client_side_rate_limiting(_In_ bool value);
+
     /// <summary>
     /// Registers to recieve Windows Push Nofication Service(WNS) events.  Event handlers will receive the xbox user id and notification type.
     /// </summary>
@@ -703,6 +716,8 @@ private:
     string_t m_firstOffendingSubstring;
 };
 
+class string_verify_batcher;
+
 /// <summary>
 /// Provides methods to validate a string for use with Xbox live.
 /// </summary>
@@ -720,6 +735,10 @@ public:
     /// <remarks>
     /// Returns a concurrency::task&lt;T&gt; object that represents the state of the asynchronous operation.
     /// 
+    /// If batching is enabled with set_verify_string_batching_enabled, strings verified within a few
+    /// milliseconds of each other are sent together in one request, and recent results are reused for
+    /// strings that were already verified.
+    ///
     /// Calls V2 GET /system/strings/validate
     /// </remarks>
     _XSAPIIMP pplx::task<xbox_live_result<verify_string_result>> verify_string(_In_ const string_t& stringToVerify);
@@ -738,6 +757,20 @@ public:
     /// </remarks>
     _XSAPIIMP pplx::task<xbox_live_result<std::vector<verify_string_result>>> verify_strings(_In_ const std::vector<string_t>& stringsToVerify);
 
+    /// <summary>
+    /// Gets whether verify_string calls are batched and their results cached.
+    /// </summary>
+    _XSAPIIMP bool verify_string_batching_enabled() const;
+
+    /// <summary>
+    /// Sets whether verify_string calls are batched and their results cached.  The default is false,
+    /// which sends each verify_string call to the service right away.
+    ///
+    /// When enabled, verify_string waits up to 50ms for other strings to send with it, and the results
+    /// for the 512 most recently verified strings are reused without calling the service.
+    /// </summary>
+    _XSAPIIMP void set_verify_string_batching_enabled(_In_ bool enabled);
+
     /// <summary>
     /// Internal function
     /// </summary>
@@ -753,9 +786,18 @@ public:
         );
 
 private:
+    static pplx::task<xbox_live_result<std::vector<verify_string_result>>> send_verify_strings_request(
+        _In_ const std::shared_ptr<XBOX_LIVE_NAMESPACE::user_context>& userContext,
+        _In_ const std::shared_ptr<XBOX_LIVE_NAMESPACE::xbox_live_context_settings>& xboxLiveContextSettings,
+        _In_ const std::shared_ptr<XBOX_LIVE_NAMESPACE::xbox_live_app_config>& appConfig,
+        _In_ const std::vector<string_t>& stringsToVerify
+        );
+
     std::shared_ptr<XBOX_LIVE_NAMESPACE::user_context> m_userContext;
     std::shared_ptr<XBOX_LIVE_NAMESPACE::xbox_live_context_settings> m_xboxLiveContextSettings;
     std::shared_ptr<XBOX_LIVE_NAMESPACE::xbox_live_app_config> m_appConfig;
+    std::shared_ptr<string_verify_batcher> m_stringVerifyBatcher;
+    bool m_isVerifyStringBatchingEnabled;
 };
 } // namespace system
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
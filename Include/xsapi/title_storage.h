@@ -524,6 +524,12 @@ private:
     title_storage_blob_metadata m_blobMetadata;
 };
 
+/// <summary>
+/// Receives a block of a blob as it is downloaded. offset is where the block starts within the blob.
+/// The data is only valid for the duration of the call. Return false to stop the download.
+/// </summary>
+typedef std::function<bool(uint64_t offset, const unsigned char* data, size_t length)> title_storage_download_block_handler;
+
 /// <summary>
 /// Services that manage title storage.
 /// </summary>
@@ -679,11 +685,55 @@ public:
         _In_ uint32_t preferredDownloadBlockSize
         );
 
+    /// <summary>
+    /// Downloads blob data from title storage and hands each block to a caller provided handler as it arrives,
+    /// so the blob is never held in memory as a whole.
+    /// </summary>
+    /// <param name="blobMetadata">The blob metadata for the title storage blob to download.</param>
+    /// <param name="blockHandler">Called with each block in order. Returning false fails the download.</param>
+    /// <param name="etagMatchCondition">The ETag match condition used to determine if the blob should be downloaded.</param>
+    /// <param name="selectQuery">ConfigStorage filter string or JSONStorage json property name string to filter. (Optional)</param>
+    /// <param name="preferredDownloadBlockSize">The preferred download block size in bytes for binary blobs. </param>
+    /// <param name="startByte">Where to start downloading a binary blob from, to resume a download that was interrupted.
+    /// Pass the ETag of the partially downloaded version in blobMetadata with title_storage_e_tag_match_condition::if_match
+    /// so the download fails with http_status_412_precondition_failed if the blob has changed since.</param>
+    /// <returns>title_storage_blob_metadata object with updated ETag and Length properties.</returns>
+    /// <remarks>
+    /// Once the first block arrives, the remaining blocks are requested with If-Match on its ETag so a blob that changes
+    /// mid download fails instead of mixing versions.
+    /// </remarks>
+    _XSAPIIMP pplx::task<xbox_live_result<title_storage_blob_metadata>> download_blob_to_handler(
+        _In_ title_storage_blob_metadata blobMetadata,
+        _In_ title_storage_download_block_handler blockHandler,
+        _In_ title_storage_e_tag_match_condition etagMatchCondition,
+        _In_ string_t selectQuery = string_t(),
+        _In_ uint32_t preferredDownloadBlockSize = DEFAULT_DOWNLOAD_BLOCK_SIZE,
+        _In_ uint64_t startByte = 0
+        );
+
+    /// <summary>
+    /// Downloads blob data from title storage straight into a file. Each block is written at its offset as it
+    /// arrives, so only one block is in memory at a time.
+    /// </summary>
+    /// <param name="blobMetadata">The blob metadata for the title storage blob to download.</param>
+    /// <param name="filePath">The file to write the blob to. It is replaced unless a download is being resumed.</param>
+    /// <param name="resumeIfPartial">For binary blobs, continue a previous download of filePath that did not finish.
+    /// The ETag of the version being downloaded is kept next to the file in filePath + ".etag" until the download
+    /// completes. If the blob has changed since, the download starts over from the beginning.</param>
+    /// <param name="preferredDownloadBlockSize">The preferred download block size in bytes for binary blobs. </param>
+    /// <returns>title_storage_blob_metadata object with updated ETag and Length properties.</returns>
+    _XSAPIIMP pplx::task<xbox_live_result<title_storage_blob_metadata>> download_blob_to_file(
+        _In_ title_storage_blob_metadata blobMetadata,
+        _In_ string_t filePath,
+        _In_ bool resumeIfPartial,
+        _In_ uint32_t preferredDownloadBlockSize = DEFAULT_DOWNLOAD_BLOCK_SIZE
+        );
+
     /// <summary>
     /// Uploads blob data to title storage.
     /// </summary>
     /// <param name="blobMetadata">Contains properties required to upload the buffer to title storage.  Uploads require a service configuration Id, blob path, blob type and storage type at a minimum.</param>
-    /// <param name="blobBuffer">The buffer containing the blob data to upload.  This buffer must be available for the duration of the async operation.  Clients should not modify the buffer while an upload is in progress.</param>
+    /// <param name="blobBuffer">The buffer containing the blob data to upload.  This buffer must be available for the duration of the async operation.  Clients should not modify the buffer while an upload is in progress.  Each block is sent straight out of this buffer without being copied.</param>
     /// <param name="etagMatchCondition">The ETag match condition used to determine if the blob data should be uploaded.</param>
     /// <param name="preferredUploadBlockSize">The preferred upload block size in bytes for binary blobs. Binary blobs will be
     /// uploaded in multiple chunks of this size if they exceed it.  Larger sizes are preferred by the service.
@@ -739,8 +789,22 @@ private:
 
     static void set_range_header(
         _In_ std::shared_ptr<xbox::services::http_call> httpCall,
-        _In_ uint32_t startByte,
-        _In_ uint32_t endByte
+        _In_ uint64_t startByte,
+        _In_ uint64_t endByte
+        );
+
+    static xbox_live_result<title_storage_blob_metadata> download_blob_blocks(
+        _In_ const std::shared_ptr<xbox::services::xbox_live_context_settings>& xboxLiveContextSettings,
+        _In_ const std::shared_ptr<xbox::services::user_context>& userContext,
+        _In_ const std::shared_ptr<xbox::services::xbox_live_app_config>& appConfig,
+        _In_ const title_storage_blob_metadata& blobMetadata,
+        _In_ string_t etag,
+        _In_ title_storage_e_tag_match_condition etagMatchCondition,
+        _In_ const string_t& selectQuery,
+        _In_ uint32_t preferredDownloadBlockSize,
+        _In_ uint64_t startByte,
+        _In_ const title_storage_download_block_handler& blockHandler,
+        _In_ const std::function<void(const string_t& etag)>& etagHandler
         );
 
     static xbox_live_result<string_t> title_storage_quota_subpath(
@@ -289,6 +289,11 @@ public:
     /// </summary>
     void _Set_statistic_change_subscription_handler(_In_ std::function<void(const statistic_change_event_args&)> statisticChangeHandler);
 
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    void _Update_from_shared_subscription(_In_ const statistic_change_subscription& sharedSubscription);
+
 protected:
     void on_subscription_created(_In_ uint32_t id, _In_ const web::json::value& data) override;
     void on_event_received(_In_ const web::json::value& data) override;
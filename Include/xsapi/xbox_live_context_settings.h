@@ -29,6 +29,7 @@ NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 #define DEFAULT_HTTP_RETRY_WINDOW_SECONDS (20)
 #define DEFAULT_RETRY_DELAY_SECONDS (2)
 #define MIN_RETRY_DELAY_SECONDS (2)
+#define DEFAULT_MAX_CONCURRENT_BATCH_REQUESTS (4)
 
 /// <summary>
 /// Enumeration values that indicate the trace levels of debug output for service diagnostics.
@@ -262,6 +263,21 @@ public:
     /// </summary>
     _XSAPIIMP void set_use_core_dispatcher_for_event_routing(_In_ bool value);
 
+    /// <summary>
+    /// Gets the maximum number of requests that are sent concurrently when a batch call,
+    /// such as profile_service::get_user_profiles, is larger than the service allows in a single request.
+    /// Default is 4.
+    /// </summary>
+    _XSAPIIMP uint32_t max_concurrent_batch_requests() const;
+
+    /// <summary>
+    /// Sets the maximum number of requests that are sent concurrently when a batch call,
+    /// such as profile_service::get_user_profiles, is larger than the service allows in a single request.
+    /// The batch is split into service sized chunks and the results are merged in input order.
+    /// Set to 1 to send the chunks one at a time.  Values less than 1 are treated as 1.
+    /// </summary>
+    _XSAPIIMP void set_max_concurrent_batch_requests(_In_ uint32_t value);
+
     /// <summary>
     /// Disables asserts for Xbox Live throttling in dev sandboxes.
     /// The asserts will not fire in RETAIL sandbox, and this setting has has no affect in RETAIL sandboxes.
@@ -321,6 +337,7 @@ private:
     
     std::chrono::seconds m_websocketTimeoutWindow;
     bool m_useCoreDispatcherForEventRouting;
+    uint32_t m_maxConcurrentBatchRequests;
     bool m_disableAssertsForXboxLiveThrottlingInDevSandboxes;
     bool m_disableAssertsForMaxNumberOfWebsocketsActivated;
 };
@@ -14,6 +14,7 @@
 #include "xsapi/achievements.h"
 #include "xsapi/services.h"
 #include "xbox_live_context_impl.h"
+#include "achievements_reader.h"
 
 #if TV_API
 #pragma pack(push, 16)
@@ -318,6 +319,101 @@ achievement_service::get_achievements_for_title_id(
         );
 }
 
+pplx::task<xbox::services::xbox_live_result<void>>
+achievement_service::read_achievements_for_title_ids(
+    _In_ const string_t& xboxUserId,
+    _In_ const std::vector<uint32_t>& titleIds,
+    _In_ achievement_type type,
+    _In_ bool unlockedOnly,
+    _In_ achievement_order_by orderBy,
+    _In_ uint32_t maxItemsPerPage,
+    _In_ uint32_t maxConcurrentTitles,
+    _In_ std::function<void(uint32_t titleId, const achievements_result& page)> pageHandler
+    )
+{
+    RETURN_TASK_CPP_INVALIDARGUMENT_IF(xboxUserId.empty(), void, "xbox user id is empty");
+    RETURN_TASK_CPP_INVALIDARGUMENT_IF(pageHandler == nullptr, void, "pageHandler is null");
+
+    return achievements_reader::run(
+        *this,
+        xboxUserId,
+        titleIds,
+        type,
+        unlockedOnly,
+        orderBy,
+        maxItemsPerPage,
+        maxConcurrentTitles,
+        std::move(pageHandler)
+        );
+}
+
+pplx::task<xbox::services::xbox_live_result<std::vector<achievement_summary>>>
+achievement_service::get_achievement_summaries_for_title_ids(
+    _In_ const string_t& xboxUserId,
+    _In_ const std::vector<uint32_t>& titleIds,
+    _In_ achievement_type type,
+    _In_ bool unlockedOnly,
+    _In_ achievement_order_by orderBy
+    )
+{
+    RETURN_TASK_CPP_INVALIDARGUMENT_IF(xboxUserId.empty(), std::vector<achievement_summary>, "xbox user id is empty");
+
+    // Page handler calls are serialized by the reader, so these don't need their own lock
+    auto summariesByTitle = std::make_shared<std::unordered_map<uint32_t, std::vector<achievement_summary>>>();
+    auto scidPool = std::make_shared<std::unordered_map<string_t, std::shared_ptr<const string_t>>>();
+
+    auto pageHandler = [summariesByTitle, scidPool](uint32_t titleId, const achievements_result& page)
+    {
+        auto& summaries = (*summariesByTitle)[titleId];
+        summaries.reserve(summaries.size() + page.items().size());
+        for (const auto& item : page.items())
+        {
+            auto& scid = (*scidPool)[item.service_configuration_id()];
+            if (scid == nullptr)
+            {
+                scid = std::make_shared<const string_t>(item.service_configuration_id());
+            }
+            summaries.push_back(achievement_summary(item, titleId, scid));
+        }
+    };
+
+    auto task = achievements_reader::run(
+        *this,
+        xboxUserId,
+        titleIds,
+        type,
+        unlockedOnly,
+        orderBy,
+        MAX_ACHIEVEMENTS_PER_SUMMARY_PAGE,
+        m_xboxLiveContextSettings->max_concurrent_batch_requests(),
+        pageHandler
+        )
+    .then([titleIds, summariesByTitle](xbox_live_result<void> result)
+    {
+        if (result.err())
+        {
+            return xbox_live_result<std::vector<achievement_summary>>(result.err(), result.err_message());
+        }
+
+        std::vector<achievement_summary> summaries;
+        for (uint32_t titleId : titleIds)
+        {
+            auto iter = summariesByTitle->find(titleId);
+            if (iter != summariesByTitle->end())
+            {
+                std::move(iter->second.begin(), iter->second.end(), std::back_inserter(summaries));
+                summariesByTitle->erase(iter);
+            }
+        }
+
+        return xbox_live_result<std::vector<achievement_summary>>(std::move(summaries));
+    });
+
+    return utils::create_exception_free_task<std::vector<achievement_summary>>(
+        task
+        );
+}
+
 pplx::task<xbox::services::xbox_live_result<achievement>>
 achievement_service::get_achievement(
     _In_ const string_t& xboxUserId,
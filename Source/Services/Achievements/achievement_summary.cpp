@@ -0,0 +1,72 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "xsapi/achievements.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_ACHIEVEMENTS_CPP_BEGIN
+
+achievement_summary::achievement_summary(
+    _In_ const achievement& achievementItem,
+    _In_ uint32_t titleId,
+    _In_ std::shared_ptr<const string_t> serviceConfigurationId
+    ) :
+    m_id(achievementItem.id()),
+    m_serviceConfigurationId(std::move(serviceConfigurationId)),
+    m_name(achievementItem.name()),
+    m_timeUnlocked(achievementItem.progression().time_unlocked()),
+    m_titleId(titleId),
+    m_progressState(achievementItem.progress_state()),
+    m_isSecret(achievementItem.is_secret())
+{
+}
+
+const string_t&
+achievement_summary::id() const
+{
+    return m_id;
+}
+
+const string_t&
+achievement_summary::service_configuration_id() const
+{
+    return *m_serviceConfigurationId;
+}
+
+uint32_t
+achievement_summary::title_id() const
+{
+    return m_titleId;
+}
+
+const string_t&
+achievement_summary::name() const
+{
+    return m_name;
+}
+
+achievement_progress_state
+achievement_summary::progress_state() const
+{
+    return m_progressState;
+}
+
+const utility::datetime&
+achievement_summary::time_unlocked() const
+{
+    return m_timeUnlocked;
+}
+
+bool
+achievement_summary::is_secret() const
+{
+    return m_isSecret;
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_ACHIEVEMENTS_CPP_END
@@ -0,0 +1,193 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "achievements_reader.h"
+#include "utils.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_ACHIEVEMENTS_CPP_BEGIN
+
+pplx::task<xbox_live_result<void>>
+achievements_reader::run(
+    _In_ achievement_service service,
+    _In_ const string_t& xboxUserId,
+    _In_ const std::vector<uint32_t>& titleIds,
+    _In_ achievement_type type,
+    _In_ bool unlockedOnly,
+    _In_ achievement_order_by orderBy,
+    _In_ uint32_t maxItemsPerPage,
+    _In_ uint32_t maxConcurrentTitles,
+    _In_ page_handler pageHandler
+    )
+{
+    if (titleIds.empty())
+    {
+        return pplx::task_from_result(xbox_live_result<void>());
+    }
+
+    auto state = std::make_shared<reader_state>();
+    state->service = std::move(service);
+    state->xboxUserId = xboxUserId;
+    state->titleIds = titleIds;
+    state->type = type;
+    state->unlockedOnly = unlockedOnly;
+    state->orderBy = orderBy;
+    state->maxItemsPerPage = maxItemsPerPage;
+    state->pageHandler = std::move(pageHandler);
+
+    size_t lanes = __max(static_cast<size_t>(maxConcurrentTitles), static_cast<size_t>(1));
+    lanes = __min(lanes, titleIds.size());
+    state->activeLanes = lanes;
+    for (size_t i = 0; i < lanes; ++i)
+    {
+        start_next_title(state);
+    }
+
+    return pplx::create_task(state->tce);
+}
+
+void achievements_reader::start_next_title(_In_ std::shared_ptr<reader_state> state)
+{
+    uint32_t titleId;
+    {
+        std::lock_guard<std::mutex> lock(state->lock);
+        titleId = state->titleIds[state->nextTitle++];
+    }
+
+    state->service.get_achievements_for_title_id(
+        state->xboxUserId,
+        titleId,
+        state->type,
+        state->unlockedOnly,
+        state->orderBy,
+        0,
+        state->maxItemsPerPage
+        ).then([state, titleId](pplx::task<xbox_live_result<achievements_result>> t)
+    {
+        on_page_received(state, titleId, pplx::task_from_result(), t);
+    });
+}
+
+void achievements_reader::on_page_received(
+    _In_ std::shared_ptr<reader_state> state,
+    _In_ uint32_t titleId,
+    _In_ pplx::task<void> previousDelivery,
+    _In_ pplx::task<xbox_live_result<achievements_result>> pageTask
+    )
+{
+    xbox_live_result<achievements_result> page;
+    try
+    {
+        page = pageTask.get();
+    }
+    catch (const std::exception& e)
+    {
+        page = xbox_live_result<achievements_result>(utils::convert_exception_to_xbox_live_error_code(), e.what());
+    }
+
+    if (page.err())
+    {
+        set_error(state, page.err(), page.err_message());
+        previousDelivery.then([state]()
+        {
+            on_title_completed(state);
+        });
+        return;
+    }
+
+    // Hand the page to the caller only after the earlier pages of this title
+    auto delivery = previousDelivery.then([state, titleId, page]()
+    {
+        std::lock_guard<std::mutex> lock(state->handlerLock);
+        {
+            std::lock_guard<std::mutex> stateLock(state->lock);
+            if (state->hasError)
+            {
+                return;
+            }
+        }
+
+        try
+        {
+            state->pageHandler(titleId, page.payload());
+        }
+        catch (const std::exception& e)
+        {
+            set_error(state, xbox_live_error_code::runtime_error, e.what());
+        }
+    });
+
+    bool hasNext;
+    {
+        std::lock_guard<std::mutex> lock(state->lock);
+        hasNext = !state->hasError && page.payload().has_next();
+    }
+
+    if (hasNext)
+    {
+        // Request the next page while the caller processes this one
+        page.payload().get_next(state->maxItemsPerPage)
+        .then([state, titleId, delivery](pplx::task<xbox_live_result<achievements_result>> t)
+        {
+            on_page_received(state, titleId, delivery, t);
+        });
+    }
+    else
+    {
+        delivery.then([state]()
+        {
+            on_title_completed(state);
+        });
+    }
+}
+
+void achievements_reader::on_title_completed(_In_ const std::shared_ptr<reader_state>& state)
+{
+    bool startNextTitle = false;
+    bool isComplete = false;
+    xbox_live_result<void> result;
+    {
+        std::lock_guard<std::mutex> lock(state->lock);
+        if (!state->hasError && state->nextTitle < state->titleIds.size())
+        {
+            startNextTitle = true;
+        }
+        else
+        {
+            --state->activeLanes;
+            isComplete = state->activeLanes == 0;
+            result = state->errorResult;
+        }
+    }
+
+    if (startNextTitle)
+    {
+        start_next_title(state);
+    }
+    else if (isComplete)
+    {
+        state->tce.set(result);
+    }
+}
+
+void achievements_reader::set_error(
+    _In_ const std::shared_ptr<reader_state>& state,
+    _In_ std::error_code errorCode,
+    _In_ const std::string& errorMessage
+    )
+{
+    std::lock_guard<std::mutex> lock(state->lock);
+    if (!state->hasError)
+    {
+        state->hasError = true;
+        state->errorResult = xbox_live_result<void>(errorCode, errorMessage);
+    }
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_ACHIEVEMENTS_CPP_END
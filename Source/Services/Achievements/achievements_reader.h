@@ -0,0 +1,92 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include "shared_macros.h"
+#include "xsapi/achievements.h"
+#include <functional>
+#include <mutex>
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_ACHIEVEMENTS_CPP_BEGIN
+
+/// <summary>
+/// Reads every page of a player's achievements for a set of titles.
+/// Up to maxConcurrentTitles titles are queried at once. Within a title the request for the next
+/// page is sent as soon as the previous page arrives, before the previous page is handed to the caller.
+/// Pages are delivered one at a time, in order within each title.
+/// </summary>
+class achievements_reader
+{
+public:
+    typedef std::function<void(uint32_t titleId, const achievements_result& page)> page_handler;
+
+    static pplx::task<xbox_live_result<void>> run(
+        _In_ achievement_service service,
+        _In_ const string_t& xboxUserId,
+        _In_ const std::vector<uint32_t>& titleIds,
+        _In_ achievement_type type,
+        _In_ bool unlockedOnly,
+        _In_ achievement_order_by orderBy,
+        _In_ uint32_t maxItemsPerPage,
+        _In_ uint32_t maxConcurrentTitles,
+        _In_ page_handler pageHandler
+        );
+
+private:
+    struct reader_state
+    {
+        reader_state() :
+            type(achievement_type::all),
+            unlockedOnly(false),
+            orderBy(achievement_order_by::default_order),
+            maxItemsPerPage(0),
+            nextTitle(0),
+            activeLanes(0),
+            hasError(false)
+        {
+        }
+
+        achievement_service service;
+        string_t xboxUserId;
+        std::vector<uint32_t> titleIds;
+        achievement_type type;
+        bool unlockedOnly;
+        achievement_order_by orderBy;
+        uint32_t maxItemsPerPage;
+        page_handler pageHandler;
+
+        size_t nextTitle;
+        size_t activeLanes;
+        bool hasError;
+        xbox_live_result<void> errorResult;
+        pplx::task_completion_event<xbox_live_result<void>> tce;
+        std::mutex lock;
+        std::mutex handlerLock;
+    };
+
+    static void start_next_title(_In_ std::shared_ptr<reader_state> state);
+
+    static void on_page_received(
+        _In_ std::shared_ptr<reader_state> state,
+        _In_ uint32_t titleId,
+        _In_ pplx::task<void> previousDelivery,
+        _In_ pplx::task<xbox_live_result<achievements_result>> pageTask
+        );
+
+    static void on_title_completed(_In_ const std::shared_ptr<reader_state>& state);
+
+    static void set_error(
+        _In_ const std::shared_ptr<reader_state>& state,
+        _In_ std::error_code errorCode,
+        _In_ const std::string& errorMessage
+        );
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_ACHIEVEMENTS_CPP_END
@@ -30,7 +30,8 @@ xbox_live_context_impl::xbox_live_context_impl(
     _In_ Windows::Xbox::System::User^ user
     ) :
     m_signInContext(0),
-    m_signOutContext(0)
+    m_signOutContext(0),
+    m_isRealTimeActivityServiceCreated(false)
 {
     m_userContext = std::make_shared<XBOX_LIVE_NAMESPACE::user_context>(user);
 }
@@ -47,7 +48,8 @@ xbox_live_context_impl::xbox_live_context_impl(
     _In_ std::shared_ptr<system::xbox_live_user> user
     ) :
     m_signInContext(0),
-    m_signOutContext(0)
+    m_signOutContext(0),
+    m_isRealTimeActivityServiceCreated(false)
 {
     user->_User_impl()->set_user_pointer(user);
     m_userContext = std::make_shared<XBOX_LIVE_NAMESPACE::user_context>(user);
@@ -65,7 +67,8 @@ xbox_live_context_impl::xbox_live_context_impl(
     _In_ Microsoft::Xbox::Services::System::XboxLiveUser^ user
     ) :
     m_signInContext(0),
-    m_signOutContext(0)
+    m_signOutContext(0),
+    m_isRealTimeActivityServiceCreated(false)
 {
     m_userContext = std::make_shared<XBOX_LIVE_NAMESPACE::user_context>(user);
 }
@@ -104,20 +107,25 @@ xbox_live_context_impl::~xbox_live_context_impl()
     }
 
 #if !BEAM_API
-    real_time_activity::real_time_activity_service_factory::get_singleton_instance()->remove_user_from_rta_map(m_userContext);
+    // Only instances handed out by the factory are counted in its map
+    if (m_isRealTimeActivityServiceCreated && m_userContext->caller_context_type() != caller_context_type::title)
+    {
+        real_time_activity::real_time_activity_service_factory::get_singleton_instance()->remove_user_from_rta_map(m_userContext);
+    }
 #endif
 }
 
 
+#if TV_API || UWP_API
+static std::once_flag s_readLocalConfigOnce;
+#endif
+
 void xbox_live_context_impl::init()
 {
-    xbox_live_result<void> servicesConfigFileReadResult;
+    auto startTime = std::chrono::high_resolution_clock::now();
 
     m_appConfig = xbox_live_app_config::get_app_config_singleton();
-m_xboxLiveContextSettings = std::make_shared<XBOX_LIVE_NAMESPACE::xbox_live_context_settings>();
-#if !BEAM_API
-    init_real_time_activity_service_instance();
-#endif
+    m_xboxLiveContextSettings = std::make_shared<XBOX_LIVE_NAMESPACE::xbox_live_context_settings>();
 
 #if TV_API || UWP_API
     auto dispatcher = xbox_live_context_settings::_s_dispatcher;
@@ -150,46 +158,18 @@ m_xboxLiveContextSettings = std::make_shared<XBOX_LIVE_NAMESPACE::xbox_live_cont
         }
     }
 
-    XBOX_LIVE_NAMESPACE::service_call_logging_config::get_singleton_instance()->_ReadLocalConfig();
+    // The local config is process wide, so only the first context needs to read it
+    std::call_once(s_readLocalConfigOnce, []()
+    {
+        XBOX_LIVE_NAMESPACE::service_call_logging_config::get_singleton_instance()->_ReadLocalConfig();
+    });
 #endif
 
+#if !XSAPI_SERVER && !TV_API && !UNIT_TEST_SERVICES && !XBOX_UWP && !BEAM_API
     std::weak_ptr<xbox_live_context_impl> thisWeakPtr = shared_from_this();
 
-#if !BEAM_API
-    m_profileService = XBOX_LIVE_NAMESPACE::social::profile_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
-    m_reputationService = XBOX_LIVE_NAMESPACE::social::reputation_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
-    m_leaderboardService = XBOX_LIVE_NAMESPACE::leaderboard::leaderboard_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
-    m_achievementService = XBOX_LIVE_NAMESPACE::achievements::achievement_service(m_userContext, m_xboxLiveContextSettings, m_appConfig, thisWeakPtr);
-    m_matchmakingService = XBOX_LIVE_NAMESPACE::matchmaking::matchmaking_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
-    m_gameServerPlatformService = XBOX_LIVE_NAMESPACE::game_server_platform::game_server_platform_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
-    m_titleStorageService = XBOX_LIVE_NAMESPACE::title_storage::title_storage_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
-    m_privacyService = XBOX_LIVE_NAMESPACE::privacy::privacy_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
-    m_presenceService = XBOX_LIVE_NAMESPACE::presence::presence_service(m_userContext, m_xboxLiveContextSettings, m_appConfig, m_realTimeActivityService);
-    m_userStatisticsService = XBOX_LIVE_NAMESPACE::user_statistics::user_statistics_service(m_userContext, m_xboxLiveContextSettings, m_appConfig, m_realTimeActivityService);
-    m_multiplayerService = XBOX_LIVE_NAMESPACE::multiplayer::multiplayer_service(m_userContext, m_xboxLiveContextSettings, m_appConfig, m_realTimeActivityService);
-    m_socialService = XBOX_LIVE_NAMESPACE::social::social_service(m_userContext, m_xboxLiveContextSettings, m_appConfig, m_realTimeActivityService);
-    m_contextualSearchService = XBOX_LIVE_NAMESPACE::contextual_search::contextual_search_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
-#endif
-    m_stringService = XBOX_LIVE_NAMESPACE::system::string_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
-
-#if !XSAPI_SERVER
-
-#if UWP_API || XSAPI_U
-    m_eventsService = events::events_service(m_userContext, m_appConfig);
-#endif 
-
-#if TV_API || UNIT_TEST_SERVICES
-    // These services are only on XDK
-    m_catalogService = marketplace::catalog_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
-    m_inventoryService = marketplace::inventory_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
-    m_entertainmentProfileService = entertainment_profile::entertainment_profile_list_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
-#else
-
-#if !XBOX_UWP
-
-#if !BEAM_API
     // Only start the presence writer on UAP
-    presence::presence_writer::get_presence_writer_singleton()->start_writer(m_presenceService._Impl());
+    presence::presence_writer::get_presence_writer_singleton()->start_writer(presence_service()._Impl());
 
     auto notificationService = notification::notification_service::get_notification_service_singleton();
     notificationService->subscribe_to_notifications(
@@ -207,7 +187,7 @@ m_xboxLiveContextSettings = std::make_shared<XBOX_LIVE_NAMESPACE::xbox_live_cont
             std::shared_ptr<xbox_live_context_impl> pThis(thisWeakPtr.lock());
             if (pThis != nullptr && utils::str_icmp(pThis->xbox_live_user_id(), xboxUserId) == 0)
             {
-                presence::presence_writer::get_presence_writer_singleton()->start_writer(pThis->m_presenceService._Impl());
+                presence::presence_writer::get_presence_writer_singleton()->start_writer(pThis->presence_service()._Impl());
             }
         });
 
@@ -217,7 +197,10 @@ m_xboxLiveContextSettings = std::make_shared<XBOX_LIVE_NAMESPACE::xbox_live_cont
             std::shared_ptr<xbox_live_context_impl> pThis(thisWeakPtr.lock());
             if (pThis != nullptr)
             {
-                pThis->real_time_activity_service()->_Close_websocket();
+                if (pThis->m_isRealTimeActivityServiceCreated)
+                {
+                    pThis->real_time_activity_service()->_Close_websocket();
+                }
                 presence::presence_writer::get_presence_writer_singleton()->stop_writer(pThis->xbox_live_user_id());
             }
         });
@@ -229,7 +212,7 @@ m_xboxLiveContextSettings = std::make_shared<XBOX_LIVE_NAMESPACE::xbox_live_cont
             std::shared_ptr<xbox_live_context_impl> pThis(thisWeakPtr.lock());
             if (pThis != nullptr && utils::str_icmp(pThis->xbox_live_user_id(), xboxUserId) == 0)
             {
-                presence::presence_writer::get_presence_writer_singleton()->start_writer(pThis->m_presenceService._Impl());
+                presence::presence_writer::get_presence_writer_singleton()->start_writer(pThis->presence_service()._Impl());
             }
         });
 
@@ -240,16 +223,22 @@ m_xboxLiveContextSettings = std::make_shared<XBOX_LIVE_NAMESPACE::xbox_live_cont
             std::shared_ptr<xbox_live_context_impl> pThis(thisWeakPtr.lock());
             if (pThis != nullptr)
             {
-                pThis->real_time_activity_service()->_Close_websocket();
+                if (pThis->m_isRealTimeActivityServiceCreated)
+                {
+                    pThis->real_time_activity_service()->_Close_websocket();
+                }
                 presence::presence_writer::get_presence_writer_singleton()->stop_writer(pThis->xbox_live_user_id());
             }
         });
 #endif
     }
-#endif //!BEAM_API
-#endif
-#endif
 #endif
+
+    xbox_live_context_startup_profiler::get_singleton_instance()->record(
+        xbox_live_context_component::context,
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - startTime),
+        sizeof(xbox_live_context_impl)
+        );
 }
 
 std::shared_ptr<user_context> xbox_live_context_impl::user_context()
@@ -266,54 +255,79 @@ const string_t& xbox_live_context_impl::xbox_live_user_id()
 social::profile_service&
 xbox_live_context_impl::profile_service()
 {
-    return m_profileService;
+    return create_on_first_use(m_profileServiceOnce, m_profileService, xbox_live_context_component::profile, [this]()
+    {
+        return XBOX_LIVE_NAMESPACE::social::profile_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
+    });
 }
 
 social::social_service&
 xbox_live_context_impl::social_service()
 {
-    return m_socialService;
+    return create_on_first_use(m_socialServiceOnce, m_socialService, xbox_live_context_component::social, [this]()
+    {
+        return XBOX_LIVE_NAMESPACE::social::social_service(m_userContext, m_xboxLiveContextSettings, m_appConfig, real_time_activity_service());
+    });
 }
 
 social::reputation_service&
 xbox_live_context_impl::reputation_service()
 {
-    return m_reputationService;
+    return create_on_first_use(m_reputationServiceOnce, m_reputationService, xbox_live_context_component::reputation, [this]()
+    {
+        return XBOX_LIVE_NAMESPACE::social::reputation_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
+    });
 }
 
 leaderboard::leaderboard_service&
 xbox_live_context_impl::leaderboard_service()
 {
-    return m_leaderboardService;
+    return create_on_first_use(m_leaderboardServiceOnce, m_leaderboardService, xbox_live_context_component::leaderboard, [this]()
+    {
+        return XBOX_LIVE_NAMESPACE::leaderboard::leaderboard_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
+    });
 }
 
 achievements::achievement_service&
 xbox_live_context_impl::achievement_service()
 {
-    return m_achievementService;
+    return create_on_first_use(m_achievementServiceOnce, m_achievementService, xbox_live_context_component::achievements, [this]()
+    {
+        return XBOX_LIVE_NAMESPACE::achievements::achievement_service(m_userContext, m_xboxLiveContextSettings, m_appConfig, std::weak_ptr<xbox_live_context_impl>(shared_from_this()));
+    });
 }
 
 multiplayer::multiplayer_service&
 xbox_live_context_impl::multiplayer_service()
 {
-    return m_multiplayerService;
+    return create_on_first_use(m_multiplayerServiceOnce, m_multiplayerService, xbox_live_context_component::multiplayer, [this]()
+    {
+        return XBOX_LIVE_NAMESPACE::multiplayer::multiplayer_service(m_userContext, m_xboxLiveContextSettings, m_appConfig, real_time_activity_service());
+    });
 }
 
 matchmaking::matchmaking_service&
 xbox_live_context_impl::matchmaking_service()
 {
-    return m_matchmakingService;
+    return create_on_first_use(m_matchmakingServiceOnce, m_matchmakingService, xbox_live_context_component::matchmaking, [this]()
+    {
+        return XBOX_LIVE_NAMESPACE::matchmaking::matchmaking_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
+    });
 }
 
 user_statistics::user_statistics_service&
 xbox_live_context_impl::user_statistics_service()
 {
-    return m_userStatisticsService;
+    return create_on_first_use(m_userStatisticsServiceOnce, m_userStatisticsService, xbox_live_context_component::user_statistics, [this]()
+    {
+        return XBOX_LIVE_NAMESPACE::user_statistics::user_statistics_service(m_userContext, m_xboxLiveContextSettings, m_appConfig, real_time_activity_service());
+    });
 }
 
 void
 xbox_live_context_impl::init_real_time_activity_service_instance()
 {
+    auto startTime = std::chrono::high_resolution_clock::now();
     if (m_userContext->caller_context_type() == caller_context_type::title)
     {
         m_realTimeActivityService = std::shared_ptr<XBOX_LIVE_NAMESPACE::real_time_activity::real_time_activity_service>(new XBOX_LIVE_NAMESPACE::real_time_activity::real_time_activity_service(m_userContext, m_xboxLiveContextSettings, m_appConfig));
@@ -322,56 +336,89 @@ xbox_live_context_impl::init_real_time_activity_service_instance()
     {
         m_realTimeActivityService = real_time_activity::real_time_activity_service_factory::get_singleton_instance()->get_rta_instance(m_userContext, m_xboxLiveContextSettings, m_appConfig);
     }
+
+    m_isRealTimeActivityServiceCreated = true;
+    xbox_live_context_startup_profiler::get_singleton_instance()->record(
+        xbox_live_context_component::real_time_activity,
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - startTime),
+        sizeof(m_realTimeActivityService)
+        );
 }
 
 const std::shared_ptr<real_time_activity::real_time_activity_service>&
 xbox_live_context_impl::real_time_activity_service()
 {
+    std::call_once(m_realTimeActivityServiceOnce, [this]()
+    {
+        init_real_time_activity_service_instance();
+    });
+
     return m_realTimeActivityService;
 }
 
 presence::presence_service&
 xbox_live_context_impl::presence_service()
 {
-    return m_presenceService;
+    return create_on_first_use(m_presenceServiceOnce, m_presenceService, xbox_live_context_component::presence, [this]()
+    {
+        return XBOX_LIVE_NAMESPACE::presence::presence_service(m_userContext, m_xboxLiveContextSettings, m_appConfig, real_time_activity_service());
+    });
 }
 
 game_server_platform::game_server_platform_service&
 xbox_live_context_impl::game_server_platform_service()
 {
-    return m_gameServerPlatformService;
+    return create_on_first_use(m_gameServerPlatformServiceOnce, m_gameServerPlatformService, xbox_live_context_component::game_server_platform, [this]()
+    {
+        return XBOX_LIVE_NAMESPACE::game_server_platform::game_server_platform_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
+    });
 }
 
 title_storage::title_storage_service&
 xbox_live_context_impl::title_storage_service()
 {
-    return m_titleStorageService;
+    return create_on_first_use(m_titleStorageServiceOnce, m_titleStorageService, xbox_live_context_component::title_storage, [this]()
+    {
+        return XBOX_LIVE_NAMESPACE::title_storage::title_storage_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
+    });
 }
 
 privacy::privacy_service&
 xbox_live_context_impl::privacy_service()
 {
-    return m_privacyService;
+    return create_on_first_use(m_privacyServiceOnce, m_privacyService, xbox_live_context_component::privacy, [this]()
+    {
+        return XBOX_LIVE_NAMESPACE::privacy::privacy_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
+    });
 }
 
 contextual_search::contextual_search_service&
 xbox_live_context_impl::contextual_search_service()
 {
-    return m_contextualSearchService;
+    return create_on_first_use(m_contextualSearchServiceOnce, m_contextualSearchService, xbox_live_context_component::contextual_search, [this]()
+    {
+        return XBOX_LIVE_NAMESPACE::contextual_search::contextual_search_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
+    });
 }
 #endif
 
 system::string_service&
 xbox_live_context_impl::string_service()
 {
-	return m_stringService;
+    return create_on_first_use(m_stringServiceOnce, m_stringService, xbox_live_context_component::string, [this]()
+    {
+        return XBOX_LIVE_NAMESPACE::system::string_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
+    });
 }
 
 #if UWP_API || XSAPI_U
 events::events_service&
 xbox_live_context_impl::events_service()
 {
-    return m_eventsService;
+    return create_on_first_use(m_eventsServiceOnce, m_eventsService, xbox_live_context_component::events, [this]()
+    {
+        return events::events_service(m_userContext, m_appConfig);
+    });
 }
 #endif
 
@@ -379,18 +426,27 @@ xbox_live_context_impl::events_service()
 marketplace::catalog_service&
 xbox_live_context_impl::catalog_service()
 {
-    return m_catalogService;
+    return create_on_first_use(m_catalogServiceOnce, m_catalogService, xbox_live_context_component::catalog, [this]()
+    {
+        return marketplace::catalog_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
+    });
 }
 
 marketplace::inventory_service&
     xbox_live_context_impl::inventory_service()
 {
-    return m_inventoryService;
+    return create_on_first_use(m_inventoryServiceOnce, m_inventoryService, xbox_live_context_component::inventory, [this]()
+    {
+        return marketplace::inventory_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
+    });
 }
 entertainment_profile::entertainment_profile_list_service&
 xbox_live_context_impl::entertainment_profile_list_service()
 {
-    return m_entertainmentProfileService;
+    return create_on_first_use(m_entertainmentProfileServiceOnce, m_entertainmentProfileService, xbox_live_context_component::entertainment_profile, [this]()
+    {
+        return entertainment_profile::entertainment_profile_list_service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
+    });
 }
 #endif
 
@@ -9,6 +9,8 @@
 //*********************************************************
 #pragma once
 #include <mutex>
+#include <atomic>
+#include "xbox_live_context_startup_profiler.h"
 #if !TV_API
 
 #if !XSAPI_CPP
@@ -21,6 +23,11 @@
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 
+/// <summary>
+/// Services are created the first time they are accessed rather than in init(), since most contexts
+/// only ever use a few of them. The real-time activity service is created the first time it or a service
+/// that depends on it is accessed.
+/// </summary>
 class xbox_live_context_impl : public std::enable_shared_from_this < xbox_live_context_impl >
 {
 public:
@@ -186,6 +193,28 @@ public:
 #endif
 
 private:
+    template<typename T, typename Factory>
+    T& create_on_first_use(
+        _In_ std::once_flag& onceFlag,
+        _In_ T& service,
+        _In_ xbox_live_context_component component,
+        _In_ Factory factory
+        )
+    {
+        std::call_once(onceFlag, [&]()
+        {
+            auto startTime = std::chrono::high_resolution_clock::now();
+            service = factory();
+            xbox_live_context_startup_profiler::get_singleton_instance()->record(
+                component,
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - startTime),
+                sizeof(T)
+                );
+        });
+
+        return service;
+    }
+
     std::shared_ptr<XBOX_LIVE_NAMESPACE::user_context> m_userContext;
     std::shared_ptr<XBOX_LIVE_NAMESPACE::xbox_live_context_settings> m_xboxLiveContextSettings;
     std::shared_ptr<xbox_live_app_config> m_appConfig;
@@ -217,6 +246,27 @@ private:
     entertainment_profile::entertainment_profile_list_service m_entertainmentProfileService;
 #endif
 
+    std::atomic<bool> m_isRealTimeActivityServiceCreated;
+    std::once_flag m_profileServiceOnce;
+    std::once_flag m_socialServiceOnce;
+    std::once_flag m_reputationServiceOnce;
+    std::once_flag m_leaderboardServiceOnce;
+    std::once_flag m_achievementServiceOnce;
+    std::once_flag m_userStatisticsServiceOnce;
+    std::once_flag m_multiplayerServiceOnce;
+    std::once_flag m_matchmakingServiceOnce;
+    std::once_flag m_realTimeActivityServiceOnce;
+    std::once_flag m_presenceServiceOnce;
+    std::once_flag m_gameServerPlatformServiceOnce;
+    std::once_flag m_titleStorageServiceOnce;
+    std::once_flag m_privacyServiceOnce;
+    std::once_flag m_contextualSearchServiceOnce;
+    std::once_flag m_stringServiceOnce;
+    std::once_flag m_eventsServiceOnce;
+    std::once_flag m_catalogServiceOnce;
+    std::once_flag m_inventoryServiceOnce;
+    std::once_flag m_entertainmentProfileServiceOnce;
+
     function_context m_signInContext;
     function_context m_signOutContext;
 
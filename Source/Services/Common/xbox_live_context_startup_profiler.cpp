@@ -0,0 +1,128 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "xbox_live_context_startup_profiler.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+static const utility::char_t* const s_componentNames[] =
+{
+    _T("context"),
+    _T("profile"),
+    _T("social"),
+    _T("reputation"),
+    _T("leaderboard"),
+    _T("achievements"),
+    _T("user_statistics"),
+    _T("multiplayer"),
+    _T("matchmaking"),
+    _T("real_time_activity"),
+    _T("presence"),
+    _T("game_server_platform"),
+    _T("title_storage"),
+    _T("privacy"),
+    _T("contextual_search"),
+    _T("string"),
+    _T("events"),
+    _T("catalog"),
+    _T("inventory"),
+    _T("entertainment_profile")
+};
+
+static_assert(sizeof(s_componentNames) / sizeof(s_componentNames[0]) == XBOX_LIVE_CONTEXT_COMPONENT_COUNT, "Every component needs a name");
+
+static std::mutex g_startupProfilerSingletonLock;
+static std::shared_ptr<xbox_live_context_startup_profiler> g_startupProfilerSingleton;
+
+std::shared_ptr<xbox_live_context_startup_profiler>
+xbox_live_context_startup_profiler::get_singleton_instance()
+{
+    std::lock_guard<std::mutex> guard(g_startupProfilerSingletonLock);
+    if (g_startupProfilerSingleton == nullptr)
+    {
+        g_startupProfilerSingleton = std::make_shared<xbox_live_context_startup_profiler>();
+    }
+
+    return g_startupProfilerSingleton;
+}
+
+xbox_live_context_startup_profiler::xbox_live_context_startup_profiler()
+{
+    reset();
+}
+
+void
+xbox_live_context_startup_profiler::record(
+    _In_ xbox_live_context_component component,
+    _In_ std::chrono::microseconds elapsed,
+    _In_ uint64_t bytes
+    )
+{
+    component_counters& counters = m_counters[static_cast<size_t>(component)];
+    uint64_t elapsedMicroseconds = static_cast<uint64_t>(__max(elapsed.count(), static_cast<int64_t>(0)));
+
+    counters.constructionCount.fetch_add(1, std::memory_order_relaxed);
+    counters.totalMicroseconds.fetch_add(elapsedMicroseconds, std::memory_order_relaxed);
+    counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+
+    uint64_t currentMax = counters.maxMicroseconds.load(std::memory_order_relaxed);
+    while (elapsedMicroseconds > currentMax &&
+        !counters.maxMicroseconds.compare_exchange_weak(currentMax, elapsedMicroseconds, std::memory_order_relaxed))
+    {
+    }
+}
+
+std::vector<xbox_live_context_component_stats>
+xbox_live_context_startup_profiler::snapshot() const
+{
+    std::vector<xbox_live_context_component_stats> result;
+    for (size_t i = 0; i < XBOX_LIVE_CONTEXT_COMPONENT_COUNT; ++i)
+    {
+        const component_counters& counters = m_counters[i];
+        uint64_t constructionCount = counters.constructionCount.load(std::memory_order_relaxed);
+        if (constructionCount == 0)
+        {
+            continue;
+        }
+
+        xbox_live_context_component_stats stats;
+        stats.component = static_cast<xbox_live_context_component>(i);
+        stats.constructionCount = constructionCount;
+        stats.totalTime = std::chrono::microseconds(counters.totalMicroseconds.load(std::memory_order_relaxed));
+        stats.maxTime = std::chrono::microseconds(counters.maxMicroseconds.load(std::memory_order_relaxed));
+        stats.bytes = counters.bytes.load(std::memory_order_relaxed);
+        result.push_back(stats);
+    }
+
+    return result;
+}
+
+void
+xbox_live_context_startup_profiler::reset()
+{
+    for (auto& counters : m_counters)
+    {
+        counters.constructionCount.store(0, std::memory_order_relaxed);
+        counters.totalMicroseconds.store(0, std::memory_order_relaxed);
+        counters.maxMicroseconds.store(0, std::memory_order_relaxed);
+        counters.bytes.store(0, std::memory_order_relaxed);
+    }
+}
+
+string_t
+xbox_live_context_startup_profiler::component_name(
+    _In_ xbox_live_context_component component
+    )
+{
+    size_t index = static_cast<size_t>(component);
+    return index < XBOX_LIVE_CONTEXT_COMPONENT_COUNT ? s_componentNames[index] : _T("unknown");
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -0,0 +1,111 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+#include <atomic>
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+enum class xbox_live_context_component
+{
+    /// <summary>
+    /// xbox_live_context_impl::init itself, excluding any services
+    /// </summary>
+    context,
+    profile,
+    social,
+    reputation,
+    leaderboard,
+    achievements,
+    user_statistics,
+    multiplayer,
+    matchmaking,
+    real_time_activity,
+    presence,
+    game_server_platform,
+    title_storage,
+    privacy,
+    contextual_search,
+    string,
+    events,
+    catalog,
+    inventory,
+    entertainment_profile
+};
+
+const size_t XBOX_LIVE_CONTEXT_COMPONENT_COUNT = static_cast<size_t>(xbox_live_context_component::entertainment_profile) + 1;
+
+struct xbox_live_context_component_stats
+{
+    xbox_live_context_component_stats() :
+        component(xbox_live_context_component::context),
+        constructionCount(0),
+        totalTime(std::chrono::microseconds::zero()),
+        maxTime(std::chrono::microseconds::zero()),
+        bytes(0)
+    {
+    }
+
+    xbox_live_context_component component;
+
+    /// <summary>
+    /// How many times the component was set up, across all contexts
+    /// </summary>
+    uint64_t constructionCount;
+    std::chrono::microseconds totalTime;
+    std::chrono::microseconds maxTime;
+
+    /// <summary>
+    /// Size of the objects the contexts hold for the component. Heap allocations made by
+    /// the component's implementation are not included.
+    /// </summary>
+    uint64_t bytes;
+};
+
+/// <summary>
+/// Attributes the cost of creating xbox_live_contexts to the context itself and to each service
+/// it sets up. Services are created the first time they are used, so a context that is created and
+/// never used should only show up under xbox_live_context_component::context.
+/// A service's time includes creating the real-time activity service when it is the first to need it.
+/// </summary>
+class xbox_live_context_startup_profiler
+{
+public:
+    xbox_live_context_startup_profiler();
+
+    static std::shared_ptr<xbox_live_context_startup_profiler> get_singleton_instance();
+
+    void record(
+        _In_ xbox_live_context_component component,
+        _In_ std::chrono::microseconds elapsed,
+        _In_ uint64_t bytes
+        );
+
+    /// <summary>
+    /// Returns the stats of every component that has been set up since the last reset
+    /// </summary>
+    std::vector<xbox_live_context_component_stats> snapshot() const;
+
+    void reset();
+
+    static string_t component_name(_In_ xbox_live_context_component component);
+
+private:
+    struct component_counters
+    {
+        std::atomic<uint64_t> constructionCount;
+        std::atomic<uint64_t> totalMicroseconds;
+        std::atomic<uint64_t> maxMicroseconds;
+        std::atomic<uint64_t> bytes;
+    };
+
+    component_counters m_counters[XBOX_LIVE_CONTEXT_COMPONENT_COUNT];
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
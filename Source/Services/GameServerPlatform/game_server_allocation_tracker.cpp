@@ -0,0 +1,413 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "game_server_allocation_tracker.h"
+#include "utils.h"
+#if !XSAPI_U
+#include "ppltasks_extra.h"
+#else
+#include "ppltasks_extra_unix.h"
+#endif
+
+using namespace Concurrency::extras;
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_GAMESERVERPLATFORM_CPP_BEGIN
+
+const std::chrono::milliseconds game_server_allocation_tracker::INITIAL_POLL_INTERVAL = std::chrono::milliseconds(1000);
+const std::chrono::milliseconds game_server_allocation_tracker::NEAR_POLL_INTERVAL = std::chrono::milliseconds(500);
+const std::chrono::milliseconds game_server_allocation_tracker::MAX_POLL_INTERVAL = std::chrono::milliseconds(10000);
+const std::chrono::milliseconds game_server_allocation_tracker::TYPICAL_ALLOCATION_TIME = std::chrono::milliseconds(15000);
+const std::chrono::milliseconds game_server_allocation_tracker::MAX_TRACKING_TIME = std::chrono::minutes(5);
+const size_t game_server_allocation_tracker::MAX_CONCURRENT_POLLS = 32;
+
+// Allocations due this close to a timer tick are polled on it rather than on a tick of their own
+static const std::chrono::milliseconds TIMER_SLACK = std::chrono::milliseconds(100);
+
+game_server_allocation_tracker::game_server_allocation_tracker(
+    _In_ std::chrono::milliseconds initialPollInterval,
+    _In_ std::chrono::milliseconds nearPollInterval,
+    _In_ std::chrono::milliseconds maxPollInterval,
+    _In_ std::chrono::milliseconds typicalAllocationTime,
+    _In_ std::chrono::milliseconds maxTrackingTime,
+    _In_ size_t maxConcurrentPolls,
+    _In_ std::function<pplx::task<xbox_live_result<game_server_ticket_status>>(uint32_t, const string_t&)> ticketStatusHandler,
+    _In_ std::function<pplx::task<xbox_live_result<allocation_result>>(uint32_t, const string_t&)> allocationStatusHandler
+    ) :
+    m_initialPollInterval(initialPollInterval),
+    m_nearPollInterval(nearPollInterval),
+    m_maxPollInterval(maxPollInterval),
+    m_maxTrackingTime(maxTrackingTime),
+    m_maxConcurrentPolls(__max(maxConcurrentPolls, static_cast<size_t>(1))),
+    m_ticketStatusHandler(std::move(ticketStatusHandler)),
+    m_allocationStatusHandler(std::move(allocationStatusHandler)),
+    m_typicalAllocationTime(typicalAllocationTime),
+    m_isTimerScheduled(false),
+    m_timerGeneration(0),
+    m_pollsInFlight(0),
+    m_pollsSent(0),
+    m_tracksCoalesced(0),
+    m_timerTicks(0)
+{
+    XSAPI_ASSERT(m_ticketStatusHandler != nullptr && m_allocationStatusHandler != nullptr);
+}
+
+game_server_allocation_tracker::~game_server_allocation_tracker()
+{
+    // Polls still in flight find no waiters left when they come back
+    for (auto& allocationPair : m_allocations)
+    {
+        auto& allocation = allocationPair.second;
+        for (auto& waiter : allocation->ticketWaiters)
+        {
+            waiter.set(xbox_live_result<game_server_ticket_status>(xbox_live_error_code::runtime_error, "game_server_platform_service was destroyed"));
+        }
+        for (auto& waiter : allocation->sessionHostWaiters)
+        {
+            waiter.set(xbox_live_result<allocation_result>(xbox_live_error_code::runtime_error, "game_server_platform_service was destroyed"));
+        }
+        allocation->ticketWaiters.clear();
+        allocation->sessionHostWaiters.clear();
+    }
+}
+
+std::chrono::milliseconds
+game_server_allocation_tracker::next_poll_delay(
+    _In_ std::chrono::milliseconds elapsed,
+    _In_ uint32_t pollCount,
+    _In_ std::chrono::milliseconds typicalAllocationTime,
+    _In_ std::chrono::milliseconds initialPollInterval,
+    _In_ std::chrono::milliseconds nearPollInterval,
+    _In_ std::chrono::milliseconds maxPollInterval
+    )
+{
+    auto nearStart = typicalAllocationTime * 3 / 4;
+    auto nearEnd = typicalAllocationTime * 5 / 4;
+
+    if (elapsed < nearStart)
+    {
+        // Double the interval each poll, but don't skip over the time the allocation is likely to finish
+        auto delay = __min(initialPollInterval * (static_cast<int64_t>(1) << __min(pollCount, static_cast<uint32_t>(16))), maxPollInterval);
+        if (elapsed + delay > nearStart)
+        {
+            delay = __max(nearStart - elapsed, nearPollInterval);
+        }
+        return delay;
+    }
+
+    if (elapsed < nearEnd)
+    {
+        return nearPollInterval;
+    }
+
+    // Running late, so back off in proportion to how late
+    return __min(__max((elapsed - nearEnd) / 2, nearPollInterval), maxPollInterval);
+}
+
+bool
+game_server_allocation_tracker::is_transient_error(
+    _In_ const std::error_code& errc
+    )
+{
+    return errc == xbox_live_error_condition::http_429_too_many_requests ||
+        errc == xbox_live_error_condition::http_service_timeout ||
+        errc == xbox_live_error_condition::network ||
+        errc == xbox_live_error_code::http_status_500_internal_server_error ||
+        errc == xbox_live_error_code::http_status_502_bad_gateway;
+}
+
+std::shared_ptr<game_server_allocation_tracker::tracked_allocation>
+game_server_allocation_tracker::get_or_add_allocation(
+    _In_ allocation_kind kind,
+    _In_ uint32_t gameServerTitleId,
+    _In_ const string_t& id
+    )
+{
+    stringstream_t key;
+    key << (kind == allocation_kind::ticket ? _T("ticket|") : _T("sessionhost|")) << gameServerTitleId << _T('|') << id;
+
+    auto& allocation = m_allocations[key.str()];
+    if (allocation != nullptr)
+    {
+        ++m_tracksCoalesced;
+        return allocation;
+    }
+
+    auto now = chrono_clock_t::now();
+    allocation = std::make_shared<tracked_allocation>();
+    allocation->kind = kind;
+    allocation->titleId = gameServerTitleId;
+    allocation->id = id;
+    allocation->key = key.str();
+    allocation->startTime = now;
+    allocation->nextPollTime = now + m_initialPollInterval;
+    allocation->pollCount = 0;
+    allocation->isPolling = false;
+    schedule_timer(now);
+    return allocation;
+}
+
+pplx::task<xbox_live_result<game_server_ticket_status>>
+game_server_allocation_tracker::track_ticket(
+    _In_ uint32_t gameServerTitleId,
+    _In_ const string_t& ticketId
+    )
+{
+    pplx::task_completion_event<xbox_live_result<game_server_ticket_status>> tce;
+    std::lock_guard<std::mutex> lock(m_lock);
+    get_or_add_allocation(allocation_kind::ticket, gameServerTitleId, ticketId)->ticketWaiters.push_back(tce);
+    return pplx::create_task(tce);
+}
+
+pplx::task<xbox_live_result<allocation_result>>
+game_server_allocation_tracker::track_session_host(
+    _In_ uint32_t gameServerTitleId,
+    _In_ const string_t& sessionId
+    )
+{
+    pplx::task_completion_event<xbox_live_result<allocation_result>> tce;
+    std::lock_guard<std::mutex> lock(m_lock);
+    get_or_add_allocation(allocation_kind::session_host, gameServerTitleId, sessionId)->sessionHostWaiters.push_back(tce);
+    return pplx::create_task(tce);
+}
+
+void
+game_server_allocation_tracker::schedule_timer(
+    _In_ const chrono_clock_t::time_point& now
+    )
+{
+    bool hasDueTime = false;
+    chrono_clock_t::time_point dueTime;
+    for (const auto& allocationPair : m_allocations)
+    {
+        const auto& allocation = allocationPair.second;
+        if (!allocation->isPolling && (!hasDueTime || allocation->nextPollTime < dueTime))
+        {
+            dueTime = allocation->nextPollTime;
+            hasDueTime = true;
+        }
+    }
+
+    if (!hasDueTime || (m_isTimerScheduled && m_timerDueTime <= dueTime))
+    {
+        return;
+    }
+
+    // Replaces any later timer; that one sees a stale generation when it fires and does nothing
+    m_isTimerScheduled = true;
+    m_timerDueTime = dueTime;
+    uint64_t timerGeneration = ++m_timerGeneration;
+    auto delay = dueTime > now ? std::chrono::duration_cast<std::chrono::milliseconds>(dueTime - now) : std::chrono::milliseconds(0);
+
+    std::weak_ptr<game_server_allocation_tracker> thisWeakPtr = shared_from_this();
+    create_delayed_task(
+        delay,
+        [thisWeakPtr, timerGeneration]()
+    {
+        std::shared_ptr<game_server_allocation_tracker> pThis(thisWeakPtr.lock());
+        if (pThis != nullptr)
+        {
+            pThis->on_timer(timerGeneration);
+        }
+    });
+}
+
+void
+game_server_allocation_tracker::on_timer(
+    _In_ uint64_t timerGeneration
+    )
+{
+    std::vector<std::shared_ptr<tracked_allocation>> dueAllocations;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (timerGeneration != m_timerGeneration)
+        {
+            return;
+        }
+
+        m_isTimerScheduled = false;
+        ++m_timerTicks;
+
+        auto now = chrono_clock_t::now();
+        for (auto& allocationPair : m_allocations)
+        {
+            auto& allocation = allocationPair.second;
+            if (allocation->isPolling || allocation->nextPollTime > now + TIMER_SLACK)
+            {
+                continue;
+            }
+
+            if (m_pollsInFlight < m_maxConcurrentPolls)
+            {
+                allocation->isPolling = true;
+                ++m_pollsInFlight;
+                ++m_pollsSent;
+                dueAllocations.push_back(allocation);
+            }
+            else
+            {
+                // Spread a burst out over the following ticks
+                allocation->nextPollTime = now + m_nearPollInterval;
+            }
+        }
+
+        schedule_timer(now);
+    }
+
+    for (const auto& allocation : dueAllocations)
+    {
+        poll(allocation);
+    }
+}
+
+void
+game_server_allocation_tracker::poll(
+    _In_ const std::shared_ptr<tracked_allocation>& allocation
+    )
+{
+    std::weak_ptr<game_server_allocation_tracker> thisWeakPtr = shared_from_this();
+    if (allocation->kind == allocation_kind::ticket)
+    {
+        m_ticketStatusHandler(allocation->titleId, allocation->id)
+        .then([thisWeakPtr, allocation](pplx::task<xbox_live_result<game_server_ticket_status>> statusTask)
+        {
+            xbox_live_result<game_server_ticket_status> result;
+            try
+            {
+                result = statusTask.get();
+            }
+            catch (const std::exception&)
+            {
+                result = xbox_live_result<game_server_ticket_status>(xbox_live_error_code::runtime_error, "get_ticket_status failed");
+            }
+
+            std::shared_ptr<game_server_allocation_tracker> pThis(thisWeakPtr.lock());
+            if (pThis != nullptr)
+            {
+                auto status = result.payload().status();
+                bool isPending = !result.err() && (status == game_server_host_status::queued || status == game_server_host_status::unknown);
+                pThis->complete_poll(allocation, result, isPending, &tracked_allocation::ticketWaiters);
+            }
+        });
+    }
+    else
+    {
+        m_allocationStatusHandler(allocation->titleId, allocation->id)
+        .then([thisWeakPtr, allocation](pplx::task<xbox_live_result<allocation_result>> statusTask)
+        {
+            xbox_live_result<allocation_result> result;
+            try
+            {
+                result = statusTask.get();
+            }
+            catch (const std::exception&)
+            {
+                result = xbox_live_result<allocation_result>(xbox_live_error_code::runtime_error, "get_session_host_allocation_status failed");
+            }
+
+            std::shared_ptr<game_server_allocation_tracker> pThis(thisWeakPtr.lock());
+            if (pThis != nullptr)
+            {
+                auto state = result.payload().fulfillment_state();
+                bool isPending = !result.err() && (state == game_server_fulfillment_state::queued || state == game_server_fulfillment_state::unknown);
+                pThis->complete_poll(allocation, result, isPending, &tracked_allocation::sessionHostWaiters);
+            }
+        });
+    }
+}
+
+template<typename T>
+void
+game_server_allocation_tracker::complete_poll(
+    _In_ const std::shared_ptr<tracked_allocation>& allocation,
+    _In_ const xbox_live_result<T>& result,
+    _In_ bool isPending,
+    _In_ std::vector<pplx::task_completion_event<xbox_live_result<T>>> tracked_allocation::* waiters
+    )
+{
+    xbox_live_result<T> finalResult = result;
+    std::vector<pplx::task_completion_event<xbox_live_result<T>>> waitersToComplete;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        --m_pollsInFlight;
+        allocation->isPolling = false;
+
+        auto now = chrono_clock_t::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - allocation->startTime);
+        if (isPending || (result.err() && is_transient_error(result.err())))
+        {
+            if (elapsed < m_maxTrackingTime)
+            {
+                ++allocation->pollCount;
+                allocation->nextPollTime = now + next_poll_delay(
+                    elapsed,
+                    allocation->pollCount,
+                    m_typicalAllocationTime,
+                    m_initialPollInterval,
+                    m_nearPollInterval,
+                    m_maxPollInterval
+                    );
+                schedule_timer(now);
+                return;
+            }
+
+            finalResult = xbox_live_result<T>(result.payload(), xbox_live_error_code::runtime_error, "The allocation did not complete in time");
+        }
+        else if (!result.err())
+        {
+            // Follow the allocation times actually seen, weighting recent ones by 1/8
+            m_typicalAllocationTime = (m_typicalAllocationTime * 7 + elapsed) / 8;
+        }
+
+        m_allocations.erase(allocation->key);
+        waitersToComplete.swap((*allocation).*waiters);
+    }
+
+    for (auto& waiter : waitersToComplete)
+    {
+        waiter.set(finalResult);
+    }
+}
+
+std::chrono::milliseconds
+game_server_allocation_tracker::typical_allocation_time() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_typicalAllocationTime;
+}
+
+size_t
+game_server_allocation_tracker::tracked_count() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_allocations.size();
+}
+
+uint64_t
+game_server_allocation_tracker::polls_sent() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_pollsSent;
+}
+
+uint64_t
+game_server_allocation_tracker::tracks_coalesced() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_tracksCoalesced;
+}
+
+uint64_t
+game_server_allocation_tracker::timer_ticks() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_timerTicks;
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_GAMESERVERPLATFORM_CPP_END
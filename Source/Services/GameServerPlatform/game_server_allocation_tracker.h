@@ -0,0 +1,149 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+#include "xsapi/types.h"
+#include "xsapi/game_server_platform.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_GAMESERVERPLATFORM_CPP_BEGIN
+
+/// <summary>
+/// Polls outstanding cluster tickets and session host allocations until they leave the queued state.
+/// Every allocation being tracked shares one timer, set for whichever is due first, and each tick polls
+/// all the allocations due within a short slack of it. Polls back off exponentially until the typical
+/// allocation time is near, poll tightly around it, then back off again. The typical allocation time
+/// starts at a default and follows the allocation times actually seen.
+/// Tracking the same ticket or session host more than once shares the same polls.
+/// </summary>
+class game_server_allocation_tracker : public std::enable_shared_from_this<game_server_allocation_tracker>
+{
+public:
+    static const std::chrono::milliseconds INITIAL_POLL_INTERVAL;
+    static const std::chrono::milliseconds NEAR_POLL_INTERVAL;
+    static const std::chrono::milliseconds MAX_POLL_INTERVAL;
+    static const std::chrono::milliseconds TYPICAL_ALLOCATION_TIME;
+    static const std::chrono::milliseconds MAX_TRACKING_TIME;
+    static const size_t MAX_CONCURRENT_POLLS;
+
+    game_server_allocation_tracker(
+        _In_ std::chrono::milliseconds initialPollInterval,
+        _In_ std::chrono::milliseconds nearPollInterval,
+        _In_ std::chrono::milliseconds maxPollInterval,
+        _In_ std::chrono::milliseconds typicalAllocationTime,
+        _In_ std::chrono::milliseconds maxTrackingTime,
+        _In_ size_t maxConcurrentPolls,
+        _In_ std::function<pplx::task<xbox_live_result<game_server_ticket_status>>(uint32_t, const string_t&)> ticketStatusHandler,
+        _In_ std::function<pplx::task<xbox_live_result<allocation_result>>(uint32_t, const string_t&)> allocationStatusHandler
+        );
+
+    ~game_server_allocation_tracker();
+
+    pplx::task<xbox_live_result<game_server_ticket_status>> track_ticket(
+        _In_ uint32_t gameServerTitleId,
+        _In_ const string_t& ticketId
+        );
+
+    pplx::task<xbox_live_result<allocation_result>> track_session_host(
+        _In_ uint32_t gameServerTitleId,
+        _In_ const string_t& sessionId
+        );
+
+    /// <summary>
+    /// How long to wait before the next poll of an allocation that has been outstanding for elapsed
+    /// and polled pollCount times
+    /// </summary>
+    static std::chrono::milliseconds next_poll_delay(
+        _In_ std::chrono::milliseconds elapsed,
+        _In_ uint32_t pollCount,
+        _In_ std::chrono::milliseconds typicalAllocationTime,
+        _In_ std::chrono::milliseconds initialPollInterval,
+        _In_ std::chrono::milliseconds nearPollInterval,
+        _In_ std::chrono::milliseconds maxPollInterval
+        );
+
+    std::chrono::milliseconds typical_allocation_time() const;
+    size_t tracked_count() const;
+    uint64_t polls_sent() const;
+    uint64_t tracks_coalesced() const;
+    uint64_t timer_ticks() const;
+
+private:
+    enum class allocation_kind
+    {
+        ticket,
+        session_host
+    };
+
+    struct tracked_allocation
+    {
+        allocation_kind kind;
+        uint32_t titleId;
+        string_t id;
+        string_t key;
+        chrono_clock_t::time_point startTime;
+        chrono_clock_t::time_point nextPollTime;
+        uint32_t pollCount;
+        bool isPolling;
+        std::vector<pplx::task_completion_event<xbox_live_result<game_server_ticket_status>>> ticketWaiters;
+        std::vector<pplx::task_completion_event<xbox_live_result<allocation_result>>> sessionHostWaiters;
+    };
+
+    // Called with m_lock held. Returns the allocation being tracked under the key, adding it if it's new.
+    std::shared_ptr<tracked_allocation> get_or_add_allocation(
+        _In_ allocation_kind kind,
+        _In_ uint32_t gameServerTitleId,
+        _In_ const string_t& id
+        );
+
+    // Called with m_lock held
+    void schedule_timer(
+        _In_ const chrono_clock_t::time_point& now
+        );
+
+    void on_timer(
+        _In_ uint64_t timerGeneration
+        );
+
+    void poll(
+        _In_ const std::shared_ptr<tracked_allocation>& allocation
+        );
+
+    template<typename T>
+    void complete_poll(
+        _In_ const std::shared_ptr<tracked_allocation>& allocation,
+        _In_ const xbox_live_result<T>& result,
+        _In_ bool isPending,
+        _In_ std::vector<pplx::task_completion_event<xbox_live_result<T>>> tracked_allocation::* waiters
+        );
+
+    static bool is_transient_error(
+        _In_ const std::error_code& errc
+        );
+
+    std::chrono::milliseconds m_initialPollInterval;
+    std::chrono::milliseconds m_nearPollInterval;
+    std::chrono::milliseconds m_maxPollInterval;
+    std::chrono::milliseconds m_maxTrackingTime;
+    size_t m_maxConcurrentPolls;
+    std::function<pplx::task<xbox_live_result<game_server_ticket_status>>(uint32_t, const string_t&)> m_ticketStatusHandler;
+    std::function<pplx::task<xbox_live_result<allocation_result>>(uint32_t, const string_t&)> m_allocationStatusHandler;
+
+    mutable std::mutex m_lock;
+    std::unordered_map<string_t, std::shared_ptr<tracked_allocation>> m_allocations;
+    std::chrono::milliseconds m_typicalAllocationTime;
+    bool m_isTimerScheduled;
+    chrono_clock_t::time_point m_timerDueTime;
+    uint64_t m_timerGeneration;
+    size_t m_pollsInFlight;
+    uint64_t m_pollsSent;
+    uint64_t m_tracksCoalesced;
+    uint64_t m_timerTicks;
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_GAMESERVERPLATFORM_CPP_END
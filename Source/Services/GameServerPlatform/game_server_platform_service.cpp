@@ -12,6 +12,7 @@
 #include "xbox_system_factory.h"
 #include "utils.h"
 #include "user_context.h"
+#include "game_server_allocation_tracker.h"
 
 using namespace pplx;
 
@@ -26,6 +27,23 @@ game_server_platform_service::game_server_platform_service(
     m_xboxLiveContextSettings(std::move(xboxLiveContextSettings)),
     m_appConfig(std::move(appConfig))
 {
+    // Polls through a copy made before the tracker is set, so the tracker doesn't keep itself alive
+    game_server_platform_service pollingService(*this);
+    m_allocationTracker = std::make_shared<game_server_allocation_tracker>(
+        game_server_allocation_tracker::INITIAL_POLL_INTERVAL,
+        game_server_allocation_tracker::NEAR_POLL_INTERVAL,
+        game_server_allocation_tracker::MAX_POLL_INTERVAL,
+        game_server_allocation_tracker::TYPICAL_ALLOCATION_TIME,
+        game_server_allocation_tracker::MAX_TRACKING_TIME,
+        game_server_allocation_tracker::MAX_CONCURRENT_POLLS,
+        [pollingService](uint32_t gameServerTitleId, const string_t& ticketId) mutable
+        {
+            return pollingService.get_ticket_status(gameServerTitleId, ticketId);
+        },
+        [pollingService](uint32_t gameServerTitleId, const string_t& sessionId) mutable
+        {
+            return pollingService.get_session_host_allocation_status(gameServerTitleId, sessionId);
+        });
 }
 
 pplx::task<xbox::services::xbox_live_result<cluster_result>>
@@ -397,6 +415,35 @@ game_server_platform_service::get_session_host_allocation_status(
         );
 }
 
+pplx::task<xbox::services::xbox_live_result<game_server_ticket_status>>
+game_server_platform_service::track_ticket_status(
+    _In_ uint32_t gameServerTitleId,
+    _In_ const string_t& ticketId
+    )
+{
+    RETURN_TASK_CPP_INVALIDARGUMENT_IF_STRING_EMPTY(ticketId, game_server_ticket_status, "ticketId is required");
+    if (m_allocationTracker == nullptr)
+    {
+        return pplx::task_from_result(xbox_live_result<game_server_ticket_status>(xbox_live_error_code::runtime_error, "game_server_platform_service is not initialized"));
+    }
+
+    return m_allocationTracker->track_ticket(gameServerTitleId, ticketId);
+}
+
+pplx::task<xbox::services::xbox_live_result<allocation_result>>
+game_server_platform_service::track_session_host_allocation(
+    _In_ uint32_t gameServerTitleId,
+    _In_ const string_t& sessionId
+    )
+{
+    RETURN_TASK_CPP_INVALIDARGUMENT_IF_STRING_EMPTY(sessionId, allocation_result, "sessionId is required");
+    if (m_allocationTracker == nullptr)
+    {
+        return pplx::task_from_result(xbox_live_result<allocation_result>(xbox_live_error_code::runtime_error, "game_server_platform_service is not initialized"));
+    }
+
+    return m_allocationTracker->track_session_host(gameServerTitleId, sessionId);
+}
 
 string_t 
 game_server_platform_service::pathandquery_game_server_create_cluster_subpath(
@@ -0,0 +1,153 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "shared_macros.h"
+#include "xsapi/leaderboard.h"
+#include "utils.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_LEADERBOARD_CPP_BEGIN
+
+leaderboard_cursor::leaderboard_cursor(
+    _In_ const leaderboard_result& firstPage,
+    _In_ uint32_t maxItems,
+    _In_ uint32_t prefetchPageCount
+    ) :
+    m_maxItems(maxItems),
+    m_prefetchPageCount(prefetchPageCount),
+    m_lastFetchedPage(firstPage),
+    m_fetchInProgress(false),
+    m_prefetchPaused(false)
+{
+}
+
+bool leaderboard_cursor::has_next() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return !m_fetchedPages.empty() || m_fetchInProgress || m_lastFetchedPage.has_next();
+}
+
+uint32_t leaderboard_cursor::prefetched_page_count() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return static_cast<uint32_t>(m_fetchedPages.size());
+}
+
+pplx::task<xbox_live_result<leaderboard_result>> leaderboard_cursor::get_next()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    // An explicit request retries after a failed prefetch
+    m_prefetchPaused = false;
+
+    if (!m_fetchedPages.empty())
+    {
+        auto page = std::move(m_fetchedPages.front());
+        m_fetchedPages.pop_front();
+        prefetch_if_needed();
+        return pplx::task_from_result(page);
+    }
+
+    if (!m_fetchInProgress && !m_lastFetchedPage.has_next())
+    {
+        return pplx::task_from_result(xbox_live_result<leaderboard_result>(xbox_live_error_code::out_of_range, "leaderboard_cursor does not have a next page"));
+    }
+
+    pplx::task_completion_event<xbox_live_result<leaderboard_result>> tce;
+    m_waitingCallers.push_back(tce);
+    prefetch_if_needed();
+    return pplx::create_task(tce);
+}
+
+void leaderboard_cursor::prefetch_if_needed()
+{
+    // Must be called with m_lock held
+    if (m_fetchInProgress || m_prefetchPaused || !m_lastFetchedPage.has_next())
+    {
+        return;
+    }
+
+    if (m_waitingCallers.empty() && m_fetchedPages.size() >= m_prefetchPageCount)
+    {
+        return;
+    }
+
+    m_fetchInProgress = true;
+    std::weak_ptr<leaderboard_cursor> thisWeakPtr = shared_from_this();
+    m_lastFetchedPage.get_next(m_maxItems)
+    .then([thisWeakPtr](pplx::task<xbox_live_result<leaderboard_result>> t)
+    {
+        xbox_live_result<leaderboard_result> page;
+        try
+        {
+            page = t.get();
+        }
+        catch (const std::exception& e)
+        {
+            page = xbox_live_result<leaderboard_result>(utils::convert_exception_to_xbox_live_error_code(), e.what());
+        }
+
+        std::shared_ptr<leaderboard_cursor> pThis(thisWeakPtr.lock());
+        if (pThis != nullptr)
+        {
+            pThis->on_page_fetched(std::move(page));
+        }
+    });
+}
+
+void leaderboard_cursor::on_page_fetched(_In_ xbox_live_result<leaderboard_result> page)
+{
+    std::vector<pplx::task_completion_event<xbox_live_result<leaderboard_result>>> exhaustedCallers;
+    pplx::task_completion_event<xbox_live_result<leaderboard_result>> waitingCaller;
+    bool hasWaitingCaller = false;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_fetchInProgress = false;
+
+        if (!page.err())
+        {
+            m_lastFetchedPage = page.payload();
+        }
+
+        if (!m_waitingCallers.empty())
+        {
+            waitingCaller = m_waitingCallers.front();
+            m_waitingCallers.pop_front();
+            hasWaitingCaller = true;
+        }
+        else
+        {
+            m_fetchedPages.push_back(page);
+        }
+
+        // After a failure, stop prefetching until someone asks again rather than retrying in a tight loop.
+        // Callers already queued behind the failed fetch retry from the last good page.
+        m_prefetchPaused = page.err() && m_waitingCallers.empty();
+        prefetch_if_needed();
+
+        if (!m_fetchInProgress)
+        {
+            // Reached the last page with callers still waiting
+            exhaustedCallers.assign(m_waitingCallers.begin(), m_waitingCallers.end());
+            m_waitingCallers.clear();
+        }
+    }
+
+    if (hasWaitingCaller)
+    {
+        waitingCaller.set(page);
+    }
+
+    for (auto& caller : exhaustedCallers)
+    {
+        caller.set(xbox_live_result<leaderboard_result>(xbox_live_error_code::out_of_range, "leaderboard_cursor does not have a next page"));
+    }
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_LEADERBOARD_CPP_END
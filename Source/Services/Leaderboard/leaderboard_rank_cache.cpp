@@ -0,0 +1,174 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "leaderboard_rank_cache.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_LEADERBOARD_CPP_BEGIN
+
+leaderboard_rank_cache::leaderboard_rank_cache() :
+    m_expiry(std::chrono::seconds::zero())
+{
+}
+
+std::chrono::seconds leaderboard_rank_cache::expiry() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_expiry;
+}
+
+void leaderboard_rank_cache::set_expiry(_In_ std::chrono::seconds expiry)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_expiry = expiry;
+    if (m_expiry <= std::chrono::seconds::zero())
+    {
+        m_entries.clear();
+    }
+}
+
+bool leaderboard_rank_cache::is_expired(
+    _In_ const cached_row& row,
+    _In_ const std::chrono::steady_clock::time_point& now
+    ) const
+{
+    return now - row.fetchTime >= m_expiry;
+}
+
+void leaderboard_rank_cache::add_page(
+    _In_ const string_t& queryKey,
+    _In_ const leaderboard_result& page
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (m_expiry <= std::chrono::seconds::zero() || page.rows().empty())
+    {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    cache_entry& entry = m_entries[queryKey];
+
+    // Rows fetched under a different column layout or total can't be mixed into one window
+    if (entry.totalRowCount != page.total_row_count() || entry.columns.size() != page.columns().size())
+    {
+        entry.rowsByRank.clear();
+    }
+
+    entry.displayName = page.display_name();
+    entry.totalRowCount = page.total_row_count();
+    entry.columns = page.columns();
+
+    for (auto iter = entry.rowsByRank.begin(); iter != entry.rowsByRank.end();)
+    {
+        if (is_expired(iter->second, now))
+        {
+            iter = entry.rowsByRank.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+
+    for (const auto& row : page.rows())
+    {
+        auto inserted = entry.rowsByRank.insert(std::make_pair(row.rank(), cached_row(row, now)));
+        if (!inserted.second)
+        {
+            inserted.first->second = cached_row(row, now);
+        }
+    }
+}
+
+bool leaderboard_rank_cache::try_get_window(
+    _In_ const string_t& queryKey,
+    _In_ uint32_t skipToRank,
+    _In_ uint32_t maxItems,
+    _Out_ leaderboard_rank_window& window
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (m_expiry <= std::chrono::seconds::zero() || skipToRank == 0 || maxItems == 0)
+    {
+        return false;
+    }
+
+    auto entryIter = m_entries.find(queryKey);
+    if (entryIter == m_entries.end())
+    {
+        return false;
+    }
+
+    const cache_entry& entry = entryIter->second;
+    if (skipToRank > entry.totalRowCount)
+    {
+        return false;
+    }
+
+    uint32_t lastRank = __min(skipToRank + maxItems - 1, entry.totalRowCount);
+    auto now = std::chrono::steady_clock::now();
+
+    std::vector<leaderboard_row> rows;
+    rows.reserve(lastRank - skipToRank + 1);
+    auto rowIter = entry.rowsByRank.find(skipToRank);
+    for (uint32_t rank = skipToRank; rank <= lastRank; ++rank, ++rowIter)
+    {
+        // Only a fully populated, unexpired window can be served locally
+        if (rowIter == entry.rowsByRank.end() || rowIter->first != rank || is_expired(rowIter->second, now))
+        {
+            return false;
+        }
+        rows.push_back(rowIter->second.row);
+    }
+
+    window.displayName = entry.displayName;
+    window.totalRowCount = entry.totalRowCount;
+    window.columns = entry.columns;
+    window.rows = std::move(rows);
+    return true;
+}
+
+void leaderboard_rank_cache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_entries.clear();
+}
+
+string_t leaderboard_rank_cache::global_query_key(
+    _In_ const string_t& scid,
+    _In_ const string_t& name,
+    _In_ const string_t& xuid,
+    _In_ const string_t& socialGroup,
+    _In_ const std::vector<string_t>& additionalColumnNames
+    )
+{
+    stringstream_t key;
+    key << _T("lb|") << scid << _T("|") << name << _T("|") << xuid << _T("|") << socialGroup;
+    for (const auto& column : additionalColumnNames)
+    {
+        key << _T("|") << column;
+    }
+    return key.str();
+}
+
+string_t leaderboard_rank_cache::social_query_key(
+    _In_ const string_t& xuid,
+    _In_ const string_t& scid,
+    _In_ const string_t& statName,
+    _In_ const string_t& socialGroup,
+    _In_ const string_t& sortOrder
+    )
+{
+    stringstream_t key;
+    key << _T("stat|") << xuid << _T("|") << scid << _T("|") << statName << _T("|") << socialGroup << _T("|") << sortOrder;
+    return key.str();
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_LEADERBOARD_CPP_END
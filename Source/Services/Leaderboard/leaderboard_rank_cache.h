@@ -0,0 +1,103 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include "shared_macros.h"
+#include "xsapi/leaderboard.h"
+#include <chrono>
+#include <map>
+#include <mutex>
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_LEADERBOARD_CPP_BEGIN
+
+struct leaderboard_rank_window
+{
+    leaderboard_rank_window() : totalRowCount(0) {}
+
+    string_t displayName;
+    uint32_t totalRowCount;
+    std::vector<leaderboard_column> columns;
+    std::vector<leaderboard_row> rows;
+};
+
+/// <summary>
+/// Caches leaderboard rows by rank for each distinct query (leaderboard or stat, view and columns)
+/// so that a skip to rank request whose window was already fetched can be served without a service call.
+/// Rows older than the expiry are ignored and pruned.
+/// </summary>
+class leaderboard_rank_cache
+{
+public:
+    leaderboard_rank_cache();
+
+    std::chrono::seconds expiry() const;
+    void set_expiry(_In_ std::chrono::seconds expiry);
+
+    void add_page(
+        _In_ const string_t& queryKey,
+        _In_ const leaderboard_result& page
+        );
+
+    bool try_get_window(
+        _In_ const string_t& queryKey,
+        _In_ uint32_t skipToRank,
+        _In_ uint32_t maxItems,
+        _Out_ leaderboard_rank_window& window
+        );
+
+    void clear();
+
+    static string_t global_query_key(
+        _In_ const string_t& scid,
+        _In_ const string_t& name,
+        _In_ const string_t& xuid,
+        _In_ const string_t& socialGroup,
+        _In_ const std::vector<string_t>& additionalColumnNames
+        );
+
+    static string_t social_query_key(
+        _In_ const string_t& xuid,
+        _In_ const string_t& scid,
+        _In_ const string_t& statName,
+        _In_ const string_t& socialGroup,
+        _In_ const string_t& sortOrder
+        );
+
+private:
+    struct cached_row
+    {
+        cached_row(_In_ leaderboard_row _row, _In_ std::chrono::steady_clock::time_point _fetchTime) :
+            row(std::move(_row)),
+            fetchTime(_fetchTime)
+        {
+        }
+
+        leaderboard_row row;
+        std::chrono::steady_clock::time_point fetchTime;
+    };
+
+    struct cache_entry
+    {
+        cache_entry() : totalRowCount(0) {}
+
+        string_t displayName;
+        uint32_t totalRowCount;
+        std::vector<leaderboard_column> columns;
+        std::map<uint32_t, cached_row> rowsByRank;
+    };
+
+    bool is_expired(_In_ const cached_row& row, _In_ const std::chrono::steady_clock::time_point& now) const;
+
+    std::chrono::seconds m_expiry;
+    std::unordered_map<string_t, cache_entry> m_entries;
+    mutable std::mutex m_lock;
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_LEADERBOARD_CPP_END
@@ -10,12 +10,14 @@
 #include "pch.h"
 #include "shared_macros.h"
 #include "leaderboard_query.h"
+#include "leaderboard_rank_cache.h"
 #include "xsapi/leaderboard.h"
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_LEADERBOARD_CPP_BEGIN
 
 leaderboard_result::leaderboard_result() :
-    m_totalRowCount(0)
+    m_totalRowCount(0),
+    m_nextRank(0)
 {
 }
 
@@ -32,6 +34,7 @@ leaderboard_result::leaderboard_result(
     m_displayName(std::move(display_name)),
     m_totalRowCount(total_row_count),
     m_continuationToken(std::move(continuationToken)),
+    m_nextRank(0),
     m_columns(std::move(columns)),
     m_rows(std::move(rows)),
     m_userContext(std::move(userContext)),
@@ -70,6 +73,16 @@ void leaderboard_result::_Set_next_query(std::shared_ptr<leaderboard_social_quer
     m_socialQuery = std::move(query);
 }
 
+void leaderboard_result::_Set_next_rank(uint32_t nextRank)
+{
+    m_nextRank = nextRank;
+}
+
+void leaderboard_result::_Set_rank_cache(std::shared_ptr<leaderboard_rank_cache> rankCache)
+{
+    m_rankCache = std::move(rankCache);
+}
+
 void leaderboard_result::_Parse_additional_columns(const std::vector<string_t>& additionalColumnNames)
 {
     std::vector<leaderboard_column> columns;
@@ -128,17 +141,21 @@ void leaderboard_result::_Parse_additional_columns(const std::vector<string_t>&
 
 bool leaderboard_result::has_next() const
 {
-    return !m_continuationToken.empty();
+    return !m_continuationToken.empty() || m_nextRank != 0;
 }
 
 pplx::task<xbox_live_result<leaderboard_result>> leaderboard_result::get_next(_In_ uint32_t maxItems) const
 {
-    if (m_continuationToken.empty())
+    if (!has_next())
     {
         return pplx::task_from_result(xbox_live_result<leaderboard_result>(xbox_live_error_code::out_of_range, "leadboard_result does not have a next page"));
     }
 
     leaderboard_service service(m_userContext, m_xboxLiveContextSettings, m_appConfig);
+    service.m_rankCache = m_rankCache;
+
+    // Pages served from the rank cache have no continuation token, so continue by rank instead
+    uint32_t skipToRank = m_continuationToken.empty() ? m_nextRank : NO_SKIP_RANK;
 
     if (m_globalQuery != nullptr)
     {
@@ -150,7 +167,7 @@ pplx::task<xbox_live_result<leaderboard_result>> leaderboard_result::get_next(_I
         return service.get_leaderboard_internal(
             scid,
             name,
-            NO_SKIP_RANK,
+            skipToRank,
             NO_SKIP_XUID,
             xuid,
             socialGroup,
@@ -165,7 +182,7 @@ pplx::task<xbox_live_result<leaderboard_result>> leaderboard_result::get_next(_I
             m_socialQuery->scid,
             m_socialQuery->statName,
             m_socialQuery->socialGroup,
-            NO_SKIP_RANK,
+            skipToRank,
             NO_SKIP_XUID,
             m_socialQuery->sortOrder,
             maxItems,
@@ -12,6 +12,7 @@
 #include "xbox_system_factory.h"
 #include "leaderboard_serializers.h"
 #include "leaderboard_query.h"
+#include "leaderboard_rank_cache.h"
 #include "xsapi/leaderboard.h"
 #include "utils.h"
 
@@ -27,10 +28,24 @@ leaderboard_service::leaderboard_service(
     ) :
     m_userContext(std::move(userContext)),
     m_xboxLiveContextSettings(std::move(xboxLiveContextSettings)),
-    m_appConfig(std::move(appConfig))
+    m_appConfig(std::move(appConfig)),
+    m_rankCache(std::make_shared<leaderboard_rank_cache>())
 {
 }
 
+std::chrono::seconds leaderboard_service::rank_cache_expiry() const
+{
+    return m_rankCache != nullptr ? m_rankCache->expiry() : std::chrono::seconds::zero();
+}
+
+void leaderboard_service::set_rank_cache_expiry(_In_ std::chrono::seconds expiry)
+{
+    if (m_rankCache != nullptr)
+    {
+        m_rankCache->set_expiry(expiry);
+    }
+}
+
 pplx::task<xbox_live_result<leaderboard_result>> leaderboard_service::get_leaderboard(
     _In_ const string_t& scid,
     _In_ const string_t& name,
@@ -240,6 +255,52 @@ pplx::task<xbox_live_result<leaderboard_result>> leaderboard_service::get_leader
         NO_CONTINUATION);
 }
 
+pplx::task<xbox_live_result<social_leaderboard_table>> leaderboard_service::get_social_leaderboard_table(
+    _In_ const string_t& xuid,
+    _In_ const string_t& scid,
+    _In_ const std::vector<string_t>& statNames,
+    _In_ const string_t& socialGroup,
+    _In_ uint32_t maxItems
+    )
+{
+    RETURN_TASK_CPP_INVALIDARGUMENT_IF(statNames.empty(), social_leaderboard_table, "statNames is empty");
+
+    // One request per stat, all in flight together
+    std::vector<pplx::task<xbox_live_result<leaderboard_result>>> statTasks;
+    statTasks.reserve(statNames.size());
+    for (const auto& statName : statNames)
+    {
+        statTasks.push_back(get_leaderboard_for_social_group_internal(
+            xuid,
+            scid,
+            statName,
+            socialGroup,
+            NO_SKIP_RANK,
+            NO_SKIP_XUID,
+            NO_SORT_ORDER,
+            maxItems,
+            NO_CONTINUATION));
+    }
+
+    return pplx::when_all(statTasks.begin(), statTasks.end())
+    .then([statNames](std::vector<xbox_live_result<leaderboard_result>> results)
+    {
+        social_leaderboard_table table(statNames);
+        for (size_t column = 0; column < results.size(); ++column)
+        {
+            const auto& result = results[column];
+            if (result.err())
+            {
+                return xbox_live_result<social_leaderboard_table>(result.err(), result.err_message());
+            }
+
+            table._Add_column_rows(column, result.payload());
+        }
+
+        return xbox_live_result<social_leaderboard_table>(std::move(table));
+    });
+}
+
 xbox_live_result<string_t> create_leaderboard_url(
     _In_ const string_t& scid,
     _In_ const string_t& name,
@@ -311,6 +372,35 @@ xbox_live_result<string_t> create_leaderboard_url(
     return xbox_live_result<string_t>(builder.to_string());
 }
 
+xbox_live_result<leaderboard_result> create_leaderboard_result_from_rank_window(
+    _In_ const leaderboard_rank_window& window,
+    _In_ const std::shared_ptr<xbox::services::user_context>& userContext,
+    _In_ const std::shared_ptr<xbox::services::xbox_live_context_settings>& xboxLiveContextSettings,
+    _In_ const std::shared_ptr<xbox::services::xbox_live_app_config>& appConfig,
+    _In_ const std::shared_ptr<leaderboard_rank_cache>& rankCache
+    )
+{
+    leaderboard_result result(
+        window.displayName,
+        window.totalRowCount,
+        string_t(),
+        window.columns,
+        window.rows,
+        userContext,
+        xboxLiveContextSettings,
+        appConfig
+        );
+
+    uint32_t lastRank = window.rows.back().rank();
+    if (lastRank < window.totalRowCount)
+    {
+        result._Set_next_rank(lastRank + 1);
+    }
+    result._Set_rank_cache(rankCache);
+
+    return xbox_live_result<leaderboard_result>(result);
+}
+
 pplx::task<xbox_live_result<leaderboard_result>> leaderboard_service::get_leaderboard_internal(
     _In_ const string_t& scid,
     _In_ const string_t& name,
@@ -344,6 +434,22 @@ pplx::task<xbox_live_result<leaderboard_result>> leaderboard_service::get_leader
     query->socialGroup = socialGroup;
     query->columns = additionalColumnNames;
 
+    auto rankCache = m_rankCache;
+    string_t rankCacheKey;
+    if (rankCache != nullptr)
+    {
+        rankCacheKey = leaderboard_rank_cache::global_query_key(scid, name, xuid, socialGroup, additionalColumnNames);
+
+        leaderboard_rank_window window;
+        if (skipToXuid.empty() && continuationToken.empty() &&
+            rankCache->try_get_window(rankCacheKey, skipToRank, maxItems, window))
+        {
+            auto cachedResult = create_leaderboard_result_from_rank_window(window, m_userContext, m_xboxLiveContextSettings, m_appConfig, rankCache);
+            cachedResult.payload()._Set_next_query(query);
+            return pplx::task_from_result(cachedResult);
+        }
+    }
+
     std::shared_ptr<http_call> http_call = xbox::services::system::xbox_system_factory::get_factory()->create_http_call(
         m_xboxLiveContextSettings,
         _T("GET"),
@@ -371,7 +477,7 @@ pplx::task<xbox_live_result<leaderboard_result>> leaderboard_service::get_leader
             response
             );
 
-    }).then([query, additionalColumnNames](xbox_live_result<leaderboard_result> lb)
+    }).then([query, additionalColumnNames, rankCache, rankCacheKey](xbox_live_result<leaderboard_result> lb)
     {
         leaderboard_result& lbRes = lb.payload();
         lbRes._Set_next_query(query);
@@ -380,6 +486,15 @@ pplx::task<xbox_live_result<leaderboard_result>> leaderboard_service::get_leader
             lbRes._Parse_additional_columns(additionalColumnNames);
         }
 
+        if (rankCache != nullptr)
+        {
+            lbRes._Set_rank_cache(rankCache);
+            if (!lb.err())
+            {
+                rankCache->add_page(rankCacheKey, lbRes);
+            }
+        }
+
         return lb;
     });
 
@@ -491,6 +606,22 @@ pplx::task<xbox_live_result<leaderboard_result>> leaderboard_service::get_leader
     query->socialGroup = group;
     query->sortOrder = sortOrder;
 
+    auto rankCache = m_rankCache;
+    string_t rankCacheKey;
+    if (rankCache != nullptr)
+    {
+        rankCacheKey = leaderboard_rank_cache::social_query_key(xuid, scid, statName, group, sortOrder);
+
+        leaderboard_rank_window window;
+        if (skipToXuid.empty() && continuationToken.empty() &&
+            rankCache->try_get_window(rankCacheKey, skipToRank, maxItems, window))
+        {
+            auto cachedResult = create_leaderboard_result_from_rank_window(window, m_userContext, m_xboxLiveContextSettings, m_appConfig, rankCache);
+            cachedResult.payload()._Set_next_query(query);
+            return pplx::task_from_result(cachedResult);
+        }
+    }
+
     std::shared_ptr<http_call> http_call = xbox::services::system::xbox_system_factory::get_factory()->create_http_call(
         m_xboxLiveContextSettings,
         _T("GET"),
@@ -519,10 +650,18 @@ pplx::task<xbox_live_result<leaderboard_result>> leaderboard_service::get_leader
             response
             );
 
-    }).then([query](xbox_live_result<leaderboard_result> lb)
+    }).then([query, rankCache, rankCacheKey](xbox_live_result<leaderboard_result> lb)
     {
         auto leaderboardResult = lb.payload();
         leaderboardResult._Set_next_query(query);
+        if (rankCache != nullptr)
+        {
+            leaderboardResult._Set_rank_cache(rankCache);
+            if (!lb.err())
+            {
+                rankCache->add_page(rankCacheKey, leaderboardResult);
+            }
+        }
         return xbox_live_result<leaderboard_result>(leaderboardResult, lb.err(), lb.err_message());
     });
 
@@ -0,0 +1,288 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "shared_macros.h"
+#include "xsapi/leaderboard.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_LEADERBOARD_CPP_BEGIN
+
+social_leaderboard_table::social_leaderboard_table(
+    _In_ std::vector<string_t> statNames
+    ) :
+    m_statNames(std::move(statNames)),
+    m_columnValues(m_statNames.size()),
+    m_columnHasValues(m_statNames.size()),
+    m_sortColumn(0),
+    m_sortDescending(true),
+    m_isSorted(false)
+{
+}
+
+const std::vector<string_t>&
+social_leaderboard_table::stat_names() const
+{
+    return m_statNames;
+}
+
+int
+social_leaderboard_table::column_index(
+    _In_ const string_t& statName
+    ) const
+{
+    for (size_t i = 0; i < m_statNames.size(); ++i)
+    {
+        if (m_statNames[i] == statName)
+        {
+            return static_cast<int>(i);
+        }
+    }
+
+    return -1;
+}
+
+size_t
+social_leaderboard_table::row_count() const
+{
+    return m_xboxUserIds.size();
+}
+
+int
+social_leaderboard_table::row_index(
+    _In_ const string_t& xboxUserId
+    ) const
+{
+    auto iter = m_rowIndices.find(xboxUserId);
+    return iter != m_rowIndices.end() ? static_cast<int>(iter->second) : -1;
+}
+
+const string_t&
+social_leaderboard_table::xbox_user_id(
+    _In_ size_t row
+    ) const
+{
+    return m_xboxUserIds[row];
+}
+
+const string_t&
+social_leaderboard_table::gamertag(
+    _In_ size_t row
+    ) const
+{
+    return m_gamertags[row];
+}
+
+bool
+social_leaderboard_table::has_value(
+    _In_ size_t row,
+    _In_ size_t column
+    ) const
+{
+    return m_columnHasValues[column][row] != 0;
+}
+
+double
+social_leaderboard_table::value(
+    _In_ size_t row,
+    _In_ size_t column
+    ) const
+{
+    return m_columnValues[column][row];
+}
+
+const std::vector<double>&
+social_leaderboard_table::column_values(
+    _In_ size_t column
+    ) const
+{
+    return m_columnValues[column];
+}
+
+const std::vector<uint32_t>&
+social_leaderboard_table::sorted_rows() const
+{
+    return m_sortedRows;
+}
+
+size_t
+social_leaderboard_table::sort_column() const
+{
+    return m_sortColumn;
+}
+
+bool
+social_leaderboard_table::is_sorted_descending() const
+{
+    return m_sortDescending;
+}
+
+uint32_t
+social_leaderboard_table::add_row(
+    _In_ const string_t& xboxUserId,
+    _In_ const string_t& gamertag
+    )
+{
+    auto iter = m_rowIndices.find(xboxUserId);
+    if (iter != m_rowIndices.end())
+    {
+        if (m_gamertags[iter->second].empty())
+        {
+            m_gamertags[iter->second] = gamertag;
+        }
+        return iter->second;
+    }
+
+    uint32_t row = static_cast<uint32_t>(m_xboxUserIds.size());
+    m_rowIndices[xboxUserId] = row;
+    m_xboxUserIds.push_back(xboxUserId);
+    m_gamertags.push_back(gamertag);
+    for (size_t column = 0; column < m_columnValues.size(); ++column)
+    {
+        m_columnValues[column].push_back(0);
+        m_columnHasValues[column].push_back(0);
+    }
+
+    return row;
+}
+
+void
+social_leaderboard_table::_Add_column_rows(
+    _In_ size_t column,
+    _In_ const leaderboard_result& result
+    )
+{
+    for (const auto& leaderboardRow : result.rows())
+    {
+        uint32_t row = add_row(leaderboardRow.xbox_user_id(), leaderboardRow.gamertag());
+        if (!leaderboardRow.column_values().empty())
+        {
+            // Parsed once here so sorting only ever compares numbers
+            stringstream_t valueStream(leaderboardRow.column_values()[0]);
+            double value = 0;
+            valueStream >> value;
+            if (!valueStream.fail())
+            {
+                m_columnValues[column][row] = value;
+                m_columnHasValues[column][row] = 1;
+            }
+        }
+
+        // Rows start in the order the service ranked the first stat
+        if (column == 0)
+        {
+            m_sortedRows.push_back(row);
+        }
+    }
+
+    // Players only on later stats' leaderboards go after those ranked on the first
+    if (m_sortedRows.size() < m_xboxUserIds.size())
+    {
+        std::vector<uint8_t> isSorted(m_xboxUserIds.size(), 0);
+        for (auto row : m_sortedRows)
+        {
+            isSorted[row] = 1;
+        }
+        for (uint32_t row = 0; row < isSorted.size(); ++row)
+        {
+            if (!isSorted[row])
+            {
+                m_sortedRows.push_back(row);
+            }
+        }
+    }
+}
+
+bool
+social_leaderboard_table::sorts_before(
+    _In_ uint32_t row1,
+    _In_ uint32_t row2
+    ) const
+{
+    const auto& values = m_columnValues[m_sortColumn];
+    const auto& hasValues = m_columnHasValues[m_sortColumn];
+    if (hasValues[row1] != hasValues[row2])
+    {
+        return hasValues[row1] > hasValues[row2];
+    }
+
+    if (values[row1] != values[row2])
+    {
+        return m_sortDescending ? values[row1] > values[row2] : values[row1] < values[row2];
+    }
+
+    return row1 < row2;
+}
+
+void
+social_leaderboard_table::sort_by(
+    _In_ size_t column,
+    _In_ bool descending
+    )
+{
+    if (column >= m_statNames.size())
+    {
+        return;
+    }
+
+    m_sortColumn = column;
+    m_sortDescending = descending;
+    m_isSorted = true;
+    std::sort(m_sortedRows.begin(), m_sortedRows.end(), [this](uint32_t row1, uint32_t row2)
+    {
+        return sorts_before(row1, row2);
+    });
+}
+
+bool
+social_leaderboard_table::update_value(
+    _In_ const string_t& xboxUserId,
+    _In_ const string_t& gamertag,
+    _In_ const string_t& statName,
+    _In_ double value
+    )
+{
+    int column = column_index(statName);
+    if (column < 0)
+    {
+        return false;
+    }
+
+    bool isNewRow = m_rowIndices.find(xboxUserId) == m_rowIndices.end();
+    uint32_t row = add_row(xboxUserId, gamertag);
+
+    bool needsMove = m_isSorted && static_cast<size_t>(column) == m_sortColumn;
+    if (needsMove && !isNewRow)
+    {
+        m_sortedRows.erase(std::find(m_sortedRows.begin(), m_sortedRows.end(), row));
+    }
+
+    m_columnValues[column][row] = value;
+    m_columnHasValues[column][row] = 1;
+
+    if (needsMove || isNewRow)
+    {
+        if (m_isSorted)
+        {
+            // The rest of the rows are still in order, so the row only needs to be put back in its place
+            auto position = std::lower_bound(m_sortedRows.begin(), m_sortedRows.end(), row, [this](uint32_t row1, uint32_t row2)
+            {
+                return sorts_before(row1, row2);
+            });
+            m_sortedRows.insert(position, row);
+        }
+        else
+        {
+            m_sortedRows.push_back(row);
+        }
+    }
+
+    return true;
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_LEADERBOARD_CPP_END
@@ -10,10 +10,12 @@
 #include "pch.h"
 #include "xbox_system_factory.h"
 #include "xsapi/system.h"
+#include "string_verify_batcher.h"
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
 
-string_service::string_service()
+string_service::string_service() :
+    m_isVerifyStringBatchingEnabled(false)
 {
 }
 
@@ -24,8 +26,20 @@ string_service::string_service(
     ) :
     m_userContext(std::move(userContext)),
     m_xboxLiveContextSettings(std::move(xboxLiveContextSettings)),
-    m_appConfig(std::move(appConfig))
+    m_appConfig(std::move(appConfig)),
+    m_isVerifyStringBatchingEnabled(false)
 {
+    auto sharedUserContext = m_userContext;
+    auto sharedSettings = m_xboxLiveContextSettings;
+    auto sharedAppConfig = m_appConfig;
+    m_stringVerifyBatcher = std::make_shared<string_verify_batcher>(
+        string_verify_batcher::BATCH_WINDOW,
+        string_verify_batcher::MAX_STRINGS_PER_BATCH,
+        string_verify_batcher::MAX_CACHED_VERDICTS,
+        [sharedUserContext, sharedSettings, sharedAppConfig](const std::vector<string_t>& stringsToVerify)
+        {
+            return send_verify_strings_request(sharedUserContext, sharedSettings, sharedAppConfig, stringsToVerify);
+        });
 }
 
 pplx::task<xbox_live_result<verify_string_result>>
@@ -33,6 +47,11 @@ string_service::verify_string(_In_ const string_t& stringToVerify)
 {
     RETURN_TASK_CPP_INVALIDARGUMENT_IF_STRING_EMPTY(stringToVerify, verify_string_result, "stringToVerify is empty");
 
+    if (m_isVerifyStringBatchingEnabled && m_stringVerifyBatcher != nullptr)
+    {
+        return m_stringVerifyBatcher->verify_string(stringToVerify);
+    }
+
     std::vector<string_t> stringsToVerify;
     stringsToVerify.push_back(stringToVerify);
     return verify_strings(std::vector<string_t>(stringsToVerify))
@@ -56,15 +75,38 @@ string_service::verify_string(_In_ const string_t& stringToVerify)
     });
 }
 
+bool
+string_service::verify_string_batching_enabled() const
+{
+    return m_isVerifyStringBatchingEnabled;
+}
+
+void
+string_service::set_verify_string_batching_enabled(_In_ bool enabled)
+{
+    m_isVerifyStringBatchingEnabled = enabled;
+}
+
 pplx::task<xbox_live_result<std::vector<verify_string_result>>>
 string_service::verify_strings(_In_ const std::vector<string_t>& stringsToVerify)
 {
     RETURN_TASK_CPP_INVALIDARGUMENT_IF_STRING_EMPTY(stringsToVerify, std::vector<verify_string_result>, "stringsToVerify is empty");
 
+    return send_verify_strings_request(m_userContext, m_xboxLiveContextSettings, m_appConfig, stringsToVerify);
+}
+
+pplx::task<xbox_live_result<std::vector<verify_string_result>>>
+string_service::send_verify_strings_request(
+    _In_ const std::shared_ptr<xbox::services::user_context>& userContext,
+    _In_ const std::shared_ptr<xbox::services::xbox_live_context_settings>& xboxLiveContextSettings,
+    _In_ const std::shared_ptr<xbox::services::xbox_live_app_config>& appConfig,
+    _In_ const std::vector<string_t>& stringsToVerify
+    )
+{
     std::shared_ptr<http_call> httpCall = xbox::services::system::xbox_system_factory::get_factory()->create_http_call(
-        m_xboxLiveContextSettings,
+        xboxLiveContextSettings,
         _T("POST"),
-        utils::create_xboxlive_endpoint(_T("client-strings"), m_appConfig),
+        utils::create_xboxlive_endpoint(_T("client-strings"), appConfig),
         _T("/system/strings/validate"),
         xbox_live_api::verify_strings
         );
@@ -80,7 +122,7 @@ string_service::verify_strings(_In_ const std::vector<string_t>& stringsToVerify
     httpCall->set_request_body(request.serialize());
     httpCall->set_xbox_contract_version_header_value(_T("2"));
 
-    return httpCall->get_response_with_auth(m_userContext)
+    return httpCall->get_response_with_auth(userContext)
     .then([](std::shared_ptr<http_call_response> response)
     {
         std::error_code errc = xbox_live_error_code::no_error;
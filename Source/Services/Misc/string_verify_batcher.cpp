@@ -0,0 +1,302 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "string_verify_batcher.h"
+#if !XSAPI_U
+#include "ppltasks_extra.h"
+#else
+#include "ppltasks_extra_unix.h"
+#endif
+
+using namespace Concurrency::extras;
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
+
+const std::chrono::milliseconds string_verify_batcher::BATCH_WINDOW = std::chrono::milliseconds(50);
+const size_t string_verify_batcher::MAX_STRINGS_PER_BATCH = 20;
+const size_t string_verify_batcher::MAX_CACHED_VERDICTS = 512;
+
+string_verify_batcher::string_verify_batcher(
+    _In_ std::chrono::milliseconds batchWindow,
+    _In_ size_t maxStringsPerBatch,
+    _In_ size_t maxCachedVerdicts,
+    _In_ std::function<pplx::task<xbox_live_result<std::vector<verify_string_result>>>(const std::vector<string_t>&)> sendHandler
+    ) :
+    m_batchWindow(batchWindow),
+    m_maxStringsPerBatch(__max(maxStringsPerBatch, static_cast<size_t>(1))),
+    m_maxCachedVerdicts(maxCachedVerdicts),
+    m_sendHandler(std::move(sendHandler)),
+    m_isFlushScheduled(false),
+    m_stringsRequested(0),
+    m_cacheHits(0),
+    m_batchesSent(0),
+    m_stringsSent(0)
+{
+    XSAPI_ASSERT(m_sendHandler != nullptr);
+}
+
+string_verify_batcher::verdict_key
+string_verify_batcher::make_key(
+    _In_ const string_t& text,
+    _In_ const string_t& locales
+    )
+{
+    verdict_key key;
+    key.text = text;
+    key.locales = locales;
+    std::hash<string_t> hasher;
+    size_t textHash = hasher(text);
+    key.hash = textHash ^ (hasher(locales) + 0x9e3779b9 + (textHash << 6) + (textHash >> 2));
+    return key;
+}
+
+pplx::task<xbox_live_result<verify_string_result>>
+string_verify_batcher::verify_string(
+    _In_ const string_t& stringToVerify
+    )
+{
+    auto key = make_key(stringToVerify, utils::get_locales());
+    pplx::task_completion_event<xbox_live_result<verify_string_result>> tce;
+    std::vector<pending_string> fullBatch;
+    bool scheduleFlush = false;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        ++m_stringsRequested;
+
+        auto verdictIter = m_verdicts.find(key);
+        if (verdictIter != m_verdicts.end())
+        {
+            ++m_cacheHits;
+            m_lruOrder.splice(m_lruOrder.begin(), m_lruOrder, verdictIter->second.lruPosition);
+            return pplx::task_from_result(xbox_live_result<verify_string_result>(verdictIter->second.result));
+        }
+
+        auto pendingIter = m_pendingIndices.find(key);
+        if (pendingIter != m_pendingIndices.end())
+        {
+            m_pendingBatch[pendingIter->second].waiters.push_back(tce);
+        }
+        else
+        {
+            m_pendingIndices[key] = m_pendingBatch.size();
+            pending_string pendingString;
+            pendingString.key = std::move(key);
+            pendingString.waiters.push_back(tce);
+            m_pendingBatch.push_back(std::move(pendingString));
+        }
+
+        if (m_pendingBatch.size() >= m_maxStringsPerBatch)
+        {
+            fullBatch.swap(m_pendingBatch);
+            m_pendingIndices.clear();
+        }
+        else if (!m_isFlushScheduled)
+        {
+            m_isFlushScheduled = true;
+            scheduleFlush = true;
+        }
+    }
+
+    if (!fullBatch.empty())
+    {
+        send_batch(std::move(fullBatch));
+    }
+    else if (scheduleFlush)
+    {
+        std::weak_ptr<string_verify_batcher> thisWeakPtr = shared_from_this();
+        create_delayed_task(
+            m_batchWindow,
+            [thisWeakPtr]()
+        {
+            std::shared_ptr<string_verify_batcher> pThis(thisWeakPtr.lock());
+            if (pThis != nullptr)
+            {
+                pThis->flush();
+            }
+        });
+    }
+
+    return pplx::create_task(tce);
+}
+
+void
+string_verify_batcher::flush()
+{
+    std::vector<pending_string> batch;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_isFlushScheduled = false;
+        batch.swap(m_pendingBatch);
+        m_pendingIndices.clear();
+    }
+
+    if (!batch.empty())
+    {
+        send_batch(std::move(batch));
+    }
+}
+
+void
+string_verify_batcher::send_batch(
+    _In_ std::vector<pending_string> batch
+    )
+{
+    std::vector<string_t> strings;
+    strings.reserve(batch.size());
+    for (const auto& pendingString : batch)
+    {
+        strings.push_back(pendingString.key.text);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        ++m_batchesSent;
+        m_stringsSent += strings.size();
+    }
+
+    std::weak_ptr<string_verify_batcher> thisWeakPtr = shared_from_this();
+    auto sharedBatch = std::make_shared<std::vector<pending_string>>(std::move(batch));
+    m_sendHandler(strings)
+    .then([thisWeakPtr, sharedBatch](pplx::task<xbox_live_result<std::vector<verify_string_result>>> resultsTask)
+    {
+        xbox_live_result<std::vector<verify_string_result>> results;
+        try
+        {
+            results = resultsTask.get();
+        }
+        catch (const std::exception&)
+        {
+            results = xbox_live_result<std::vector<verify_string_result>>(xbox_live_error_code::runtime_error, "verify_strings failed");
+        }
+
+        std::shared_ptr<string_verify_batcher> pThis(thisWeakPtr.lock());
+        if (pThis != nullptr)
+        {
+            pThis->complete_batch(*sharedBatch, results);
+        }
+        else
+        {
+            for (auto& pendingString : *sharedBatch)
+            {
+                for (auto& waiter : pendingString.waiters)
+                {
+                    waiter.set(xbox_live_result<verify_string_result>(xbox_live_error_code::runtime_error, "string_service was destroyed"));
+                }
+            }
+        }
+    });
+}
+
+void
+string_verify_batcher::complete_batch(
+    _In_ std::vector<pending_string>& batch,
+    _In_ const xbox_live_result<std::vector<verify_string_result>>& results
+    )
+{
+    const auto& verdicts = results.payload();
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (!results.err())
+        {
+            for (size_t i = 0; i < batch.size() && i < verdicts.size(); ++i)
+            {
+                // Only verdicts on the text itself are worth keeping, not failures to check it
+                if (verdicts[i].result_code() != verify_string_result_code::unknown_error)
+                {
+                    cache_verdict(batch[i].key, verdicts[i]);
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        xbox_live_result<verify_string_result> result;
+        if (i < verdicts.size())
+        {
+            result = xbox_live_result<verify_string_result>(verdicts[i], results.err(), results.err_message());
+        }
+        else if (results.err() == xbox_live_error_condition::generic_error)
+        {
+            result = xbox_live_result<verify_string_result>(xbox_live_error_code::json_error, "string validation result not fond");
+        }
+        else
+        {
+            result = xbox_live_result<verify_string_result>(results.err(), results.err_message());
+        }
+
+        for (auto& waiter : batch[i].waiters)
+        {
+            waiter.set(result);
+        }
+    }
+}
+
+void
+string_verify_batcher::cache_verdict(
+    _In_ const verdict_key& key,
+    _In_ const verify_string_result& result
+    )
+{
+    if (m_maxCachedVerdicts == 0)
+    {
+        return;
+    }
+
+    auto verdictIter = m_verdicts.find(key);
+    if (verdictIter != m_verdicts.end())
+    {
+        verdictIter->second.result = result;
+        m_lruOrder.splice(m_lruOrder.begin(), m_lruOrder, verdictIter->second.lruPosition);
+        return;
+    }
+
+    if (m_verdicts.size() >= m_maxCachedVerdicts)
+    {
+        m_verdicts.erase(m_lruOrder.back());
+        m_lruOrder.pop_back();
+    }
+
+    m_lruOrder.push_front(key);
+    cached_verdict verdict;
+    verdict.result = result;
+    verdict.lruPosition = m_lruOrder.begin();
+    m_verdicts[key] = verdict;
+}
+
+uint64_t
+string_verify_batcher::strings_requested() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_stringsRequested;
+}
+
+uint64_t
+string_verify_batcher::cache_hits() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_cacheHits;
+}
+
+uint64_t
+string_verify_batcher::batches_sent() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_batchesSent;
+}
+
+uint64_t
+string_verify_batcher::strings_sent() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_stringsSent;
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
@@ -0,0 +1,115 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+#include "xsapi/types.h"
+#include "xsapi/system.h"
+#include <list>
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
+
+/// <summary>
+/// Gathers verify_string calls made within a short window into a single verify_strings request, and
+/// remembers recent verdicts so strings that keep coming up, like common chat phrases, aren't sent again.
+/// Identical strings waiting in the same batch are only sent once. Verdicts are cached per locale since
+/// the service checks strings against the caller's locales.
+/// </summary>
+class string_verify_batcher : public std::enable_shared_from_this<string_verify_batcher>
+{
+public:
+    static const std::chrono::milliseconds BATCH_WINDOW;
+    static const size_t MAX_STRINGS_PER_BATCH;
+    static const size_t MAX_CACHED_VERDICTS;
+
+    string_verify_batcher(
+        _In_ std::chrono::milliseconds batchWindow,
+        _In_ size_t maxStringsPerBatch,
+        _In_ size_t maxCachedVerdicts,
+        _In_ std::function<pplx::task<xbox_live_result<std::vector<verify_string_result>>>(const std::vector<string_t>&)> sendHandler
+        );
+
+    pplx::task<xbox_live_result<verify_string_result>> verify_string(
+        _In_ const string_t& stringToVerify
+        );
+
+    uint64_t strings_requested() const;
+    uint64_t cache_hits() const;
+    uint64_t batches_sent() const;
+    uint64_t strings_sent() const;
+
+private:
+    struct verdict_key
+    {
+        string_t text;
+        string_t locales;
+        size_t hash;
+
+        bool operator==(_In_ const verdict_key& other) const
+        {
+            return hash == other.hash && text == other.text && locales == other.locales;
+        }
+    };
+
+    struct verdict_key_hash
+    {
+        size_t operator()(_In_ const verdict_key& key) const { return key.hash; }
+    };
+
+    struct cached_verdict
+    {
+        verify_string_result result;
+        std::list<verdict_key>::iterator lruPosition;
+    };
+
+    struct pending_string
+    {
+        verdict_key key;
+        std::vector<pplx::task_completion_event<xbox_live_result<verify_string_result>>> waiters;
+    };
+
+    static verdict_key make_key(
+        _In_ const string_t& text,
+        _In_ const string_t& locales
+        );
+
+    void flush();
+
+    void send_batch(
+        _In_ std::vector<pending_string> batch
+        );
+
+    void complete_batch(
+        _In_ std::vector<pending_string>& batch,
+        _In_ const xbox_live_result<std::vector<verify_string_result>>& results
+        );
+
+    // Called with m_lock held
+    void cache_verdict(
+        _In_ const verdict_key& key,
+        _In_ const verify_string_result& result
+        );
+
+    std::chrono::milliseconds m_batchWindow;
+    size_t m_maxStringsPerBatch;
+    size_t m_maxCachedVerdicts;
+    std::function<pplx::task<xbox_live_result<std::vector<verify_string_result>>>(const std::vector<string_t>&)> m_sendHandler;
+
+    mutable std::mutex m_lock;
+    std::vector<pending_string> m_pendingBatch;
+    std::unordered_map<verdict_key, size_t, verdict_key_hash> m_pendingIndices;
+    bool m_isFlushScheduled;
+    std::list<verdict_key> m_lruOrder;
+    std::unordered_map<verdict_key, cached_verdict, verdict_key_hash> m_verdicts;
+    uint64_t m_stringsRequested;
+    uint64_t m_cacheHits;
+    uint64_t m_batchesSent;
+    uint64_t m_stringsSent;
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
@@ -24,6 +24,15 @@ using namespace Windows::Foundation::Collections;
 #endif
 NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_MANAGER_CPP_BEGIN
 
+// Unit tests drive shoulder taps synchronously, so only duplicate and stale taps are dropped there.
+// Tests that cover coalescing set the window on tap_coalescer() or build their own coalescer.
+const std::chrono::milliseconds TAP_COALESCE_WINDOW_MS =
+#if UNIT_TEST_SERVICES
+std::chrono::milliseconds::zero();
+#else
+std::chrono::milliseconds(50);
+#endif
+
 multiplayer_client_manager::multiplayer_client_manager(const multiplayer_client_manager& other) 
 {
     std::lock_guard<std::mutex> lock(other.m_clientRequestLock);
@@ -34,6 +43,8 @@ multiplayer_client_manager::multiplayer_client_manager(const multiplayer_client_
     m_primaryXboxLiveContext = other.m_primaryXboxLiveContext == nullptr ? nullptr : other.m_primaryXboxLiveContext;
     m_lastPendingRead = other.m_lastPendingRead == nullptr ? nullptr : other.m_lastPendingRead;
     m_latestPendingRead = other.m_latestPendingRead == nullptr ? nullptr : other.m_latestPendingRead;
+    m_tapCoalescer = other.m_tapCoalescer;
+    m_wantedEventTypes = other.m_wantedEventTypes.load();
 }
 
 multiplayer_client_manager::multiplayer_client_manager(
@@ -44,6 +55,7 @@ multiplayer_client_manager::multiplayer_client_manager(
     m_subscriptionLostContext(0),
     m_rtaResyncContext(0),
     m_subscriptionsLostFired(false),
+    m_wantedEventTypes(UINT32_MAX),
     m_autoFillMembers(false)
 {
     m_multiplayerLocalUserManager = std::make_shared<multiplayer_local_user_manager>();
@@ -53,6 +65,22 @@ void
 multiplayer_client_manager::register_local_user_manager_events()
 {
     std::weak_ptr<multiplayer_client_manager> thisWeakPtr = shared_from_this();
+    m_tapCoalescer = std::make_shared<multiplayer_session_tap_coalescer>(
+        TAP_COALESCE_WINDOW_MS,
+        [thisWeakPtr](_In_ const multiplayer_session_reference& sessionRef)
+        {
+            std::shared_ptr<multiplayer_client_manager> pThis(thisWeakPtr.lock());
+            return pThis != nullptr ? pThis->local_session_change_number(sessionRef) : 0;
+        },
+        [thisWeakPtr](_In_ const multiplayer_session_change_event_args& args)
+        {
+            std::shared_ptr<multiplayer_client_manager> pThis(thisWeakPtr.lock());
+            if (pThis != nullptr)
+            {
+                pThis->dispatch_session_changed(args);
+            }
+        });
+
     m_sessionChangedContext = m_multiplayerLocalUserManager->add_multiplayer_session_changed_handler([thisWeakPtr](_In_ const multiplayer_session_change_event_args& args)
     {
         std::shared_ptr<multiplayer_client_manager> pThis(thisWeakPtr.lock());
@@ -98,6 +126,7 @@ multiplayer_client_manager::initialize()
     m_lastPendingRead = std::make_shared<multiplayer_client_pending_reader>();
     m_subscriptionsLostFired.store(false);
     m_latestPendingRead->set_auto_fill_members_during_matchmaking(m_autoFillMembers);
+    m_latestPendingRead->match_client()->set_built_in_quality_of_service_measurements(m_qosAddressResolver, m_qosProbeSettings);
 }
 
 void multiplayer_client_manager::shutdown()
@@ -111,6 +140,11 @@ multiplayer_client_manager::destroy()
 {
     m_latestPendingRead.reset();
     m_lastPendingRead.reset();
+    if (m_tapCoalescer != nullptr)
+    {
+        m_tapCoalescer->clear();
+    }
+
     if (m_multiplayerLocalUserManager != nullptr)
     {
         m_multiplayerLocalUserManager->remove_multiplayer_session_changed_handler(m_sessionChangedContext);
@@ -669,7 +703,7 @@ multiplayer_client_manager::do_work()
     process_events(m_latestPendingRead->match_client()->session(), m_lastPendingRead->match_client()->session(), multiplayer_session_type::match_session);
 
     m_lastPendingRead->deep_copy_if_updated(*m_latestPendingRead);
-    auto eventQueue = m_lastPendingRead->multiplayer_event_queue();
+    auto eventQueue = m_lastPendingRead->take_multiplayer_event_queue();
 
     if (get_xbox_live_context_map().size() == 0 && !is_request_in_progress())
     {
@@ -692,6 +726,22 @@ multiplayer_client_manager::do_work()
     return eventQueue;
 }
 
+void
+multiplayer_client_manager::set_wanted_event_types(
+    _In_ uint32_t eventTypes
+    )
+{
+    m_wantedEventTypes = eventTypes;
+}
+
+bool
+multiplayer_client_manager::is_event_type_wanted(
+    _In_ multiplayer_event_type eventType
+    ) const
+{
+    return (m_wantedEventTypes & multiplayer_manager_utils::event_type_bit(eventType)) != 0;
+}
+
 std::map<string_t, std::shared_ptr<multiplayer_local_user>>
 multiplayer_client_manager::get_xbox_live_context_map()
 {
@@ -753,6 +803,58 @@ void
 multiplayer_client_manager::on_session_changed(
     _In_ const multiplayer_session_change_event_args& args
     )
+{
+    // Every local user's subscription delivers the same taps, and busy sessions send them in bursts.
+    // Let the coalescer decide which of them are worth a session fetch.
+    auto tapCoalescer = m_tapCoalescer;
+    if (tapCoalescer != nullptr)
+    {
+        tapCoalescer->on_session_changed(args);
+    }
+    else
+    {
+        dispatch_session_changed(args);
+    }
+}
+
+std::shared_ptr<multiplayer_session_tap_coalescer>
+multiplayer_client_manager::tap_coalescer() const
+{
+    return m_tapCoalescer;
+}
+
+uint64_t
+multiplayer_client_manager::local_session_change_number(
+    _In_ const multiplayer_session_reference& sessionRef
+    )
+{
+    auto latestPendingRead = m_latestPendingRead;
+    if (latestPendingRead == nullptr)
+    {
+        return 0;
+    }
+
+    std::shared_ptr<multiplayer_session> localSession;
+    if (latestPendingRead->is_lobby(sessionRef))
+    {
+        localSession = latestPendingRead->lobby_client()->session();
+    }
+    else if (latestPendingRead->is_game(sessionRef))
+    {
+        localSession = latestPendingRead->game_client()->session();
+    }
+    else if (latestPendingRead->is_match(sessionRef))
+    {
+        localSession = latestPendingRead->match_client()->session();
+    }
+
+    return localSession != nullptr ? localSession->change_number() : 0;
+}
+
+void
+multiplayer_client_manager::dispatch_session_changed(
+    _In_ const multiplayer_session_change_event_args& args
+    )
 {
     std::lock_guard<std::mutex> guard(m_synchronizeWriteWithTapLock);
 
@@ -810,6 +912,8 @@ multiplayer_client_manager::add_multiplayer_event_helper(
     _In_ std::string errorMessage
     )
 {
+    // Queued whatever the wanted types are: is_update_avaialable watches the queue sizes, and
+    // do_work relies on that to tear down after client_disconnected_from_multiplayer_service.
     multiplayer_event multiplayerEvent(
         errorCode,
         errorMessage,
@@ -871,24 +975,29 @@ multiplayer_client_manager::process_events(
 
     multiplayer_session_change_types diffType = diff.payload();
 
+    // Changes of event types the title doesn't want are skipped before their event args are built
     if (sessionType != multiplayer_session_type::match_session)
     {
-        if (multiplayer_manager_utils::is_multiplayer_session_change_type(diffType, multiplayer_session_change_types::host_device_token_change))
+        if (multiplayer_manager_utils::is_multiplayer_session_change_type(diffType, multiplayer_session_change_types::host_device_token_change) &&
+            is_event_type_wanted(multiplayer_event_type::host_changed))
         {
             handle_host_changed(currentSession, sessionType);
         }
 
-        if (multiplayer_manager_utils::is_multiplayer_session_change_type(diffType, multiplayer_session_change_types::member_list_change))
+        if (multiplayer_manager_utils::is_multiplayer_session_change_type(diffType, multiplayer_session_change_types::member_list_change) &&
+            (is_event_type_wanted(multiplayer_event_type::member_joined) || is_event_type_wanted(multiplayer_event_type::member_left)))
         {
             handle_member_list_changed(currentSession, oldSession, sessionType);
         }
 
+        // Always handled, since a lobby property change can start joining the game
         if (multiplayer_manager_utils::is_multiplayer_session_change_type(diffType, multiplayer_session_change_types::custom_property_change))
         {
             handle_session_properties_changed(currentSession, oldSession, sessionType);
         }
 
-        if (multiplayer_manager_utils::is_multiplayer_session_change_type(diffType, multiplayer_session_change_types::member_custom_property_change))
+        if (multiplayer_manager_utils::is_multiplayer_session_change_type(diffType, multiplayer_session_change_types::member_custom_property_change) &&
+            is_event_type_wanted(multiplayer_event_type::member_property_changed))
         {
             handle_member_properties_changed(currentSession, oldSession, sessionType);
         }
@@ -965,7 +1074,7 @@ multiplayer_client_manager::handle_member_list_changed(
 
     if (haveMembersJoined || haveMembersLeft)
     {
-        if (haveMembersJoined)
+        if (haveMembersJoined && is_event_type_wanted(multiplayer_event_type::member_joined))
         {
             std::vector<std::shared_ptr<multiplayer_member>> gameMembers;
             for (const auto& member : membersJoined)
@@ -988,7 +1097,7 @@ multiplayer_client_manager::handle_member_list_changed(
             add_to_multiplayer_event_queue(multiplayerEvent);
         }
 
-        if (haveMembersLeft)
+        if (haveMembersLeft && is_event_type_wanted(multiplayer_event_type::member_left))
         {
             std::vector<std::shared_ptr<multiplayer_member>> gameMembers;
             for (const auto& member : membersLeft)
@@ -1100,7 +1209,8 @@ multiplayer_client_manager::handle_session_properties_changed(
     }
 
     // Don't trigger property changed event if the transfer handle property changes.
-    if (multiplayer_manager_utils::has_session_property_changed(currentSession, oldSession, multiplayer_lobby_client::c_transferHandlePropertyName) ||
+    if (!is_event_type_wanted(multiplayer_event_type::session_property_changed) ||
+        multiplayer_manager_utils::has_session_property_changed(currentSession, oldSession, multiplayer_lobby_client::c_transferHandlePropertyName) ||
         multiplayer_manager_utils::has_session_property_changed(currentSession, oldSession, multiplayer_lobby_client::c_joinabilityPropertyName))
     {
         return;
@@ -1159,8 +1269,9 @@ multiplayer_client_manager::handle_tournament_properties_changed(
 {
     auto currTournamentsServer = currentSession->tournaments_server();
     auto oldTournamentsServer = oldSession->tournaments_server();
-    if (currTournamentsServer.registration_state() != oldTournamentsServer.registration_state() ||
-        currTournamentsServer.registration_reason() != oldTournamentsServer.registration_reason())
+    if ((currTournamentsServer.registration_state() != oldTournamentsServer.registration_state() ||
+        currTournamentsServer.registration_reason() != oldTournamentsServer.registration_reason()) &&
+        is_event_type_wanted(multiplayer_event_type::tournament_registration_state_changed))
     {
         auto registrationStateChangedEventArgs = std::make_shared<tournament_registration_state_changed_event_args>(
             currTournamentsServer.registration_state(),
@@ -1217,4 +1328,18 @@ multiplayer_client_manager::set_auto_fill_members_during_matchmaking(
     }
 }
 
+void
+multiplayer_client_manager::set_built_in_quality_of_service_measurements(
+    _In_ std::function<string_t(const string_t&)> addressResolver,
+    _In_ const qos_probe_settings& settings
+    )
+{
+    m_qosAddressResolver = addressResolver;
+    m_qosProbeSettings = settings;
+    if (latest_pending_read() != nullptr)
+    {
+        latest_pending_read()->match_client()->set_built_in_quality_of_service_measurements(addressResolver, settings);
+    }
+}
+
 NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_MANAGER_CPP_END
\ No newline at end of file
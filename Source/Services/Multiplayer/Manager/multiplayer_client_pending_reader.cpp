@@ -211,6 +211,15 @@ multiplayer_client_pending_reader::multiplayer_event_queue() const
     return m_multiplayerEventQueue;
 }
 
+std::vector<multiplayer_event>
+multiplayer_client_pending_reader::take_multiplayer_event_queue()
+{
+    std::lock_guard<std::mutex> lock(m_clientRequestLock);
+    std::vector<multiplayer_event> eventQueue;
+    eventQueue.swap(m_multiplayerEventQueue);
+    return eventQueue;
+}
+
 void
 multiplayer_client_pending_reader::add_to_multiplayer_event_queue(
     _In_ multiplayer_event multiplayerEvent
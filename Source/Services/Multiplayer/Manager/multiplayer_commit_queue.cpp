@@ -0,0 +1,65 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include "pch.h"
+#include "multiplayer_manager_internal.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_MANAGER_CPP_BEGIN
+
+multiplayer_commit_queue::multiplayer_commit_queue() :
+    m_lastCommitTask(pplx::task_from_result()),
+    m_queuedCommitCount(0)
+{
+}
+
+pplx::task<void>
+multiplayer_commit_queue::enqueue(
+    _In_ std::function<pplx::task<void>()> commitOperation
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    ++m_queuedCommitCount;
+
+    std::weak_ptr<multiplayer_commit_queue> thisWeakPtr = shared_from_this();
+    m_lastCommitTask = m_lastCommitTask.then([commitOperation]()
+    {
+        return commitOperation();
+    })
+    .then([thisWeakPtr](pplx::task<void> commitTask)
+    {
+        try
+        {
+            commitTask.get();
+        }
+        catch (...)
+        {
+            LOG_ERROR("multiplayer_commit_queue commit operation threw an exception");
+        }
+
+        std::shared_ptr<multiplayer_commit_queue> pThis(thisWeakPtr.lock());
+        if (pThis != nullptr)
+        {
+            std::lock_guard<std::mutex> lock(pThis->m_lock);
+            --pThis->m_queuedCommitCount;
+        }
+    });
+
+    return m_lastCommitTask;
+}
+
+bool
+multiplayer_commit_queue::is_idle() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_queuedCommitCount == 0;
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_MANAGER_CPP_END
@@ -18,9 +18,9 @@ using namespace xbox::services::multiplayer;
 NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_MANAGER_CPP_BEGIN
 
 multiplayer_game_client::multiplayer_game_client() :
-    m_updateNumber(0),
-    m_pendingCommitInProgress(false)
+    m_updateNumber(0)
 {
+    m_commitQueue = std::make_shared<multiplayer_commit_queue>();
     m_sessionWriter = std::make_shared<multiplayer_session_writer>();
 }
 
@@ -28,9 +28,9 @@ multiplayer_game_client::multiplayer_game_client(
     _In_ std::shared_ptr<multiplayer_local_user_manager> localUserManager
     ) :
     m_multiplayerLocalUserManager(localUserManager),
-    m_updateNumber(0),
-    m_pendingCommitInProgress(false)
+    m_updateNumber(0)
 {
+    m_commitQueue = std::make_shared<multiplayer_commit_queue>();
     m_sessionWriter = std::make_shared<multiplayer_session_writer>(m_multiplayerLocalUserManager);
 }
 
@@ -275,55 +275,57 @@ multiplayer_game_client::get_processing_queue()
 std::vector<multiplayer_event>
 multiplayer_game_client::do_work()
 {
-    bool expected = false;
-    if (m_pendingCommitInProgress.compare_exchange_strong(expected, true))
+    // Requests that arrive while a commit is in flight are batched into the next one
+    if (m_commitQueue->is_idle() && m_pendingRequestQueue.size() > 0)
     {
-        if (m_pendingRequestQueue.size() > 0)
+        std::vector<std::shared_ptr<multiplayer_client_pending_request>> processingQueue;
+        bool applySynchronizedChanges = false;
+        bool doneProcessing = false;
+        do
         {
-            std::vector<std::shared_ptr<multiplayer_client_pending_request>> processingQueue;
-            bool applySynchronizedChanges = false;
-            bool doneProcessing = false;
-            do
+            std::lock_guard<std::mutex> lock(m_clientRequestLock);
             {
-                std::lock_guard<std::mutex> lock(m_clientRequestLock);
-                {
-                    auto pendingRequest = m_pendingRequestQueue.front();
-                    processingQueue.push_back(pendingRequest);
-                    m_pendingRequestQueue.pop();
+                auto pendingRequest = m_pendingRequestQueue.front();
+                processingQueue.push_back(pendingRequest);
+                m_pendingRequestQueue.pop();
 
-                    if (m_pendingRequestQueue.size() > 0)
+                if (m_pendingRequestQueue.size() > 0)
+                {
+                    if (pendingRequest->request_type() != m_pendingRequestQueue.front()->request_type())
                     {
-                        if (pendingRequest->request_type() != m_pendingRequestQueue.front()->request_type())
-                        {
-                            doneProcessing = true;
-                        }
+                        doneProcessing = true;
                     }
+                }
 
-                    if (!applySynchronizedChanges && pendingRequest->request_type() == pending_request_type::synchronized_changes)
-                    {
-                        applySynchronizedChanges = true;
-                    }
+                if (!applySynchronizedChanges && pendingRequest->request_type() == pending_request_type::synchronized_changes)
+                {
+                    applySynchronizedChanges = true;
                 }
+            }
+
+        } while (!doneProcessing && m_pendingRequestQueue.size() > 0);
 
-            } while (!doneProcessing && m_pendingRequestQueue.size() > 0);
+        if (processingQueue.size() > 0)
+        {
+            add_to_processing_queue(processingQueue);
 
-            if (processingQueue.size() > 0)
+            std::weak_ptr<multiplayer_game_client> thisWeakPtr = shared_from_this();
+            m_commitQueue->enqueue([thisWeakPtr, processingQueue, applySynchronizedChanges]()
             {
-                add_to_processing_queue(processingQueue);
+                std::shared_ptr<multiplayer_game_client> pThis(thisWeakPtr.lock());
+                if (pThis == nullptr) return pplx::task_from_result();
+
                 pplx::task<xbox_live_result<std::vector<multiplayer_event>>> asyncOp;
                 if (applySynchronizedChanges)
                 {
-                    asyncOp = m_sessionWriter->commit_pending_synchronized_changes(processingQueue, multiplayer_session_type::game_session);
+                    asyncOp = pThis->m_sessionWriter->commit_pending_synchronized_changes(processingQueue, multiplayer_session_type::game_session);
                 }
                 else
                 {
-                    asyncOp = m_sessionWriter->commit_pending_changes(processingQueue, multiplayer_session_type::game_session);
+                    asyncOp = pThis->m_sessionWriter->commit_pending_changes(processingQueue, multiplayer_session_type::game_session);
                 }
 
-                std::weak_ptr<multiplayer_game_client> thisWeakPtr = shared_from_this();
-
-                create_task(asyncOp)
-                .then([thisWeakPtr, processingQueue](xbox_live_result<std::vector<multiplayer_event>> result)
+                return asyncOp.then([thisWeakPtr, processingQueue](xbox_live_result<std::vector<multiplayer_event>> result)
                 {
                     std::shared_ptr<multiplayer_game_client> pThis(thisWeakPtr.lock());
                     if (pThis != nullptr)
@@ -341,19 +343,9 @@ multiplayer_game_client::do_work()
                         {
                             pThis->remove_from_processing_queue(processingRequest->identifier());
                         }
-
-                        pThis->m_pendingCommitInProgress.store(false);
                     }
                 });
-            }
-            else
-            {
-                m_pendingCommitInProgress.store(false);
-            }
-        }
-        else
-        {
-            m_pendingCommitInProgress.store(false);
+            });
         }
     }
 
@@ -409,37 +401,30 @@ multiplayer_game_client::set_local_member_properties_to_remote_session(
     }
 
     std::weak_ptr<multiplayer_game_client> thisWeakPtr = shared_from_this();
-    pplx::create_task([thisWeakPtr, localUser, localUserMap, localUserConnectionAddress]()
+    m_commitQueue->enqueue([thisWeakPtr, localUser, localUserMap, localUserConnectionAddress]()
     {
         std::shared_ptr<multiplayer_game_client> pThis(thisWeakPtr.lock());
-        if (pThis == nullptr) return;
+        if (pThis == nullptr) return pplx::task_from_result();
+
+        auto gameSession = pThis->session();
+        if (gameSession == nullptr) return pplx::task_from_result();
 
-        bool expected = false;
-        while (!pThis->m_pendingCommitInProgress.compare_exchange_weak(expected, true))
+        auto sessionToCommit = std::make_shared<multiplayer_session>(localUser->xbox_user_id(), gameSession->session_reference());
+        sessionToCommit->join(web::json::value::null(), false, true, false);
+        for (const auto& prop : localUserMap)
         {
-            expected = false;
-            utils::sleep(0);
+            sessionToCommit->set_current_user_member_custom_property_json(prop.first, prop.second);
         }
 
-        auto gameSession = pThis->session();
-        if (gameSession != nullptr)
+        if (!localUserConnectionAddress.empty())
         {
-            auto sessionToCommit = std::make_shared<multiplayer_session>(localUser->xbox_user_id(), gameSession->session_reference());
-            sessionToCommit->join(web::json::value::null(), false, true, false);
-            for (const auto& prop : localUserMap)
-            {
-                sessionToCommit->set_current_user_member_custom_property_json(prop.first, prop.second);
-            }
-
-            if (!localUserConnectionAddress.empty())
-            {
-                sessionToCommit->set_current_user_secure_device_address_base64(localUserConnectionAddress);
-            }
-            
-            pThis->m_sessionWriter->write_session(localUser->context(), sessionToCommit, multiplayer_session_write_mode::update_existing).get();
+            sessionToCommit->set_current_user_secure_device_address_base64(localUserConnectionAddress);
         }
 
-        pThis->m_pendingCommitInProgress = false;
+        return pThis->m_sessionWriter->write_session(localUser->context(), sessionToCommit, multiplayer_session_write_mode::update_existing)
+        .then([](xbox_live_result<std::shared_ptr<multiplayer_session>>)
+        {
+        });
     });
 }
 
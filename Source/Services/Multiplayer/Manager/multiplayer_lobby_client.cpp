@@ -19,10 +19,10 @@ const string_t multiplayer_lobby_client::c_transferHandlePropertyName = _T("Game
 const string_t multiplayer_lobby_client::c_joinabilityPropertyName = _T("Joinability");
 
 multiplayer_lobby_client::multiplayer_lobby_client() :
-    m_pendingCommitInProgress(false),
     m_updateNumber(0),
     m_joinability(joinability::none)
 {
+    m_commitQueue = std::make_shared<multiplayer_commit_queue>();
     m_sessionWriter = std::make_shared<multiplayer_session_writer>();
 }
 
@@ -32,10 +32,10 @@ multiplayer_lobby_client::multiplayer_lobby_client(
     ) :
     m_lobbySessionTemplateName(std::move(lobbySessionTemplateName)),
     m_multiplayerLocalUserManager(localUserManager),
-    m_pendingCommitInProgress(false),
     m_updateNumber(0),
     m_joinability(joinability::none)
 {
+    m_commitQueue = std::make_shared<multiplayer_commit_queue>();
     m_sessionWriter = std::make_shared<multiplayer_session_writer>(localUserManager);
 }
 
@@ -500,93 +500,95 @@ xbox_live_result<void> multiplayer_lobby_client::set_joinability(
 std::vector<multiplayer_event>
 multiplayer_lobby_client::do_work()
 {
-    bool expected = false;
-    if (m_pendingCommitInProgress.compare_exchange_strong(expected, true))
+    // Requests that arrive while a commit is in flight are batched into the next one
+    if (m_commitQueue->is_idle() && m_pendingRequestQueue.size() > 0)
     {
-        if (m_pendingRequestQueue.size() > 0)
+        std::vector<std::shared_ptr<multiplayer_client_pending_request>> processingQueue;
+        multiplayer_session_reference teamSessionRef;
+        bool applySynchronizedChanges = false;
+        bool joinByHandleId = false;
+        bool doneProcessing = false;
+        do
         {
-            std::vector<std::shared_ptr<multiplayer_client_pending_request>> processingQueue;
-            multiplayer_session_reference teamSessionRef;
-            bool applySynchronizedChanges = false;
-            bool joinByHandleId = false;
-            bool doneProcessing = false;
-            do
+            std::lock_guard<std::mutex> lock(m_clientRequestLock);
             {
-                std::lock_guard<std::mutex> lock(m_clientRequestLock);
-                {
-                    auto pendingRequest = m_pendingRequestQueue.front();
-                    processingQueue.push_back(pendingRequest);
-                    m_pendingRequestQueue.pop();
+                auto pendingRequest = m_pendingRequestQueue.front();
+                processingQueue.push_back(pendingRequest);
+                m_pendingRequestQueue.pop();
 
-                    if (m_pendingRequestQueue.size() > 0)
+                if (m_pendingRequestQueue.size() > 0)
+                {
+                    if (pendingRequest->request_type() != m_pendingRequestQueue.front()->request_type())
                     {
-                        if (pendingRequest->request_type() != m_pendingRequestQueue.front()->request_type())
-                        {
-                            doneProcessing = true;
-                        }
+                        doneProcessing = true;
                     }
+                }
 
-                    if (!applySynchronizedChanges && pendingRequest->request_type() == pending_request_type::synchronized_changes)
-                    {
-                        applySynchronizedChanges = true;
-                    }
+                if (!applySynchronizedChanges && pendingRequest->request_type() == pending_request_type::synchronized_changes)
+                {
+                    applySynchronizedChanges = true;
+                }
 
-                    if (pendingRequest->local_user() != nullptr)
+                if (pendingRequest->local_user() != nullptr)
+                {
+                    auto lobbyState = pendingRequest->lobby_state();
+                    if (lobbyState == multiplayer_local_user_lobby_state::join)
                     {
-                        auto lobbyState = pendingRequest->lobby_state();
-                        if (lobbyState == multiplayer_local_user_lobby_state::join)
+                        // Leave existing lobby without updating the latest as the leave may comeback after the actual join and overwrite it.
+                        auto latestSession = m_sessionWriter->session();
+                        if (latestSession != nullptr)
                         {
-                            // Leave existing lobby without updating the latest as the leave may comeback after the actual join and overwrite it.
-                            auto latestSession = m_sessionWriter->session();
-                            if (latestSession != nullptr)
-                            {
-                                leave_remote_session(latestSession);
-                            }
+                            leave_remote_session(latestSession);
+                        }
 
-                            m_sessionWriter->update_session(nullptr);
-                            update_lobby(nullptr);
-                            m_localLobbyMembers.clear();
-                            m_joinability = joinability::none;
+                        m_sessionWriter->update_session(nullptr);
+                        update_lobby(nullptr);
+                        m_localLobbyMembers.clear();
+                        m_joinability = joinability::none;
 
-                            if (!pendingRequest->lobby_handle_id().empty())
-                            {
-                                pendingRequest->local_user()->set_lobby_handle_id(pendingRequest->lobby_handle_id());
-                                joinByHandleId = true;
-                            }
-                            else if (!pendingRequest->team_session_reference().is_null())
-                            {
-                                teamSessionRef = pendingRequest->team_session_reference();
-                            }
+                        if (!pendingRequest->lobby_handle_id().empty())
+                        {
+                            pendingRequest->local_user()->set_lobby_handle_id(pendingRequest->lobby_handle_id());
+                            joinByHandleId = true;
                         }
-
-                        if (lobbyState != multiplayer_local_user_lobby_state::unknown)
+                        else if (!pendingRequest->team_session_reference().is_null())
                         {
-                            pendingRequest->local_user()->set_lobby_state(lobbyState);
+                            teamSessionRef = pendingRequest->team_session_reference();
                         }
-                        
-                        pendingRequest->local_user()->set_write_changes_to_service(true);
                     }
+
+                    if (lobbyState != multiplayer_local_user_lobby_state::unknown)
+                    {
+                        pendingRequest->local_user()->set_lobby_state(lobbyState);
+                    }
+                    
+                    pendingRequest->local_user()->set_write_changes_to_service(true);
                 }
+            }
 
-            } while (!doneProcessing && m_pendingRequestQueue.size() > 0);
+        } while (!doneProcessing && m_pendingRequestQueue.size() > 0);
 
-            if (processingQueue.size() > 0)
+        if (processingQueue.size() > 0)
+        {
+            add_to_processing_queue(processingQueue);
+
+            std::weak_ptr<multiplayer_lobby_client> thisWeakPtr = shared_from_this();
+            m_commitQueue->enqueue([thisWeakPtr, processingQueue, applySynchronizedChanges, joinByHandleId, teamSessionRef]()
             {
-                add_to_processing_queue(processingQueue);
+                std::shared_ptr<multiplayer_lobby_client> pThis(thisWeakPtr.lock());
+                if (pThis == nullptr) return pplx::task_from_result();
+
                 pplx::task<xbox_live_result<std::vector<multiplayer_event>>> asyncOp;
                 if (applySynchronizedChanges)
                 {
-                    asyncOp = m_sessionWriter->commit_pending_synchronized_changes(processingQueue, multiplayer_session_type::lobby_session);
+                    asyncOp = pThis->m_sessionWriter->commit_pending_synchronized_changes(processingQueue, multiplayer_session_type::lobby_session);
                 }
                 else
                 {
-                    asyncOp = commit_pending_lobby_changes(joinByHandleId, teamSessionRef);
+                    asyncOp = pThis->commit_pending_lobby_changes(joinByHandleId, teamSessionRef);
                 }
 
-                std::weak_ptr<multiplayer_lobby_client> thisWeakPtr = shared_from_this();
-
-                create_task(asyncOp)
-                .then([thisWeakPtr, processingQueue](xbox_live_result<std::vector<multiplayer_event>> result)
+                return asyncOp.then([thisWeakPtr, processingQueue](xbox_live_result<std::vector<multiplayer_event>> result)
                 {
                     std::shared_ptr<multiplayer_lobby_client> pThis(thisWeakPtr.lock());
                     if (pThis != nullptr)
@@ -604,19 +606,9 @@ multiplayer_lobby_client::do_work()
                         {
                             pThis->remove_from_processing_queue(processingRequest->identifier());
                         }
-
-                        pThis->m_pendingCommitInProgress.store(false);
                     }
                 });
-            }
-            else
-            {
-                m_pendingCommitInProgress.store(false);
-            }
-        }
-        else
-        {
-            m_pendingCommitInProgress.store(false);
+            });
         }
     }
 
@@ -985,46 +977,39 @@ multiplayer_lobby_client::advertise_game_session()
         return;
     }
 
+    // Joining the lobby is a commit, so it waits its turn behind any commit already in flight.
+    auto joinFailed = std::make_shared<bool>(false);
     std::weak_ptr<multiplayer_lobby_client> thisWeakPtr = shared_from_this();
-    pplx::create_task([thisWeakPtr, primaryContext]()
+    m_commitQueue->enqueue([thisWeakPtr, joinFailed]()
     {
         std::shared_ptr<multiplayer_lobby_client> pThis(thisWeakPtr.lock());
-        if (pThis == nullptr) return;
-
-        bool expected = false;
-        while (!pThis->m_pendingCommitInProgress.compare_exchange_strong(expected, true))
+        if (pThis == nullptr || pThis->game_session() == nullptr || pThis->session() != nullptr ||
+            pThis->m_multiplayerLocalUserManager->get_local_user_map().size() == 0)
         {
-            expected = false;
-            utils::sleep(0);
+            return pplx::task_from_result();
         }
 
-        auto lobbySession = pThis->session();
-        if (pThis->game_session() == nullptr) return;
-
-        // If the advertising fails, we simply eat the error as it isn't actionable for the title.
-        if (lobbySession == nullptr)
+        pThis->m_multiplayerLocalUserManager->change_all_local_user_lobby_state(multiplayer_local_user_lobby_state::add);
+        return pThis->commit_pending_lobby_changes(false)
+        .then([thisWeakPtr, joinFailed](xbox_live_result<std::vector<multiplayer_event>> joinLobbyResult)
         {
-            if (pThis->m_multiplayerLocalUserManager->get_local_user_map().size() == 0)
-            {
-                return;
-            }
+            *joinFailed = joinLobbyResult.err() != xbox_live_error_code::no_error;
 
-            pThis->m_multiplayerLocalUserManager->change_all_local_user_lobby_state(multiplayer_local_user_lobby_state::add);
-            auto joinLobbyResult = pThis->commit_pending_lobby_changes(false).get();
-
-            pThis->m_pendingCommitInProgress = false;
-            pThis->join_lobby_completed(joinLobbyResult.err(), joinLobbyResult.err_message(), string_t());
-            if (joinLobbyResult.err())
+            std::shared_ptr<multiplayer_lobby_client> pThis(thisWeakPtr.lock());
+            if (pThis != nullptr)
             {
-                return;
+                pThis->join_lobby_completed(joinLobbyResult.err(), joinLobbyResult.err_message(), string_t());
             }
+        });
+    })
+    .then([thisWeakPtr, primaryContext, joinFailed]()
+    {
+        std::shared_ptr<multiplayer_lobby_client> pThis(thisWeakPtr.lock());
+        if (pThis == nullptr || *joinFailed) return;
 
-            lobbySession = pThis->session();
-        }
-        else
-        {
-            pThis->m_pendingCommitInProgress = false;
-        }
+        // If the advertising fails, we simply eat the error as it isn't actionable for the title.
+        auto lobbySession = pThis->session();
+        if (lobbySession == nullptr || pThis->game_session() == nullptr) return;
 
         auto lobbyProperties = lobbySession->session_properties()->session_custom_properties_json();
         if (!lobbyProperties.has_field(c_transferHandlePropertyName) ||
@@ -25,7 +25,9 @@ static std::mutex s_singletonLock;
 
 multiplayer_manager::multiplayer_manager() :
     m_joinability(joinability::none),
-    m_isDirty(false)
+    m_isDirty(false),
+    m_eventHandlerCounter(0),
+    m_returnedEventTypes(UINT32_MAX)
 {
 }
 
@@ -63,6 +65,7 @@ multiplayer_manager::initialize(
         );
 
     m_multiplayerClientManager->register_local_user_manager_events();
+    m_multiplayerClientManager->set_wanted_event_types(wanted_event_types());
     m_multiplayerLobbySession = std::make_shared<multiplayer_lobby_session>(m_multiplayerClientManager);
 }
 
@@ -74,9 +77,140 @@ multiplayer_manager::_Is_dirty()
 
 std::vector<multiplayer_event>
 multiplayer_manager::do_work()
+{
+    std::vector<multiplayer_event> eventQueue;
+    std::vector<event_handler> eventHandlers;
+    uint32_t returnedEventTypes;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        eventQueue = collect_events();
+        returnedEventTypes = m_returnedEventTypes;
+        for (const auto& eventHandler : m_eventHandlers)
+        {
+            eventHandlers.push_back(eventHandler.second);
+        }
+
+        uint32_t wantedEventTypes = wanted_event_types();
+        m_lastEventCounts.clear();
+        for (const auto& multiplayerEvent : eventQueue)
+        {
+            if (wantedEventTypes & multiplayer_manager_utils::event_type_bit(multiplayerEvent.event_type()))
+            {
+                ++m_lastEventCounts[multiplayerEvent.event_type()];
+            }
+        }
+    }
+
+    if (eventHandlers.empty() && returnedEventTypes == UINT32_MAX)
+    {
+        return eventQueue;
+    }
+
+    // Handlers are called without m_lock, so they can use the lobby and game sessions
+    std::vector<multiplayer_event> returnedEvents;
+    for (auto& multiplayerEvent : eventQueue)
+    {
+        for (const auto& eventHandler : eventHandlers)
+        {
+            if (eventHandler.eventType == multiplayerEvent.event_type())
+            {
+                eventHandler.handler(multiplayerEvent);
+            }
+        }
+
+        if (returnedEventTypes & multiplayer_manager_utils::event_type_bit(multiplayerEvent.event_type()))
+        {
+            returnedEvents.push_back(std::move(multiplayerEvent));
+        }
+    }
+
+    return returnedEvents;
+}
+
+function_context
+multiplayer_manager::add_event_handler(
+    _In_ multiplayer_event_type eventType,
+    _In_ std::function<void(const multiplayer_event&)> handler
+    )
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    function_context context = -1;
+    if (handler != nullptr)
+    {
+        context = ++m_eventHandlerCounter;
+        event_handler& eventHandler = m_eventHandlers[context];
+        eventHandler.eventType = eventType;
+        eventHandler.handler = std::move(handler);
+
+        if (m_multiplayerClientManager != nullptr)
+        {
+            m_multiplayerClientManager->set_wanted_event_types(wanted_event_types());
+        }
+    }
+
+    return context;
+}
+
+void
+multiplayer_manager::remove_event_handler(
+    _In_ function_context context
+    )
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_eventHandlers.erase(context);
+    if (m_multiplayerClientManager != nullptr)
+    {
+        m_multiplayerClientManager->set_wanted_event_types(wanted_event_types());
+    }
+}
+
+void
+multiplayer_manager::set_returned_event_types(
+    _In_ const std::vector<multiplayer_event_type>& eventTypes
+    )
 {
     std::lock_guard<std::mutex> guard(m_lock);
+    m_returnedEventTypes = 0;
+    for (auto eventType : eventTypes)
+    {
+        m_returnedEventTypes |= multiplayer_manager_utils::event_type_bit(eventType);
+    }
+
+    // Asking for every type restores the default, which lets do_work skip filtering
+    if (m_returnedEventTypes == (multiplayer_manager_utils::event_type_bit(multiplayer_event_type::arbitration_complete) << 1) - 1)
+    {
+        m_returnedEventTypes = UINT32_MAX;
+    }
+
+    if (m_multiplayerClientManager != nullptr)
+    {
+        m_multiplayerClientManager->set_wanted_event_types(wanted_event_types());
+    }
+}
+
+std::map<multiplayer_event_type, uint32_t>
+multiplayer_manager::last_event_counts() const
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_lastEventCounts;
+}
+
+uint32_t
+multiplayer_manager::wanted_event_types() const
+{
+    uint32_t wantedEventTypes = m_returnedEventTypes;
+    for (const auto& eventHandler : m_eventHandlers)
+    {
+        wantedEventTypes |= multiplayer_manager_utils::event_type_bit(eventHandler.second.eventType);
+    }
+
+    return wantedEventTypes;
+}
 
+std::vector<multiplayer_event>
+multiplayer_manager::collect_events()
+{
     if (m_multiplayerClientManager == nullptr)
     {
         m_isDirty = false;
@@ -89,10 +223,9 @@ multiplayer_manager::do_work()
         m_isDirty = false;
 
         // To handle the scenario of returning InvitedXuid info in the join_lobby_completed event
-        std::vector<multiplayer_event> eventQueue; 
-        if (m_multiplayerClientManager->event_queue().size() > 0)
+        std::vector<multiplayer_event> eventQueue = m_multiplayerClientManager->event_queue();
+        if (!eventQueue.empty())
         {
-            eventQueue = m_multiplayerClientManager->event_queue();
             m_multiplayerClientManager->clear_event_queue();
         }
 
@@ -316,6 +449,31 @@ multiplayer_manager::set_quality_of_service_measurements(
     }
 }
 
+void
+multiplayer_manager::enable_built_in_quality_of_service_measurements(
+    _In_ std::function<string_t(const string_t& secureDeviceAddress)> addressResolver,
+    _In_ uint32_t probeCount,
+    _In_ std::chrono::milliseconds timeout
+    )
+{
+    if (m_multiplayerClientManager != nullptr)
+    {
+        qos_probe_settings settings;
+        settings.probeCount = probeCount;
+        settings.timeout = timeout;
+        m_multiplayerClientManager->set_built_in_quality_of_service_measurements(addressResolver, settings);
+    }
+}
+
+void
+multiplayer_manager::disable_built_in_quality_of_service_measurements()
+{
+    if (m_multiplayerClientManager != nullptr)
+    {
+        m_multiplayerClientManager->set_built_in_quality_of_service_measurements(nullptr, qos_probe_settings());
+    }
+}
+
 bool
 multiplayer_manager::auto_fill_members_during_matchmaking() const
 {
@@ -18,6 +18,7 @@
 #include "system_internal.h"
 #include "user_context.h"
 #include "xbox_live_context_impl.h"
+#include "qos_prober.h"
 
 namespace xbox { namespace services { 
     class xbox_live_context_impl;
@@ -29,6 +30,7 @@ class multiplayer_match_client;
 class multiplayer_client_manager;
 class multiplayer_local_user_manager;
 class multiplayer_lobby_client;
+class multiplayer_session_tap_coalescer;
 
 enum class multiplayer_local_user_lobby_state
 {
@@ -148,6 +150,25 @@ private:
     std::map<string_t, web::json::value> m_synchronizedSessionProperties;
 };
 
+/// <summary>
+/// Serializes the commits made to a session. Each commit operation starts once the task returned by
+/// the previously queued operation has completed, so callers never block a thread waiting for their turn.
+/// A failed commit does not stop the ones queued behind it.
+/// </summary>
+class multiplayer_commit_queue : public std::enable_shared_from_this<multiplayer_commit_queue>
+{
+public:
+    multiplayer_commit_queue();
+
+    pplx::task<void> enqueue(_In_ std::function<pplx::task<void>()> commitOperation);
+    bool is_idle() const;
+
+private:
+    mutable std::mutex m_lock;
+    pplx::task<void> m_lastCommitTask;
+    uint32_t m_queuedCommitCount;
+};
+
 
 class multiplayer_session_writer : public std::enable_shared_from_this<multiplayer_session_writer>
 {
@@ -372,7 +393,7 @@ private:
         );
 
     mutable std::mutex m_clientRequestLock;
-    std::atomic<bool> m_pendingCommitInProgress;
+    std::shared_ptr<multiplayer_commit_queue> m_commitQueue;
     string_t m_gameSessionTemplateName;
     uint64_t m_updateNumber;
     std::shared_ptr<multiplayer_session_writer> m_sessionWriter;
@@ -565,7 +586,7 @@ private:
         );
 
     string_t m_lobbySessionTemplateName;
-    std::atomic<bool> m_pendingCommitInProgress;
+    std::shared_ptr<multiplayer_commit_queue> m_commitQueue;
 
     uint64_t m_updateNumber;
     xbox::services::multiplayer::manager::joinability m_joinability;
@@ -603,6 +624,9 @@ public:
 
     std::vector<multiplayer_event> multiplayer_event_queue() const;
 
+    /// Moves the queued events out, leaving the queue empty
+    std::vector<multiplayer_event> take_multiplayer_event_queue();
+
     void clear_multiplayer_event_queue();
     void add_to_multiplayer_event_queue(_In_ multiplayer_event multiplayerEvent);
     void add_to_multiplayer_event_queue(_In_ std::vector<multiplayer_event> multiplayerEventQueue);
@@ -854,6 +878,11 @@ public:
 
     std::vector<multiplayer_event> do_work();
 
+    /// Sets the event types the title wants, one bit per multiplayer_event_type. Session changes of
+    /// other types aren't turned into events; any other event is still queued and dropped by do_work.
+    void set_wanted_event_types(_In_ uint32_t eventTypes);
+    bool is_event_type_wanted(_In_ multiplayer_event_type eventType) const;
+
     pplx::task<xbox_live_result<std::vector<xbox::services::multiplayer::multiplayer_activity_details>>> get_activities_for_social_group(
         _In_ xbox_live_user_t user,
         _In_ const string_t& socialGroup
@@ -907,10 +936,17 @@ public:
 
     void set_auto_fill_members_during_matchmaking(_In_ bool autoFillMembers);
 
+    void set_built_in_quality_of_service_measurements(
+        _In_ std::function<string_t(const string_t&)> addressResolver,
+        _In_ const xbox::services::qos_probe_settings& settings
+        );
+
     void on_session_changed(
         _In_ const xbox::services::multiplayer::multiplayer_session_change_event_args& args
     );
 
+    std::shared_ptr<multiplayer_session_tap_coalescer> tap_coalescer() const;
+
     std::vector<multiplayer_event> event_queue() const;
     void clear_event_queue();
 
@@ -920,6 +956,14 @@ private:
 
     void destroy();
 
+    void dispatch_session_changed(
+        _In_ const xbox::services::multiplayer::multiplayer_session_change_event_args& args
+        );
+
+    uint64_t local_session_change_number(
+        _In_ const xbox::services::multiplayer::multiplayer_session_reference& sessionRef
+        );
+
     xbox::services::multiplayer::multiplayer_service& get_multiplayer_service(
         _In_ xbox_live_user_t user
         );
@@ -1013,8 +1057,11 @@ private:
     mutable std::mutex m_clientRequestLock;
     std::mutex m_synchronizeWriteWithTapLock;
     std::atomic<bool> m_subscriptionsLostFired;
+    std::atomic<uint32_t> m_wantedEventTypes;
 
     bool m_autoFillMembers;
+    std::function<string_t(const string_t&)> m_qosAddressResolver;
+    xbox::services::qos_probe_settings m_qosProbeSettings;
     string_t m_lobbySessionTemplateName;
     function_context m_sessionChangedContext;
     function_context m_subscriptionLostContext;
@@ -1022,6 +1069,7 @@ private:
 
     pplx::task<void> m_pendingGameCommitTask;
     std::vector<multiplayer_event> m_multiplayerEventQueue;
+    std::shared_ptr<multiplayer_session_tap_coalescer> m_tapCoalescer;
     xbox::services::multiplayer::multiplayer_service m_clientManagerMultiplayerService;
     std::shared_ptr<xbox_live_context_impl> m_primaryXboxLiveContext;
     std::shared_ptr<multiplayer_local_user_manager> m_multiplayerLocalUserManager;
@@ -1090,6 +1138,16 @@ public:
 
     void disable_next_timer(bool value);
 
+    /// <summary>
+    /// Has the match client probe the other members itself instead of raising perform_qos_measurements.
+    /// The resolver maps a member's secure device address to the "host:port" of its QoS endpoint,
+    /// returning an empty string for members it can't resolve. An empty resolver turns this off.
+    /// </summary>
+    void set_built_in_quality_of_service_measurements(
+        _In_ std::function<string_t(const string_t&)> addressResolver,
+        _In_ const xbox::services::qos_probe_settings& settings
+        );
+
     bool m_disableNextTimer;
 
 private:
@@ -1100,6 +1158,10 @@ private:
 
     void handle_qos_measurements();
 
+    void measure_quality_of_service(
+        _In_ const std::map<string_t, string_t>& addressDeviceTokenMap
+        );
+
     void handle_match_found(
         _In_ std::shared_ptr<xbox::services::multiplayer::multiplayer_session> currentSession
         );
@@ -1123,11 +1185,78 @@ private:
     xbox::services::multiplayer::multiplayer_session_reference m_matchTicketSessionRef;
     std::shared_ptr<xbox::services::multiplayer::multiplayer_session> m_matchSession;
     std::shared_ptr<multiplayer_local_user_manager> m_multiplayerLocalUserManager;
+    std::function<string_t(const string_t&)> m_qosAddressResolver;
+    xbox::services::qos_probe_settings m_qosProbeSettings;
 
     pplx::task<void> m_getSessionTask;
     pplx::task<xbox_live_result<std::shared_ptr<xbox::services::multiplayer::multiplayer_session>>> m_joinTargetSessionTask;
 };
 
+/// <summary>
+/// Collapses bursts of shoulder taps for the same session into a single session fetch.
+/// Taps are keyed by session reference. Within the coalescing window only the highest change number
+/// is kept, and taps that are not newer than the local copy of the session or the last dispatched tap are dropped.
+/// A tap that skips ahead of the known change number means intermediate changes were missed, so it is
+/// dispatched right away instead of waiting for the window.
+/// The end of a window is scheduled with create_delayed_task unless a schedule handler is given.
+/// </summary>
+class multiplayer_session_tap_coalescer : public std::enable_shared_from_this<multiplayer_session_tap_coalescer>
+{
+public:
+    multiplayer_session_tap_coalescer(
+        _In_ std::chrono::milliseconds coalesceWindow,
+        _In_ std::function<uint64_t(const xbox::services::multiplayer::multiplayer_session_reference&)> localChangeNumberHandler,
+        _In_ std::function<void(const xbox::services::multiplayer::multiplayer_session_change_event_args&)> dispatchHandler,
+        _In_ std::function<void(std::chrono::milliseconds, std::function<void()>)> scheduleHandler = nullptr
+        );
+
+    void on_session_changed(_In_ const xbox::services::multiplayer::multiplayer_session_change_event_args& args);
+    void clear();
+
+    std::chrono::milliseconds coalesce_window() const;
+
+    /// <summary>
+    /// Zero dispatches every new tap right away.  Taps already waiting keep the window they started with.
+    /// </summary>
+    void set_coalesce_window(_In_ std::chrono::milliseconds coalesceWindow);
+
+    uint64_t taps_received() const;
+    uint64_t taps_dispatched() const;
+    uint64_t taps_coalesced() const;
+    uint64_t taps_skipped() const;
+    uint64_t gaps_detected() const;
+
+private:
+    struct session_tap_state
+    {
+        session_tap_state() :
+            lastDispatchedChangeNumber(0),
+            hasPendingTap(false)
+        {
+        }
+
+        uint64_t lastDispatchedChangeNumber;
+        bool hasPendingTap;
+        xbox::services::multiplayer::multiplayer_session_change_event_args pendingTap;
+    };
+
+    static string_t session_key(_In_ const xbox::services::multiplayer::multiplayer_session_reference& sessionRef);
+    void flush(_In_ const string_t& sessionKey);
+
+    std::chrono::milliseconds m_coalesceWindow;
+    std::function<uint64_t(const xbox::services::multiplayer::multiplayer_session_reference&)> m_localChangeNumberHandler;
+    std::function<void(const xbox::services::multiplayer::multiplayer_session_change_event_args&)> m_dispatchHandler;
+    std::function<void(std::chrono::milliseconds, std::function<void()>)> m_scheduleHandler;
+
+    mutable std::mutex m_lock;
+    std::unordered_map<string_t, session_tap_state> m_sessions;
+    uint64_t m_tapsReceived;
+    uint64_t m_tapsDispatched;
+    uint64_t m_tapsCoalesced;
+    uint64_t m_tapsSkipped;
+    uint64_t m_gapsDetected;
+};
+
 class multiplayer_manager_utils
 {
 public:
@@ -1155,6 +1284,14 @@ public:
         return (diffType & value) == value;
     }
 
+    /// The bit for an event type in a set of event types
+    static uint32_t event_type_bit(
+        _In_ multiplayer_event_type eventType
+        )
+    {
+        return static_cast<uint32_t>(1) << static_cast<uint32_t>(eventType);
+    }
+
     static bool is_player_in_session(
         _In_ const string_t& xboxUserId,
         _In_ const std::shared_ptr<xbox::services::multiplayer::multiplayer_session>& session
@@ -186,6 +186,12 @@ multiplayer_match_client::handle_qos_measurements()
     {
         m_matchStatus = match_status::measuring;
 
+        if (m_qosAddressResolver)
+        {
+            measure_quality_of_service(addressDeviceTokenMap);
+            return;
+        }
+
         std::shared_ptr<perform_qos_measurements_event_args> performQosEventArgs = std::make_shared<perform_qos_measurements_event_args>(addressDeviceTokenMap);
         multiplayer_event multiplayerEvent(
             xbox_live_error_code::no_error,
@@ -206,6 +212,79 @@ multiplayer_match_client::handle_qos_measurements()
     }
 }
 
+void
+multiplayer_match_client::measure_quality_of_service(
+    _In_ const std::map<string_t, string_t>& addressDeviceTokenMap
+    )
+{
+    std::vector<string_t> targets;
+    std::vector<string_t> deviceTokens;
+    for (const auto& addressDeviceToken : addressDeviceTokenMap)
+    {
+        string_t target = m_qosAddressResolver(addressDeviceToken.first);
+        if (!target.empty())
+        {
+            targets.push_back(std::move(target));
+            deviceTokens.push_back(addressDeviceToken.second);
+        }
+    }
+
+    if (targets.empty())
+    {
+        // Nothing the prober can reach, so leave it to the title like before
+        std::shared_ptr<perform_qos_measurements_event_args> performQosEventArgs = std::make_shared<perform_qos_measurements_event_args>(addressDeviceTokenMap);
+        multiplayer_event multiplayerEvent(
+            xbox_live_error_code::no_error,
+            std::string(),
+            multiplayer_event_type::perform_qos_measurements,
+            std::dynamic_pointer_cast<perform_qos_measurements_event_args>(performQosEventArgs),
+            multiplayer_session_type::game_session
+            );
+
+        std::lock_guard<std::mutex> lock(m_multiplayerEventQueueLock);
+        m_multiplayerEventQueue.push_back(multiplayerEvent);
+        return;
+    }
+
+    std::weak_ptr<multiplayer_match_client> thisWeakPtr = shared_from_this();
+    qos_prober::measure(targets, m_qosProbeSettings)
+    .then([thisWeakPtr, deviceTokens](std::vector<qos_probe_result> results)
+    {
+        std::shared_ptr<multiplayer_match_client> pThis(thisWeakPtr.lock());
+        if (pThis == nullptr) return;
+
+        // Unreachable members are left out so the service treats them as failed measurements
+        auto measurements = std::make_shared<std::vector<multiplayer_quality_of_service_measurements>>();
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const qos_probe_result& result = results[i];
+            if (result.probesReceived == 0) continue;
+
+            web::json::value customJson;
+            customJson[_T("packetLoss")] = web::json::value::number(result.packetLoss);
+            measurements->push_back(multiplayer_quality_of_service_measurements(
+                deviceTokens[i],
+                result.latency,
+                result.bandwidthKilobitsPerSecond,
+                result.bandwidthKilobitsPerSecond,
+                customJson.serialize()
+                ));
+        }
+
+        pThis->set_quality_of_service_measurements(measurements);
+    });
+}
+
+void
+multiplayer_match_client::set_built_in_quality_of_service_measurements(
+    _In_ std::function<string_t(const string_t&)> addressResolver,
+    _In_ const qos_probe_settings& settings
+    )
+{
+    m_qosAddressResolver = std::move(addressResolver);
+    m_qosProbeSettings = settings;
+}
+
 void
 multiplayer_match_client::handle_find_match_completed(
     _In_ std::error_code errorCode,
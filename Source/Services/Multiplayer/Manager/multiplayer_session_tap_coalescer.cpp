@@ -0,0 +1,226 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include "pch.h"
+#include "multiplayer_manager_internal.h"
+#if !XSAPI_U
+#include "ppltasks_extra.h"
+#else
+#include "ppltasks_extra_unix.h"
+#endif
+
+using namespace xbox::services::multiplayer;
+using namespace Concurrency::extras;
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_MANAGER_CPP_BEGIN
+
+multiplayer_session_tap_coalescer::multiplayer_session_tap_coalescer(
+    _In_ std::chrono::milliseconds coalesceWindow,
+    _In_ std::function<uint64_t(const multiplayer_session_reference&)> localChangeNumberHandler,
+    _In_ std::function<void(const multiplayer_session_change_event_args&)> dispatchHandler,
+    _In_ std::function<void(std::chrono::milliseconds, std::function<void()>)> scheduleHandler
+    ) :
+    m_coalesceWindow(coalesceWindow),
+    m_localChangeNumberHandler(std::move(localChangeNumberHandler)),
+    m_dispatchHandler(std::move(dispatchHandler)),
+    m_scheduleHandler(std::move(scheduleHandler)),
+    m_tapsReceived(0),
+    m_tapsDispatched(0),
+    m_tapsCoalesced(0),
+    m_tapsSkipped(0),
+    m_gapsDetected(0)
+{
+    XSAPI_ASSERT(m_dispatchHandler != nullptr);
+    if (m_scheduleHandler == nullptr)
+    {
+        m_scheduleHandler = [](std::chrono::milliseconds delay, std::function<void()> callback)
+        {
+            create_delayed_task(delay, callback);
+        };
+    }
+}
+
+std::chrono::milliseconds
+multiplayer_session_tap_coalescer::coalesce_window() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_coalesceWindow;
+}
+
+void
+multiplayer_session_tap_coalescer::set_coalesce_window(
+    _In_ std::chrono::milliseconds coalesceWindow
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_coalesceWindow = coalesceWindow;
+}
+
+void
+multiplayer_session_tap_coalescer::on_session_changed(
+    _In_ const multiplayer_session_change_event_args& args
+    )
+{
+    // Looked up before taking m_lock as it takes the client locks
+    uint64_t localChangeNumber = m_localChangeNumberHandler != nullptr ? m_localChangeNumberHandler(args.session_reference()) : 0;
+    string_t sessionKey = session_key(args.session_reference());
+    bool dispatchNow = false;
+    bool scheduleFlush = false;
+    std::chrono::milliseconds coalesceWindow;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        ++m_tapsReceived;
+        coalesceWindow = m_coalesceWindow;
+
+        session_tap_state& state = m_sessions[sessionKey];
+        uint64_t knownChangeNumber = __max(localChangeNumber, state.lastDispatchedChangeNumber);
+        if (args.change_number() <= knownChangeNumber)
+        {
+            // Duplicate from another local user's subscription, or already covered by our own copy of the session
+            ++m_tapsSkipped;
+            return;
+        }
+
+        if (state.hasPendingTap)
+        {
+            if (args.change_number() > state.pendingTap.change_number())
+            {
+                state.pendingTap = args;
+            }
+            ++m_tapsCoalesced;
+            return;
+        }
+
+        bool isGap = knownChangeNumber != 0 && args.change_number() > knownChangeNumber + 1;
+        if (isGap)
+        {
+            ++m_gapsDetected;
+        }
+
+        if (isGap || coalesceWindow <= std::chrono::milliseconds::zero())
+        {
+            // Changes were missed, so resync with the service right away
+            state.lastDispatchedChangeNumber = args.change_number();
+            ++m_tapsDispatched;
+            dispatchNow = true;
+        }
+        else
+        {
+            state.pendingTap = args;
+            state.hasPendingTap = true;
+            scheduleFlush = true;
+        }
+    }
+
+    if (dispatchNow)
+    {
+        m_dispatchHandler(args);
+    }
+    else if (scheduleFlush)
+    {
+        std::weak_ptr<multiplayer_session_tap_coalescer> thisWeakPtr = shared_from_this();
+        m_scheduleHandler(
+            coalesceWindow,
+            [thisWeakPtr, sessionKey]()
+        {
+            std::shared_ptr<multiplayer_session_tap_coalescer> pThis(thisWeakPtr.lock());
+            if (pThis != nullptr)
+            {
+                pThis->flush(sessionKey);
+            }
+        });
+    }
+}
+
+void
+multiplayer_session_tap_coalescer::flush(
+    _In_ const string_t& sessionKey
+    )
+{
+    multiplayer_session_change_event_args tap;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto iter = m_sessions.find(sessionKey);
+        if (iter == m_sessions.end() || !iter->second.hasPendingTap)
+        {
+            return;
+        }
+
+        tap = iter->second.pendingTap;
+        iter->second.hasPendingTap = false;
+        iter->second.lastDispatchedChangeNumber = __max(iter->second.lastDispatchedChangeNumber, tap.change_number());
+        ++m_tapsDispatched;
+    }
+
+    m_dispatchHandler(tap);
+}
+
+void
+multiplayer_session_tap_coalescer::clear()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_sessions.clear();
+}
+
+uint64_t
+multiplayer_session_tap_coalescer::taps_received() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_tapsReceived;
+}
+
+uint64_t
+multiplayer_session_tap_coalescer::taps_dispatched() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_tapsDispatched;
+}
+
+uint64_t
+multiplayer_session_tap_coalescer::taps_coalesced() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_tapsCoalesced;
+}
+
+uint64_t
+multiplayer_session_tap_coalescer::taps_skipped() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_tapsSkipped;
+}
+
+uint64_t
+multiplayer_session_tap_coalescer::gaps_detected() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_gapsDetected;
+}
+
+string_t
+multiplayer_session_tap_coalescer::session_key(
+    _In_ const multiplayer_session_reference& sessionRef
+    )
+{
+    // Session references compare case insensitively
+    string_t key = sessionRef.to_uri_path();
+    for (auto& character : key)
+    {
+#if XSAPI_U
+        character = static_cast<char>(::tolower(static_cast<unsigned char>(character)));
+#else
+        character = static_cast<wchar_t>(::towlower(character));
+#endif
+    }
+    return key;
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_MANAGER_CPP_END
@@ -12,6 +12,7 @@
 #include "xbox_system_factory.h"
 #include "utils.h"
 #include "user_context.h"
+#include "batch_fan_out.h"
 
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_PRIVACY_CPP_BEGIN
@@ -240,7 +241,29 @@ privacy_service::check_multiple_permissions_with_multiple_target_users(
     RETURN_TASK_CPP_INVALIDARGUMENT_IF(permissionIds.empty(), std::vector<multiple_permissions_check_result>, "Permission Ids are empty");
     RETURN_TASK_CPP_INVALIDARGUMENT_IF(targetXboxUserIds.empty(), std::vector<multiple_permissions_check_result>, "Target Xbox User Ids are empty");
 
-    string_t xboxUserId = m_userContext->xbox_user_id();
+    auto userContext = m_userContext;
+    auto xboxLiveContextSettings = m_xboxLiveContextSettings;
+    auto appConfig = m_appConfig;
+    return batch_fan_out<string_t, multiple_permissions_check_result>::run(
+        targetXboxUserIds,
+        MAX_TARGET_USERS_PER_BATCH_REQUEST,
+        m_xboxLiveContextSettings->max_concurrent_batch_requests(),
+        [userContext, xboxLiveContextSettings, appConfig, permissionIds](const std::vector<string_t>& batchTargetXboxUserIds)
+        {
+            return check_multiple_permissions_batch(userContext, xboxLiveContextSettings, appConfig, permissionIds, batchTargetXboxUserIds);
+        });
+}
+
+pplx::task<xbox_live_result<std::vector<multiple_permissions_check_result>>>
+privacy_service::check_multiple_permissions_batch(
+    _In_ const std::shared_ptr<xbox::services::user_context>& userContext,
+    _In_ const std::shared_ptr<xbox::services::xbox_live_context_settings>& xboxLiveContextSettings,
+    _In_ const std::shared_ptr<xbox::services::xbox_live_app_config>& appConfig,
+    _In_ const std::vector<string_t>& permissionIds,
+    _In_ const std::vector<string_t>& targetXboxUserIds
+    )
+{
+    string_t xboxUserId = userContext->xbox_user_id();
     web::uri subpathAndQuery = permission_batch_validate_sub_path(xboxUserId);
 
     // Set request body to something like:
@@ -271,9 +294,9 @@ privacy_service::check_multiple_permissions_with_multiple_target_users(
     serializedObject[_T("permissions")] = utils::serialize_vector<string_t>(utils::json_string_serializer, permissionIds);
 
     std::shared_ptr<http_call> httpCall = xbox::services::system::xbox_system_factory::get_factory()->create_http_call(
-        m_xboxLiveContextSettings,
+        xboxLiveContextSettings,
         _T("POST"),
-        utils::create_xboxlive_endpoint(_T("privacy"), m_appConfig),
+        utils::create_xboxlive_endpoint(_T("privacy"), appConfig),
         subpathAndQuery,
         xbox_live_api::check_multiple_permissions_with_multiple_target_users
         );
@@ -282,7 +305,7 @@ privacy_service::check_multiple_permissions_with_multiple_target_users(
         serializedObject.serialize()
         );
 
-    auto task = httpCall->get_response_with_auth(m_userContext)
+    auto task = httpCall->get_response_with_auth(userContext)
     .then([permissionIds](std::shared_ptr<http_call_response> response)
     {
         std::error_code errc = xbox_live_error_code::no_error;
@@ -11,6 +11,7 @@
 #include "social_manager_internal.h"
 #include "http_call_impl.h"
 #include "xbox_system_factory.h"
+#include "batch_fan_out.h"
 
 using namespace xbox::services;
 
@@ -49,13 +50,22 @@ peoplehub_service::get_social_graph(
     _In_ const std::vector<string_t> xboxLiveUsers
     )
 {
-    return get_social_graph(
-        callerXboxUserId,
-        decorations,
-        _T(""),
+    peoplehub_service peoplehubService(*this);
+    string_t caller = callerXboxUserId;
+    return batch_fan_out<string_t, xbox_social_user>::run(
         xboxLiveUsers,
-        true
-        );
+        MAX_USERS_PER_BATCH_REQUEST,
+        m_httpCallSettings->max_concurrent_batch_requests(),
+        [peoplehubService, caller, decorations](const std::vector<string_t>& batchXboxLiveUsers) mutable
+        {
+            return peoplehubService.get_social_graph(
+                caller,
+                decorations,
+                _T(""),
+                batchXboxLiveUsers,
+                true
+                );
+        });
 }
 
 pplx::task<xbox_live_result<std::vector<xbox_social_user>>>
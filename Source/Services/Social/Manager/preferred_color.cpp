@@ -16,36 +16,33 @@ NAMESPACE_MICROSOFT_XBOX_SERVICES_SOCIAL_MANAGER_CPP_BEGIN
 
 preferred_color::preferred_color()
 {
-    initialize_char_arr(m_primaryColor);
-    initialize_char_arr(m_secondaryColor);
-    initialize_char_arr(m_tertiaryColor);
 }
 
 const char_t*
 preferred_color::primary_color() const
 {
-    return m_primaryColor;
+    return m_primaryColor.c_str();
 }
 
 const char_t*
 preferred_color::secondary_color() const
 {
-    return m_secondaryColor;
+    return m_secondaryColor.c_str();
 }
 
 const char_t*
 preferred_color::tertiary_color() const
 {
-    return m_tertiaryColor;
+    return m_tertiaryColor.c_str();
 }
 
 bool
 preferred_color::operator!=(const preferred_color& rhs) const
 {
     return (
-        utils::str_icmp(m_primaryColor, rhs.m_primaryColor) != 0 ||
-        utils::str_icmp(m_secondaryColor, rhs.m_secondaryColor) != 0 ||
-        utils::str_icmp(m_tertiaryColor, rhs.m_tertiaryColor) != 0
+        utils::str_icmp(m_primaryColor.c_str(), rhs.m_primaryColor.c_str()) != 0 ||
+        utils::str_icmp(m_secondaryColor.c_str(), rhs.m_secondaryColor.c_str()) != 0 ||
+        utils::str_icmp(m_tertiaryColor.c_str(), rhs.m_tertiaryColor.c_str()) != 0
         );
 }
 
@@ -59,9 +56,9 @@ preferred_color::_Deserialize(
     if (json.is_null()) return xbox_live_result<preferred_color>();
 
     std::error_code errc = xbox_live_error_code::no_error;
-    utils::extract_json_string_to_char_t_array(json, _T("primaryColor"), errc, returnObject.m_primaryColor, ARRAYSIZE(returnObject.m_primaryColor));
-    utils::extract_json_string_to_char_t_array(json, _T("secondaryColor"), errc, returnObject.m_secondaryColor, ARRAYSIZE(returnObject.m_secondaryColor));
-    utils::extract_json_string_to_char_t_array(json, _T("tertiaryColor"), errc, returnObject.m_tertiaryColor, ARRAYSIZE(returnObject.m_tertiaryColor));
+    returnObject.m_primaryColor = pooled_string(utils::extract_json_string(json, _T("primaryColor"), errc), COLOR_CHAR_SIZE - 1);
+    returnObject.m_secondaryColor = pooled_string(utils::extract_json_string(json, _T("secondaryColor"), errc), COLOR_CHAR_SIZE - 1);
+    returnObject.m_tertiaryColor = pooled_string(utils::extract_json_string(json, _T("tertiaryColor"), errc), COLOR_CHAR_SIZE - 1);
 
     if (errcOut)
     {
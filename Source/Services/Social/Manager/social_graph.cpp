@@ -15,6 +15,8 @@
 #include "xbox_live_context_impl.h"
 #include "system_internal.h"
 #include "xbox_system_factory.h"
+#include "social_user_store.h"
+#include <unordered_set>
 
 using namespace xbox::services;
 using namespace xbox::services::system;
@@ -67,6 +69,8 @@ social_graph::social_graph(
 
 social_graph::~social_graph()
 {
+    social_user_store::get_singleton_instance()->remove_graph(this);
+
     std::lock_guard<std::recursive_mutex> lock(m_socialGraphMutex);
     std::lock_guard<std::recursive_mutex> priorityLock(m_socialGraphPriorityMutex);
     m_xboxLiveContextImpl->real_time_activity_service()->deactivate();
@@ -219,8 +223,23 @@ social_graph::initialize()
                 
                 pThis->initialize_social_buffers(socialUsersResult.payload());
                 auto& inactiveBufferSocialGraph = pThis->m_userBuffer.inactive_buffer()->socialUserGraph;
+                std::vector<uint64_t> users;
+                users.reserve(inactiveBufferSocialGraph.size());
                 for (auto& user : inactiveBufferSocialGraph)
                 {
+                    users.push_back(user.first);
+                }
+
+                // Users another local user's graph already subscribed to are left to that graph
+                auto usersToSubscribe = social_user_store::get_singleton_instance()->add_users(pThis, users);
+                std::unordered_set<uint64_t> usersToSubscribeSet(usersToSubscribe.begin(), usersToSubscribe.end());
+                for (auto& user : inactiveBufferSocialGraph)
+                {
+                    if (usersToSubscribeSet.find(user.first) == usersToSubscribeSet.end())
+                    {
+                        continue;
+                    }
+
                     auto devicePresenceSubResult = pThis->m_xboxLiveContextImpl->presence_service().subscribe_to_device_presence_change(user.second.socialUser->xbox_user_id());
                     auto titlePresenceSubResult = pThis->m_xboxLiveContextImpl->presence_service().subscribe_to_title_presence_change(
                         user.second.socialUser->xbox_user_id(),
@@ -551,7 +570,7 @@ social_graph::apply_users_removed_event(
     m_userBuffer.remove_users_from_buffer(removeUsers, *inactiveBuffer);
     if (isFreshEvent)
     {
-        unsubscribe_users(removeUsers);
+        unsubscribe_users(social_user_store::get_singleton_instance()->remove_users(this, removeUsers));
     }
     m_perfTester.stop_timer(_T("removing_users"));
 }
@@ -606,7 +625,7 @@ social_graph::apply_users_change_event(
         }
         if (isFreshEvent)
         {
-            setup_device_and_presence_subscriptions(usersList);
+            setup_device_and_presence_subscriptions(social_user_store::get_singleton_instance()->add_users(shared_from_this(), usersList));
             internal_social_event internalSocialUsersAddedEvent(internal_social_event_type::users_added, utils::std_vector_to_xsapi_vector(usersToAdd));
             m_socialEventQueue.push(internalSocialUsersAddedEvent, m_user, social_event_type::users_added_to_social_graph);
         }
@@ -821,7 +840,8 @@ social_graph::setup_rta_subscriptions(
             users.push_back(user->_Xbox_user_id_as_integer());
         }
 
-        setup_device_and_presence_subscriptions(users);
+        // Only resubscribe to the users this graph subscribed to, the rest are on other local users' connections
+        setup_device_and_presence_subscriptions(social_user_store::get_singleton_instance()->subscribed_users(this, users));
     }
 
     std::weak_ptr<social_graph> thisWeakPtr = shared_from_this();
@@ -896,6 +916,11 @@ social_graph::setup_device_and_presence_subscriptions(
     _In_ const std::vector<uint64_t>& users
     )
 {
+    if (users.empty())
+    {
+        return;
+    }
+
     std::weak_ptr<social_graph> thisWeak = shared_from_this();
     pplx::create_task([users, thisWeak]()
     {
@@ -914,7 +939,12 @@ social_graph::unsubscribe_users(
     _In_ const std::vector<uint64_t>& users
     )
 {
-    std::weak_ptr<social_graph> thisWeakPtr;
+    if (users.empty())
+    {
+        return;
+    }
+
+    std::weak_ptr<social_graph> thisWeakPtr = shared_from_this();
     pplx::create_task([thisWeakPtr, users]()
     {
         std::shared_ptr<social_graph> pThis(thisWeakPtr.lock());
@@ -1009,14 +1039,7 @@ social_graph::refresh_graph()
         {
             if (!socialListResult.err())
             {
-                auto& socialList = socialListResult.payload();
-                xsapi_internal_unordered_map(uint64_t, xbox_social_user) socialMap;
-                for (auto& user : socialList)
-                {
-                    socialMap[user._Xbox_user_id_as_integer()] = user;
-                }
-
-                pThis->perform_diff(socialMap);
+                pThis->perform_diff(socialListResult.payload());
             }
             else
             {
@@ -1026,87 +1049,105 @@ social_graph::refresh_graph()
     });
 }
 
-void
-social_graph::perform_diff(
-    _In_ const xsapi_internal_unordered_map(uint64_t, xbox_social_user)& xboxSocialUsers
+social_graph_diff
+social_graph::diff_users(
+    _In_ const xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)& previousUsers,
+    _In_ const std::vector<xbox_social_user>& currentUsers
     )
 {
-    std::lock_guard<std::recursive_mutex> socialGraphStateLock(m_socialGraphStateMutex);
+    social_graph_diff diff;
+    std::unordered_set<uint64_t> currentUserIds;
+    currentUserIds.reserve(currentUsers.size());
+
+    for (auto& currentUser : currentUsers)
     {
-        std::lock_guard<std::recursive_mutex> lock(m_socialGraphMutex);
-        std::lock_guard<std::recursive_mutex> priorityLock(m_socialGraphPriorityMutex);
-        m_perfTester.start_timer(_T("set_state"));
-        if (m_userBuffer.inactive_buffer() == nullptr)
+        uint64_t xuid = currentUser._Xbox_user_id_as_integer();
+        currentUserIds.insert(xuid);
+
+        auto previousUserIter = previousUsers.find(xuid);
+        if (previousUserIter == previousUsers.end())
         {
-            LOG_ERROR("Diff cannot happening with null buffer");
-            return;
+            diff.usersAdded.push_back(currentUser);
+            continue;
         }
-        set_state(social_graph_state::diff);
-        m_perfTester.stop_timer(_T("set_state"));
-    }
 
-    xsapi_internal_vector(xbox_social_user) usersAddedList;
-    xsapi_internal_vector(uint64_t) usersRemovedList;
-    xsapi_internal_vector(social_manager_presence_record) presenceChangeList;
-    xsapi_internal_vector(xbox_social_user) socialRelationshipChangeList;
-    xsapi_internal_vector(xbox_social_user) profileChangeList;
-
-    for (auto& currentUserPair : xboxSocialUsers)
-    {
-        m_perfTester.start_timer(_T("perform_diff: start"));
-        auto inactiveBufferUserGraph = m_userBuffer.inactive_buffer()->socialUserGraph;
-        if (inactiveBufferUserGraph.find(currentUserPair.first) == inactiveBufferUserGraph.end())
+        auto previousUser = previousUserIter->second.socialUser;
+        if (previousUser == nullptr)
         {
-            usersAddedList.push_back(currentUserPair.second);
+            // Still being looked up, and the lookup will bring in the latest copy
             continue;
         }
 
-        auto previousUser = inactiveBufferUserGraph.at(currentUserPair.first).socialUser;
-        change_list_enum didChange = xbox_social_user::_Compare(*previousUser, currentUserPair.second);
-
+        change_list_enum didChange = xbox_social_user::_Compare(*previousUser, currentUser);
         if ((didChange & change_list_enum::presence_change) == change_list_enum::presence_change)
         {
-            presenceChangeList.push_back(currentUserPair.second.presence_record());
+            diff.presenceChanged.push_back(currentUser.presence_record());
         }
         if ((didChange & change_list_enum::profile_change) == change_list_enum::profile_change)
         {
-            profileChangeList.push_back(currentUserPair.second);
+            diff.profilesChanged.push_back(currentUser);
         }
         if ((didChange & change_list_enum::social_relationship_change) == change_list_enum::social_relationship_change)
         {
-            socialRelationshipChangeList.push_back(currentUserPair.second);
+            diff.socialRelationshipsChanged.push_back(currentUser);
         }
     }
 
-    auto inactiveBufferUserGraph = m_userBuffer.inactive_buffer()->socialUserGraph;
-    for (auto& previousUserPair : inactiveBufferUserGraph)
+    for (auto& previousUserPair : previousUsers)
     {
-        if (xboxSocialUsers.find(previousUserPair.first) == xboxSocialUsers.end() && 
-            (previousUserPair.second.socialUser != nullptr && previousUserPair.second.socialUser->is_following_user()))
+        if (previousUserPair.second.socialUser != nullptr &&
+            previousUserPair.second.socialUser->is_following_user() &&
+            currentUserIds.find(previousUserPair.first) == currentUserIds.end())
         {
-            usersRemovedList.push_back(previousUserPair.first);
+            diff.usersRemoved.push_back(previousUserPair.first);
         }
     }
 
-    if (usersAddedList.size() > 0)
+    return diff;
+}
+
+void
+social_graph::perform_diff(
+    _In_ const std::vector<xbox_social_user>& xboxSocialUsers
+    )
+{
+    std::lock_guard<std::recursive_mutex> socialGraphStateLock(m_socialGraphStateMutex);
     {
-        m_internalEventQueue.push(internal_social_event_type::users_changed, usersAddedList);
+        std::lock_guard<std::recursive_mutex> lock(m_socialGraphMutex);
+        std::lock_guard<std::recursive_mutex> priorityLock(m_socialGraphPriorityMutex);
+        m_perfTester.start_timer(_T("set_state"));
+        if (m_userBuffer.inactive_buffer() == nullptr)
+        {
+            LOG_ERROR("Diff cannot happening with null buffer");
+            return;
+        }
+        set_state(social_graph_state::diff);
+        m_perfTester.stop_timer(_T("set_state"));
+    }
+
+    m_perfTester.start_timer(_T("perform_diff"));
+    auto diff = diff_users(m_userBuffer.inactive_buffer()->socialUserGraph, xboxSocialUsers);
+    m_perfTester.stop_timer(_T("perform_diff"));
+
+    if (diff.usersAdded.size() > 0)
+    {
+        m_internalEventQueue.push(internal_social_event_type::users_changed, diff.usersAdded);
     }
-    if (usersRemovedList.size() > 0)
+    if (diff.usersRemoved.size() > 0)
     {
-        m_internalEventQueue.push(internal_social_event_type::users_removed, usersRemovedList);
+        m_internalEventQueue.push(internal_social_event_type::users_removed, diff.usersRemoved);
     }
-    if (presenceChangeList.size() > 0)
+    if (diff.presenceChanged.size() > 0)
     {
-        m_internalEventQueue.push(internal_social_event_type::presence_changed, presenceChangeList);
+        m_internalEventQueue.push(internal_social_event_type::presence_changed, diff.presenceChanged);
     }
-    if (profileChangeList.size() > 0)
+    if (diff.profilesChanged.size() > 0)
     {
-        m_internalEventQueue.push(internal_social_event_type::profiles_changed, profileChangeList);
+        m_internalEventQueue.push(internal_social_event_type::profiles_changed, diff.profilesChanged);
     }
-    if (socialRelationshipChangeList.size() > 0)
+    if (diff.socialRelationshipsChanged.size() > 0)
     {
-        m_internalEventQueue.push(internal_social_event_type::social_relationships_changed, socialRelationshipChangeList);
+        m_internalEventQueue.push(internal_social_event_type::social_relationships_changed, diff.socialRelationshipsChanged);
     }
 
     {
@@ -1258,7 +1299,12 @@ social_graph::handle_device_presence_change(
         return;
     }
 
-    m_internalEventQueue.push(internal_social_event(internal_social_event_type::device_presence_changed, devicePresenceChanged));
+    internal_social_event devicePresenceChangeEvent(internal_social_event_type::device_presence_changed, devicePresenceChanged);
+    m_internalEventQueue.push(devicePresenceChangeEvent);
+    for (auto& graph : social_user_store::get_singleton_instance()->other_graphs_with_user(this, id))
+    {
+        graph->m_internalEventQueue.push(devicePresenceChangeEvent);
+    }
 }
 
 void
@@ -1276,6 +1322,11 @@ social_graph::handle_title_presence_change(
     {
         internal_social_event titlePresenceChangeEvent(internal_social_event_type::title_presence_changed, titlePresenceChanged);
         m_internalEventQueue.push(titlePresenceChangeEvent);
+        auto id = utils::string_t_to_uint64(titlePresenceChanged.xbox_user_id().c_str());
+        for (auto& graph : social_user_store::get_singleton_instance()->other_graphs_with_user(this, id))
+        {
+            graph->m_internalEventQueue.push(titlePresenceChangeEvent);
+        }
     }
 }
 
@@ -1448,6 +1499,7 @@ social_graph::presence_timer_callback(
                     internal_social_event_type::presence_changed,
                     socialManagerPresenceVec
                     );
+                pThis->push_presence_to_other_graphs(socialManagerPresenceVec);
 
                 {
                     std::lock_guard<std::recursive_mutex> lock(pThis->m_socialGraphMutex);
@@ -1465,6 +1517,36 @@ social_graph::presence_timer_callback(
     });
 }
 
+void
+social_graph::push_presence_to_other_graphs(
+    _In_ const xsapi_internal_vector(social_manager_presence_record)& presenceRecords
+    )
+{
+    std::vector<uint64_t> users;
+    users.reserve(presenceRecords.size());
+    std::unordered_map<uint64_t, size_t> recordIndices;
+    for (size_t i = 0; i < presenceRecords.size(); ++i)
+    {
+        users.push_back(presenceRecords[i]._Xbox_user_id());
+        recordIndices[presenceRecords[i]._Xbox_user_id()] = i;
+    }
+
+    for (auto& graphUsers : social_user_store::get_singleton_instance()->other_graphs_with_users(this, users))
+    {
+        xsapi_internal_vector(social_manager_presence_record) graphPresenceRecords;
+        graphPresenceRecords.reserve(graphUsers.second.size());
+        for (auto user : graphUsers.second)
+        {
+            graphPresenceRecords.push_back(presenceRecords[recordIndices[user]]);
+        }
+
+        graphUsers.first->m_internalEventQueue.push(
+            internal_social_event_type::presence_changed,
+            graphPresenceRecords
+            );
+    }
+}
+
 bool
 social_graph::are_events_empty()
 {
@@ -1509,15 +1591,27 @@ social_graph::presence_refresh_callback()
                 set_state(social_graph_state::refresh);
                 m_perfTester.stop_timer(_T("presence refresh state set"));
             }
-            userList.reserve(m_userBuffer.inactive_buffer()->socialUserGraph.size());
+            std::vector<uint64_t> users;
+            users.reserve(m_userBuffer.inactive_buffer()->socialUserGraph.size());
             for (auto& user : m_userBuffer.inactive_buffer()->socialUserGraph)
             {
                 if (user.second.socialUser != nullptr)
                 {
-                    userList.push_back(user.second.socialUser->xbox_user_id());
+                    users.push_back(user.first);
                 }
             }
 
+            // Skip users another local user's graph just polled, their results are passed on to this graph
+            users = social_user_store::get_singleton_instance()->claim_presence_poll(
+                users,
+                std::chrono::duration_cast<std::chrono::milliseconds>(TIME_PER_CALL_SEC)
+                );
+            userList.reserve(users.size());
+            for (auto user : users)
+            {
+                userList.push_back(utils::uint64_to_string_t(user));
+            }
+
             m_presencePollingTimer->fire(userList);
 
             {
@@ -1598,15 +1692,32 @@ user_buffers_holder::~user_buffers_holder()
 {
     LOG_DEBUG("destroying user buffer holder");
 
-    if (m_userBufferA.buffer != nullptr)
+    buffer_free(m_userBufferA);
+    buffer_free(m_userBufferB);
+}
+
+void
+user_buffers_holder::buffer_free(
+    _Inout_ user_buffer& userBuffer
+    )
+{
+    if (userBuffer.buffer == nullptr)
     {
-        xsapi_memory::mem_free(m_userBufferA.buffer);
+        return;
     }
 
-    if (m_userBufferB.buffer != nullptr)
+    // Users hold references to pooled strings, so they have to be destroyed rather than just freed
+    for (auto& user : userBuffer.socialUserGraph)
     {
-        xsapi_memory::mem_free(m_userBufferB.buffer);
+        if (user.second.socialUser != nullptr)
+        {
+            user.second.socialUser->~xbox_social_user();
+            user.second.socialUser = nullptr;
+        }
     }
+
+    xsapi_memory::mem_free(userBuffer.buffer);
+    userBuffer.buffer = nullptr;
 }
 
 void
@@ -1738,25 +1849,17 @@ user_buffers_holder::add_users_to_buffer(
     auto totalSizeNeeded = __max(finalSize, users.size());
     if (totalSizeNeeded > userBufferInactive.freeData.size())
     {
-        uint32_t size = 0;
+        std::vector<xbox_social_user> socialVec;
+        socialVec.reserve(userBufferInactive.socialUserGraph.size());
         for (auto& user : userBufferInactive.socialUserGraph)
         {
             if (user.second.socialUser != nullptr)
             {
-                ++size;
+                socialVec.push_back(*user.second.socialUser);
             }
         }
 
-        std::vector<xbox_social_user> socialVec(size);
-        if (size > 0)
-        {
-#if _WIN32
-            memcpy_s(&socialVec[0], socialVec.size() * sizeof(xbox_social_user), &userBufferInactive.buffer[0], size * sizeof(xbox_social_user));
-#else
-            memcpy(&socialVec[0], &userBufferInactive.buffer[0], size * sizeof(xbox_social_user));
-#endif
-        }
-        xsapi_memory::mem_free(userBufferInactive.buffer);
+        buffer_free(userBufferInactive);
         initialize_buffer(userBufferInactive, socialVec, totalSizeNeeded);
     }
 
@@ -1783,8 +1886,12 @@ user_buffers_holder::remove_users_from_buffer(
         auto xboxSocialUserContextIter = userBufferInactive.socialUserGraph.find(user);
         if (xboxSocialUserContextIter != userBufferInactive.socialUserGraph.end())
         {
-            auto userPtr = userBufferInactive.socialUserGraph[user].socialUser;
-            userBufferInactive.freeData.push(reinterpret_cast<byte*>(userPtr));
+            auto userPtr = xboxSocialUserContextIter->second.socialUser;
+            if (userPtr != nullptr)
+            {
+                userPtr->~xbox_social_user();
+                userBufferInactive.freeData.push(reinterpret_cast<byte*>(userPtr));
+            }
             userBufferInactive.socialUserGraph.erase(xboxSocialUserContextIter);
         }
         else
@@ -10,6 +10,8 @@
 #include "pch.h"
 #include "xsapi/social_manager.h"
 #include "social_manager_internal.h"
+#include "social_string_pool.h"
+#include "social_user_store.h"
 #if UNIT_TEST_SERVICES
 #include "MockSocialManager.h"
 #endif
@@ -34,7 +36,8 @@ social_manager::get_singleton_instance()
     return m_socialManager;
 }
 
-social_manager::social_manager()
+social_manager::social_manager() :
+    m_processGraphsInParallel(false)
 {
     m_perfTester = perf_tester(_T("social_manager"));
 }
@@ -407,26 +410,45 @@ social_manager::do_work()
 {
     std::lock_guard<std::mutex> lock(m_socialMangerLock);
     std::lock_guard<std::mutex> eventLock(m_socialManagerEventLock);
-    std::vector<social_event> socialEvents(m_eventQueue);
+    std::vector<social_event> socialEvents;
+    socialEvents.swap(m_eventQueue);
     m_perfTester.start_timer(_T("do_work"));
-    m_perfTester.start_timer(_T("do_work: eventqueue clear"));
-    m_eventQueue.clear();
-    m_perfTester.stop_timer(_T("do_work: eventqueue clear"));
-    for (auto& graph : m_localGraphs)
+
+    m_graphWorkTimings.clear();
+    if (m_processGraphsInParallel && m_localGraphs.size() > 1)
+    {
+        do_graph_work_in_parallel(socialEvents);
+    }
+    else
     {
-        m_perfTester.start_timer(_T("do_work: social_graph do_work"));
-        auto graphData = graph.second->do_work(socialEvents);
-        m_perfTester.stop_timer(_T("do_work: social_graph do_work"));
-        const auto& userViewList = m_userToViewMap[graph.first];
-        for (auto& viewHash : userViewList)
+        for (auto& graph : m_localGraphs)
         {
-            auto& view = m_xboxSocialUserGroups[viewHash];
-            if(graphData.socialUsers != nullptr)
+            auto startTime = std::chrono::high_resolution_clock::now();
+            size_t eventCount = socialEvents.size();
+            m_perfTester.start_timer(_T("do_work: social_graph do_work"));
+            auto graphData = graph.second->do_work(socialEvents);
+            m_perfTester.stop_timer(_T("do_work: social_graph do_work"));
+            auto graphDoneTime = std::chrono::high_resolution_clock::now();
+
+            const auto& userViewList = m_userToViewMap[graph.first];
+            for (auto& viewHash : userViewList)
             {
-                m_perfTester.start_timer(_T("do_work: update_view"));
-                view->update_view(*graphData.socialUsers, socialEvents);
-                m_perfTester.stop_timer(_T("do_work: update_view"));
+                auto& view = m_xboxSocialUserGroups[viewHash];
+                if(graphData.socialUsers != nullptr)
+                {
+                    m_perfTester.start_timer(_T("do_work: update_view"));
+                    view->update_view(*graphData.socialUsers, socialEvents);
+                    m_perfTester.stop_timer(_T("do_work: update_view"));
+                }
             }
+
+            social_graph_work_timing timing;
+            timing.xboxUserId = graph.first;
+            timing.graphTime = std::chrono::duration_cast<std::chrono::microseconds>(graphDoneTime - startTime);
+            timing.userGroupsTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - graphDoneTime);
+            timing.eventCount = socialEvents.size() - eventCount;
+            timing.processedInParallel = false;
+            m_graphWorkTimings.push_back(timing);
         }
     }
 
@@ -435,6 +457,134 @@ social_manager::do_work()
     return socialEvents;
 }
 
+void
+social_manager::do_graph_work_in_parallel(
+    _Inout_ std::vector<social_event>& socialEvents
+    )
+{
+    struct graph_work
+    {
+        std::shared_ptr<social_graph> graph;
+        std::vector<std::shared_ptr<xbox_social_user_group>> userGroups;
+        std::vector<social_event> events;
+        change_struct graphData;
+        social_graph_work_timing timing;
+    };
+
+    // Everything a task touches is gathered up front so the tasks never read the social manager's maps
+    std::vector<graph_work> graphWork(m_localGraphs.size());
+    size_t graphIndex = 0;
+    for (auto& graph : m_localGraphs)
+    {
+        auto& work = graphWork[graphIndex++];
+        work.graph = graph.second;
+        work.timing.xboxUserId = graph.first;
+        for (auto& viewHash : m_userToViewMap[graph.first])
+        {
+            work.userGroups.push_back(m_xboxSocialUserGroups[viewHash]);
+        }
+    }
+
+    std::vector<pplx::task<void>> tasks;
+    tasks.reserve(graphWork.size());
+    for (auto& work : graphWork)
+    {
+        graph_work* pWork = &work;
+        tasks.push_back(pplx::create_task([pWork]()
+        {
+            auto startTime = std::chrono::high_resolution_clock::now();
+            pWork->graphData = pWork->graph->do_work(pWork->events);
+            pWork->timing.graphTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - startTime);
+            pWork->timing.eventCount = pWork->events.size();
+            pWork->timing.processedInParallel = true;
+        }));
+    }
+
+    m_perfTester.start_timer(_T("do_work: parallel join"));
+    pplx::when_all(tasks.begin(), tasks.end()).wait();
+    m_perfTester.stop_timer(_T("do_work: parallel join"));
+
+    // The serial loop hands a graph's user groups every event queued so far, including other graphs' events
+    // for users they share, so each graph's groups get the same prefix here rather than only their own events
+    std::vector<std::vector<social_event>> userGroupEvents(graphWork.size());
+    for (size_t i = 0; i < graphWork.size(); ++i)
+    {
+        socialEvents.insert(
+            socialEvents.end(),
+            std::make_move_iterator(graphWork[i].events.begin()),
+            std::make_move_iterator(graphWork[i].events.end())
+            );
+        if (i + 1 < graphWork.size() && !graphWork[i].userGroups.empty())
+        {
+            userGroupEvents[i] = socialEvents;
+        }
+    }
+
+    tasks.clear();
+    for (size_t i = 0; i < graphWork.size(); ++i)
+    {
+        graph_work* pWork = &graphWork[i];
+        if (pWork->graphData.socialUsers == nullptr || pWork->userGroups.empty())
+        {
+            continue;
+        }
+
+        // The last graph's prefix is every event, so it reads socialEvents directly, which nothing writes to until the join
+        const std::vector<social_event>* pEvents = i + 1 < graphWork.size() ? &userGroupEvents[i] : &socialEvents;
+        tasks.push_back(pplx::create_task([pWork, pEvents]()
+        {
+            auto startTime = std::chrono::high_resolution_clock::now();
+            for (auto& userGroup : pWork->userGroups)
+            {
+                userGroup->update_view(*pWork->graphData.socialUsers, *pEvents);
+            }
+            pWork->timing.userGroupsTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - startTime);
+        }));
+    }
+
+    if (!tasks.empty())
+    {
+        m_perfTester.start_timer(_T("do_work: parallel update_view join"));
+        pplx::when_all(tasks.begin(), tasks.end()).wait();
+        m_perfTester.stop_timer(_T("do_work: parallel update_view join"));
+    }
+
+    for (auto& work : graphWork)
+    {
+        m_graphWorkTimings.push_back(work.timing);
+    }
+}
+
+void
+social_manager::set_parallel_graph_processing(
+    _In_ bool processInParallel
+    )
+{
+    std::lock_guard<std::mutex> lock(m_socialMangerLock);
+    m_processGraphsInParallel = processInParallel;
+}
+
+xbox_live_result<void>
+social_manager::set_social_user_sharing(
+    _In_ bool shareAcrossLocalUsers
+    )
+{
+    std::lock_guard<std::mutex> lock(m_socialMangerLock);
+    if (!m_localGraphs.empty() || !social_user_store::get_singleton_instance()->set_sharing_enabled(shareAcrossLocalUsers))
+    {
+        return xbox_live_result<void>(xbox_live_error_code::logic_error, "social user sharing can only be changed when there are no local users");
+    }
+
+    return xbox_live_result<void>();
+}
+
+std::vector<social_graph_work_timing>
+social_manager::_Graph_work_timings()
+{
+    std::lock_guard<std::mutex> lock(m_socialMangerLock);
+    return m_graphWorkTimings;
+}
+
 const std::vector<xbox_live_user_t>&
 social_manager::local_users() const
 {
@@ -521,6 +671,20 @@ void social_manager::_Log_state()
         << " m_localGraphs: " << m_localGraphs.size()
         << " m_eventQueue: " << m_eventQueue.size()
         << " m_localUserList: " << m_localUserList.size();
+
+    auto stringPoolStats = social_string_pool::get_singleton_instance()->stats();
+    LOGS_DEBUG << "[SM] Users: " << sizeof(xbox_social_user) << " bytes each per buffer"
+        << " string pool: " << stringPoolStats.stringCount << " strings"
+        << " " << stringPoolStats.bytes << " bytes"
+        << " " << stringPoolStats.referenceCount << " references";
+
+    auto userStoreStats = social_user_store::get_singleton_instance()->stats();
+    LOGS_DEBUG << "[SM] Shared users: " << userStoreStats.distinctUserCount << " distinct"
+        << " " << userStoreStats.userReferenceCount << " held by local users"
+        << " " << userStoreStats.subscribedUserCount << " subscribed"
+        << " user dedup ratio: " << userStoreStats.user_dedup_ratio()
+        << " subscription dedup ratio: " << userStoreStats.subscription_dedup_ratio()
+        << " presence polls skipped: " << userStoreStats.presencePollsSkipped << "/" << userStoreStats.presencePollsRequested;
 }
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SOCIAL_MANAGER_CPP_END
@@ -136,6 +136,75 @@ struct xbox_social_user_context
     xbox_social_user* socialUser;
 };
 
+/// <summary>
+/// internal only
+/// Builds the 64-bit fingerprints social users are compared by. Strings are folded to lower case so
+/// fingerprints agree with the case insensitive comparisons they replace.
+/// </summary>
+class social_fingerprint
+{
+public:
+    social_fingerprint() : m_hash(FNV_OFFSET_BASIS) {}
+
+    social_fingerprint& add(_In_ const char_t* text)
+    {
+        for (; *text != 0; ++text)
+        {
+            char_t character = *text;
+            if (character >= 'A' && character <= 'Z')
+            {
+                character = static_cast<char_t>(character - 'A' + 'a');
+            }
+            add_byte_group(static_cast<uint64_t>(character));
+        }
+
+        // Keeps ("ab", "c") apart from ("a", "bc")
+        add_byte_group(0);
+        return *this;
+    }
+
+    social_fingerprint& add(_In_ uint64_t value)
+    {
+        add_byte_group(value);
+        return *this;
+    }
+
+    uint64_t value() const
+    {
+        // Finalizer so fingerprints can be summed without similar inputs cancelling out
+        uint64_t hash = m_hash;
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+private:
+    static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+    static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+    void add_byte_group(_In_ uint64_t value)
+    {
+        m_hash ^= value;
+        m_hash *= FNV_PRIME;
+    }
+
+    uint64_t m_hash;
+};
+
+/// <summary>
+/// internal only
+/// What changed between the users in a graph and a fresh copy of the graph from the service
+/// </summary>
+struct social_graph_diff
+{
+    xsapi_internal_vector(xbox_social_user) usersAdded;
+    xsapi_internal_vector(uint64_t) usersRemoved;
+    xsapi_internal_vector(social_manager_presence_record) presenceChanged;
+    xsapi_internal_vector(xbox_social_user) profilesChanged;
+    xsapi_internal_vector(xbox_social_user) socialRelationshipsChanged;
+};
+
 struct xbox_social_user_subscriptions
 {
     std::shared_ptr<xbox::services::presence::device_presence_change_subscription> devicePresenceChangeSubscription;
@@ -261,6 +330,8 @@ protected:
         _In_ size_t freeSpaceRequired
         );
 
+    static void buffer_free(_Inout_ user_buffer& userBuffer);
+
     static const uint32_t EXTRA_USER_FREE_SPACE;
 
     user_buffer* m_activeBuffer;
@@ -350,6 +421,8 @@ private:
         _In_ bool isBatch
         ) const;
 
+    static const size_t MAX_USERS_PER_BATCH_REQUEST = 100;
+
     std::shared_ptr<xbox::services::user_context> m_userContext;
     std::shared_ptr<xbox::services::xbox_live_context_settings> m_httpCallSettings;
     std::shared_ptr<xbox::services::xbox_live_app_config> m_appConfig;
@@ -401,6 +474,14 @@ public:
 
     const xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)* active_buffer_social_graph();
 
+    /// <summary>
+    /// Compares a fresh copy of the graph against the users already in it, in time linear in the size of both
+    /// </summary>
+    static social_graph_diff diff_users(
+        _In_ const xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)& previousUsers,
+        _In_ const std::vector<xbox_social_user>& currentUsers
+        );
+
 protected:
     static const std::chrono::minutes REFRESH_TIME_MIN;
 
@@ -459,7 +540,7 @@ protected:
         _In_ xbox::services::real_time_activity::real_time_activity_connection_state rtaState
         );
 
-    void perform_diff(_In_ const xsapi_internal_unordered_map(uint64_t, xbox_social_user)& xboxSocialUsers);
+    void perform_diff(_In_ const std::vector<xbox_social_user>& xboxSocialUsers);
 
     void set_state(_In_ social_graph_state socialGraphState);
 
@@ -496,6 +577,9 @@ protected:
 
     void refresh_graph_helper(std::vector<uint64_t>& userRefreshList);
 
+    void push_presence_to_other_graphs(_In_ const xsapi_internal_vector(social_manager_presence_record)& presenceRecords);
+
+    friend class social_user_store;
 
     bool m_isInitialized;
     bool m_wasDisconnected;
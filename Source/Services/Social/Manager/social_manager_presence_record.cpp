@@ -10,6 +10,7 @@
 #include "pch.h"
 #include "xsapi/social_manager.h"
 #include "xsapi/presence.h"
+#include "social_manager_internal.h"
 
 using namespace xbox::services::presence;
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SOCIAL_MANAGER_CPP_BEGIN
@@ -18,6 +19,7 @@ social_manager_presence_record::social_manager_presence_record() :
     m_userState(xbox::services::presence::user_presence_state::unknown),
     m_xboxUserId(0)
 {
+    update_fingerprint();
 }
 
 social_manager_presence_record::social_manager_presence_record(
@@ -40,6 +42,8 @@ social_manager_presence_record::social_manager_presence_record(
             ++counter;
         }
     }
+
+    update_fingerprint();
 }
 
 xbox::services::presence::user_presence_state
@@ -103,6 +107,7 @@ social_manager_presence_record::_Deserialize(
         }
     }
 
+    returnObject.update_fingerprint();
     return returnObject;
 }
 
@@ -133,39 +138,42 @@ social_manager_presence_record::presence_title_records() const
     return returnVec;
 }
 
-bool
-social_manager_presence_record::_Compare(
-    _In_ const social_manager_presence_record& presenceRecord
-    ) const
+uint64_t
+social_manager_presence_record::_Fingerprint() const
 {
-    if (presenceRecord.m_userState != m_userState)
-    {
-        return true;
-    }
-
+    return m_fingerprint;
+}
 
-    for (auto& titleRecord : presenceRecord.m_presenceVec)
+void
+social_manager_presence_record::update_fingerprint()
+{
+    // Title records are summed so their order doesn't matter, and the device they are on is ignored
+    uint64_t titleRecordsFingerprint = 0;
+    for (auto& titleRecord : m_presenceVec)
     {
-        bool wasTitleFound = false;
-        for (auto& compareTitleRecord : m_presenceVec)
+        if (!titleRecord._Is_null())
         {
-            if (compareTitleRecord.title_id() == titleRecord.title_id()
-                && utils::str_icmp(compareTitleRecord.presence_text(), titleRecord.presence_text()) == 0
-                && compareTitleRecord.is_title_active() == titleRecord.is_title_active()
-                && compareTitleRecord.is_broadcasting() == titleRecord.is_broadcasting()
-                )
-            {
-                wasTitleFound = true;
-            }
-        }
-
-        if (!wasTitleFound)
-        {
-            return true;
+            titleRecordsFingerprint += social_fingerprint()
+                .add(titleRecord.title_id())
+                .add(titleRecord.presence_text())
+                .add(titleRecord.is_title_active())
+                .add(titleRecord.is_broadcasting())
+                .value();
         }
     }
 
-    return false;
+    m_fingerprint = social_fingerprint()
+        .add(static_cast<uint64_t>(m_userState))
+        .add(titleRecordsFingerprint)
+        .value();
+}
+
+bool
+social_manager_presence_record::_Compare(
+    _In_ const social_manager_presence_record& presenceRecord
+    ) const
+{
+    return presenceRecord.m_fingerprint != m_fingerprint;
 }
 
 void
@@ -195,6 +203,8 @@ social_manager_presence_record::_Update_device(
     {
         m_userState = user_presence_state::offline;
     }
+
+    update_fingerprint();
 }
 
 void
@@ -211,6 +221,8 @@ social_manager_presence_record::_Remove_title(
             break;
         }
     }
+
+    update_fingerprint();
 }
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SOCIAL_MANAGER_CPP_END
\ No newline at end of file
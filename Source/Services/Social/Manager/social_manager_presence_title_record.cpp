@@ -22,7 +22,6 @@ social_manager_presence_title_record::social_manager_presence_title_record() :
     m_deviceType(presence_device_type::unknown),
     m_isNull(true)
 {
-    initialize_char_arr(m_presenceText);
 }
 
 social_manager_presence_title_record::social_manager_presence_title_record(
@@ -33,9 +32,9 @@ social_manager_presence_title_record::social_manager_presence_title_record(
     m_isBroadcasting(presenceTitleRecord.broadcast_record().start_time() != utility::datetime()),
     m_isTitleActive(presenceTitleRecord.is_title_active()),
     m_deviceType(deviceType),
-    m_isNull(false)
+    m_isNull(false),
+    m_presenceText(presenceTitleRecord.presence(), RICH_PRESENCE_CHAR_SIZE - 1)
 {
-    utils::char_t_copy(m_presenceText, ARRAYSIZE(m_presenceText), presenceTitleRecord.presence().c_str());
 }
 
 uint32_t
@@ -53,7 +52,7 @@ social_manager_presence_title_record::is_title_active() const
 const char_t*
 social_manager_presence_title_record::presence_text() const
 {
-    return m_presenceText;
+    return m_presenceText.c_str();
 }
 
 bool social_manager_presence_title_record::is_broadcasting() const
@@ -85,7 +84,7 @@ social_manager_presence_title_record::_Deserialize(
 
     auto deviceString = utils::extract_json_string(json, _T("Device"), errc);
     returnObject.m_deviceType = presence_device_record::_Convert_string_to_presence_device_type(deviceString);
-    utils::extract_json_string_to_char_t_array(json, _T("PresenceText"), errc, returnObject.m_presenceText, ARRAYSIZE(returnObject.m_presenceText));
+    returnObject.m_presenceText = pooled_string(utils::extract_json_string(json, _T("PresenceText"), errc), RICH_PRESENCE_CHAR_SIZE - 1);
     auto state = utils::extract_json_string(json, _T("State"), errc);
     returnObject.m_isTitleActive = (!state.empty() && utils::str_icmp(state, _T("active")) == 0);
     returnObject.m_titleId = utils::string_t_to_uint32(utils::extract_json_string(json, _T("TitleId"), errc));
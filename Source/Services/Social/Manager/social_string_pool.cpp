@@ -0,0 +1,221 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "social_string_pool.h"
+
+using namespace xbox::services::system;
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SOCIAL_MANAGER_CPP_BEGIN
+
+static std::mutex g_socialStringPoolSingletonLock;
+// Never deleted, so users destroyed along with other statics can still release their strings
+static std::atomic<social_string_pool*> g_socialStringPoolSingleton(nullptr);
+
+social_string_pool*
+social_string_pool::get_singleton_instance()
+{
+    social_string_pool* pool = g_socialStringPoolSingleton.load(std::memory_order_acquire);
+    if (pool == nullptr)
+    {
+        std::lock_guard<std::mutex> guard(g_socialStringPoolSingletonLock);
+        pool = g_socialStringPoolSingleton.load(std::memory_order_relaxed);
+        if (pool == nullptr)
+        {
+            pool = new social_string_pool();
+            g_socialStringPoolSingleton.store(pool, std::memory_order_release);
+        }
+    }
+
+    return pool;
+}
+
+social_string_pool::social_string_pool() :
+    m_bytes(0)
+{
+}
+
+size_t
+social_string_pool::hash_string(
+    _In_ const char_t* text,
+    _In_ size_t length
+    )
+{
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= static_cast<uint64_t>(text[i]);
+        hash *= 1099511628211ULL;
+    }
+
+    return static_cast<size_t>(hash);
+}
+
+pooled_string_entry*
+social_string_pool::intern(
+    _In_ const char_t* text,
+    _In_ size_t length
+    )
+{
+    if (text == nullptr || length == 0)
+    {
+        return nullptr;
+    }
+
+    string_key key;
+    key.text = text;
+    key.length = length;
+    key.hash = hash_string(text, length);
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    auto iter = m_strings.find(key);
+    if (iter != m_strings.end())
+    {
+        // May bring an entry back from zero; release only frees entries that are still at zero under m_lock
+        iter->second->refCount.fetch_add(1, std::memory_order_relaxed);
+        return iter->second;
+    }
+
+    size_t size = offsetof(pooled_string_entry, text) + (length + 1) * sizeof(char_t);
+    auto entry = static_cast<pooled_string_entry*>(xsapi_memory::mem_alloc(size));
+    if (entry == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    new (&entry->refCount) std::atomic<uint32_t>(1);
+    entry->length = length;
+    entry->hash = key.hash;
+    memcpy(entry->text, text, length * sizeof(char_t));
+    entry->text[length] = 0;
+
+    key.text = entry->text;
+    m_strings[key] = entry;
+    m_bytes += size;
+    return entry;
+}
+
+void
+social_string_pool::add_ref(
+    _In_ pooled_string_entry* entry
+    )
+{
+    if (entry != nullptr)
+    {
+        entry->refCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void
+social_string_pool::release(
+    _In_ pooled_string_entry* entry
+    )
+{
+    if (entry == nullptr)
+    {
+        return;
+    }
+
+    // Only drop the last reference under m_lock, so intern can't hand out an entry that is being freed
+    uint32_t refCount = entry->refCount.load(std::memory_order_relaxed);
+    while (refCount > 1)
+    {
+        if (entry->refCount.compare_exchange_weak(refCount, refCount - 1, std::memory_order_release, std::memory_order_relaxed))
+        {
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (entry->refCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+    {
+        return;
+    }
+
+    string_key key;
+    key.text = entry->text;
+    key.length = entry->length;
+    key.hash = entry->hash;
+    m_strings.erase(key);
+    m_bytes -= offsetof(pooled_string_entry, text) + (entry->length + 1) * sizeof(char_t);
+
+    entry->refCount.~atomic();
+    xsapi_memory::mem_free(entry);
+}
+
+social_string_pool_stats
+social_string_pool::stats()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    social_string_pool_stats stats;
+    stats.stringCount = m_strings.size();
+    stats.bytes = m_bytes;
+    for (const auto& pooledString : m_strings)
+    {
+        stats.referenceCount += pooledString.second->refCount.load(std::memory_order_relaxed);
+    }
+
+    return stats;
+}
+
+pooled_string::pooled_string() :
+    m_entry(nullptr)
+{
+}
+
+pooled_string::pooled_string(
+    _In_ const string_t& value,
+    _In_ size_t maxLength
+    ) :
+    m_entry(social_string_pool::get_singleton_instance()->intern(value.c_str(), __min(value.size(), maxLength)))
+{
+}
+
+pooled_string::pooled_string(
+    _In_ const pooled_string& other
+    ) :
+    m_entry(other.m_entry)
+{
+    social_string_pool::add_ref(m_entry);
+}
+
+pooled_string&
+pooled_string::operator=(
+    _In_ const pooled_string& other
+    )
+{
+    if (m_entry != other.m_entry)
+    {
+        social_string_pool::add_ref(other.m_entry);
+        if (m_entry != nullptr)
+        {
+            social_string_pool::get_singleton_instance()->release(m_entry);
+        }
+        m_entry = other.m_entry;
+    }
+
+    return *this;
+}
+
+pooled_string::~pooled_string()
+{
+    if (m_entry != nullptr)
+    {
+        social_string_pool::get_singleton_instance()->release(m_entry);
+    }
+}
+
+const char_t*
+pooled_string::c_str() const
+{
+    return m_entry != nullptr ? m_entry->text : _T("");
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SOCIAL_MANAGER_CPP_END
@@ -0,0 +1,108 @@
+///*********************************************************
+///
+/// Copyright (c) Microsoft. All rights reserved.
+/// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+/// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+/// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+/// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+///
+///*********************************************************
+#pragma once
+#include "xsapi/social_manager.h"
+#include "xsapi/mem.h"
+#include <atomic>
+
+namespace xbox { namespace services { namespace social { namespace manager {
+
+struct pooled_string_entry
+{
+    std::atomic<uint32_t> refCount;
+    size_t length;
+    size_t hash;
+    // Allocated to fit length characters and a null terminator
+    char_t text[1];
+};
+
+struct social_string_pool_stats
+{
+    social_string_pool_stats() :
+        stringCount(0),
+        bytes(0),
+        referenceCount(0)
+    {
+    }
+
+    /// <summary>
+    /// Distinct strings in the pool
+    /// </summary>
+    size_t stringCount;
+
+    /// <summary>
+    /// Memory used by the strings, including their bookkeeping but not the pool's index
+    /// </summary>
+    size_t bytes;
+
+    /// <summary>
+    /// References held to strings in the pool. Each one would be a separate copy without the pool.
+    /// </summary>
+    size_t referenceCount;
+};
+
+/// <summary>
+/// Process wide pool of the strings held by xbox_social_users. Gamertags, colors and presence text
+/// repeat across a graph and the same user shows up in both of a graph's buffers and in the graphs of
+/// other local users, so each distinct string is stored once and reference counted.
+/// </summary>
+class social_string_pool
+{
+public:
+    static social_string_pool* get_singleton_instance();
+
+    /// <summary>
+    /// Returns the entry for the string with one reference added, or nullptr for an empty string
+    /// </summary>
+    pooled_string_entry* intern(
+        _In_ const char_t* text,
+        _In_ size_t length
+        );
+
+    static void add_ref(_In_ pooled_string_entry* entry);
+
+    void release(_In_ pooled_string_entry* entry);
+
+    social_string_pool_stats stats();
+
+private:
+    social_string_pool();
+
+    struct string_key
+    {
+        const char_t* text;
+        size_t length;
+        size_t hash;
+    };
+
+    struct string_key_hash
+    {
+        size_t operator()(_In_ const string_key& key) const { return key.hash; }
+    };
+
+    struct string_key_equal
+    {
+        bool operator()(_In_ const string_key& lhs, _In_ const string_key& rhs) const
+        {
+            return lhs.length == rhs.length && memcmp(lhs.text, rhs.text, lhs.length * sizeof(char_t)) == 0;
+        }
+    };
+
+    static size_t hash_string(
+        _In_ const char_t* text,
+        _In_ size_t length
+        );
+
+    std::mutex m_lock;
+    std::unordered_map<string_key, pooled_string_entry*, string_key_hash, string_key_equal, xsapi_stl_allocator<std::pair<const string_key, pooled_string_entry*>>> m_strings;
+    size_t m_bytes;
+};
+
+}}}}
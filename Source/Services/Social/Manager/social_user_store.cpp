@@ -0,0 +1,414 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "social_user_store.h"
+#include "social_manager_internal.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SOCIAL_MANAGER_CPP_BEGIN
+
+static std::mutex g_socialUserStoreSingletonLock;
+// Never deleted, so graphs destroyed along with other statics can still remove themselves
+static std::atomic<social_user_store*> g_socialUserStoreSingleton(nullptr);
+
+social_user_store*
+social_user_store::get_singleton_instance()
+{
+    social_user_store* store = g_socialUserStoreSingleton.load(std::memory_order_acquire);
+    if (store == nullptr)
+    {
+        std::lock_guard<std::mutex> guard(g_socialUserStoreSingletonLock);
+        store = g_socialUserStoreSingleton.load(std::memory_order_relaxed);
+        if (store == nullptr)
+        {
+            store = new social_user_store();
+            g_socialUserStoreSingleton.store(store, std::memory_order_release);
+        }
+    }
+
+    return store;
+}
+
+social_user_store::social_user_store() :
+    m_isSharingEnabled(false),
+    m_userReferenceCount(0),
+    m_presencePollsRequested(0),
+    m_presencePollsSkipped(0)
+{
+}
+
+bool
+social_user_store::set_sharing_enabled(
+    _In_ bool isSharingEnabled
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (!m_users.empty())
+    {
+        return false;
+    }
+
+    m_isSharingEnabled = isSharingEnabled;
+    return true;
+}
+
+bool
+social_user_store::is_sharing_enabled()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_isSharingEnabled;
+}
+
+std::vector<uint64_t>
+social_user_store::add_users(
+    _In_ const std::shared_ptr<social_graph>& graph,
+    _In_ const std::vector<uint64_t>& users
+    )
+{
+    std::vector<uint64_t> usersToSubscribe;
+    std::lock_guard<std::mutex> lock(m_lock);
+    for (auto user : users)
+    {
+        auto& entry = m_users[user];
+        bool isHeld = false;
+        for (auto& graphReference : entry.graphs)
+        {
+            if (graphReference.graph == graph.get())
+            {
+                isHeld = true;
+                break;
+            }
+        }
+
+        if (!isHeld)
+        {
+            graph_reference graphReference;
+            graphReference.graph = graph.get();
+            graphReference.weakGraph = graph;
+            entry.graphs.push_back(graphReference);
+            ++m_userReferenceCount;
+        }
+
+        if (!m_isSharingEnabled)
+        {
+            usersToSubscribe.push_back(user);
+        }
+        else if (entry.subscriptionOwner == nullptr)
+        {
+            entry.subscriptionOwner = graph.get();
+            usersToSubscribe.push_back(user);
+        }
+    }
+
+    return usersToSubscribe;
+}
+
+std::vector<uint64_t>
+social_user_store::remove_users(
+    _In_ const social_graph* graph,
+    _In_ const std::vector<uint64_t>& users
+    )
+{
+    std::vector<uint64_t> usersToUnsubscribe;
+    graph_user_list handovers;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        for (auto user : users)
+        {
+            if (remove_graph_from_user(graph, user, handovers) || !m_isSharingEnabled)
+            {
+                usersToUnsubscribe.push_back(user);
+            }
+        }
+    }
+
+    complete_handovers(handovers);
+    return usersToUnsubscribe;
+}
+
+void
+social_user_store::remove_graph(
+    _In_ const social_graph* graph
+    )
+{
+    graph_user_list handovers;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        std::vector<uint64_t> users;
+        for (auto& userPair : m_users)
+        {
+            for (auto& graphReference : userPair.second.graphs)
+            {
+                if (graphReference.graph == graph)
+                {
+                    users.push_back(userPair.first);
+                    break;
+                }
+            }
+        }
+
+        for (auto user : users)
+        {
+            remove_graph_from_user(graph, user, handovers);
+        }
+    }
+
+    complete_handovers(handovers);
+}
+
+bool
+social_user_store::remove_graph_from_user(
+    _In_ const social_graph* graph,
+    _In_ uint64_t user,
+    _Inout_ graph_user_list& handovers
+    )
+{
+    auto userIter = m_users.find(user);
+    if (userIter == m_users.end())
+    {
+        return false;
+    }
+
+    auto& entry = userIter->second;
+    for (auto iter = entry.graphs.begin(); iter != entry.graphs.end(); ++iter)
+    {
+        if (iter->graph == graph)
+        {
+            entry.graphs.erase(iter);
+            --m_userReferenceCount;
+            break;
+        }
+    }
+
+    bool wasOwner = entry.subscriptionOwner == graph;
+    if (entry.graphs.empty())
+    {
+        m_users.erase(userIter);
+        return wasOwner;
+    }
+
+    if (wasOwner)
+    {
+        entry.subscriptionOwner = nullptr;
+        for (auto& graphReference : entry.graphs)
+        {
+            auto newOwner = graphReference.weakGraph.lock();
+            if (newOwner != nullptr)
+            {
+                entry.subscriptionOwner = graphReference.graph;
+                add_to_graph_list(handovers, newOwner, user);
+                break;
+            }
+        }
+    }
+
+    return wasOwner;
+}
+
+void
+social_user_store::add_to_graph_list(
+    _Inout_ graph_user_list& graphList,
+    _In_ const std::shared_ptr<social_graph>& graph,
+    _In_ uint64_t user
+    )
+{
+    for (auto& graphUsers : graphList)
+    {
+        if (graphUsers.first == graph)
+        {
+            graphUsers.second.push_back(user);
+            return;
+        }
+    }
+
+    graphList.push_back(std::make_pair(graph, std::vector<uint64_t>(1, user)));
+}
+
+void
+social_user_store::complete_handovers(
+    _In_ const graph_user_list& handovers
+    )
+{
+    // The graphs take their own locks, so this is only called once m_lock has been released
+    for (auto& handover : handovers)
+    {
+        LOGS_DEBUG << "social_user_store: handing " << handover.second.size() << " presence subscriptions over to another local user";
+        handover.first->setup_device_and_presence_subscriptions(handover.second);
+    }
+}
+
+std::vector<uint64_t>
+social_user_store::subscribed_users(
+    _In_ const social_graph* graph,
+    _In_ const std::vector<uint64_t>& users
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (!m_isSharingEnabled)
+    {
+        return users;
+    }
+
+    std::vector<uint64_t> subscribedUsers;
+    for (auto user : users)
+    {
+        auto userIter = m_users.find(user);
+        if (userIter != m_users.end() && userIter->second.subscriptionOwner == graph)
+        {
+            subscribedUsers.push_back(user);
+        }
+    }
+
+    return subscribedUsers;
+}
+
+std::vector<std::shared_ptr<social_graph>>
+social_user_store::other_graphs_with_user(
+    _In_ const social_graph* graph,
+    _In_ uint64_t user
+    )
+{
+    std::vector<std::shared_ptr<social_graph>> graphs;
+    std::lock_guard<std::mutex> lock(m_lock);
+    auto userIter = m_users.find(user);
+    if (!m_isSharingEnabled || userIter == m_users.end())
+    {
+        return graphs;
+    }
+
+    for (auto& graphReference : userIter->second.graphs)
+    {
+        if (graphReference.graph != graph)
+        {
+            auto otherGraph = graphReference.weakGraph.lock();
+            if (otherGraph != nullptr)
+            {
+                graphs.push_back(otherGraph);
+            }
+        }
+    }
+
+    return graphs;
+}
+
+std::vector<std::pair<std::shared_ptr<social_graph>, std::vector<uint64_t>>>
+social_user_store::other_graphs_with_users(
+    _In_ const social_graph* graph,
+    _In_ const std::vector<uint64_t>& users
+    )
+{
+    graph_user_list graphs;
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (!m_isSharingEnabled)
+    {
+        return graphs;
+    }
+
+    for (auto user : users)
+    {
+        auto userIter = m_users.find(user);
+        if (userIter == m_users.end())
+        {
+            continue;
+        }
+
+        for (auto& graphReference : userIter->second.graphs)
+        {
+            if (graphReference.graph != graph)
+            {
+                auto otherGraph = graphReference.weakGraph.lock();
+                if (otherGraph != nullptr)
+                {
+                    add_to_graph_list(graphs, otherGraph, user);
+                }
+            }
+        }
+    }
+
+    return graphs;
+}
+
+std::vector<uint64_t>
+social_user_store::claim_presence_poll(
+    _In_ const std::vector<uint64_t>& users,
+    _In_ std::chrono::milliseconds pollInterval
+    )
+{
+    std::vector<uint64_t> usersToPoll;
+    usersToPoll.reserve(users.size());
+    auto now = chrono_clock_t::now();
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_presencePollsRequested += users.size();
+    if (!m_isSharingEnabled)
+    {
+        return users;
+    }
+
+    for (auto user : users)
+    {
+        auto userIter = m_users.find(user);
+        if (userIter == m_users.end())
+        {
+            usersToPoll.push_back(user);
+            continue;
+        }
+
+        auto& lastPresencePoll = userIter->second.lastPresencePoll;
+        if (lastPresencePoll != chrono_clock_t::time_point() && now - lastPresencePoll < pollInterval)
+        {
+            ++m_presencePollsSkipped;
+            continue;
+        }
+
+        lastPresencePoll = now;
+        usersToPoll.push_back(user);
+    }
+
+    return usersToPoll;
+}
+
+social_user_store_stats
+social_user_store::stats()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    social_user_store_stats stats;
+    stats.distinctUserCount = m_users.size();
+    stats.userReferenceCount = m_userReferenceCount;
+    if (!m_isSharingEnabled)
+    {
+        stats.subscribedUserCount = m_userReferenceCount;
+    }
+    else
+    {
+        for (auto& userPair : m_users)
+        {
+            if (userPair.second.subscriptionOwner != nullptr)
+            {
+                ++stats.subscribedUserCount;
+            }
+        }
+    }
+    stats.presencePollsRequested = m_presencePollsRequested;
+    stats.presencePollsSkipped = m_presencePollsSkipped;
+    return stats;
+}
+
+void
+social_user_store::_Reset()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_users.clear();
+    m_isSharingEnabled = false;
+    m_userReferenceCount = 0;
+    m_presencePollsRequested = 0;
+    m_presencePollsSkipped = 0;
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SOCIAL_MANAGER_CPP_END
@@ -0,0 +1,210 @@
+///*********************************************************
+///
+/// Copyright (c) Microsoft. All rights reserved.
+/// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+/// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+/// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+/// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+///
+///*********************************************************
+#pragma once
+#include "xsapi/social_manager.h"
+#include "xsapi/mem.h"
+
+namespace xbox { namespace services { namespace social { namespace manager {
+
+class social_graph;
+
+struct social_user_store_stats
+{
+    social_user_store_stats() :
+        distinctUserCount(0),
+        userReferenceCount(0),
+        subscribedUserCount(0),
+        presencePollsRequested(0),
+        presencePollsSkipped(0)
+    {
+    }
+
+    /// <summary>
+    /// Users held by at least one local user's social graph
+    /// </summary>
+    size_t distinctUserCount;
+
+    /// <summary>
+    /// Users summed over every local user's social graph, which is how many would be stored and subscribed to without sharing
+    /// </summary>
+    size_t userReferenceCount;
+
+    /// <summary>
+    /// Presence subscriptions held across all social graphs, one per user while sharing is enabled
+    /// </summary>
+    size_t subscribedUserCount;
+
+    /// <summary>
+    /// Users the social graphs asked to poll presence for
+    /// </summary>
+    uint64_t presencePollsRequested;
+
+    /// <summary>
+    /// Presence polls skipped because another social graph had just polled the user
+    /// </summary>
+    uint64_t presencePollsSkipped;
+
+    /// <summary>
+    /// How many social graphs hold each user on average
+    /// </summary>
+    double user_dedup_ratio() const
+    {
+        return distinctUserCount == 0 ? 1.0 : static_cast<double>(userReferenceCount) / distinctUserCount;
+    }
+
+    /// <summary>
+    /// How many presence subscriptions each one stands in for on average
+    /// </summary>
+    double subscription_dedup_ratio() const
+    {
+        return subscribedUserCount == 0 ? 1.0 : static_cast<double>(userReferenceCount) / subscribedUserCount;
+    }
+
+    /// <summary>
+    /// Fraction of requested presence polls that were skipped
+    /// </summary>
+    double presence_poll_dedup_ratio() const
+    {
+        return presencePollsRequested == 0 ? 0.0 : static_cast<double>(presencePollsSkipped) / presencePollsRequested;
+    }
+};
+
+/// <summary>
+/// Process wide record of which local users' social graphs hold each user. With sharing enabled, friends
+/// shared between local users are only subscribed to and polled once: each user's device and title presence
+/// subscriptions are made by one of the graphs holding them, and presence it receives or fetches for the user
+/// is passed on to the other graphs. Relationship flags stay with each graph's own copy of the user, and the
+/// strings those copies hold are already shared through the social_string_pool.
+/// With sharing disabled every graph subscribes to and polls its own users, and the store only keeps count.
+/// </summary>
+class social_user_store
+{
+public:
+    static social_user_store* get_singleton_instance();
+
+    /// <summary>
+    /// Turns sharing on or off. Fails if any graph holds users, since their subscriptions were set up the other way.
+    /// </summary>
+    bool set_sharing_enabled(_In_ bool isSharingEnabled);
+
+    bool is_sharing_enabled();
+
+    /// <summary>
+    /// Records that a graph holds the users and returns the ones it should subscribe to, which are those
+    /// no other graph has subscribed to
+    /// </summary>
+    std::vector<uint64_t> add_users(
+        _In_ const std::shared_ptr<social_graph>& graph,
+        _In_ const std::vector<uint64_t>& users
+        );
+
+    /// <summary>
+    /// Records that a graph no longer holds the users and returns the ones it should unsubscribe from.
+    /// Subscriptions to users other graphs still hold are handed over to one of those graphs.
+    /// </summary>
+    std::vector<uint64_t> remove_users(
+        _In_ const social_graph* graph,
+        _In_ const std::vector<uint64_t>& users
+        );
+
+    /// <summary>
+    /// Drops a graph that is going away from every user it held, handing its subscriptions over
+    /// </summary>
+    void remove_graph(
+        _In_ const social_graph* graph
+        );
+
+    /// <summary>
+    /// Returns the users the graph is responsible for subscribing to
+    /// </summary>
+    std::vector<uint64_t> subscribed_users(
+        _In_ const social_graph* graph,
+        _In_ const std::vector<uint64_t>& users
+        );
+
+    /// <summary>
+    /// Returns the other graphs that hold a user
+    /// </summary>
+    std::vector<std::shared_ptr<social_graph>> other_graphs_with_user(
+        _In_ const social_graph* graph,
+        _In_ uint64_t user
+        );
+
+    /// <summary>
+    /// Returns the other graphs that hold any of the users, along with the users each one holds
+    /// </summary>
+    std::vector<std::pair<std::shared_ptr<social_graph>, std::vector<uint64_t>>> other_graphs_with_users(
+        _In_ const social_graph* graph,
+        _In_ const std::vector<uint64_t>& users
+        );
+
+    /// <summary>
+    /// Returns the users whose presence has not been polled by any graph within pollInterval,
+    /// and marks them as polled now
+    /// </summary>
+    std::vector<uint64_t> claim_presence_poll(
+        _In_ const std::vector<uint64_t>& users,
+        _In_ std::chrono::milliseconds pollInterval
+        );
+
+    social_user_store_stats stats();
+
+    /// <summary>
+    /// Internal function
+    /// Forgets every user and counter and turns sharing off, so a test starts from an empty store
+    /// </summary>
+    void _Reset();
+
+private:
+    social_user_store();
+
+    struct graph_reference
+    {
+        const social_graph* graph;
+        std::weak_ptr<social_graph> weakGraph;
+    };
+
+    struct user_entry
+    {
+        user_entry() : subscriptionOwner(nullptr) {}
+
+        std::vector<graph_reference> graphs;
+        const social_graph* subscriptionOwner;
+        chrono_clock_t::time_point lastPresencePoll;
+    };
+
+    typedef std::vector<std::pair<std::shared_ptr<social_graph>, std::vector<uint64_t>>> graph_user_list;
+
+    // Called with m_lock held. Drops the graph from the user and picks a new subscription owner if it was the owner.
+    bool remove_graph_from_user(
+        _In_ const social_graph* graph,
+        _In_ uint64_t user,
+        _Inout_ graph_user_list& handovers
+        );
+
+    static void add_to_graph_list(
+        _Inout_ graph_user_list& graphList,
+        _In_ const std::shared_ptr<social_graph>& graph,
+        _In_ uint64_t user
+        );
+
+    static void complete_handovers(
+        _In_ const graph_user_list& handovers
+        );
+
+    std::mutex m_lock;
+    bool m_isSharingEnabled;
+    xsapi_internal_unordered_map(uint64_t, user_entry) m_users;
+    size_t m_userReferenceCount;
+    uint64_t m_presencePollsRequested;
+    uint64_t m_presencePollsSkipped;
+};
+
+}}}}
@@ -23,18 +23,13 @@ xbox_social_user::xbox_social_user() :
     m_isFollowedByCaller(false),
     m_useAvatar(false)
 {
-    initialize_char_arr(m_gamerscore);
-    initialize_char_arr(m_gamertag);
-    initialize_char_arr(m_xboxUserId);
-    initialize_char_arr(m_displayName);
-    initialize_char_arr(m_realName);
-    initialize_char_arr(m_displayPicUrlRaw);
+    update_profile_fingerprint();
 }
 
 const char_t*
 xbox_social_user::xbox_user_id() const
 {
-    return m_xboxUserId;
+    return m_xboxUserId.c_str();
 }
 
 uint64_t
@@ -64,19 +59,19 @@ xbox_social_user::is_followed_by_caller() const
 const char_t*
 xbox_social_user::display_name() const
 {
-    return m_displayName;
+    return m_displayName.c_str();
 }
 
 const char_t*
 xbox_social_user::real_name() const
 {
-    return m_realName;
+    return m_realName.c_str();
 }
 
 const char_t*
 xbox_social_user::display_pic_url_raw() const
 {
-    return m_displayPicUrlRaw;
+    return m_displayPicUrlRaw.c_str();
 }
 
 bool
@@ -88,13 +83,13 @@ xbox_social_user::use_avatar() const
 const char_t*
 xbox_social_user::gamerscore() const
 {
-    return m_gamerscore;
+    return m_gamerscore.c_str();
 }
 
 const char_t*
 xbox_social_user::gamertag() const
 {
-    return m_gamertag;
+    return m_gamertag.c_str();
 }
 
 const social_manager_presence_record&
@@ -129,6 +124,24 @@ xbox_social_user::preferred_color() const
     return m_preferredColor;
 }
 
+void
+xbox_social_user::update_profile_fingerprint()
+{
+    m_profileFingerprint = social_fingerprint()
+        .add(m_gamerscore.c_str())
+        .add(m_gamertag.c_str())
+        .add(m_displayName.c_str())
+        .add(m_realName.c_str())
+        .add(m_displayPicUrlRaw.c_str())
+        .add(m_useAvatar)
+        .add(m_titleHistory.has_user_played())
+        .add(static_cast<uint64_t>(m_titleHistory.last_time_user_played().to_interval()))
+        .add(m_preferredColor.primary_color())
+        .add(m_preferredColor.secondary_color())
+        .add(m_preferredColor.tertiary_color())
+        .value();
+}
+
 change_list_enum xbox_social_user::_Compare(
     _In_ const xbox_social_user& previous,
     _In_ const xbox_social_user& current
@@ -136,16 +149,7 @@ change_list_enum xbox_social_user::_Compare(
 {
     change_list_enum changeResult = change_list_enum::no_change;
 
-    if (
-        utils::str_icmp(previous.m_gamerscore, current.m_gamerscore) != 0 ||
-        previous.m_titleHistory != current.m_titleHistory ||
-        utils::str_icmp(previous.m_displayPicUrlRaw, current.m_displayPicUrlRaw) != 0 ||
-        previous.m_useAvatar != current.m_useAvatar ||
-        utils::str_icmp(previous.m_gamertag, current.m_gamertag) != 0 ||
-        utils::str_icmp(previous.m_displayName, current.m_displayName) != 0 ||
-        utils::str_icmp(previous.m_realName, current.m_realName) != 0 ||
-        previous.m_preferredColor != current.m_preferredColor
-        )
+    if (previous.m_profileFingerprint != current.m_profileFingerprint)
     {
         changeResult = static_cast<change_list_enum>(changeResult | change_list_enum::profile_change);
     }
@@ -176,17 +180,17 @@ xbox_social_user::_Deserialize(
     if (json.is_null()) return xbox_live_result<xbox_social_user>();
 
     std::error_code errc = xbox_live_error_code::no_error;
-    utils::extract_json_string_to_char_t_array(json, _T("xuid"), errc, returnObject.m_xboxUserId, ARRAYSIZE(returnObject.m_xboxUserId));
-    returnObject.m_xboxUserIdAsInt = utils::string_t_to_uint64(returnObject.m_xboxUserId);
+    returnObject.m_xboxUserId = pooled_string(utils::extract_json_string(json, _T("xuid"), errc), XBOX_USER_ID_CHAR_SIZE - 1);
+    returnObject.m_xboxUserIdAsInt = utils::string_t_to_uint64(returnObject.m_xboxUserId.c_str());
     returnObject.m_isFavorite = utils::extract_json_bool(json, _T("isFavorite"), errc);
     returnObject.m_isFollowedByCaller = utils::extract_json_bool(json, _T("isFollowedByCaller"), errc);
     returnObject.m_isFollowingCaller = utils::extract_json_bool(json, _T("isFollowingCaller"), errc);
-    utils::extract_json_string_to_char_t_array(json, _T("displayName"), errc, returnObject.m_displayName, ARRAYSIZE(returnObject.m_displayName));
-    utils::extract_json_string_to_char_t_array(json, _T("realName"), errc, returnObject.m_realName, ARRAYSIZE(returnObject.m_realName));
-    utils::extract_json_string_to_char_t_array(json, _T("displayPicRaw"), errc, returnObject.m_displayPicUrlRaw, ARRAYSIZE(returnObject.m_displayPicUrlRaw));
+    returnObject.m_displayName = pooled_string(utils::extract_json_string(json, _T("displayName"), errc), DISPLAY_NAME_CHAR_SIZE - 1);
+    returnObject.m_realName = pooled_string(utils::extract_json_string(json, _T("realName"), errc), REAL_NAME_CHAR_SIZE - 1);
+    returnObject.m_displayPicUrlRaw = pooled_string(utils::extract_json_string(json, _T("displayPicRaw"), errc), DISPLAY_PIC_URL_RAW_CHAR_SIZE - 1);
     returnObject.m_useAvatar = utils::extract_json_bool(json, _T("useAvatar"), errc);
-    utils::extract_json_string_to_char_t_array(json, _T("gamertag"), errc, returnObject.m_gamertag, ARRAYSIZE(returnObject.m_gamertag));
-    utils::extract_json_string_to_char_t_array(json, _T("gamerScore"), errc, returnObject.m_gamerscore, ARRAYSIZE(returnObject.m_gamerscore));
+    returnObject.m_gamertag = pooled_string(utils::extract_json_string(json, _T("gamertag"), errc), GAMERTAG_CHAR_SIZE - 1);
+    returnObject.m_gamerscore = pooled_string(utils::extract_json_string(json, _T("gamerScore"), errc), GAMERSCORE_CHAR_SIZE - 1);
 
     returnObject.m_presenceRecord = social_manager_presence_record::_Deserialize(
             json,
@@ -215,6 +219,7 @@ xbox_social_user::_Deserialize(
             errc
         ).payload();
 
+    returnObject.update_profile_fingerprint();
     return returnObject;
 }
 
@@ -12,6 +12,7 @@
 #include "utils.h"
 #include "user_context.h"
 #include "xbox_system_factory.h"
+#include "batch_fan_out.h"
 
 using namespace pplx;
 
@@ -77,15 +78,36 @@ profile_service::get_user_profiles(
     )
 {
     RETURN_TASK_CPP_INVALIDARGUMENT_IF(xboxUserIds.size() == 0, std::vector<xbox_user_profile>, "xbox user ids size is 0");
-    for (string_t s : xboxUserIds)
+    for (const string_t& s : xboxUserIds)
     {
         RETURN_TASK_CPP_INVALIDARGUMENT_IF(s.empty(), std::vector<xbox_user_profile>, "Found empty string in xbox user ids");
     }
 
+    auto userContext = m_userContext;
+    auto xboxLiveContextSettings = m_xboxLiveContextSettings;
+    auto appConfig = m_appConfig;
+    return batch_fan_out<string_t, xbox_user_profile>::run(
+        xboxUserIds,
+        MAX_USERS_PER_BATCH_REQUEST,
+        m_xboxLiveContextSettings->max_concurrent_batch_requests(),
+        [userContext, xboxLiveContextSettings, appConfig](const std::vector<string_t>& batchXboxUserIds)
+        {
+            return get_user_profiles_batch(userContext, xboxLiveContextSettings, appConfig, batchXboxUserIds);
+        });
+}
+
+pplx::task<xbox_live_result<std::vector<xbox_user_profile>>>
+profile_service::get_user_profiles_batch(
+    _In_ const std::shared_ptr<XBOX_LIVE_NAMESPACE::user_context>& userContext,
+    _In_ const std::shared_ptr<XBOX_LIVE_NAMESPACE::xbox_live_context_settings>& xboxLiveContextSettings,
+    _In_ const std::shared_ptr<XBOX_LIVE_NAMESPACE::xbox_live_app_config>& appConfig,
+    _In_ const std::vector< string_t >& xboxUserIds
+    )
+{
     std::shared_ptr<http_call> httpCall = xbox::services::system::xbox_system_factory::get_factory()->create_http_call(
-        m_xboxLiveContextSettings,
+        xboxLiveContextSettings,
         _T("POST"),
-        utils::create_xboxlive_endpoint(_T("profile"), m_appConfig),
+        utils::create_xboxlive_endpoint(_T("profile"), appConfig),
         _T("/users/batch/profile/settings"),
         xbox_live_api::get_user_profiles
         );
@@ -97,7 +119,7 @@ profile_service::get_user_profiles(
 
     httpCall->set_request_body(request.serialize());
 
-    auto task = httpCall->get_response_with_auth(m_userContext)
+    auto task = httpCall->get_response_with_auth(userContext)
     .then([](std::shared_ptr<http_call_response> response) 
     {
         if (response->response_body_json().size() != 0)
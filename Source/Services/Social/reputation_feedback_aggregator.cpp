@@ -0,0 +1,330 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "reputation_feedback_aggregator.h"
+#include "utils.h"
+#if !XSAPI_U
+#include "ppltasks_extra.h"
+#else
+#include "ppltasks_extra_unix.h"
+#endif
+
+using namespace Concurrency::extras;
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SOCIAL_CPP_BEGIN
+
+const std::chrono::milliseconds reputation_feedback_aggregator::FLUSH_WINDOW = std::chrono::milliseconds(1000);
+const size_t reputation_feedback_aggregator::MAX_ITEMS_PER_BATCH = 50;
+const std::chrono::milliseconds reputation_feedback_aggregator::DEDUP_WINDOW = std::chrono::minutes(5);
+const uint32_t reputation_feedback_aggregator::MAX_RETRIES = 3;
+const std::chrono::milliseconds reputation_feedback_aggregator::RETRY_BASE_DELAY = std::chrono::milliseconds(2000);
+
+reputation_feedback_aggregator::reputation_feedback_aggregator(
+    _In_ std::chrono::milliseconds flushWindow,
+    _In_ size_t maxItemsPerBatch,
+    _In_ std::chrono::milliseconds dedupWindow,
+    _In_ uint32_t maxRetries,
+    _In_ std::chrono::milliseconds retryBaseDelay,
+    _In_ std::function<pplx::task<xbox_live_result<void>>(const std::vector<reputation_feedback_item>&)> sendHandler
+    ) :
+    m_flushWindow(flushWindow),
+    m_maxItemsPerBatch(__max(maxItemsPerBatch, static_cast<size_t>(1))),
+    m_dedupWindow(dedupWindow),
+    m_maxRetries(maxRetries),
+    m_retryBaseDelay(retryBaseDelay),
+    m_sendHandler(std::move(sendHandler)),
+    m_isFlushScheduled(false)
+{
+    XSAPI_ASSERT(m_sendHandler != nullptr);
+}
+
+string_t
+reputation_feedback_aggregator::make_key(
+    _In_ const reputation_feedback_item& feedbackItem
+    )
+{
+    const auto& sessionRef = feedbackItem.session_reference();
+    stringstream_t key;
+    key << feedbackItem.xbox_user_id() << _T('|') << static_cast<uint32_t>(feedbackItem.feedback_type());
+    if (!sessionRef.is_null())
+    {
+        key << _T('|') << sessionRef.service_configuration_id()
+            << _T('|') << sessionRef.session_template_name()
+            << _T('|') << sessionRef.session_name();
+    }
+
+    return key.str();
+}
+
+bool
+reputation_feedback_aggregator::is_retryable(
+    _In_ const std::error_code& errc
+    )
+{
+    return errc == xbox_live_error_condition::http_429_too_many_requests ||
+        errc == xbox_live_error_condition::http_service_timeout ||
+        errc == xbox_live_error_condition::network ||
+        errc == xbox_live_error_code::http_status_500_internal_server_error ||
+        errc == xbox_live_error_code::http_status_502_bad_gateway;
+}
+
+pplx::task<xbox_live_result<void>>
+reputation_feedback_aggregator::queue_feedback(
+    _In_ const reputation_feedback_item& feedbackItem
+    )
+{
+    auto key = make_key(feedbackItem);
+    auto now = chrono_clock_t::now();
+    pplx::task_completion_event<xbox_live_result<void>> tce;
+    std::shared_ptr<feedback_batch> fullBatch;
+    bool scheduleFlush = false;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        auto reportIter = m_reports.find(key);
+        if (reportIter != m_reports.end() && now - reportIter->second.queuedTime < m_dedupWindow)
+        {
+            ++m_stats.itemsDeduplicated;
+            if (reportIter->second.feedback == nullptr)
+            {
+                return pplx::task_from_result(xbox_live_result<void>());
+            }
+
+            reportIter->second.feedback->waiters.push_back(tce);
+            return pplx::create_task(tce);
+        }
+
+        auto feedback = std::make_shared<queued_feedback>();
+        feedback->item = feedbackItem;
+        feedback->key = key;
+        feedback->waiters.push_back(tce);
+
+        report_entry& entry = m_reports[key];
+        entry.queuedTime = now;
+        entry.feedback = feedback;
+
+        m_pending.push_back(feedback);
+        ++m_stats.itemsQueued;
+        m_stats.pendingItems = m_pending.size();
+        m_stats.peakPendingItems = __max(m_stats.peakPendingItems, m_stats.pendingItems);
+
+        if (m_pending.size() >= m_maxItemsPerBatch)
+        {
+            fullBatch = std::make_shared<feedback_batch>();
+            fullBatch->items.swap(m_pending);
+            m_stats.pendingItems = 0;
+            m_stats.inFlightItems += fullBatch->items.size();
+        }
+        else if (!m_isFlushScheduled)
+        {
+            m_isFlushScheduled = true;
+            scheduleFlush = true;
+        }
+    }
+
+    if (fullBatch != nullptr)
+    {
+        send_batch(fullBatch);
+    }
+    else if (scheduleFlush)
+    {
+        std::weak_ptr<reputation_feedback_aggregator> thisWeakPtr = shared_from_this();
+        create_delayed_task(
+            m_flushWindow,
+            [thisWeakPtr]()
+        {
+            std::shared_ptr<reputation_feedback_aggregator> pThis(thisWeakPtr.lock());
+            if (pThis != nullptr)
+            {
+                pThis->flush();
+            }
+        });
+    }
+
+    return pplx::create_task(tce);
+}
+
+void
+reputation_feedback_aggregator::flush()
+{
+    auto batch = std::make_shared<feedback_batch>();
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_isFlushScheduled = false;
+        batch->items.swap(m_pending);
+        m_stats.pendingItems = 0;
+        m_stats.inFlightItems += batch->items.size();
+        prune_reports(chrono_clock_t::now());
+    }
+
+    if (!batch->items.empty())
+    {
+        send_batch(batch);
+    }
+}
+
+void
+reputation_feedback_aggregator::prune_reports(
+    _In_ const chrono_clock_t::time_point& now
+    )
+{
+    for (auto iter = m_reports.begin(); iter != m_reports.end();)
+    {
+        if (iter->second.feedback == nullptr && now - iter->second.queuedTime >= m_dedupWindow)
+        {
+            iter = m_reports.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+}
+
+void
+reputation_feedback_aggregator::send_batch(
+    _In_ std::shared_ptr<feedback_batch> batch
+    )
+{
+    std::vector<reputation_feedback_item> feedbackItems;
+    feedbackItems.reserve(batch->items.size());
+    for (const auto& feedback : batch->items)
+    {
+        feedbackItems.push_back(feedback->item);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        ++m_stats.batchesSent;
+    }
+
+    std::weak_ptr<reputation_feedback_aggregator> thisWeakPtr = shared_from_this();
+    m_sendHandler(feedbackItems)
+    .then([thisWeakPtr, batch](pplx::task<xbox_live_result<void>> resultTask)
+    {
+        xbox_live_result<void> result;
+        try
+        {
+            result = resultTask.get();
+        }
+        catch (const std::exception&)
+        {
+            result = xbox_live_result<void>(xbox_live_error_code::runtime_error, "submit_batch_reputation_feedback failed");
+        }
+
+        std::shared_ptr<reputation_feedback_aggregator> pThis(thisWeakPtr.lock());
+        if (pThis != nullptr)
+        {
+            pThis->complete_batch(batch, result);
+        }
+        else
+        {
+            complete_waiters(batch, xbox_live_result<void>(xbox_live_error_code::runtime_error, "reputation_service was destroyed"));
+        }
+    });
+}
+
+void
+reputation_feedback_aggregator::complete_batch(
+    _In_ const std::shared_ptr<feedback_batch>& batch,
+    _In_ const xbox_live_result<void>& result
+    )
+{
+    if (result.err() && is_retryable(result.err()) && batch->attempt < m_maxRetries)
+    {
+        // 1x, 2x, 4x, ... the base delay
+        auto delay = m_retryBaseDelay * (static_cast<int64_t>(1) << batch->attempt);
+        ++batch->attempt;
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            ++m_stats.batchesRetried;
+        }
+
+        LOGS_DEBUG << "reputation_feedback_aggregator: retrying " << batch->items.size() << " feedback items in " << delay.count() << "ms";
+
+        std::weak_ptr<reputation_feedback_aggregator> thisWeakPtr = shared_from_this();
+        create_delayed_task(
+            delay,
+            [thisWeakPtr, batch]()
+        {
+            std::shared_ptr<reputation_feedback_aggregator> pThis(thisWeakPtr.lock());
+            if (pThis != nullptr)
+            {
+                pThis->send_batch(batch);
+            }
+            else
+            {
+                complete_waiters(batch, xbox_live_result<void>(xbox_live_error_code::runtime_error, "reputation_service was destroyed"));
+            }
+        });
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        for (auto& feedback : batch->items)
+        {
+            auto reportIter = m_reports.find(feedback->key);
+            if (reportIter != m_reports.end() && reportIter->second.feedback == feedback)
+            {
+                if (result.err())
+                {
+                    // Let the report be queued again
+                    m_reports.erase(reportIter);
+                }
+                else
+                {
+                    reportIter->second.feedback = nullptr;
+                }
+            }
+        }
+
+        m_stats.inFlightItems -= batch->items.size();
+        if (result.err())
+        {
+            m_stats.itemsFailed += batch->items.size();
+        }
+        else
+        {
+            m_stats.itemsSubmitted += batch->items.size();
+        }
+    }
+
+    if (result.err())
+    {
+        LOG_ERROR("reputation_feedback_aggregator: failed to submit feedback batch");
+    }
+
+    complete_waiters(batch, result);
+}
+
+void
+reputation_feedback_aggregator::complete_waiters(
+    _In_ const std::shared_ptr<feedback_batch>& batch,
+    _In_ const xbox_live_result<void>& result
+    )
+{
+    for (auto& feedback : batch->items)
+    {
+        for (auto& waiter : feedback->waiters)
+        {
+            waiter.set(result);
+        }
+    }
+}
+
+reputation_feedback_queue_stats
+reputation_feedback_aggregator::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_stats;
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SOCIAL_CPP_END
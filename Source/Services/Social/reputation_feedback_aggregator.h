@@ -0,0 +1,117 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+#include "xsapi/types.h"
+#include "xsapi/social.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SOCIAL_CPP_BEGIN
+
+/// <summary>
+/// Collects reputation feedback queued by one caller and submits it through the batch feedback endpoint,
+/// either once a batch is full or once the flush window has passed since the first item was queued.
+/// Batches that fail with a throttling, timeout or network error are resent with exponential backoff.
+/// The same report on the same user from the same session is only submitted once per dedup window;
+/// repeats wait on the original report, and a report that failed may be queued again.
+/// </summary>
+class reputation_feedback_aggregator : public std::enable_shared_from_this<reputation_feedback_aggregator>
+{
+public:
+    static const std::chrono::milliseconds FLUSH_WINDOW;
+    static const size_t MAX_ITEMS_PER_BATCH;
+    static const std::chrono::milliseconds DEDUP_WINDOW;
+    static const uint32_t MAX_RETRIES;
+    static const std::chrono::milliseconds RETRY_BASE_DELAY;
+
+    reputation_feedback_aggregator(
+        _In_ std::chrono::milliseconds flushWindow,
+        _In_ size_t maxItemsPerBatch,
+        _In_ std::chrono::milliseconds dedupWindow,
+        _In_ uint32_t maxRetries,
+        _In_ std::chrono::milliseconds retryBaseDelay,
+        _In_ std::function<pplx::task<xbox_live_result<void>>(const std::vector<reputation_feedback_item>&)> sendHandler
+        );
+
+    pplx::task<xbox_live_result<void>> queue_feedback(
+        _In_ const reputation_feedback_item& feedbackItem
+        );
+
+    /// <summary>
+    /// Sends everything queued so far without waiting for the flush window
+    /// </summary>
+    void flush();
+
+    reputation_feedback_queue_stats stats() const;
+
+private:
+    struct queued_feedback
+    {
+        reputation_feedback_item item;
+        string_t key;
+        std::vector<pplx::task_completion_event<xbox_live_result<void>>> waiters;
+    };
+
+    struct feedback_batch
+    {
+        feedback_batch() : attempt(0) {}
+
+        std::vector<std::shared_ptr<queued_feedback>> items;
+        uint32_t attempt;
+    };
+
+    struct report_entry
+    {
+        chrono_clock_t::time_point queuedTime;
+
+        // Null once the report has been submitted
+        std::shared_ptr<queued_feedback> feedback;
+    };
+
+    static string_t make_key(
+        _In_ const reputation_feedback_item& feedbackItem
+        );
+
+    static bool is_retryable(
+        _In_ const std::error_code& errc
+        );
+
+    // Called with m_lock held
+    void prune_reports(
+        _In_ const chrono_clock_t::time_point& now
+        );
+
+    void send_batch(
+        _In_ std::shared_ptr<feedback_batch> batch
+        );
+
+    void complete_batch(
+        _In_ const std::shared_ptr<feedback_batch>& batch,
+        _In_ const xbox_live_result<void>& result
+        );
+
+    static void complete_waiters(
+        _In_ const std::shared_ptr<feedback_batch>& batch,
+        _In_ const xbox_live_result<void>& result
+        );
+
+    std::chrono::milliseconds m_flushWindow;
+    size_t m_maxItemsPerBatch;
+    std::chrono::milliseconds m_dedupWindow;
+    uint32_t m_maxRetries;
+    std::chrono::milliseconds m_retryBaseDelay;
+    std::function<pplx::task<xbox_live_result<void>>(const std::vector<reputation_feedback_item>&)> m_sendHandler;
+
+    mutable std::mutex m_lock;
+    std::vector<std::shared_ptr<queued_feedback>> m_pending;
+    std::unordered_map<string_t, report_entry> m_reports;
+    bool m_isFlushScheduled;
+    reputation_feedback_queue_stats m_stats;
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SOCIAL_CPP_END
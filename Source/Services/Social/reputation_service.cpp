@@ -13,6 +13,7 @@
 #include "utils.h"
 #include "xbox_system_factory.h"
 #include "social_internal.h"
+#include "reputation_feedback_aggregator.h"
 
 using namespace pplx;
 
@@ -27,6 +28,19 @@ reputation_service::reputation_service(
     m_xboxLiveContextSettings(std::move(xboxLiveContextSettings)),
     m_appConfig(std::move(appConfig))
 {
+    auto sharedUserContext = m_userContext;
+    auto sharedSettings = m_xboxLiveContextSettings;
+    auto sharedAppConfig = m_appConfig;
+    m_feedbackAggregator = std::make_shared<reputation_feedback_aggregator>(
+        reputation_feedback_aggregator::FLUSH_WINDOW,
+        reputation_feedback_aggregator::MAX_ITEMS_PER_BATCH,
+        reputation_feedback_aggregator::DEDUP_WINDOW,
+        reputation_feedback_aggregator::MAX_RETRIES,
+        reputation_feedback_aggregator::RETRY_BASE_DELAY,
+        [sharedUserContext, sharedSettings, sharedAppConfig](const std::vector<reputation_feedback_item>& feedbackItems)
+        {
+            return send_batch_reputation_feedback(sharedUserContext, sharedSettings, sharedAppConfig, feedbackItems);
+        });
 }
 
 pplx::task<xbox_live_result<void>> 
@@ -44,11 +58,22 @@ reputation_service::submit_batch_reputation_feedback(
             "Reputation feedback type is out of range"
             );
     }
-    
+
+    return send_batch_reputation_feedback(m_userContext, m_xboxLiveContextSettings, m_appConfig, feedbackItems);
+}
+
+pplx::task<xbox_live_result<void>>
+reputation_service::send_batch_reputation_feedback(
+    _In_ const std::shared_ptr<xbox::services::user_context>& userContext,
+    _In_ const std::shared_ptr<xbox::services::xbox_live_context_settings>& xboxLiveContextSettings,
+    _In_ const std::shared_ptr<xbox::services::xbox_live_app_config>& appConfig,
+    _In_ const std::vector< reputation_feedback_item >& feedbackItems
+    )
+{
     std::shared_ptr<http_call> httpCall = xbox::services::system::xbox_system_factory::get_factory()->create_http_call(
-        m_xboxLiveContextSettings,
+        xboxLiveContextSettings,
         _T("POST"),
-        utils::create_xboxlive_endpoint(_T("reputation"), m_appConfig),
+        utils::create_xboxlive_endpoint(_T("reputation"), appConfig),
         _T("/users/batchtitlefeedback"),
         xbox_live_api::submit_batch_reputation_feedback
         );
@@ -61,7 +86,7 @@ reputation_service::submit_batch_reputation_feedback(
     RETURN_TASK_CPP_INVALIDARGUMENT_IF(err, void, "Invalid reputation_feedback_item");
     httpCall->set_request_body(request.serialize());
 
-    auto task = httpCall->get_response_with_auth(m_userContext, http_call_response_body_type::string_body)
+    auto task = httpCall->get_response_with_auth(userContext, http_call_response_body_type::string_body)
     .then([](std::shared_ptr<http_call_response> response)
     {
         return xbox_live_result<void>(response->err_code(), response->err_message());
@@ -72,6 +97,46 @@ reputation_service::submit_batch_reputation_feedback(
         );
 }
 
+pplx::task<xbox_live_result<void>>
+reputation_service::queue_reputation_feedback(
+    _In_ const reputation_feedback_item& feedbackItem
+    )
+{
+    RETURN_TASK_CPP_INVALIDARGUMENT_IF_STRING_EMPTY(feedbackItem.xbox_user_id(), void, "Xbox user id is empty");
+    RETURN_TASK_CPP_INVALIDARGUMENT_IF(
+        feedbackItem.feedback_type() < reputation_feedback_type::fair_play_kills_teammates ||
+        feedbackItem.feedback_type() > reputation_feedback_type::fair_play_leaderboard_cheater,
+        void,
+        "Reputation feedback type is out of range"
+        );
+
+    if (m_feedbackAggregator == nullptr)
+    {
+        return submit_batch_reputation_feedback(std::vector<reputation_feedback_item>(1, feedbackItem));
+    }
+
+    return m_feedbackAggregator->queue_feedback(feedbackItem);
+}
+
+void
+reputation_service::flush_reputation_feedback()
+{
+    if (m_feedbackAggregator != nullptr)
+    {
+        m_feedbackAggregator->flush();
+    }
+}
+
+reputation_feedback_queue_stats
+reputation_service::feedback_queue_stats() const
+{
+    if (m_feedbackAggregator == nullptr)
+    {
+        return reputation_feedback_queue_stats();
+    }
+
+    return m_feedbackAggregator->stats();
+}
 
 pplx::task<xbox_live_result<void>> 
 reputation_service::submit_reputation_feedback(
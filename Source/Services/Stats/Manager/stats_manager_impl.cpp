@@ -60,15 +60,46 @@ stats_manager_impl::initialize()
     );
 }
 
+uint64_t
+stats_manager_impl::user_key(
+    _In_ const xbox_live_user_t& user
+    )
+{
+    // Runs on every set_stat and get_stat, so the XUID is parsed in place rather than copied out first
+#if TV_API | XBOX_UWP
+    return _wtoi64(user->XboxUserId->Data());
+#else
+    return utils::string_t_to_uint64(user->xbox_user_id());
+#endif
+}
+
+stats_manager_impl::stats_user_shard&
+stats_manager_impl::user_shard(
+    _In_ uint64_t userKey
+    )
+{
+    return m_userShards[userKey % USER_SHARD_COUNT];
+}
+
+void
+stats_manager_impl::add_stat_event(
+    _In_ stat_event statEvent
+    )
+{
+    std::lock_guard<std::mutex> guard(m_statEventLock);
+    m_statEventList.push_back(std::move(statEvent));
+}
+
 xbox_live_result<void>
 stats_manager_impl::add_local_user(
     _In_ const xbox_live_user_t& user
     )
 {
-    std::lock_guard<std::mutex> guard(m_statsServiceMutex);
-    string_t userStr = user_context::get_user_id(user);
-    auto userIter = m_users.find(userStr);
-    if (userIter != m_users.end())
+    uint64_t userKey = user_key(user);
+    auto& shard = user_shard(userKey);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto userIter = shard.users.find(userKey);
+    if (userIter != shard.users.end())
     {
         return xbox_live_result<void>(xbox_live_error_code::invalid_argument, "User already in local map");
     }
@@ -82,10 +113,10 @@ stats_manager_impl::add_local_user(
         xboxLiveContextImpl->application_config()
         );
 
-    m_users[userStr] = stats_user_context();
+    shard.users[userKey] = stats_user_context();
     std::weak_ptr<stats_manager_impl> thisWeak = shared_from_this();
     simplifiedStatsService.get_stats_value_document()
-    .then([thisWeak, user, xboxLiveContextImpl, simplifiedStatsService, userStr](xbox_live_result<stats_value_document> statsValueDocResult)
+    .then([thisWeak, user, xboxLiveContextImpl, simplifiedStatsService, userKey](xbox_live_result<stats_value_document> statsValueDocResult)
     {
         std::shared_ptr<stats_manager_impl> pThis(thisWeak.lock());
         if (pThis == nullptr)
@@ -93,8 +124,6 @@ stats_manager_impl::add_local_user(
             return;
         }
 
-        std::lock_guard<std::mutex> guard(pThis->m_statsServiceMutex);
-
         bool isSignedIn = false;
 #if TV_API
         isSignedIn = user->IsSignedIn;
@@ -104,25 +133,28 @@ stats_manager_impl::add_local_user(
 
         if (isSignedIn)
         {
+            auto& shard = pThis->user_shard(userKey);
+            std::lock_guard<std::mutex> guard(shard.lock);
             if (statsValueDocResult.err())  // if there was an error, but the user is signed in, we assume offline sign in
             {
                 pThis->m_isOffline = true;
             }
 
             auto& svd = statsValueDocResult.payload();
-            auto userStatContext = pThis->m_users.find(userStr);
-            if (userStatContext != pThis->m_users.end())    // user could be removed by the time this completes
+            auto userStatContext = shard.users.find(userKey);
+            if (userStatContext != shard.users.end())    // user could be removed by the time this completes
             {
-                pThis->m_users[userStr] = stats_user_context(svd, xboxLiveContextImpl, simplifiedStatsService, user);
-                pThis->m_users[userStr].statValueDocument.set_flush_function([thisWeak, userStr, user]()
+                userStatContext->second = stats_user_context(svd, xboxLiveContextImpl, simplifiedStatsService, user);
+                userStatContext->second.statValueDocument.set_flush_function([thisWeak, userKey]()
                 {
                     std::shared_ptr<stats_manager_impl> pThis(thisWeak.lock());
                     if (pThis == nullptr)
                     {
                         return;
                     }
-                    auto statContextIter = pThis->m_users.find(userStr);
-                    if (statContextIter == pThis->m_users.end())
+                    auto& shard = pThis->user_shard(userKey);
+                    auto statContextIter = shard.users.find(userKey);
+                    if (statContextIter == shard.users.end())
                     {
                         return;
                     }
@@ -138,7 +170,7 @@ stats_manager_impl::add_local_user(
             LOG_DEBUG("Could not successfully get SVD for user and user is offline");
         }
 
-        pThis->m_statEventList.push_back(stat_event(stat_event_type::local_user_added, user, xbox_live_result<void>(statsValueDocResult.err(), statsValueDocResult.err_message())));
+        pThis->add_stat_event(stat_event(stat_event_type::local_user_added, user, xbox_live_result<void>(statsValueDocResult.err(), statsValueDocResult.err_message())));
     });
 
     return xbox_live_result<void>();
@@ -149,10 +181,11 @@ stats_manager_impl::remove_local_user(
     _In_ const xbox_live_user_t& user
 )
 {
-    std::lock_guard<std::mutex> guard(m_statsServiceMutex);
-    string_t userStr = user_context::get_user_id(user);
-    auto userIter = m_users.find(userStr);
-    if (userIter == m_users.end())
+    uint64_t userKey = user_key(user);
+    auto& shard = user_shard(userKey);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto userIter = shard.users.find(userKey);
+    if (userIter == shard.users.end())
     {
         return xbox_live_result<void>(xbox_live_error_code::invalid_argument, "User not found in local map");
     }
@@ -178,15 +211,15 @@ stats_manager_impl::remove_local_user(
                 pThis->write_offline(statsUserContext, serializedSVD);
             }
 
-            pThis->m_statEventList.push_back(stat_event(stat_event_type::local_user_removed, user, updateSVDResult));
+            pThis->add_stat_event(stat_event(stat_event_type::local_user_removed, user, updateSVDResult));
         });
     }
     else
     {
-        m_statEventList.push_back(stat_event(stat_event_type::local_user_removed, user, xbox_live_result<void>()));
+        add_stat_event(stat_event(stat_event_type::local_user_removed, user, xbox_live_result<void>()));
     }
 
-    m_users.erase(userIter);
+    shard.users.erase(userIter);
     return xbox_live_result<void>();
 }
 
@@ -196,14 +229,18 @@ stats_manager_impl::request_flush_to_service(
     _In_ bool isHighPriority
     )
 {
-    std::lock_guard<std::mutex> guard(m_statsServiceMutex);
     string_t userStr = user_context::get_user_id(user);
-    auto userIter = m_users.find(userStr);
-    if (userIter == m_users.end())
+    uint64_t userKey = utils::string_t_to_uint64(userStr);
     {
-        return xbox_live_result<void>(xbox_live_error_code::invalid_argument, "User not found in local map");
+        auto& shard = user_shard(userKey);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        if (shard.users.find(userKey) == shard.users.end())
+        {
+            return xbox_live_result<void>(xbox_live_error_code::invalid_argument, "User not found in local map");
+        }
     }
 
+    // The timers can call back into flush_to_service_callback, which takes the shard lock
     std::vector<string_t> userVec;
     userVec.push_back(userStr);
 
@@ -226,9 +263,9 @@ stats_manager_impl::flush_to_service(
 {
     std::weak_ptr<stats_manager_impl> thisWeak = shared_from_this();
     xbox_live_user_t user = statsUserContext.xboxLiveUser;
-    auto serializedSVD = statsUserContext.statValueDocument.serialize();
+    auto flushedStatNames = statsUserContext.statValueDocument.dirty_stat_names();
     statsUserContext.simplifiedStatsService.update_stats_value_document(statsUserContext.statValueDocument)
-    .then([thisWeak, user, serializedSVD, statsUserContext](xbox_live_result<void> updateSVDResult)
+    .then([thisWeak, user, flushedStatNames, statsUserContext](xbox_live_result<void> updateSVDResult)
     {
         std::shared_ptr<stats_manager_impl> pThis(thisWeak.lock());
         if (pThis == nullptr)
@@ -238,20 +275,44 @@ stats_manager_impl::flush_to_service(
 
         if (updateSVDResult.err())
         {
-            if (should_write_offline(updateSVDResult))
+            bool shouldWriteOffline = should_write_offline(updateSVDResult);
+            if (!shouldWriteOffline)
             {
-                pThis->write_offline(statsUserContext, serializedSVD);
+                LOG_ERROR("Stats manager could not write stats value document");
             }
-            else
+
+            // The copied document shares its stat values with the live one, so the offline fallback
+            // serializes under the shard lock, and only when a post actually fails
+            web::json::value serializedSVD;
             {
-                LOG_ERROR("Stats manager could not write stats value document");
+                uint64_t userKey = user_key(user);
+                auto& shard = pThis->user_shard(userKey);
+                std::lock_guard<std::mutex> guard(shard.lock);
+                auto userIter = shard.users.find(userKey);
+                if (userIter != shard.users.end())
+                {
+                    // Only changed stats are posted, so the ones that didn't make it go out with the next flush
+                    auto& userSVD = userIter->second.statValueDocument;
+                    userSVD.mark_stats_dirty(flushedStatNames);
+                    if (shouldWriteOffline)
+                    {
+                        serializedSVD = userSVD.serialize();
+                    }
+                }
+                else if (shouldWriteOffline)
+                {
+                    // Nothing sets stats for a user who has been removed, so the copy can't change under us
+                    serializedSVD = statsUserContext.statValueDocument.serialize();
+                }
             }
-        }
 
-        {
-            std::lock_guard<std::mutex> guard(pThis->m_statsServiceMutex);
-            pThis->m_statEventList.push_back(stat_event(stat_event_type::stat_update_complete, user, updateSVDResult));
+            if (shouldWriteOffline)
+            {
+                pThis->write_offline(statsUserContext, serializedSVD);
+            }
         }
+
+        pThis->add_stat_event(stat_event(stat_event_type::stat_update_complete, user, updateSVDResult));
     });
 }
 
@@ -260,18 +321,21 @@ stats_manager_impl::flush_to_service_callback(
     _In_ const string_t& userXuid
     )
 {
-    auto userIter = m_users.find(userXuid);
-    if (userIter != m_users.end())
+    uint64_t userKey = utils::string_t_to_uint64(userXuid);
+    auto& shard = user_shard(userKey);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto userIter = shard.users.find(userKey);
+    if (userIter != shard.users.end())
     {
         auto& userSVD = userIter->second.statValueDocument;
 
         if (userSVD.is_dirty())
         {
             userSVD.do_work();
-            userSVD.clear_dirty_state();
             flush_to_service(
                 userIter->second
                 );
+            userSVD.clear_dirty_state();
         }
     }
 }
@@ -279,13 +343,22 @@ stats_manager_impl::flush_to_service_callback(
 std::vector<stat_event>
 stats_manager_impl::do_work()
 {
-    std::lock_guard<std::mutex> guard(m_statsServiceMutex);
-    auto copyList = m_statEventList;
-    for (auto& statUserContext : m_users)
+    std::vector<stat_event> copyList;
+    {
+        std::lock_guard<std::mutex> guard(m_statEventLock);
+        copyList.swap(m_statEventList);
+    }
+
+    // One shard at a time, so writers to the other shards carry on
+    for (auto& shard : m_userShards)
     {
-        statUserContext.second.statValueDocument.do_work();
+        std::lock_guard<std::mutex> guard(shard.lock);
+        for (auto& statUserContext : shard.users)
+        {
+            statUserContext.second.statValueDocument.do_work();
+        }
     }
-    m_statEventList.clear();
+
     return copyList;
 }
 
@@ -296,10 +369,11 @@ stats_manager_impl::set_stat(
     _In_ double value
     )
 {
-    std::lock_guard<std::mutex> guard(m_statsServiceMutex);
-    string_t userStr = user_context::get_user_id(user);
-    auto userIter = m_users.find(userStr);
-    if (userIter == m_users.end())
+    uint64_t userKey = user_key(user);
+    auto& shard = user_shard(userKey);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto userIter = shard.users.find(userKey);
+    if (userIter == shard.users.end())
     {
         return xbox_live_result<void>(xbox_live_error_code::invalid_argument, "User not found in local map");
     }
@@ -314,10 +388,11 @@ stats_manager_impl::set_stat(
     _In_ const char_t* value
 )
 {
-    std::lock_guard<std::mutex> guard(m_statsServiceMutex);
-    string_t userStr = user_context::get_user_id(user);
-    auto userIter = m_users.find(userStr);
-    if (userIter == m_users.end())
+    uint64_t userKey = user_key(user);
+    auto& shard = user_shard(userKey);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto userIter = shard.users.find(userKey);
+    if (userIter == shard.users.end())
     {
         return xbox_live_result<void>(xbox_live_error_code::invalid_argument, "User not found in local map");
     }
@@ -331,10 +406,11 @@ stats_manager_impl::get_stat(
     _In_ const string_t& name
     )
 {
-    std::lock_guard<std::mutex> guard(m_statsServiceMutex);
-    string_t userStr = user_context::get_user_id(user);
-    auto userIter = m_users.find(userStr);
-    if (userIter == m_users.end())
+    uint64_t userKey = user_key(user);
+    auto& shard = user_shard(userKey);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto userIter = shard.users.find(userKey);
+    if (userIter == shard.users.end())
     {
         return xbox_live_result<std::shared_ptr<stat_value>>(xbox_live_error_code::invalid_argument, "User not found in local map");
     }
@@ -348,10 +424,11 @@ stats_manager_impl::get_stat_names(
     _Inout_ std::vector<string_t>& statNameList
     )
 {
-    std::lock_guard<std::mutex> guard(m_statsServiceMutex);
-    string_t userStr = user_context::get_user_id(user);
-    auto userIter = m_users.find(userStr);
-    if (userIter == m_users.end())
+    uint64_t userKey = user_key(user);
+    auto& shard = user_shard(userKey);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto userIter = shard.users.find(userKey);
+    if (userIter == shard.users.end())
     {
         return xbox_live_result<void>(xbox_live_error_code::invalid_argument, "User not found in local map");
     }
@@ -15,6 +15,7 @@
 #include <string>
 #include <sstream>
 #include <iostream>
+#include <atomic>
 #include "xsapi/mem.h"
 #include "call_buffer_timer.h"
 
@@ -54,7 +55,9 @@ private:
 };
 
 /// internal class
-/// The stat value document holds all of the stat information in an unordered map
+/// The stat value document holds all of the stat information in an unordered map.
+/// Repeated changes to a stat between do_work calls are coalesced into one pending event, and
+/// the stats changed since the last flush are tracked so only they need to be posted.
 class stats_value_document
 {
 public:
@@ -89,6 +92,17 @@ public:
 
     web::json::value serialize() const;
 
+    /// Serializes only the stats changed since the dirty state was last cleared
+    web::json::value serialize_dirty_stats() const;
+
+    /// Names of the stats changed since the dirty state was last cleared
+    std::vector<string_t> dirty_stat_names() const;
+
+    /// Marks stats to be posted again with the next flush, such as after a failed post
+    void mark_stats_dirty(
+        _In_ const std::vector<string_t>& statNames
+        );
+
     uint32_t revision() const;
 
     bool is_dirty() const;
@@ -104,12 +118,23 @@ public:
         );
 
 private:
+    void add_svd_event(
+        _In_ const stat_pending_state& statPendingState
+        );
+
+    web::json::value serialize_stats(
+        _In_ std::vector<std::pair<string_t, web::json::value>> statFields
+        ) const;
+
     bool m_isDirty;
     uint32_t m_revision;
     std::function<void()> m_fRequestFlush;
     xsapi_internal_string m_clientId;
     xsapi_internal_vector(svd_event) m_svdEventList;
+    // Stat name to its pending event in m_svdEventList
+    xsapi_internal_unordered_map(string_t, size_t) m_svdEventIndices;
     xsapi_internal_unordered_map(string_t, std::shared_ptr<stat_value>) m_statisticDocument;
+    xsapi_internal_unordered_map(string_t, std::shared_ptr<stat_value>) m_dirtyStats;
 };
 
 /// internal class
@@ -125,6 +150,7 @@ public:
         _In_ std::shared_ptr<xbox::services::xbox_live_app_config> appConfig
         );
 
+    /// Posts the stats changed in the document since its dirty state was last cleared
     pplx::task<xbox_live_result<void>> update_stats_value_document(
         _In_ stats_value_document& statValuePostDocument
         );
@@ -165,6 +191,10 @@ struct stats_user_context
     simplified_stats_service simplifiedStatsService;
 };
 
+/// internal class
+/// Local users are spread over shards by XUID, each with its own lock, so threads setting stats for
+/// different users rarely wait on each other. Events have their own lock, so do_work only holds
+/// one shard at a time while applying pending stat changes.
 class stats_manager_impl : public std::enable_shared_from_this<stats_manager_impl>
 {
 public:
@@ -236,15 +266,34 @@ private:
 
     void flush_to_service_callback(_In_ const string_t& userXuid);
 
+    struct stats_user_shard
+    {
+        std::mutex lock;
+        std::unordered_map<uint64_t, stats_user_context> users;
+    };
+
+    static uint64_t user_key(
+        _In_ const xbox_live_user_t& user
+        );
+
+    stats_user_shard& user_shard(
+        _In_ uint64_t userKey
+        );
+
+    void add_stat_event(
+        _In_ stat_event statEvent
+        );
+
     static const std::chrono::seconds TIME_PER_CALL_SEC;
+    static const size_t USER_SHARD_COUNT = 16;
 
-    bool m_isOffline;
+    // Set from add_local_user completions, which hold different shard locks
+    std::atomic<bool> m_isOffline;
+    std::mutex m_statEventLock;
     std::vector<stat_event> m_statEventList;
-    std::unordered_map<string_t, stats_user_context> m_users;
+    stats_user_shard m_userShards[USER_SHARD_COUNT];
     std::shared_ptr<xbox::services::call_buffer_timer> m_statTimer;
     std::shared_ptr<xbox::services::call_buffer_timer> m_statPriorityTimer;
-    // TODO: change back to xsapi_internal_string
-    std::mutex m_statsServiceMutex;
 };
 
 }}}}
\ No newline at end of file
@@ -50,7 +50,7 @@ simplified_stats_service::update_stats_value_document(
         xbox_live_api::update_stats_value_document
         );
 
-    httpCall->set_request_body(statValuePostDocument.serialize());
+    httpCall->set_request_body(statValuePostDocument.serialize_dirty_stats());
 
     auto task = httpCall->get_response_with_auth(m_userContext, http_call_response_body_type::json_body)
     .then([&statValuePostDocument](std::shared_ptr<http_call_response> response)
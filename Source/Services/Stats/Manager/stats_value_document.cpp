@@ -48,7 +48,7 @@ stats_value_document::set_stat(
     statPendingState.statDataType = stat_data_type::number;
     statPendingState.statPendingData.numberType = statValue;
 
-    m_svdEventList.push_back(svd_event(statPendingState));
+    add_svd_event(statPendingState);
     return xbox_live_result<void>();
 }
 
@@ -63,10 +63,27 @@ stats_value_document::set_stat(
     utils::char_t_copy(statPendingState.statPendingName, ARRAYSIZE(statPendingState.statPendingName), statName);
     statPendingState.statDataType = stat_data_type::string;
     utils::char_t_copy(statPendingState.statPendingData.stringType, ARRAYSIZE(statPendingState.statPendingData.stringType), statValue);
-    m_svdEventList.push_back(svd_event(statPendingState));
+    add_svd_event(statPendingState);
     return xbox_live_result<void>();
 }
 
+void
+stats_value_document::add_svd_event(
+    _In_ const stat_pending_state& statPendingState
+    )
+{
+    // Only the last value set before do_work matters, so a stat set again replaces its pending event
+    auto eventIndexIter = m_svdEventIndices.find(statPendingState.statPendingName);
+    if (eventIndexIter != m_svdEventIndices.end())
+    {
+        m_svdEventList[eventIndexIter->second] = svd_event(statPendingState);
+        return;
+    }
+
+    m_svdEventIndices[statPendingState.statPendingName] = m_svdEventList.size();
+    m_svdEventList.push_back(svd_event(statPendingState));
+}
+
 void
 stats_value_document::get_stat_names(
     _Inout_ std::vector<string_t>& statNameList
@@ -99,6 +116,36 @@ bool stats_value_document::is_dirty() const
 void stats_value_document::clear_dirty_state()
 {
     m_isDirty = false;
+    m_dirtyStats.clear();
+}
+
+std::vector<string_t>
+stats_value_document::dirty_stat_names() const
+{
+    std::vector<string_t> statNames;
+    statNames.reserve(m_dirtyStats.size());
+    for (auto& stat : m_dirtyStats)
+    {
+        statNames.push_back(stat.first);
+    }
+
+    return statNames;
+}
+
+void
+stats_value_document::mark_stats_dirty(
+    _In_ const std::vector<string_t>& statNames
+    )
+{
+    for (auto& statName : statNames)
+    {
+        auto statIter = m_statisticDocument.find(statName);
+        if (statIter != m_statisticDocument.end())
+        {
+            m_dirtyStats[statIter->first] = statIter->second;
+            m_isDirty = true;
+        }
+    }
 }
 
 void
@@ -115,27 +162,30 @@ stats_value_document::do_work()
 
                 if (statIter == m_statisticDocument.end())
                 {
-                    m_statisticDocument[pendingStat.statPendingName] = std::make_shared<stat_value>();  // this will need changed to be more like social manager
+                    statIter = m_statisticDocument.insert(std::make_pair(string_t(pendingStat.statPendingName), std::make_shared<stat_value>())).first;  // this will need changed to be more like social manager
                 }
 
                 switch (pendingStat.statDataType)
                 {
                     case stat_data_type::number:
-                        m_statisticDocument[pendingStat.statPendingName]->set_stat(
+                        statIter->second->set_stat(
                             pendingStat.statPendingData.numberType
                             );
                         break;
 
                     case stat_data_type::string:
-                        m_statisticDocument[pendingStat.statPendingName]->set_stat(pendingStat.statPendingData.stringType);
+                        statIter->second->set_stat(pendingStat.statPendingData.stringType);
                         break;
                 }
+
+                m_dirtyStats[statIter->first] = statIter->second;
                 break;
             }
         }
     }
 
     m_svdEventList.clear();
+    m_svdEventIndices.clear();
 }
 
 void
@@ -148,6 +198,34 @@ stats_value_document::set_flush_function(
 
 web::json::value
 stats_value_document::serialize() const
+{
+    std::vector<std::pair<string_t, web::json::value>> statFields;
+    statFields.reserve(m_statisticDocument.size());
+    for (auto& stat : m_statisticDocument)
+    {
+        statFields.push_back(std::make_pair(stat.first, stat.second->serialize()));
+    }
+
+    return serialize_stats(std::move(statFields));
+}
+
+web::json::value
+stats_value_document::serialize_dirty_stats() const
+{
+    std::vector<std::pair<string_t, web::json::value>> statFields;
+    statFields.reserve(m_dirtyStats.size());
+    for (auto& stat : m_dirtyStats)
+    {
+        statFields.push_back(std::make_pair(stat.first, stat.second->serialize()));
+    }
+
+    return serialize_stats(std::move(statFields));
+}
+
+web::json::value
+stats_value_document::serialize_stats(
+    _In_ std::vector<std::pair<string_t, web::json::value>> statFields
+    ) const
 {
     web::json::value requestJSON;
     requestJSON[_T("$schema")] = web::json::value::string(_T("http://stats.xboxlive.com/2017-1/schema#"));
@@ -159,12 +237,9 @@ stats_value_document::serialize() const
 #endif
     auto& statsField = requestJSON[_T("stats")];
 
-    auto& titleField = statsField[_T("title")];
-    titleField = web::json::value::object();
-    for (auto& stat : m_statisticDocument)
-    {
-        titleField[stat.first.c_str()] = stat.second->serialize();
-    }
+    // Building the object from every field at once sorts the names once, rather than shifting
+    // the fields already added for each insert
+    statsField[_T("title")] = web::json::value::object(std::move(statFields));
 
     return requestJSON;
 }
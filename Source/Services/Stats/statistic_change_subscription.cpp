@@ -136,6 +136,16 @@ statistic_change_subscription::on_event_received(
     }
 }
 
+void
+statistic_change_subscription::_Update_from_shared_subscription(
+    _In_ const statistic_change_subscription& sharedSubscription
+    )
+{
+    m_statistic = sharedSubscription.m_statistic;
+    _Set_state(sharedSubscription.state());
+    set_subscription_id(sharedSubscription.subscription_id());
+}
+
 const string_t&
 statistic_change_subscription::xbox_user_id() const
 {
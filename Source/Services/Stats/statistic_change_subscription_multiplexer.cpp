@@ -0,0 +1,424 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "statistic_change_subscription_multiplexer.h"
+#if !XSAPI_U
+#include "ppltasks_extra.h"
+#else
+#include "ppltasks_extra_unix.h"
+#endif
+
+using namespace Concurrency::extras;
+using namespace xbox::services::real_time_activity;
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_USERSTATISTICS_CPP_BEGIN
+
+const std::chrono::milliseconds statistic_change_subscription_multiplexer::RELEASE_DELAY(2000);
+
+// The subscription registered with the real-time activity service. It reports its state changes so the
+// handles given to callers can follow along.
+class shared_statistic_change_subscription : public statistic_change_subscription
+{
+public:
+    shared_statistic_change_subscription(
+        _In_ const statistic_change_subscription& handle,
+        _In_ std::function<void(const statistic_change_event_args&)> handler,
+        _In_ std::function<void(const real_time_activity_subscription_error_event_args&)> subscriptionErrorHandler,
+        _In_ std::function<void()> stateChangedHandler
+        ) :
+        statistic_change_subscription(
+            handle.xbox_user_id(),
+            handle.service_configuration_id(),
+            handle.statistic(),
+            std::move(handler),
+            std::move(subscriptionErrorHandler)
+            ),
+        m_stateChangedHandler(std::move(stateChangedHandler))
+    {
+    }
+
+protected:
+    void on_state_changed(_In_ real_time_activity_subscription_state state) override
+    {
+        UNREFERENCED_PARAMETER(state);
+        m_stateChangedHandler();
+    }
+
+private:
+    std::function<void()> m_stateChangedHandler;
+};
+
+static std::mutex g_multiplexersLock;
+static std::unordered_map<real_time_activity_service*, std::weak_ptr<statistic_change_subscription_multiplexer>> g_multiplexers;
+
+std::shared_ptr<statistic_change_subscription_multiplexer>
+statistic_change_subscription_multiplexer::get_multiplexer(
+    _In_ const std::shared_ptr<real_time_activity_service>& realTimeActivityService
+    )
+{
+    std::lock_guard<std::mutex> guard(g_multiplexersLock);
+    for (auto iter = g_multiplexers.begin(); iter != g_multiplexers.end();)
+    {
+        iter = iter->second.expired() ? g_multiplexers.erase(iter) : std::next(iter);
+    }
+
+    // A multiplexer keeps its service alive, so a live entry can't belong to an older service at the same address
+    std::shared_ptr<statistic_change_subscription_multiplexer> multiplexer = g_multiplexers[realTimeActivityService.get()].lock();
+    if (multiplexer == nullptr)
+    {
+        multiplexer = std::make_shared<statistic_change_subscription_multiplexer>(realTimeActivityService);
+        g_multiplexers[realTimeActivityService.get()] = multiplexer;
+    }
+
+    return multiplexer;
+}
+
+statistic_change_subscription_multiplexer::statistic_change_subscription_multiplexer(
+    _In_ std::shared_ptr<real_time_activity_service> realTimeActivityService
+    ) :
+    m_realTimeActivityService(std::move(realTimeActivityService)),
+    m_listenerCounter(0),
+    m_sharedSubscribeCount(0),
+    m_isReleaseScheduled(false)
+{
+}
+
+statistic_change_subscription_multiplexer::~statistic_change_subscription_multiplexer()
+{
+    // The scheduled release only holds a weak reference, so it can't clean up after us
+    release_unused_subscriptions(true);
+}
+
+function_context
+statistic_change_subscription_multiplexer::add_listener(
+    _In_ std::function<void(const statistic_change_event_args&)> handler
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    function_context listener = ++m_listenerCounter;
+    m_listeners[listener] = std::move(handler);
+    return listener;
+}
+
+void
+statistic_change_subscription_multiplexer::remove_listener(
+    _In_ function_context listener
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_listeners.erase(listener);
+
+    for (auto& sharedSubscription : m_subscriptions)
+    {
+        auto& handles = sharedSubscription.second.handles;
+        for (size_t i = handles.size(); i > 0; --i)
+        {
+            if (handles[i - 1].first == listener)
+            {
+                remove_handle(sharedSubscription.second, i - 1);
+            }
+        }
+    }
+}
+
+std::shared_ptr<statistic_change_subscription>
+statistic_change_subscription_multiplexer::create_shared_subscription(
+    _In_ const statistic_change_subscription& handle
+    )
+{
+    std::weak_ptr<statistic_change_subscription_multiplexer> thisWeakPtr = shared_from_this();
+    string_t resourceUri = handle.resource_uri();
+
+    return std::make_shared<shared_statistic_change_subscription>(
+        handle,
+        [thisWeakPtr, resourceUri](const statistic_change_event_args& eventArgs)
+        {
+            std::shared_ptr<statistic_change_subscription_multiplexer> pThis(thisWeakPtr.lock());
+            if (pThis != nullptr)
+            {
+                pThis->statistic_changed(resourceUri, eventArgs);
+            }
+        },
+        [thisWeakPtr](const real_time_activity_subscription_error_event_args& eventArgs)
+        {
+            std::shared_ptr<statistic_change_subscription_multiplexer> pThis(thisWeakPtr.lock());
+            if (pThis != nullptr)
+            {
+                pThis->m_realTimeActivityService->_Trigger_subscription_error(eventArgs);
+            }
+        },
+        [thisWeakPtr, resourceUri]()
+        {
+            std::shared_ptr<statistic_change_subscription_multiplexer> pThis(thisWeakPtr.lock());
+            if (pThis != nullptr)
+            {
+                pThis->state_changed(resourceUri);
+            }
+        });
+}
+
+xbox_live_result<std::shared_ptr<statistic_change_subscription>>
+statistic_change_subscription_multiplexer::subscribe(
+    _In_ function_context listener,
+    _In_ const string_t& xboxUserId,
+    _In_ const string_t& serviceConfigurationId,
+    _In_ const string_t& statisticName
+    )
+{
+    // Handles are never registered with the service, so their own callbacks are never called
+    auto handle = std::make_shared<statistic_change_subscription>(
+        xboxUserId,
+        serviceConfigurationId,
+        statistic(
+            statisticName,
+            string_t(),
+            string_t()
+            ),
+        [](const statistic_change_event_args&) {},
+        [](const real_time_activity_subscription_error_event_args&) {}
+        );
+
+    std::shared_ptr<statistic_change_subscription> subscriptionToAdd;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        shared_subscription& sharedSubscription = m_subscriptions[handle->resource_uri()];
+        if (sharedSubscription.subscription == nullptr ||
+            sharedSubscription.subscription->state() == real_time_activity_subscription_state::closed)
+        {
+            sharedSubscription.subscription = create_shared_subscription(*handle);
+            subscriptionToAdd = sharedSubscription.subscription;
+        }
+        else
+        {
+            ++m_sharedSubscribeCount;
+            handle->_Update_from_shared_subscription(*sharedSubscription.subscription);
+        }
+
+        sharedSubscription.handles.push_back(std::make_pair(listener, handle));
+    }
+
+    if (subscriptionToAdd != nullptr)
+    {
+        // Called without holding m_lock, since the service reports state changes back to us under its own lock
+        auto addResult = m_realTimeActivityService->_Add_subscription(subscriptionToAdd);
+        if (addResult.err())
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            auto iter = m_subscriptions.find(handle->resource_uri());
+            if (iter != m_subscriptions.end() && iter->second.subscription == subscriptionToAdd)
+            {
+                // Anyone who joined in the meantime shares the failure
+                for (auto& joinedHandle : iter->second.handles)
+                {
+                    joinedHandle.second->_Set_state(real_time_activity_subscription_state::closed);
+                }
+                m_subscriptions.erase(iter);
+            }
+
+            return xbox_live_result<std::shared_ptr<statistic_change_subscription>>(addResult.err(), addResult.err_message());
+        }
+    }
+
+    return xbox_live_result<std::shared_ptr<statistic_change_subscription>>(handle);
+}
+
+xbox_live_result<void>
+statistic_change_subscription_multiplexer::unsubscribe(
+    _In_ const std::shared_ptr<statistic_change_subscription>& subscription
+    )
+{
+    if (subscription == nullptr)
+    {
+        return xbox_live_result<void>(xbox_live_error_code::invalid_argument, "subscription is null");
+    }
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    auto iter = m_subscriptions.find(subscription->resource_uri());
+    if (iter != m_subscriptions.end())
+    {
+        auto& handles = iter->second.handles;
+        for (size_t i = 0; i < handles.size(); ++i)
+        {
+            if (handles[i].second == subscription)
+            {
+                remove_handle(iter->second, i);
+                return xbox_live_result<void>();
+            }
+        }
+    }
+
+    return xbox_live_result<void>(xbox_live_error_code::invalid_argument, "subscription is not subscribed");
+}
+
+void
+statistic_change_subscription_multiplexer::remove_handle(
+    _In_ shared_subscription& sharedSubscription,
+    _In_ size_t handleIndex
+    )
+{
+    sharedSubscription.handles[handleIndex].second->_Set_state(real_time_activity_subscription_state::closed);
+    sharedSubscription.handles.erase(sharedSubscription.handles.begin() + handleIndex);
+
+    if (sharedSubscription.handles.empty())
+    {
+        sharedSubscription.releaseTime = chrono_clock_t::now() + RELEASE_DELAY;
+        schedule_release();
+    }
+}
+
+void
+statistic_change_subscription_multiplexer::schedule_release()
+{
+    if (m_isReleaseScheduled)
+    {
+        return;
+    }
+
+    m_isReleaseScheduled = true;
+    std::weak_ptr<statistic_change_subscription_multiplexer> thisWeakPtr = shared_from_this();
+    create_delayed_task(
+        RELEASE_DELAY,
+        [thisWeakPtr]()
+    {
+        std::shared_ptr<statistic_change_subscription_multiplexer> pThis(thisWeakPtr.lock());
+        if (pThis != nullptr)
+        {
+            {
+                std::lock_guard<std::mutex> lock(pThis->m_lock);
+                pThis->m_isReleaseScheduled = false;
+            }
+            pThis->release_unused_subscriptions(false);
+        }
+    });
+}
+
+void
+statistic_change_subscription_multiplexer::release_unused_subscriptions(
+    _In_ bool releaseAll
+    )
+{
+    std::vector<std::shared_ptr<statistic_change_subscription>> subscriptionsToRemove;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto now = chrono_clock_t::now();
+        bool isReleasePending = false;
+        for (auto iter = m_subscriptions.begin(); iter != m_subscriptions.end();)
+        {
+            if (!iter->second.handles.empty())
+            {
+                ++iter;
+            }
+            else if (releaseAll || iter->second.releaseTime <= now)
+            {
+                subscriptionsToRemove.push_back(iter->second.subscription);
+                iter = m_subscriptions.erase(iter);
+            }
+            else
+            {
+                isReleasePending = true;
+                ++iter;
+            }
+        }
+
+        if (isReleasePending)
+        {
+            schedule_release();
+        }
+    }
+
+    for (auto& subscription : subscriptionsToRemove)
+    {
+        m_realTimeActivityService->_Remove_subscription(subscription);
+    }
+}
+
+void
+statistic_change_subscription_multiplexer::statistic_changed(
+    _In_ const string_t& resourceUri,
+    _In_ const statistic_change_event_args& eventArgs
+    )
+{
+    std::vector<std::function<void(const statistic_change_event_args&)>> handlers;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto iter = m_subscriptions.find(resourceUri);
+        if (iter == m_subscriptions.end())
+        {
+            return;
+        }
+
+        // Each listener hears about a change once, however many handles it holds for the statistic
+        std::vector<function_context> notifiedListeners;
+        for (auto& handle : iter->second.handles)
+        {
+            handle.second->_Update_from_shared_subscription(*iter->second.subscription);
+            if (std::find(notifiedListeners.begin(), notifiedListeners.end(), handle.first) != notifiedListeners.end())
+            {
+                continue;
+            }
+
+            notifiedListeners.push_back(handle.first);
+            auto listenerIter = m_listeners.find(handle.first);
+            if (listenerIter != m_listeners.end())
+            {
+                handlers.push_back(listenerIter->second);
+            }
+        }
+    }
+
+    for (auto& handler : handlers)
+    {
+        try
+        {
+            handler(eventArgs);
+        }
+        catch (...)
+        {
+            LOG_ERROR("statistic_change_subscription_multiplexer handler threw an exception");
+        }
+    }
+}
+
+void
+statistic_change_subscription_multiplexer::state_changed(
+    _In_ const string_t& resourceUri
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    auto iter = m_subscriptions.find(resourceUri);
+    if (iter != m_subscriptions.end())
+    {
+        for (auto& handle : iter->second.handles)
+        {
+            handle.second->_Update_from_shared_subscription(*iter->second.subscription);
+        }
+    }
+}
+
+statistic_change_subscription_counts
+statistic_change_subscription_multiplexer::counts() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    statistic_change_subscription_counts counts;
+    counts.realTimeActivitySubscriptionCount = static_cast<uint32_t>(m_subscriptions.size());
+    counts.sharedSubscribeCount = m_sharedSubscribeCount;
+    for (const auto& sharedSubscription : m_subscriptions)
+    {
+        counts.handleCount += static_cast<uint32_t>(sharedSubscription.second.handles.size());
+        if (sharedSubscription.second.handles.empty())
+        {
+            ++counts.pendingReleaseCount;
+        }
+    }
+
+    return counts;
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_USERSTATISTICS_CPP_END
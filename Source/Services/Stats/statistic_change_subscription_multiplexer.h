@@ -0,0 +1,147 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+#include "xsapi/user_statistics.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_USERSTATISTICS_CPP_BEGIN
+
+struct statistic_change_subscription_counts
+{
+    statistic_change_subscription_counts() :
+        realTimeActivitySubscriptionCount(0),
+        handleCount(0),
+        pendingReleaseCount(0),
+        sharedSubscribeCount(0)
+    {
+    }
+
+    /// <summary>
+    /// Subscriptions held with the real-time activity service, including ones waiting to be released
+    /// </summary>
+    uint32_t realTimeActivitySubscriptionCount;
+
+    /// <summary>
+    /// Subscriptions handed out to callers that have not been unsubscribed yet
+    /// </summary>
+    uint32_t handleCount;
+
+    /// <summary>
+    /// Real-time activity subscriptions with no handles left, kept for a moment in case they are subscribed to again
+    /// </summary>
+    uint32_t pendingReleaseCount;
+
+    /// <summary>
+    /// How many subscribes were served by a real-time activity subscription that already existed
+    /// </summary>
+    uint64_t sharedSubscribeCount;
+};
+
+/// <summary>
+/// Shares one real-time activity subscription between everyone who subscribes to the same statistic through
+/// the same real_time_activity_service. Each subscribe still returns its own statistic_change_subscription handle
+/// that mirrors the state of the shared one, and each listener gets one event per change no matter how many
+/// handles it holds for the statistic.
+/// When the last handle is unsubscribed the shared subscription is kept for RELEASE_DELAY, so titles that
+/// unsubscribe and resubscribe as spectators move around don't send either request to the service.
+/// </summary>
+class statistic_change_subscription_multiplexer : public std::enable_shared_from_this<statistic_change_subscription_multiplexer>
+{
+public:
+    static const std::chrono::milliseconds RELEASE_DELAY;
+
+    statistic_change_subscription_multiplexer(
+        _In_ std::shared_ptr<xbox::services::real_time_activity::real_time_activity_service> realTimeActivityService
+        );
+
+    /// <summary>
+    /// Releases every shared subscription, including ones still waiting out RELEASE_DELAY
+    /// </summary>
+    ~statistic_change_subscription_multiplexer();
+
+    /// <summary>
+    /// Returns the multiplexer for a real-time activity service, creating it if no one is using one
+    /// </summary>
+    static std::shared_ptr<statistic_change_subscription_multiplexer> get_multiplexer(
+        _In_ const std::shared_ptr<xbox::services::real_time_activity::real_time_activity_service>& realTimeActivityService
+        );
+
+    function_context add_listener(
+        _In_ std::function<void(const statistic_change_event_args&)> handler
+        );
+
+    /// <summary>
+    /// Removes a listener and unsubscribes every handle it still holds
+    /// </summary>
+    void remove_listener(
+        _In_ function_context listener
+        );
+
+    xbox_live_result<std::shared_ptr<statistic_change_subscription>> subscribe(
+        _In_ function_context listener,
+        _In_ const string_t& xboxUserId,
+        _In_ const string_t& serviceConfigurationId,
+        _In_ const string_t& statisticName
+        );
+
+    /// <summary>
+    /// Unsubscribes a handle returned by subscribe. Fails with invalid_argument if the handle isn't subscribed.
+    /// </summary>
+    xbox_live_result<void> unsubscribe(
+        _In_ const std::shared_ptr<statistic_change_subscription>& subscription
+        );
+
+    /// <summary>
+    /// Releases shared subscriptions that have no handles left. Only ones that have waited out
+    /// RELEASE_DELAY are released unless releaseAll is set.
+    /// </summary>
+    void release_unused_subscriptions(
+        _In_ bool releaseAll
+        );
+
+    statistic_change_subscription_counts counts() const;
+
+private:
+    struct shared_subscription
+    {
+        std::shared_ptr<statistic_change_subscription> subscription;
+        std::vector<std::pair<function_context, std::shared_ptr<statistic_change_subscription>>> handles;
+        chrono_clock_t::time_point releaseTime;
+    };
+
+    std::shared_ptr<statistic_change_subscription> create_shared_subscription(
+        _In_ const statistic_change_subscription& handle
+        );
+
+    void statistic_changed(
+        _In_ const string_t& resourceUri,
+        _In_ const statistic_change_event_args& eventArgs
+        );
+
+    void state_changed(
+        _In_ const string_t& resourceUri
+        );
+
+    void remove_handle(
+        _In_ shared_subscription& sharedSubscription,
+        _In_ size_t handleIndex
+        );
+
+    void schedule_release();
+
+    mutable std::mutex m_lock;
+    std::shared_ptr<xbox::services::real_time_activity::real_time_activity_service> m_realTimeActivityService;
+    std::unordered_map<string_t, shared_subscription> m_subscriptions;
+    std::unordered_map<function_context, std::function<void(const statistic_change_event_args&)>> m_listeners;
+    function_context m_listenerCounter;
+    uint64_t m_sharedSubscribeCount;
+    bool m_isReleaseScheduled;
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_USERSTATISTICS_CPP_END
@@ -9,6 +9,7 @@
 //*********************************************************
 #pragma once
 #include "system_internal.h"
+#include "statistic_change_subscription_multiplexer.h"
 namespace xbox { namespace services { namespace user_statistics {
 
 class user_statistics_service_impl : public std::enable_shared_from_this<user_statistics_service_impl>
@@ -34,11 +35,15 @@ public:
 
     void remove_statistic_changed_handler(_In_ function_context context);
 
+    const std::shared_ptr<statistic_change_subscription_multiplexer>& subscription_multiplexer() const;
+
 private:
     void statistic_changed(_In_ const statistic_change_event_args& eventArgs);
 
     xbox::services::system::xbox_live_mutex m_statisticHandlerLock;
     std::shared_ptr<xbox::services::real_time_activity::real_time_activity_service> m_realTimeActivityService;
+    std::shared_ptr<statistic_change_subscription_multiplexer> m_subscriptionMultiplexer;
+    function_context m_multiplexerListener;
     std::unordered_map<function_context, std::function<void(const statistic_change_event_args&)>> m_statisticChangeHandler;
     function_context m_statisticChangeHandlerCounter;
 };
@@ -17,15 +17,27 @@ user_statistics_service_impl::user_statistics_service_impl(
     _In_ std::shared_ptr<xbox::services::real_time_activity::real_time_activity_service> realTimeActivityService
     ) :
     m_realTimeActivityService(realTimeActivityService),
+    m_subscriptionMultiplexer(statistic_change_subscription_multiplexer::get_multiplexer(realTimeActivityService)),
+    m_multiplexerListener(0),
     m_statisticChangeHandlerCounter(0)
 {
 }
 
 user_statistics_service_impl::~user_statistics_service_impl()
 {
+    if (m_multiplexerListener != 0)
+    {
+        m_subscriptionMultiplexer->remove_listener(m_multiplexerListener);
+    }
     m_statisticChangeHandler.clear();
 }
 
+const std::shared_ptr<statistic_change_subscription_multiplexer>&
+user_statistics_service_impl::subscription_multiplexer() const
+{
+    return m_subscriptionMultiplexer;
+}
+
 function_context
 user_statistics_service_impl::add_statistic_changed_handler(
     _In_ std::function<void(const statistic_change_event_args&)> handler
@@ -87,44 +99,31 @@ user_statistics_service_impl::subscribe_to_statistic_change(
     _In_ const string_t& statisticName
     )
 {
-    std::weak_ptr<user_statistics_service_impl> thisWeakPtr = shared_from_this();
-
-    std::shared_ptr<statistic_change_subscription> statChangeSub = std::make_shared<statistic_change_subscription>(
-        xboxUserId,
-        serviceConfigurationId,
-        statistic(
-            statisticName,
-            string_t(),
-            string_t()
-            ),
-        ([thisWeakPtr](const statistic_change_event_args& eventArgs)
-        {
-            std::shared_ptr<user_statistics_service_impl> pThis(thisWeakPtr.lock());
-            if (pThis != nullptr)
-            {
-                pThis->statistic_changed(eventArgs);
-            }
-        }),
-        ([thisWeakPtr](const xbox::services::real_time_activity::real_time_activity_subscription_error_event_args& eventArgs)
+    function_context listener;
+    {
+        // Every subscription this service makes shares one listener, so each change reaches the handlers once
+        std::lock_guard<std::mutex> lock(m_statisticHandlerLock.get());
+        if (m_multiplexerListener == 0)
         {
-            std::shared_ptr<user_statistics_service_impl> pThis(thisWeakPtr.lock());
-            if (pThis != nullptr)
+            std::weak_ptr<user_statistics_service_impl> thisWeakPtr = shared_from_this();
+            m_multiplexerListener = m_subscriptionMultiplexer->add_listener([thisWeakPtr](const statistic_change_event_args& eventArgs)
             {
-                pThis->m_realTimeActivityService->_Trigger_subscription_error(eventArgs);
-            }
-        })
-        );
-
-    auto subscriptionSucceeded = m_realTimeActivityService->_Add_subscription(
-        statChangeSub
-        );
-
-    if (!subscriptionSucceeded.err())
-    {
-        return xbox_live_result<std::shared_ptr<statistic_change_subscription>>(statChangeSub);
+                std::shared_ptr<user_statistics_service_impl> pThis(thisWeakPtr.lock());
+                if (pThis != nullptr)
+                {
+                    pThis->statistic_changed(eventArgs);
+                }
+            });
+        }
+        listener = m_multiplexerListener;
     }
 
-    return xbox_live_result<std::shared_ptr<statistic_change_subscription>>(subscriptionSucceeded.err(), subscriptionSucceeded.err_message());
+    return m_subscriptionMultiplexer->subscribe(
+        listener,
+        xboxUserId,
+        serviceConfigurationId,
+        statisticName
+        );
 }
 
 xbox_live_result<void>
@@ -132,7 +131,7 @@ user_statistics_service_impl::unsubscribe_from_statistic_change(
     _In_ std::shared_ptr<statistic_change_subscription> subscription
     )
 {
-    return m_realTimeActivityService->_Remove_subscription(subscription);
+    return m_subscriptionMultiplexer->unsubscribe(subscription);
 }
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_USERSTATISTICS_CPP_END
\ No newline at end of file
@@ -12,6 +12,7 @@
 #include "user_context.h"
 #include "xbox_system_factory.h"
 #include "utils.h"
+#include <fstream>
 
 using namespace xbox::services::system;
 using namespace xbox::services;
@@ -380,99 +381,319 @@ title_storage_service::download_blob(
     auto sharedAppConfig = m_appConfig;
     auto task = pplx::create_task([sharedXboxLiveContextSettings, sharedUserContext, sharedAppConfig, blobMetadata, blobBuffer, etagMatchCondition, selectQuery, preferredDownloadBlockSize]()
     {
-        title_storage_blob_metadata resultBlobMetadata(
-            blobMetadata
-            );
+        blobBuffer->clear();
+        if (blobMetadata.length() > 0)
+        {
+            blobBuffer->reserve(static_cast<size_t>(blobMetadata.length()));
+        }
 
-        bool isBinaryData = (blobMetadata.blob_type() == title_storage_blob_type::binary);
-        bool isDownloading = true;
-        uint32_t startByte = 0;
-        
-        xbox_live_result<string_t> subpathAndQueryResult = title_storage_download_blob_subpath(
+        auto result = download_blob_blocks(
+            sharedXboxLiveContextSettings,
+            sharedUserContext,
+            sharedAppConfig,
             blobMetadata,
-            selectQuery
+            blobMetadata.e_tag(),
+            etagMatchCondition,
+            selectQuery,
+            preferredDownloadBlockSize,
+            0,
+            [blobBuffer](uint64_t offset, const unsigned char* data, size_t length)
+            {
+                UNREFERENCED_PARAMETER(offset);
+                blobBuffer->insert(blobBuffer->end(), data, data + length);
+                return true;
+            },
+            nullptr
             );
 
-        if(subpathAndQueryResult.err()) return xbox_live_result<title_storage_blob_result>(subpathAndQueryResult.err(), subpathAndQueryResult.err_message());
-
-        string_t subpathAndQuery = subpathAndQueryResult.payload();
-        blobBuffer->clear();
-        while (isDownloading)
+        if (result.err())
         {
-            std::shared_ptr<http_call> httpCall = xbox_system_factory::get_factory()->create_http_call(
-                sharedXboxLiveContextSettings,
-                _T("GET"),
-                utils::create_xboxlive_endpoint(_T("titlestorage"), sharedAppConfig),
-                subpathAndQuery,
-                xbox_live_api::download_blob
+            return xbox_live_result<title_storage_blob_result>(result.err(), result.err_message());
+        }
+
+        return xbox_live_result<title_storage_blob_result>(
+            title_storage_blob_result(
+                blobBuffer,
+                result.payload()
+                ),
+                xbox_live_error_code::no_error
                 );
+    });
 
-            httpCall->set_content_type_header_value(CONTENT_TYPE_HEADER_VALUE);
-            httpCall->set_long_http_call(true);
+    return utils::create_exception_free_task<title_storage_blob_result>(
+        task
+        );
+}
 
-            set_e_tag_header(
-                httpCall,
-                blobMetadata.e_tag(),
-                etagMatchCondition
-                );
+pplx::task<xbox_live_result<title_storage_blob_metadata>>
+title_storage_service::download_blob_to_handler(
+    _In_ title_storage_blob_metadata blobMetadata,
+    _In_ title_storage_download_block_handler blockHandler,
+    _In_ title_storage_e_tag_match_condition etagMatchCondition,
+    _In_ string_t selectQuery,
+    _In_ uint32_t preferredDownloadBlockSize,
+    _In_ uint64_t startByte
+    )
+{
+    RETURN_TASK_CPP_INVALIDARGUMENT_IF(blockHandler == nullptr, title_storage_blob_metadata, "Block handler is null");
+    RETURN_TASK_CPP_INVALIDARGUMENT_IF(startByte > 0 && blobMetadata.blob_type() != title_storage_blob_type::binary, title_storage_blob_metadata, "Only binary blobs can be resumed");
+    preferredDownloadBlockSize = preferredDownloadBlockSize < MIN_DOWNLOAD_BLOCK_SIZE ? MIN_DOWNLOAD_BLOCK_SIZE : preferredDownloadBlockSize;
 
-            if (isBinaryData)
+    auto sharedXboxLiveContextSettings = m_xboxLiveContextSettings;
+    auto sharedUserContext = m_userContext;
+    auto sharedAppConfig = m_appConfig;
+    auto task = pplx::create_task([sharedXboxLiveContextSettings, sharedUserContext, sharedAppConfig, blobMetadata, blockHandler, etagMatchCondition, selectQuery, preferredDownloadBlockSize, startByte]()
+    {
+        return download_blob_blocks(
+            sharedXboxLiveContextSettings,
+            sharedUserContext,
+            sharedAppConfig,
+            blobMetadata,
+            blobMetadata.e_tag(),
+            etagMatchCondition,
+            selectQuery,
+            preferredDownloadBlockSize,
+            startByte,
+            blockHandler,
+            nullptr
+            );
+    });
+
+    return utils::create_exception_free_task<title_storage_blob_metadata>(
+        task
+        );
+}
+
+static void remove_file(
+    _In_ const string_t& filePath
+    )
+{
+#ifdef _WIN32
+    DeleteFileW(filePath.c_str());
+#else
+    std::remove(filePath.c_str());
+#endif
+}
+
+pplx::task<xbox_live_result<title_storage_blob_metadata>>
+title_storage_service::download_blob_to_file(
+    _In_ title_storage_blob_metadata blobMetadata,
+    _In_ string_t filePath,
+    _In_ bool resumeIfPartial,
+    _In_ uint32_t preferredDownloadBlockSize
+    )
+{
+    RETURN_TASK_CPP_INVALIDARGUMENT_IF(filePath.empty(), title_storage_blob_metadata, "File path is empty");
+    preferredDownloadBlockSize = preferredDownloadBlockSize < MIN_DOWNLOAD_BLOCK_SIZE ? MIN_DOWNLOAD_BLOCK_SIZE : preferredDownloadBlockSize;
+
+    auto sharedXboxLiveContextSettings = m_xboxLiveContextSettings;
+    auto sharedUserContext = m_userContext;
+    auto sharedAppConfig = m_appConfig;
+    auto task = pplx::create_task([sharedXboxLiveContextSettings, sharedUserContext, sharedAppConfig, blobMetadata, filePath, resumeIfPartial, preferredDownloadBlockSize]()
+    {
+        string_t etagFilePath = filePath + _T(".etag");
+        uint64_t startByte = 0;
+        string_t resumeETag;
+
+        if (resumeIfPartial && blobMetadata.blob_type() == title_storage_blob_type::binary)
+        {
+            std::ifstream etagFile(etagFilePath, std::ios::in);
+            std::string etag;
+            if (etagFile && std::getline(etagFile, etag) && !etag.empty())
             {
-                set_range_header(
-                    httpCall,
-                    startByte,
-                    startByte + preferredDownloadBlockSize - 1
-                    );
+                std::ifstream partialFile(filePath, std::ios::in | std::ios::binary | std::ios::ate);
+                std::streamoff partialLength = partialFile ? static_cast<std::streamoff>(partialFile.tellg()) : -1;
+                if (partialLength > 0)
+                {
+                    resumeETag = utility::conversions::to_string_t(etag);
+                    startByte = static_cast<uint64_t>(partialLength);
+                }
             }
+        }
 
-            std::error_code errc = xbox_live_error_code::no_error;
-            httpCall->get_response_with_auth(sharedUserContext, http_call_response_body_type::vector_body)
-            .then([&errc, blobBuffer, &startByte, isBinaryData, preferredDownloadBlockSize, &isDownloading, &resultBlobMetadata](std::shared_ptr<http_call_response> response)
+        if (startByte > 0 && blobMetadata.length() > 0 && startByte >= blobMetadata.length())
+        {
+            // A range starting at the end of the blob can't be satisfied, so there's nothing left to resume
+            if (startByte == blobMetadata.length() && resumeETag == blobMetadata.e_tag())
             {
-                errc = response->err_code();
-                if (!response->err_code())
+                remove_file(etagFilePath);
+                title_storage_blob_metadata resultBlobMetadata(blobMetadata);
+                resultBlobMetadata._Set_e_tag_and_length(resumeETag, startByte);
+                return xbox_live_result<title_storage_blob_metadata>(resultBlobMetadata);
+            }
+
+            startByte = 0;
+            resumeETag.clear();
+        }
+
+        xbox_live_result<title_storage_blob_metadata> result;
+        for (;;)
+        {
+            // Blocks are written at their offsets, so a resumed download picks up right where the file ends
+            std::fstream file(
+                filePath,
+                startByte > 0 ?
+                    std::ios::in | std::ios::out | std::ios::binary :
+                    std::ios::out | std::ios::trunc | std::ios::binary
+                );
+            if (!file)
+            {
+                return xbox_live_result<title_storage_blob_metadata>(xbox_live_error_code::runtime_error, "Could not open download file");
+            }
+
+            result = download_blob_blocks(
+                sharedXboxLiveContextSettings,
+                sharedUserContext,
+                sharedAppConfig,
+                blobMetadata,
+                resumeETag,
+                startByte > 0 ? title_storage_e_tag_match_condition::if_match : title_storage_e_tag_match_condition::not_used,
+                string_t(),
+                preferredDownloadBlockSize,
+                startByte,
+                [&file](uint64_t offset, const unsigned char* data, size_t length)
+                {
+                    file.seekp(static_cast<std::streamoff>(offset));
+                    file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(length));
+                    return !file.fail();
+                },
+                [&etagFilePath](const string_t& etag)
                 {
-                    auto responseVector = response->response_body_vector();
-                    size_t responseByteLength = responseVector.size();
-                    blobBuffer->resize(blobBuffer->size() + responseByteLength);
-                    if (responseByteLength > 0)
-                    {
-                        memcpy(&(blobBuffer->at(startByte)), &responseVector[0], responseByteLength);
-                    }
-
-                    startByte += static_cast<uint32_t>(responseByteLength);
-
-                    if (!isBinaryData || responseByteLength < preferredDownloadBlockSize)
-                    {
-                        isDownloading = false;
-                        resultBlobMetadata._Set_e_tag_and_length(
-                            response->e_tag(),
-                            responseByteLength
-                            );
-                    }
+                    std::ofstream etagFile(etagFilePath, std::ios::out | std::ios::trunc);
+                    etagFile << utility::conversions::to_utf8string(etag);
                 }
-            }).wait();
+                );
 
-            if (errc)
+            file.close();
+
+            if ((result.err() == xbox_live_error_code::http_status_412_precondition_failed ||
+                result.err() == xbox_live_error_code::http_status_416_requested_range_not_satisfiable) &&
+                startByte > 0)
             {
-                return xbox_live_result<title_storage_blob_result>(errc, "Download failed");
+                // The blob changed since the partial download, so the bytes on disk are from another version.
+                // A blob of unknown length whose partial file was already complete ends up here too.
+                startByte = 0;
+                resumeETag.clear();
+                continue;
             }
+
+            break;
         }
 
-        return xbox_live_result<title_storage_blob_result>(
-            title_storage_blob_result(
-                blobBuffer,
-                resultBlobMetadata
-                ),
-                xbox_live_error_code::no_error
-                );
+        if (!result.err())
+        {
+            remove_file(etagFilePath);
+        }
+
+        return result;
     });
 
-    return utils::create_exception_free_task<title_storage_blob_result>(
+    return utils::create_exception_free_task<title_storage_blob_metadata>(
         task
         );
 }
 
+xbox_live_result<title_storage_blob_metadata>
+title_storage_service::download_blob_blocks(
+    _In_ const std::shared_ptr<xbox_live_context_settings>& xboxLiveContextSettings,
+    _In_ const std::shared_ptr<user_context>& userContext,
+    _In_ const std::shared_ptr<xbox_live_app_config>& appConfig,
+    _In_ const title_storage_blob_metadata& blobMetadata,
+    _In_ string_t etag,
+    _In_ title_storage_e_tag_match_condition etagMatchCondition,
+    _In_ const string_t& selectQuery,
+    _In_ uint32_t preferredDownloadBlockSize,
+    _In_ uint64_t startByte,
+    _In_ const title_storage_download_block_handler& blockHandler,
+    _In_ const std::function<void(const string_t& etag)>& etagHandler
+    )
+{
+    title_storage_blob_metadata resultBlobMetadata(
+        blobMetadata
+        );
+
+    bool isBinaryData = (blobMetadata.blob_type() == title_storage_blob_type::binary);
+    bool isFirstBlock = true;
+
+    xbox_live_result<string_t> subpathAndQueryResult = title_storage_download_blob_subpath(
+        blobMetadata,
+        selectQuery
+        );
+
+    if (subpathAndQueryResult.err()) return xbox_live_result<title_storage_blob_metadata>(subpathAndQueryResult.err(), subpathAndQueryResult.err_message());
+    string_t subpathAndQuery = subpathAndQueryResult.payload();
+
+    for (;;)
+    {
+        std::shared_ptr<http_call> httpCall = xbox_system_factory::get_factory()->create_http_call(
+            xboxLiveContextSettings,
+            _T("GET"),
+            utils::create_xboxlive_endpoint(_T("titlestorage"), appConfig),
+            subpathAndQuery,
+            xbox_live_api::download_blob
+            );
+
+        httpCall->set_content_type_header_value(CONTENT_TYPE_HEADER_VALUE);
+        httpCall->set_long_http_call(true);
+
+        set_e_tag_header(
+            httpCall,
+            etag,
+            etagMatchCondition
+            );
+
+        if (isBinaryData)
+        {
+            set_range_header(
+                httpCall,
+                startByte,
+                startByte + preferredDownloadBlockSize - 1
+                );
+        }
+
+        auto response = httpCall->get_response_with_auth(userContext, http_call_response_body_type::vector_body).get();
+        if (response->err_code())
+        {
+            return xbox_live_result<title_storage_blob_metadata>(response->err_code(), "Download failed");
+        }
+
+        if (isFirstBlock)
+        {
+            isFirstBlock = false;
+            if (etagHandler != nullptr && !response->e_tag().empty())
+            {
+                etagHandler(response->e_tag());
+            }
+        }
+
+        // Hand the handler the response's own buffer instead of copying it
+        const auto& responseVector = response->response_body_vector();
+        size_t responseByteLength = responseVector.size();
+        if (responseByteLength > 0 && !blockHandler(startByte, &responseVector[0], responseByteLength))
+        {
+            return xbox_live_result<title_storage_blob_metadata>(xbox_live_error_code::runtime_error, "Download block handler failed");
+        }
+
+        startByte += responseByteLength;
+
+        if (!isBinaryData || responseByteLength < preferredDownloadBlockSize)
+        {
+            resultBlobMetadata._Set_e_tag_and_length(
+                response->e_tag(),
+                startByte
+                );
+            return xbox_live_result<title_storage_blob_metadata>(resultBlobMetadata);
+        }
+
+        // Pin the remaining blocks to the version the first one came from
+        if (!response->e_tag().empty())
+        {
+            etag = response->e_tag();
+            etagMatchCondition = title_storage_e_tag_match_condition::if_match;
+        }
+    }
+}
+
 pplx::task<xbox_live_result<title_storage_blob_metadata>>
 title_storage_service::upload_blob(
     _In_ title_storage_blob_metadata blobMetadata,
@@ -500,12 +721,7 @@ title_storage_service::upload_blob(
         bool isBinaryData = resultBlobMetadata.blob_type() == title_storage_blob_type::binary;
         bool isFinalBlock = false;
 
-        std::vector<uint8_t> dataChunk(0);
         auto blobBufferSize = static_cast<uint32_t>(blobBuffer->size());
-        if (!isBinaryData)
-        {
-            dataChunk.resize(blobBufferSize);
-        }
 
         size_t start = 0;
         size_t count = 0;
@@ -513,6 +729,8 @@ title_storage_service::upload_blob(
 
         while (start < blobBufferSize)
         {
+            // Each block is sent as a view into the caller's buffer rather than a copy of it
+            size_t blockStart = start;
             if (isBinaryData)
             {
                 count = blobBufferSize - start;
@@ -521,18 +739,14 @@ title_storage_service::upload_blob(
                 {
                     count = preferredUploadBlockSize;
                 }
-                dataChunk.resize(count);
 
-                memcpy(&dataChunk[0], &(blobBuffer->at(start)), count);
-                
                 start += count;
                 isFinalBlock = start == blobBufferSize;
             }
             else
             {
-                dataChunk = *blobBuffer;
-                count = static_cast<uint32_t>(dataChunk.size());
-                start = static_cast<uint32_t>(dataChunk.size());
+                count = blobBufferSize;
+                start = blobBufferSize;
                 isFinalBlock = true;
             }
 
@@ -562,7 +776,7 @@ title_storage_service::upload_blob(
                 etagMatchCondition
                 );
 
-            httpCall->set_request_body(dataChunk);
+            httpCall->set_request_body(blobBuffer, blockStart, count);
 
             std::error_code errc = xbox_live_error_code::no_error;
             httpCall->get_response_with_auth(sharedUserContext)
@@ -633,8 +847,8 @@ title_storage_service::set_e_tag_header(
 void
 title_storage_service::set_range_header(
     _In_ std::shared_ptr<http_call> httpCall,
-    _In_ uint32_t startByte,
-    _In_ uint32_t endByte
+    _In_ uint64_t startByte,
+    _In_ uint64_t endByte
     )
 {
     stringstream_t byteRange;
@@ -17,10 +17,12 @@ HttpCallRequestMessage::HttpCallRequestMessage(
     ) : 
     m_cppObj(std::move(cppObj))
 {
-    auto nativeRequestVector = m_cppObj.request_message_vector();
-    if(!nativeRequestVector.empty())
+    if(m_cppObj.request_message_buffer_size() > 0)
     {
-        m_requestMessageVector = ref new Platform::Array<byte>(&nativeRequestVector[0], static_cast<uint32>(nativeRequestVector.size()));
+        m_requestMessageVector = ref new Platform::Array<byte>(
+            const_cast<byte*>(m_cppObj.request_message_buffer()),
+            static_cast<uint32>(m_cppObj.request_message_buffer_size())
+            );
     }
 }
 
@@ -29,7 +29,12 @@ public enum class HttpRequestMessageType
     /// <summary>
     /// The message is of type vector, and acts as a memory buffer.
     /// </summary>
-    VectorMessage = xbox::services::http_request_message_type::vector_message
+    VectorMessage = xbox::services::http_request_message_type::vector_message,
+
+    /// <summary>
+    /// The message is a range of a shared buffer, and is sent without being copied.
+    /// </summary>
+    BufferViewMessage = xbox::services::http_request_message_type::buffer_view_message
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_END
\ No newline at end of file
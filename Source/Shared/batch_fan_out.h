@@ -0,0 +1,176 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "utils.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+/// <summary>
+/// Splits a batch request into chunks no larger than the service's max batch size and issues
+/// the chunks concurrently, with at most maxConcurrentBatches requests in flight at a time.
+/// Chunk results are merged in input order. If any chunk fails, no further chunks are issued
+/// and the error of the first failing chunk is returned once the in flight chunks have completed.
+/// </summary>
+template<typename TInput, typename TResult>
+class batch_fan_out
+{
+public:
+    typedef xbox_live_result<std::vector<TResult>> batch_result;
+    typedef std::function<pplx::task<batch_result>(const std::vector<TInput>&)> batch_function;
+
+    static pplx::task<batch_result> run(
+        _In_ const std::vector<TInput>& inputs,
+        _In_ size_t maxBatchSize,
+        _In_ size_t maxConcurrentBatches,
+        _In_ batch_function batchFunction
+        )
+    {
+        if (maxBatchSize == 0 || inputs.size() <= maxBatchSize)
+        {
+            // Nothing to split, so skip the bookkeeping
+            return batchFunction(inputs);
+        }
+
+        auto state = std::make_shared<batch_state>();
+        state->batchFunction = std::move(batchFunction);
+        for (size_t start = 0; start < inputs.size(); start += maxBatchSize)
+        {
+            size_t end = __min(start + maxBatchSize, inputs.size());
+            state->chunks.push_back(std::vector<TInput>(inputs.begin() + start, inputs.begin() + end));
+        }
+        state->results.resize(state->chunks.size());
+
+        size_t lanes = __max(maxConcurrentBatches, static_cast<size_t>(1));
+        lanes = __min(lanes, state->chunks.size());
+        for (size_t i = 0; i < lanes; ++i)
+        {
+            issue_next_chunk(state);
+        }
+
+        return pplx::create_task(state->tce);
+    }
+
+private:
+    struct batch_state
+    {
+        batch_state() :
+            nextChunk(0),
+            completedChunks(0),
+            hasError(false)
+        {
+        }
+
+        std::vector<std::vector<TInput>> chunks;
+        std::vector<std::vector<TResult>> results;
+        batch_function batchFunction;
+        size_t nextChunk;
+        size_t completedChunks;
+        bool hasError;
+        batch_result errorResult;
+        pplx::task_completion_event<batch_result> tce;
+        std::mutex lock;
+    };
+
+    static void issue_next_chunk(_In_ std::shared_ptr<batch_state> state)
+    {
+        size_t chunkIndex;
+        {
+            std::lock_guard<std::mutex> lock(state->lock);
+            if (state->hasError || state->nextChunk >= state->chunks.size())
+            {
+                return;
+            }
+            chunkIndex = state->nextChunk++;
+        }
+
+        pplx::task<batch_result> chunkTask;
+        try
+        {
+            chunkTask = state->batchFunction(state->chunks[chunkIndex]);
+        }
+        catch (const std::exception& e)
+        {
+            chunkTask = pplx::task_from_result(batch_result(utils::convert_exception_to_xbox_live_error_code(), e.what()));
+        }
+
+        chunkTask.then([state, chunkIndex](pplx::task<batch_result> t)
+        {
+            batch_result chunkResult;
+            try
+            {
+                chunkResult = t.get();
+            }
+            catch (const std::exception& e)
+            {
+                chunkResult = batch_result(utils::convert_exception_to_xbox_live_error_code(), e.what());
+            }
+
+            bool isComplete = false;
+            {
+                std::lock_guard<std::mutex> lock(state->lock);
+                if (chunkResult.err())
+                {
+                    if (!state->hasError)
+                    {
+                        state->hasError = true;
+                        state->errorResult = chunkResult;
+                    }
+                }
+                else
+                {
+                    state->results[chunkIndex] = std::move(chunkResult.payload());
+                }
+
+                ++state->completedChunks;
+                isComplete = state->hasError ?
+                    state->completedChunks == state->nextChunk :
+                    state->completedChunks == state->chunks.size();
+            }
+
+            if (isComplete)
+            {
+                complete(state);
+            }
+            else
+            {
+                issue_next_chunk(state);
+            }
+        });
+    }
+
+    static void complete(_In_ const std::shared_ptr<batch_state>& state)
+    {
+        if (state->hasError)
+        {
+            state->tce.set(batch_result(state->errorResult.err(), state->errorResult.err_message()));
+            return;
+        }
+
+        size_t totalSize = 0;
+        for (const auto& chunkResult : state->results)
+        {
+            totalSize += chunkResult.size();
+        }
+
+        std::vector<TResult> merged;
+        merged.reserve(totalSize);
+        for (auto& chunkResult : state->results)
+        {
+            std::move(chunkResult.begin(), chunkResult.end(), std::back_inserter(merged));
+        }
+
+        state->tce.set(batch_result(std::move(merged)));
+    }
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
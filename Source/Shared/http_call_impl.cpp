@@ -9,11 +9,14 @@
 //*********************************************************
 #include "pch.h"
 #include "http_call_impl.h"
+#include "service_call_metrics.h"
+#include "http_call_rate_limiter.h"
 #include "utils.h"
 #include "user_context.h"
 #include "xbox_system_factory.h"
 #include "build_version.h"
 #include "xsapi/system.h"
+#include <cpprest/rawptrstream.h>
 #if TV_API
 #include "System/ppltasks_extra.h"
 #elif XSAPI_SERVER || UNIT_TEST_SYSTEM || XSAPI_U
@@ -86,15 +89,18 @@ http_call_impl::get_response(
     _In_ http_call_response_body_type httpCallResponseBodyType
     )
 {
+    m_httpCallData->callIssuedTime = chrono_clock_t::now();
     m_httpCallData->request = get_default_request();
     std::string body;
 
     if (proofKey->pub_key().x.size() != 0 || proofKey->pub_key().y.size() != 0)
     {
         std::vector<unsigned char> bodyData;
-        if (m_httpCallData->requestBody.get_http_request_message_type() == http_request_message_type::vector_message)
+        if (m_httpCallData->requestBody.get_http_request_message_type() == http_request_message_type::vector_message ||
+            m_httpCallData->requestBody.get_http_request_message_type() == http_request_message_type::buffer_view_message)
         {
-            bodyData = m_httpCallData->requestBody.request_message_vector();
+            const unsigned char* buffer = m_httpCallData->requestBody.request_message_buffer();
+            bodyData.assign(buffer, buffer + m_httpCallData->requestBody.request_message_buffer_size());
         }
         else
         {
@@ -115,7 +121,7 @@ http_call_impl::get_response(
         m_httpCallData->request.headers().add(_T("Signature"), signature);
     }
 
-    return internal_get_response(m_httpCallData);
+    return track_call_metrics(m_httpCallData, internal_get_response(m_httpCallData));
 }
 #endif
 
@@ -124,10 +130,11 @@ http_call_impl::get_response(
     _In_ http_call_response_body_type httpCallResponseBodyType
     )
 {
+    m_httpCallData->callIssuedTime = chrono_clock_t::now();
     m_httpCallData->httpCallResponseBodyType = httpCallResponseBodyType;
     m_httpCallData->request = get_default_request();
 
-    return internal_get_response(m_httpCallData);
+    return track_call_metrics(m_httpCallData, internal_get_response(m_httpCallData));
 }
 
 pplx::task<std::shared_ptr<http_call_response>>
@@ -136,10 +143,11 @@ http_call_impl::get_response(
     _In_ const web::http::http_request& httpRequest
     )
 {
+    m_httpCallData->callIssuedTime = chrono_clock_t::now();
     m_httpCallData->httpCallResponseBodyType = httpCallResponseBodyType;
     m_httpCallData->request = httpRequest;
 
-    return internal_get_response(m_httpCallData);
+    return track_call_metrics(m_httpCallData, internal_get_response(m_httpCallData));
 }
 
 pplx::task<std::shared_ptr<http_call_response>>
@@ -216,19 +224,22 @@ http_call_impl::_Internal_get_response_with_auth(
 {
     pplx::task<xbox_live_result<user_context_auth_result>> asyncOp;
 
+    m_httpCallData->callIssuedTime = chrono_clock_t::now();
     m_httpCallData->userContext = userContext;
     m_httpCallData->httpCallResponseBodyType = httpCallResponseBodyType;
     m_httpCallData->request = get_default_request();
 
     string_t fullUrl = m_httpCallData->serverName + m_httpCallData->request.request_uri().to_string();
 
-    if (m_httpCallData->requestBody.get_http_request_message_type() == http_request_message_type::vector_message)
+    if (m_httpCallData->requestBody.get_http_request_message_type() == http_request_message_type::vector_message ||
+        m_httpCallData->requestBody.get_http_request_message_type() == http_request_message_type::buffer_view_message)
     {
         asyncOp = m_httpCallData->userContext->get_auth_result(
             m_httpCallData->httpMethod,
             fullUrl,
             utils::headers_to_string(m_httpCallData->request.headers()),
-            m_httpCallData->requestBody.request_message_vector(),
+            m_httpCallData->requestBody.request_message_buffer(),
+            m_httpCallData->requestBody.request_message_buffer_size(),
             allUsersAuthRequired
             );
     }
@@ -245,7 +256,7 @@ http_call_impl::_Internal_get_response_with_auth(
 
     auto httpCallData = m_httpCallData;
 
-    return asyncOp.then([httpCallData](xbox_live_result<user_context_auth_result> xblResult)
+    return track_call_metrics(httpCallData, asyncOp.then([httpCallData](xbox_live_result<user_context_auth_result> xblResult)
     {
         if (xblResult.err())
         {
@@ -267,13 +278,45 @@ http_call_impl::_Internal_get_response_with_auth(
         }
 
         return internal_get_response(httpCallData);
-    });
+    }));
 }
 
 pplx::task<std::shared_ptr<http_call_response>>
 http_call_impl::internal_get_response(
     _In_ const std::shared_ptr<http_call_data>& httpCallData
     )
+{
+    auto rateLimiter = http_call_rate_limiter::get_singleton_instance();
+    if (!rateLimiter->is_enabled())
+    {
+        return send_request(httpCallData);
+    }
+
+    string_t xboxUserId;
+    http_call_priority priority = http_call_priority::foreground;
+    if (httpCallData->userContext != nullptr)
+    {
+        xboxUserId = httpCallData->userContext->xbox_user_id();
+        if (httpCallData->userContext->caller_context_type() == caller_context_type::social_manager ||
+            httpCallData->userContext->caller_context_type() == caller_context_type::stats_manager)
+        {
+            priority = http_call_priority::background;
+        }
+    }
+
+    // Every attempt, including retries, is a call against the service's budget
+    auto sharedHttpCallData = httpCallData;
+    return rateLimiter->acquire(httpCallData->xboxLiveApi, xboxUserId, priority)
+    .then([sharedHttpCallData]()
+    {
+        return send_request(sharedHttpCallData);
+    });
+}
+
+pplx::task<std::shared_ptr<http_call_response>>
+http_call_impl::send_request(
+    _In_ const std::shared_ptr<http_call_data>& httpCallData
+    )
 {
     auto requestStartTime = chrono_clock_t::now();
     if (httpCallData->iterationNumber == 0)
@@ -322,8 +365,14 @@ http_call_impl::internal_get_response(
     auto factory = xbox_system_factory::get_factory();
     std::shared_ptr<xbox_http_client> client = factory->create_http_client(httpCallData->serverName, config);
 
+    auto requestSentTime = chrono_clock_t::now();
+    if (httpCallData->iterationNumber == 1)
+    {
+        httpCallData->firstRequestSentTime = requestSentTime;
+    }
+
     return client->get_request(httpCallData->request)
-    .then([httpCallData, requestStartTime](pplx::task<http_response> t)
+    .then([httpCallData, requestStartTime, requestSentTime](pplx::task<http_response> t)
     {
         chrono_clock_t::time_point responseReceivedTime = chrono_clock_t::now();
         http_response httpResponse;
@@ -345,6 +394,15 @@ http_call_impl::internal_get_response(
         httpCallResponse->_Set_timing(requestStartTime, responseReceivedTime);
 
         auto shouldRetry = should_retry(httpCallResponse, httpCallData, networkError);
+        service_call_metrics::get_singleton_instance()->record_attempt(
+            httpCallData->xboxLiveApi,
+            std::chrono::duration_cast<std::chrono::microseconds>(responseReceivedTime - requestSentTime),
+            httpCallData->request.headers().content_length(),
+            httpResponse.headers().content_length(),
+            httpResponse.status_code() == static_cast<int>(xbox_live_error_code::http_status_429_too_many_requests),
+            shouldRetry
+            );
+
         if (shouldRetry)
         {
             httpCallResponse->_Route_service_call();
@@ -376,6 +434,81 @@ http_call_impl::internal_get_response(
     });
 }
 
+static http_headers build_default_headers(
+    _In_ const string_t& xboxContractVersion,
+    _In_ const string_t& contentType
+    )
+{
+    http_headers headers;
+    headers.add(_T("x-xbl-contract-version"), xboxContractVersion);
+    headers.add(_T("Content-Type"), contentType);
+    headers.add(_T("Accept-Language"), utils::get_locales());
+    return headers;
+}
+
+#if !defined(_MSC_VER) || _MSC_VER >= 1900
+struct default_headers_template
+{
+    string_t xboxContractVersion;
+    string_t contentType;
+    uint32_t localesVersion;
+    http_headers headers;
+};
+
+// Calls use a handful of contract versions, so a few templates per thread cover nearly all of them
+const size_t MAX_DEFAULT_HEADERS_TEMPLATES_PER_THREAD = 8;
+
+static void set_default_headers(
+    _In_ http_headers& headers,
+    _In_ const string_t& xboxContractVersion,
+    _In_ const string_t& contentType
+    )
+{
+    // Each thread keeps its own templates, so building a request takes no locks unless the locale changed
+    static thread_local std::vector<default_headers_template> s_templates;
+
+    // Read the version before the locales so a change racing with the rebuild is caught on the next call
+    uint32_t localesVersion = utils::get_locales_version();
+    for (auto& headersTemplate : s_templates)
+    {
+        if (headersTemplate.xboxContractVersion == xboxContractVersion && headersTemplate.contentType == contentType)
+        {
+            if (headersTemplate.localesVersion != localesVersion)
+            {
+                headersTemplate.headers = build_default_headers(xboxContractVersion, contentType);
+                headersTemplate.localesVersion = localesVersion;
+            }
+
+            headers = headersTemplate.headers;
+            return;
+        }
+    }
+
+    if (s_templates.size() >= MAX_DEFAULT_HEADERS_TEMPLATES_PER_THREAD)
+    {
+        s_templates.erase(s_templates.begin());
+    }
+
+    default_headers_template headersTemplate;
+    headersTemplate.xboxContractVersion = xboxContractVersion;
+    headersTemplate.contentType = contentType;
+    headersTemplate.localesVersion = localesVersion;
+    headersTemplate.headers = build_default_headers(xboxContractVersion, contentType);
+    s_templates.push_back(headersTemplate);
+    headers = headersTemplate.headers;
+}
+#else
+static void set_default_headers(
+    _In_ http_headers& headers,
+    _In_ const string_t& xboxContractVersion,
+    _In_ const string_t& contentType
+    )
+{
+    // No thread_local before VS2015
+    headers = build_default_headers(xboxContractVersion, contentType);
+}
+#endif
+
 web::http::http_request
 http_call_impl::get_default_request()
 {
@@ -383,20 +516,13 @@ http_call_impl::get_default_request()
     request.set_request_uri(m_httpCallData->pathQueryFragment);
     if (add_default_headers())
     {
-        request.headers().add(_T("x-xbl-contract-version"), m_httpCallData->xboxContractVersionHeaderValue);
-        request.headers().add(_T("Content-Type"), m_httpCallData->contentTypeHeaderValue);
-        request.headers().add(_T("Accept-Language"), utils::get_locales());
+        set_default_headers(request.headers(), m_httpCallData->xboxContractVersionHeaderValue, m_httpCallData->contentTypeHeaderValue);
     }
 
     for (auto& customHeader : m_httpCallData->customHeaderMap)
     {
         // Replace any existing headers instead of appending
-        if (request.headers().has(customHeader.first))
-        {
-            request.headers().remove(customHeader.first);
-        }
-
-        request.headers().add(customHeader.first, customHeader.second);
+        request.headers()[customHeader.first] = customHeader.second;
     }
 
     switch (m_httpCallData->requestBody.get_http_request_message_type())
@@ -408,6 +534,18 @@ http_call_impl::get_default_request()
         case http_request_message_type::vector_message:
             request.set_body(m_httpCallData->requestBody.request_message_vector());
             break;
+
+        case http_request_message_type::buffer_view_message:
+            // Reads straight out of the shared buffer, which requestBody keeps alive for the life of the call.
+            // The stream is seekable, so _reset_body_for_retry can rewind it for a retry.
+            request.set_body(
+                concurrency::streams::rawptr_stream<uint8_t>::open_istream(
+                    m_httpCallData->requestBody.request_message_buffer(),
+                    m_httpCallData->requestBody.request_message_buffer_size()
+                    ),
+                m_httpCallData->requestBody.request_message_buffer_size()
+                );
+            break;
     }
 
     return request;
@@ -481,6 +619,15 @@ void http_call_impl::set_request_body(
     m_httpCallData->requestBody = http_call_request_message(value);
 }
 
+void http_call_impl::set_request_body(
+    _In_ std::shared_ptr<const std::vector<uint8_t>> buffer,
+    _In_ size_t offset,
+    _In_ size_t length
+    )
+{
+    m_httpCallData->requestBody = http_call_request_message(std::move(buffer), offset, length);
+}
+
 void http_call_impl::set_request_body(
     _In_ const web::json::value& value
     )
@@ -931,6 +1078,48 @@ void http_call_impl::set_http_timeout(
     }
 }
 
+pplx::task<std::shared_ptr<http_call_response>>
+http_call_impl::track_call_metrics(
+    _In_ const std::shared_ptr<http_call_data>& httpCallData,
+    _In_ pplx::task<std::shared_ptr<http_call_response>> responseTask
+    )
+{
+    return responseTask.then([httpCallData](pplx::task<std::shared_ptr<http_call_response>> responseTask)
+    {
+        auto record_call = [httpCallData](bool isError)
+        {
+            auto completedTime = chrono_clock_t::now();
+
+            // Calls that fast fail or fail to get a token never send a request, so all their time is queue time
+            auto queueEndTime = httpCallData->firstRequestSentTime >= httpCallData->callIssuedTime ?
+                httpCallData->firstRequestSentTime :
+                completedTime;
+
+            service_call_metrics::get_singleton_instance()->record_call(
+                httpCallData->xboxLiveApi,
+                isError,
+                std::chrono::duration_cast<std::chrono::microseconds>(queueEndTime - httpCallData->callIssuedTime),
+                std::chrono::duration_cast<std::chrono::microseconds>(completedTime - httpCallData->callIssuedTime)
+                );
+        };
+
+        std::shared_ptr<http_call_response> httpCallResponse;
+        try
+        {
+            httpCallResponse = responseTask.get();
+        }
+        catch (...)
+        {
+            // Still counted as a failed call, then passed on to the caller unchanged
+            record_call(true);
+            throw;
+        }
+
+        record_call(httpCallResponse == nullptr || httpCallResponse->err_code());
+        return httpCallResponse;
+    });
+}
+
 static std::mutex g_httpRetryPolicyManagerSingletonLock;
 static std::shared_ptr<http_retry_after_manager> g_httpRetryPolicyManagerSingleton;
 
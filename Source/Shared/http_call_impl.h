@@ -97,6 +97,9 @@ enum class xbox_live_api
     xbox_one_pins_remove_item
 };
 
+// Keep in sync with the last xbox_live_api value and with the name table in service_call_metrics.cpp
+const size_t XBOX_LIVE_API_COUNT = static_cast<size_t>(xbox_live_api::xbox_one_pins_remove_item) + 1;
+
 struct http_call_data
 {
     http_call_data(
@@ -125,7 +128,9 @@ struct http_call_data
     }
 
     std::chrono::milliseconds delayBeforeRetry;
+    chrono_clock_t::time_point callIssuedTime;
     chrono_clock_t::time_point firstCallStartTime;
+    chrono_clock_t::time_point firstRequestSentTime;
     bool hasPerformedRetryOn401;
     bool retryAllowed;
     uint32_t iterationNumber;
@@ -288,6 +293,11 @@ public:
     void set_request_body(_In_ const string_t& value) override;
     void set_request_body(_In_ const web::json::value& value) override;
     void set_request_body(_In_ const std::vector<uint8_t>& value) override;
+    void set_request_body(
+        _In_ std::shared_ptr<const std::vector<uint8_t>> buffer,
+        _In_ size_t offset,
+        _In_ size_t length
+        ) override;
     const http_call_request_message& request_body() const override;
 
     void set_content_type_header_value(_In_ const string_t& value) override;
@@ -322,6 +332,10 @@ private:
         _In_ const std::shared_ptr<http_call_data>& httpCallData
         );
 
+    static pplx::task<std::shared_ptr<http_call_response>> send_request(
+        _In_ const std::shared_ptr<http_call_data>& httpCallData
+        );
+
     static void set_user_agent(
         _In_ const std::shared_ptr<http_call_data>& httpCallData
         );
@@ -377,6 +391,11 @@ private:
         _In_ const std::shared_ptr<http_call_data>& httpCallData,
         _In_ const chrono_clock_t::time_point& currentTime
         );
+
+    static pplx::task<std::shared_ptr<http_call_response>> track_call_metrics(
+        _In_ const std::shared_ptr<http_call_data>& httpCallData,
+        _In_ pplx::task<std::shared_ptr<http_call_response>> responseTask
+        );
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
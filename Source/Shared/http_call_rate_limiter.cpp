@@ -0,0 +1,430 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "http_call_rate_limiter.h"
+#if !XSAPI_U
+#include "ppltasks_extra.h"
+#else
+#include "ppltasks_extra_unix.h"
+#endif
+
+using namespace Concurrency::extras;
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+// Default fine grained rate limits the services apply per user and per title
+const uint32_t DEFAULT_BURST_CALLS = 10;
+const std::chrono::seconds DEFAULT_BURST_WINDOW(15);
+const uint32_t DEFAULT_SUSTAINED_CALLS = 30;
+const std::chrono::seconds DEFAULT_SUSTAINED_WINDOW(300);
+
+// Buckets are swept once there are this many, and again each time the count doubles after a sweep
+const size_t http_call_rate_limiter::MIN_BUCKETS_BEFORE_EVICTION = 64;
+
+static std::mutex g_httpCallRateLimiterSingletonLock;
+static std::shared_ptr<http_call_rate_limiter> g_httpCallRateLimiterSingleton;
+
+std::shared_ptr<http_call_rate_limiter>
+http_call_rate_limiter::get_singleton_instance()
+{
+    std::lock_guard<std::mutex> guard(g_httpCallRateLimiterSingletonLock);
+    if (g_httpCallRateLimiterSingleton == nullptr)
+    {
+        g_httpCallRateLimiterSingleton = std::make_shared<http_call_rate_limiter>();
+    }
+
+    return g_httpCallRateLimiterSingleton;
+}
+
+http_call_rate_limiter::http_call_rate_limiter() :
+    m_isEnabled(false),
+    m_evictionThreshold(MIN_BUCKETS_BEFORE_EVICTION)
+{
+}
+
+bool
+http_call_rate_limiter::is_enabled() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_isEnabled;
+}
+
+void
+http_call_rate_limiter::set_enabled(
+    _In_ bool enabled
+    )
+{
+    std::vector<bucket_key> keysToDrain;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_isEnabled = enabled;
+        for (const auto& bucket : m_buckets)
+        {
+            keysToDrain.push_back(bucket.first);
+        }
+    }
+
+    // Turning the limiter off releases anything it was holding
+    for (const auto& key : keysToDrain)
+    {
+        drain(key);
+    }
+}
+
+http_call_rate_limit_budget
+http_call_rate_limiter::default_budget(
+    _In_ xbox_live_api xboxLiveApi
+    )
+{
+    if (xboxLiveApi == xbox_live_api::unspecified)
+    {
+        // Auth and other untagged calls aren't subject to the per API limits
+        return http_call_rate_limit_budget();
+    }
+
+    return http_call_rate_limit_budget(DEFAULT_BURST_CALLS, DEFAULT_BURST_WINDOW, DEFAULT_SUSTAINED_CALLS, DEFAULT_SUSTAINED_WINDOW);
+}
+
+http_call_rate_limit_budget
+http_call_rate_limiter::budget(
+    _In_ xbox_live_api xboxLiveApi
+    ) const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return api_budget(static_cast<uint32_t>(xboxLiveApi));
+}
+
+http_call_rate_limit_budget
+http_call_rate_limiter::api_budget(
+    _In_ uint32_t xboxLiveApi
+    ) const
+{
+    // Called with m_lock held
+    auto iter = m_budgetOverrides.find(xboxLiveApi);
+    return iter != m_budgetOverrides.end() ? iter->second : default_budget(static_cast<xbox_live_api>(xboxLiveApi));
+}
+
+void
+http_call_rate_limiter::evict_idle_buckets(
+    _In_ const chrono_clock_t::time_point& now
+    )
+{
+    // Called with m_lock held. A bucket with nothing waiting that has refilled completely is
+    // no different from a new one, so it can be dropped and recreated on the next call.
+    for (auto iter = m_buckets.begin(); iter != m_buckets.end();)
+    {
+        bucket_state& bucket = iter->second;
+        bool isIdle = bucket.foregroundQueue.empty() && bucket.backgroundQueue.empty() && !bucket.isDrainScheduled;
+        bool isFull = false;
+        if (isIdle)
+        {
+            http_call_rate_limit_budget apiBudget = api_budget(iter->first.first);
+            if (apiBudget.is_unlimited())
+            {
+                isFull = true;
+            }
+            else
+            {
+                refill(bucket, apiBudget, now);
+                isFull = bucket.burstTokens >= apiBudget.burstCalls && bucket.sustainedTokens >= apiBudget.sustainedCalls;
+            }
+        }
+
+        if (isIdle && isFull)
+        {
+            iter = m_buckets.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+
+    m_evictionThreshold = __max(MIN_BUCKETS_BEFORE_EVICTION, m_buckets.size() * 2);
+}
+
+void
+http_call_rate_limiter::set_budget(
+    _In_ xbox_live_api xboxLiveApi,
+    _In_ const http_call_rate_limit_budget& budget
+    )
+{
+    std::vector<bucket_key> keysToDrain;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_budgetOverrides[static_cast<uint32_t>(xboxLiveApi)] = budget;
+        for (const auto& bucket : m_buckets)
+        {
+            if (bucket.first.first == static_cast<uint32_t>(xboxLiveApi))
+            {
+                keysToDrain.push_back(bucket.first);
+            }
+        }
+    }
+
+    for (const auto& key : keysToDrain)
+    {
+        drain(key);
+    }
+}
+
+void
+http_call_rate_limiter::refill(
+    _In_ bucket_state& bucket,
+    _In_ const http_call_rate_limit_budget& budget,
+    _In_ const chrono_clock_t::time_point& now
+    )
+{
+    double elapsedSeconds = std::chrono::duration_cast<std::chrono::duration<double>>(now - bucket.lastRefillTime).count();
+    if (elapsedSeconds <= 0)
+    {
+        return;
+    }
+
+    bucket.burstTokens = __min(
+        static_cast<double>(budget.burstCalls),
+        bucket.burstTokens + elapsedSeconds * budget.burstCalls / budget.burstWindow.count()
+        );
+    bucket.sustainedTokens = __min(
+        static_cast<double>(budget.sustainedCalls),
+        bucket.sustainedTokens + elapsedSeconds * budget.sustainedCalls / budget.sustainedWindow.count()
+        );
+    bucket.lastRefillTime = now;
+}
+
+std::chrono::milliseconds
+http_call_rate_limiter::time_until_next_token(
+    _In_ const bucket_state& bucket,
+    _In_ const http_call_rate_limit_budget& budget
+    )
+{
+    double burstWaitSeconds = bucket.burstTokens >= 1 ?
+        0 :
+        (1 - bucket.burstTokens) * budget.burstWindow.count() / budget.burstCalls;
+    double sustainedWaitSeconds = bucket.sustainedTokens >= 1 ?
+        0 :
+        (1 - bucket.sustainedTokens) * budget.sustainedWindow.count() / budget.sustainedCalls;
+
+    // Round up so the drain doesn't wake a hair before the token is available
+    return std::chrono::milliseconds(static_cast<int64_t>(std::ceil(__max(burstWaitSeconds, sustainedWaitSeconds) * 1000)));
+}
+
+pplx::task<void>
+http_call_rate_limiter::acquire(
+    _In_ xbox_live_api xboxLiveApi,
+    _In_ const string_t& xboxUserId,
+    _In_ http_call_priority priority
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (!m_isEnabled)
+    {
+        return pplx::task_from_result();
+    }
+
+    http_call_rate_limit_budget apiBudget = api_budget(static_cast<uint32_t>(xboxLiveApi));
+    if (apiBudget.is_unlimited())
+    {
+        return pplx::task_from_result();
+    }
+
+    auto now = chrono_clock_t::now();
+    if (m_buckets.size() >= m_evictionThreshold)
+    {
+        evict_idle_buckets(now);
+    }
+
+    bucket_key key(static_cast<uint32_t>(xboxLiveApi), xboxUserId);
+    auto inserted = m_buckets.insert(std::make_pair(key, bucket_state()));
+    bucket_state& bucket = inserted.first->second;
+    if (inserted.second)
+    {
+        bucket.burstTokens = apiBudget.burstCalls;
+        bucket.sustainedTokens = apiBudget.sustainedCalls;
+        bucket.lastRefillTime = now;
+    }
+    else
+    {
+        refill(bucket, apiBudget, now);
+    }
+
+    http_call_rate_limiter_api_metrics& apiMetrics = m_metrics[key.first];
+    apiMetrics.api = xboxLiveApi;
+
+    // Calls already waiting keep their place, so a new call only goes straight through when nothing is queued
+    if (bucket.foregroundQueue.empty() && bucket.backgroundQueue.empty() &&
+        bucket.burstTokens >= 1 && bucket.sustainedTokens >= 1)
+    {
+        bucket.burstTokens -= 1;
+        bucket.sustainedTokens -= 1;
+        ++apiMetrics.admittedCount;
+        return pplx::task_from_result();
+    }
+
+    waiting_call waitingCall;
+    waitingCall.queuedTime = now;
+    if (priority == http_call_priority::foreground)
+    {
+        bucket.foregroundQueue.push_back(waitingCall);
+    }
+    else
+    {
+        bucket.backgroundQueue.push_back(waitingCall);
+    }
+    ++apiMetrics.queuedCount;
+    ++apiMetrics.currentlyQueuedCount;
+
+    schedule_drain(key, bucket, apiBudget);
+    return pplx::create_task(waitingCall.tce);
+}
+
+void
+http_call_rate_limiter::schedule_drain(
+    _In_ const bucket_key& key,
+    _In_ bucket_state& bucket,
+    _In_ const http_call_rate_limit_budget& budget
+    )
+{
+    if (bucket.isDrainScheduled)
+    {
+        return;
+    }
+
+    bucket.isDrainScheduled = true;
+    std::weak_ptr<http_call_rate_limiter> thisWeakPtr = shared_from_this();
+    create_delayed_task(
+        time_until_next_token(bucket, budget),
+        [thisWeakPtr, key]()
+    {
+        std::shared_ptr<http_call_rate_limiter> pThis(thisWeakPtr.lock());
+        if (pThis != nullptr)
+        {
+            pThis->drain(key);
+        }
+    });
+}
+
+void
+http_call_rate_limiter::drain(
+    _In_ const bucket_key& key
+    )
+{
+    std::vector<pplx::task_completion_event<void>> admittedCalls;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto bucketIter = m_buckets.find(key);
+        if (bucketIter == m_buckets.end())
+        {
+            return;
+        }
+
+        bucket_state& bucket = bucketIter->second;
+        bucket.isDrainScheduled = false;
+
+        http_call_rate_limit_budget apiBudget = api_budget(key.first);
+        bool releaseAll = !m_isEnabled || apiBudget.is_unlimited();
+
+        auto now = chrono_clock_t::now();
+        if (!releaseAll)
+        {
+            refill(bucket, apiBudget, now);
+        }
+
+        http_call_rate_limiter_api_metrics& apiMetrics = m_metrics[key.first];
+        while (!bucket.foregroundQueue.empty() || !bucket.backgroundQueue.empty())
+        {
+            if (!releaseAll && (bucket.burstTokens < 1 || bucket.sustainedTokens < 1))
+            {
+                break;
+            }
+
+            // Foreground calls always go first; background refreshes only get what's left over
+            auto& queue = !bucket.foregroundQueue.empty() ? bucket.foregroundQueue : bucket.backgroundQueue;
+            waiting_call waitingCall = queue.front();
+            queue.pop_front();
+
+            if (!releaseAll)
+            {
+                bucket.burstTokens -= 1;
+                bucket.sustainedTokens -= 1;
+            }
+
+            auto queueWait = std::chrono::duration_cast<std::chrono::milliseconds>(now - waitingCall.queuedTime);
+            ++apiMetrics.admittedCount;
+            --apiMetrics.currentlyQueuedCount;
+            apiMetrics.totalQueueWait += queueWait;
+            apiMetrics.maxQueueWait = __max(apiMetrics.maxQueueWait, queueWait);
+            admittedCalls.push_back(waitingCall.tce);
+        }
+
+        if (!bucket.foregroundQueue.empty() || !bucket.backgroundQueue.empty())
+        {
+            schedule_drain(key, bucket, apiBudget);
+        }
+    }
+
+    // Completing the calls runs their continuations, so do it outside the lock
+    for (auto& tce : admittedCalls)
+    {
+        tce.set();
+    }
+}
+
+std::vector<http_call_rate_limiter_api_metrics>
+http_call_rate_limiter::metrics() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    std::vector<http_call_rate_limiter_api_metrics> result;
+    for (const auto& apiMetrics : m_metrics)
+    {
+        result.push_back(apiMetrics.second);
+    }
+
+    return result;
+}
+
+size_t
+http_call_rate_limiter::bucket_count() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_buckets.size();
+}
+
+void
+http_call_rate_limiter::reset()
+{
+    std::vector<pplx::task_completion_event<void>> queuedCalls;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        for (auto& bucket : m_buckets)
+        {
+            for (auto& waitingCall : bucket.second.foregroundQueue)
+            {
+                queuedCalls.push_back(waitingCall.tce);
+            }
+            for (auto& waitingCall : bucket.second.backgroundQueue)
+            {
+                queuedCalls.push_back(waitingCall.tce);
+            }
+        }
+
+        m_budgetOverrides.clear();
+        m_buckets.clear();
+        m_metrics.clear();
+        m_evictionThreshold = MIN_BUCKETS_BEFORE_EVICTION;
+    }
+
+    for (auto& tce : queuedCalls)
+    {
+        tce.set();
+    }
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -0,0 +1,201 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+#include <deque>
+#include <map>
+#include "http_call_impl.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+enum class http_call_priority
+{
+    /// <summary>
+    /// Calls made directly by the title, which a player is likely waiting on
+    /// </summary>
+    foreground,
+
+    /// <summary>
+    /// Refreshes issued by the social and stats managers, which can wait behind foreground calls
+    /// </summary>
+    background
+};
+
+/// <summary>
+/// The number of calls a single user may make to an API. A call is only admitted when both the
+/// burst and the sustained budgets have room, matching how the service enforces its limits.
+/// </summary>
+struct http_call_rate_limit_budget
+{
+    http_call_rate_limit_budget() :
+        burstCalls(0),
+        burstWindow(std::chrono::seconds::zero()),
+        sustainedCalls(0),
+        sustainedWindow(std::chrono::seconds::zero())
+    {
+    }
+
+    http_call_rate_limit_budget(
+        _In_ uint32_t _burstCalls,
+        _In_ std::chrono::seconds _burstWindow,
+        _In_ uint32_t _sustainedCalls,
+        _In_ std::chrono::seconds _sustainedWindow
+        ) :
+        burstCalls(_burstCalls),
+        burstWindow(_burstWindow),
+        sustainedCalls(_sustainedCalls),
+        sustainedWindow(_sustainedWindow)
+    {
+    }
+
+    bool is_unlimited() const { return burstCalls == 0 || sustainedCalls == 0; }
+
+    uint32_t burstCalls;
+    std::chrono::seconds burstWindow;
+    uint32_t sustainedCalls;
+    std::chrono::seconds sustainedWindow;
+};
+
+struct http_call_rate_limiter_api_metrics
+{
+    http_call_rate_limiter_api_metrics() :
+        api(xbox_live_api::unspecified),
+        admittedCount(0),
+        queuedCount(0),
+        currentlyQueuedCount(0),
+        totalQueueWait(std::chrono::milliseconds::zero()),
+        maxQueueWait(std::chrono::milliseconds::zero())
+    {
+    }
+
+    xbox_live_api api;
+
+    /// <summary>
+    /// Calls let through, including those that had to wait
+    /// </summary>
+    uint64_t admittedCount;
+
+    /// <summary>
+    /// Calls that had to wait for budget
+    /// </summary>
+    uint64_t queuedCount;
+    uint64_t currentlyQueuedCount;
+    std::chrono::milliseconds totalQueueWait;
+    std::chrono::milliseconds maxQueueWait;
+};
+
+/// <summary>
+/// Proactively keeps service calls within the service's per user rate limits instead of waiting to be throttled.
+/// Each API and user pair has a burst and a sustained token bucket. When either is empty, calls are queued and
+/// released as tokens refill, foreground calls ahead of background ones, rather than being sent to collect a 429.
+/// Disabled by default; http_retry_after_manager still handles any throttling that gets through.
+/// </summary>
+class http_call_rate_limiter : public std::enable_shared_from_this<http_call_rate_limiter>
+{
+public:
+    http_call_rate_limiter();
+
+    static std::shared_ptr<http_call_rate_limiter> get_singleton_instance();
+
+    bool is_enabled() const;
+    void set_enabled(_In_ bool enabled);
+
+    http_call_rate_limit_budget budget(_In_ xbox_live_api xboxLiveApi) const;
+
+    /// <summary>
+    /// Overrides the budget of an API. An unlimited budget turns limiting off for it.
+    /// </summary>
+    void set_budget(
+        _In_ xbox_live_api xboxLiveApi,
+        _In_ const http_call_rate_limit_budget& budget
+        );
+
+    /// <summary>
+    /// Completes once the call may be sent
+    /// </summary>
+    pplx::task<void> acquire(
+        _In_ xbox_live_api xboxLiveApi,
+        _In_ const string_t& xboxUserId,
+        _In_ http_call_priority priority
+        );
+
+    std::vector<http_call_rate_limiter_api_metrics> metrics() const;
+
+    /// <summary>
+    /// The number of API and user pairs currently tracked. Idle buckets that have fully refilled are dropped.
+    /// </summary>
+    size_t bucket_count() const;
+
+    /// <summary>
+    /// Restores the default budgets and clears all buckets and metrics. Queued calls are released.
+    /// </summary>
+    void reset();
+
+    static http_call_rate_limit_budget default_budget(_In_ xbox_live_api xboxLiveApi);
+
+    static const size_t MIN_BUCKETS_BEFORE_EVICTION;
+
+private:
+    struct waiting_call
+    {
+        pplx::task_completion_event<void> tce;
+        chrono_clock_t::time_point queuedTime;
+    };
+
+    struct bucket_state
+    {
+        bucket_state() :
+            burstTokens(0),
+            sustainedTokens(0),
+            isDrainScheduled(false)
+        {
+        }
+
+        double burstTokens;
+        double sustainedTokens;
+        chrono_clock_t::time_point lastRefillTime;
+        std::deque<waiting_call> foregroundQueue;
+        std::deque<waiting_call> backgroundQueue;
+        bool isDrainScheduled;
+    };
+
+    typedef std::pair<uint32_t, string_t> bucket_key;
+
+    static void refill(
+        _In_ bucket_state& bucket,
+        _In_ const http_call_rate_limit_budget& budget,
+        _In_ const chrono_clock_t::time_point& now
+        );
+
+    static std::chrono::milliseconds time_until_next_token(
+        _In_ const bucket_state& bucket,
+        _In_ const http_call_rate_limit_budget& budget
+        );
+
+    void schedule_drain(
+        _In_ const bucket_key& key,
+        _In_ bucket_state& bucket,
+        _In_ const http_call_rate_limit_budget& budget
+        );
+
+    void drain(_In_ const bucket_key& key);
+
+    http_call_rate_limit_budget api_budget(_In_ uint32_t xboxLiveApi) const;
+
+    void evict_idle_buckets(_In_ const chrono_clock_t::time_point& now);
+
+    bool m_isEnabled;
+    size_t m_evictionThreshold;
+    std::map<uint32_t, http_call_rate_limit_budget> m_budgetOverrides;
+    std::map<bucket_key, bucket_state> m_buckets;
+    std::map<uint32_t, http_call_rate_limiter_api_metrics> m_metrics;
+    mutable std::mutex m_lock;
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
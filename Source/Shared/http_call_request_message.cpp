@@ -14,6 +14,8 @@
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 
 http_call_request_message::http_call_request_message() :
+    m_requestMessageBufferOffset(0),
+    m_requestMessageBufferLength(0),
     m_httpRequestMessageType(http_request_message_type::empty_message)
 {
 }
@@ -22,6 +24,8 @@ http_call_request_message::http_call_request_message(
     _In_ string_t messageString
     ) : 
     m_requestMessageString(std::move(messageString)),
+    m_requestMessageBufferOffset(0),
+    m_requestMessageBufferLength(0),
     m_httpRequestMessageType(http_request_message_type::string_message)
 {
 }
@@ -30,10 +34,25 @@ http_call_request_message::http_call_request_message(
     _In_ std::vector<unsigned char> messageVector
     ) :
     m_requestMessageVector(std::move(messageVector)),
+    m_requestMessageBufferOffset(0),
+    m_requestMessageBufferLength(0),
     m_httpRequestMessageType(http_request_message_type::vector_message)
 {
 }
 
+http_call_request_message::http_call_request_message(
+    _In_ std::shared_ptr<const std::vector<unsigned char>> messageBuffer,
+    _In_ size_t offset,
+    _In_ size_t length
+    ) :
+    m_requestMessageBuffer(std::move(messageBuffer)),
+    m_requestMessageBufferOffset(offset),
+    m_requestMessageBufferLength(length),
+    m_httpRequestMessageType(http_request_message_type::buffer_view_message)
+{
+    XSAPI_ASSERT(m_requestMessageBuffer != nullptr && offset + length <= m_requestMessageBuffer->size());
+}
+
 const string_t&
 http_call_request_message::request_message_string() const
 {
@@ -46,6 +65,38 @@ http_call_request_message::request_message_vector() const
     return m_requestMessageVector;
 }
 
+const unsigned char*
+http_call_request_message::request_message_buffer() const
+{
+    switch (m_httpRequestMessageType)
+    {
+        case http_request_message_type::vector_message:
+            return m_requestMessageVector.empty() ? nullptr : m_requestMessageVector.data();
+
+        case http_request_message_type::buffer_view_message:
+            return m_requestMessageBufferLength == 0 ? nullptr : m_requestMessageBuffer->data() + m_requestMessageBufferOffset;
+
+        default:
+            return nullptr;
+    }
+}
+
+size_t
+http_call_request_message::request_message_buffer_size() const
+{
+    switch (m_httpRequestMessageType)
+    {
+        case http_request_message_type::vector_message:
+            return m_requestMessageVector.size();
+
+        case http_request_message_type::buffer_view_message:
+            return m_requestMessageBufferLength;
+
+        default:
+            return 0;
+    }
+}
+
 http_request_message_type
 http_call_request_message::get_http_request_message_type() const
 {
@@ -44,9 +44,23 @@ std::shared_ptr<local_config> local_config::get_local_config_singleton()
 }
 
 local_config::local_config()
+#if XSAPI_U
+    :
+    m_isLocalStorageLoaded(false),
+    m_isLocalStorageDirty(false),
+    m_isLocalStorageFlushScheduled(false)
+#endif
 {
 }
 
+local_config::~local_config()
+{
+#if XSAPI_U
+    // Don't lose writes still waiting on the write-behind delay
+    flush_local_storage();
+#endif
+}
+
 #if !TV_API
 uint64_t local_config::get_uint64_from_config(
     _In_ const string_t& name,
@@ -12,12 +12,38 @@
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 
-class local_config
+#if XSAPI_U
+struct local_storage_stats
+{
+    local_storage_stats() :
+        valueReads(0),
+        valueWrites(0),
+        fileReads(0),
+        fileWrites(0)
+    {
+    }
+
+    /// <summary>
+    /// Calls to get, write and delete a value
+    /// </summary>
+    uint64_t valueReads;
+    uint64_t valueWrites;
+
+    /// <summary>
+    /// Times the storage file was actually read from or written to disk
+    /// </summary>
+    uint64_t fileReads;
+    uint64_t fileWrites;
+};
+#endif
+
+class local_config : public std::enable_shared_from_this<local_config>
 {
 public:
     static std::shared_ptr<local_config> get_local_config_singleton();
 
     local_config();
+    virtual ~local_config();
     NO_COPY_AND_ASSIGN(local_config);
 
 #if !TV_API
@@ -51,6 +77,15 @@ public:
     virtual xbox_live_result<void> write_value_to_local_storage(_In_ const string_t& name, _In_ const string_t& value);
     virtual xbox_live_result<void> delete_value_from_local_storage(_In_ const string_t& name);
 
+#if XSAPI_U
+    /// <summary>
+    /// Writes any changes to local storage that are still waiting on the write-behind delay
+    /// </summary>
+    void flush_local_storage();
+
+    local_storage_stats get_local_storage_stats();
+#endif
+
 #if XSAPI_I
     virtual string_t apns_environment();
 #elif XSAPI_A
@@ -77,8 +112,21 @@ protected:
     web::json::value m_jsonConfig;
     std::mutex m_jsonConfigLock;
 #if XSAPI_U
+    string_t local_storage_file_path();
+    void load_local_storage_if_needed();
+    void schedule_local_storage_flush();
+
+    // The parsed storage file is kept in memory once loaded. Changes are applied to it right away
+    // and written to disk together after a short delay.
     web::json::value m_jsonLocalStorage;
+    bool m_isLocalStorageLoaded;
+    bool m_isLocalStorageDirty;
+    bool m_isLocalStorageFlushScheduled;
+    local_storage_stats m_localStorageStats;
     std::mutex m_jsonLocalStorageLock;
+
+    // Held while writing the file so flushes land in the order their snapshots were taken
+    std::mutex m_localStorageFileLock;
 #endif
 #endif
 };
@@ -0,0 +1,425 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <netdb.h>
+#include <unistd.h>
+#endif
+#include "qos_prober.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+#if defined(_WIN32)
+typedef SOCKET qos_socket;
+static const qos_socket INVALID_QOS_SOCKET = INVALID_SOCKET;
+#else
+typedef int qos_socket;
+static const qos_socket INVALID_QOS_SOCKET = -1;
+#endif
+
+static const uint32_t QOS_PROBE_MAGIC = 0x58514f53; // "XQOS"
+static const uint32_t QOS_PROBE_MAX_SIZE = 1400;
+
+// The probe loop holds a thread for its whole run, so no settings can keep it longer than this
+static const std::chrono::seconds QOS_PROBE_MAX_DURATION(10);
+
+enum class qos_probe_kind : uint32_t
+{
+    latency,
+    bandwidth
+};
+
+struct qos_probe_header
+{
+    uint32_t magic;
+    uint32_t targetIndex;
+    uint32_t sequence;
+    uint32_t kind;
+};
+
+struct qos_probe_target_state
+{
+    qos_probe_target_state() :
+        isResolved(false),
+        bandwidthRepliesReceived(0),
+        bandwidthBytesReceived(0)
+    {
+        memset(&address, 0, sizeof(address));
+    }
+
+    bool isResolved;
+    sockaddr_in address;
+    std::vector<std::chrono::steady_clock::time_point> latencySendTimes;
+    std::vector<bool> latencyReplied;
+    std::vector<std::chrono::microseconds> roundTripTimes;
+    std::vector<bool> bandwidthReplied;
+    uint32_t bandwidthRepliesReceived;
+    uint64_t bandwidthBytesReceived;
+    std::chrono::steady_clock::time_point firstBandwidthReplyTime;
+    std::chrono::steady_clock::time_point lastBandwidthReplyTime;
+};
+
+/// <summary>
+/// Owns the socket and, on Windows, the Winsock initialization for one measurement
+/// </summary>
+class qos_probe_socket
+{
+public:
+    qos_probe_socket() :
+        m_socket(INVALID_QOS_SOCKET),
+        m_isStarted(false)
+    {
+#if defined(_WIN32)
+        WSADATA wsaData;
+        m_isStarted = WSAStartup(MAKEWORD(2, 2), &wsaData) == 0;
+        if (!m_isStarted) return;
+#else
+        m_isStarted = true;
+#endif
+        m_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    }
+
+    ~qos_probe_socket()
+    {
+        if (m_socket != INVALID_QOS_SOCKET)
+        {
+#if defined(_WIN32)
+            closesocket(m_socket);
+#else
+            close(m_socket);
+#endif
+        }
+#if defined(_WIN32)
+        if (m_isStarted)
+        {
+            WSACleanup();
+        }
+#endif
+    }
+
+    bool is_valid() const { return m_isStarted && m_socket != INVALID_QOS_SOCKET; }
+    qos_socket get() const { return m_socket; }
+
+private:
+    qos_probe_socket(const qos_probe_socket&);
+    void operator=(const qos_probe_socket&);
+
+    qos_socket m_socket;
+    bool m_isStarted;
+};
+
+bool
+qos_prober::parse_target(
+    _In_ const string_t& target,
+    _Out_ std::string& host,
+    _Out_ std::string& port
+    )
+{
+    std::string targetUtf8 = utility::conversions::to_utf8string(target);
+    size_t separator = targetUtf8.rfind(':');
+    if (separator == std::string::npos || separator == 0 || separator + 1 >= targetUtf8.size())
+    {
+        return false;
+    }
+
+    host = targetUtf8.substr(0, separator);
+    port = targetUtf8.substr(separator + 1);
+    if (host.size() >= 2 && host.front() == '[' && host.back() == ']')
+    {
+        host = host.substr(1, host.size() - 2);
+    }
+
+    return !host.empty() && port.find_first_not_of("0123456789") == std::string::npos;
+}
+
+static bool resolve_target(
+    _In_ const string_t& target,
+    _Out_ sockaddr_in& address
+    )
+{
+    std::string host;
+    std::string port;
+    if (!qos_prober::parse_target(target, host, port))
+    {
+        return false;
+    }
+
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_protocol = IPPROTO_UDP;
+
+    addrinfo* results = nullptr;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &results) != 0 || results == nullptr)
+    {
+        return false;
+    }
+
+    memcpy(&address, results->ai_addr, sizeof(address));
+    freeaddrinfo(results);
+    return true;
+}
+
+static int wait_for_readable(
+    _In_ qos_socket socketHandle,
+    _In_ int64_t waitMicroseconds
+    )
+{
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    FD_SET(socketHandle, &readSet);
+    timeval waitTime;
+    waitTime.tv_sec = static_cast<long>(waitMicroseconds / 1000000);
+    waitTime.tv_usec = static_cast<long>(waitMicroseconds % 1000000);
+    return select(static_cast<int>(socketHandle + 1), &readSet, nullptr, nullptr, &waitTime);
+}
+
+static void send_probe(
+    _In_ qos_socket socketHandle,
+    _In_ const sockaddr_in& address,
+    _In_ uint32_t targetIndex,
+    _In_ uint32_t sequence,
+    _In_ qos_probe_kind kind,
+    _In_ std::vector<char>& buffer
+    )
+{
+    qos_probe_header header;
+    header.magic = QOS_PROBE_MAGIC;
+    header.targetIndex = targetIndex;
+    header.sequence = sequence;
+    header.kind = static_cast<uint32_t>(kind);
+    memcpy(buffer.data(), &header, sizeof(header));
+
+    // A probe that can't be sent is simply counted as lost
+    sendto(socketHandle, buffer.data(), static_cast<int>(buffer.size()), 0, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+}
+
+std::vector<qos_probe_result>
+qos_prober::measure_blocking(
+    _In_ const std::vector<string_t>& targets,
+    _In_ const qos_probe_settings& settings
+    )
+{
+    std::vector<qos_probe_result> results(targets.size());
+    std::vector<qos_probe_target_state> states(targets.size());
+    for (size_t i = 0; i < targets.size(); ++i)
+    {
+        results[i].target = targets[i];
+        states[i].isResolved = resolve_target(targets[i], states[i].address);
+        results[i].isResolved = states[i].isResolved;
+        states[i].latencySendTimes.resize(settings.probeCount);
+        states[i].latencyReplied.resize(settings.probeCount, false);
+        states[i].bandwidthReplied.resize(settings.bandwidthProbeCount, false);
+    }
+
+    qos_probe_socket probeSocket;
+    if (!probeSocket.is_valid() || targets.empty())
+    {
+        return results;
+    }
+
+    std::vector<char> latencyBuffer(sizeof(qos_probe_header), 0);
+    std::vector<char> bandwidthBuffer(__max(__min(settings.bandwidthProbeSize, QOS_PROBE_MAX_SIZE), static_cast<uint32_t>(sizeof(qos_probe_header))), 0);
+    std::vector<char> receiveBuffer(QOS_PROBE_MAX_SIZE, 0);
+
+    uint32_t roundsSent = 0;
+    bool bandwidthSent = settings.bandwidthProbeCount == 0;
+    auto nextSendTime = std::chrono::steady_clock::now();
+    auto deadline = std::chrono::steady_clock::time_point::max();
+    auto hardDeadline = nextSendTime + QOS_PROBE_MAX_DURATION;
+
+    while (true)
+    {
+        auto now = std::chrono::steady_clock::now();
+
+        // Every target gets its probe of a round together, so each round is one pass over the targets
+        while (roundsSent < settings.probeCount && now >= nextSendTime)
+        {
+            for (uint32_t i = 0; i < states.size(); ++i)
+            {
+                if (!states[i].isResolved) continue;
+                states[i].latencySendTimes[roundsSent] = std::chrono::steady_clock::now();
+                send_probe(probeSocket.get(), states[i].address, i, roundsSent, qos_probe_kind::latency, latencyBuffer);
+                ++results[i].probesSent;
+            }
+
+            ++roundsSent;
+            nextSendTime += settings.probeInterval;
+        }
+
+        if (roundsSent == settings.probeCount && !bandwidthSent)
+        {
+            // Back to back so the spacing of the replies reflects the bottleneck link
+            for (uint32_t i = 0; i < states.size(); ++i)
+            {
+                if (!states[i].isResolved) continue;
+                for (uint32_t sequence = 0; sequence < settings.bandwidthProbeCount; ++sequence)
+                {
+                    send_probe(probeSocket.get(), states[i].address, i, sequence, qos_probe_kind::bandwidth, bandwidthBuffer);
+                }
+            }
+
+            bandwidthSent = true;
+        }
+
+        if (roundsSent == settings.probeCount && bandwidthSent && deadline == std::chrono::steady_clock::time_point::max())
+        {
+            deadline = std::chrono::steady_clock::now() + settings.timeout;
+        }
+
+        bool allReplied = roundsSent == settings.probeCount && bandwidthSent;
+        for (size_t i = 0; allReplied && i < states.size(); ++i)
+        {
+            allReplied = !states[i].isResolved ||
+                (results[i].probesReceived == settings.probeCount && states[i].bandwidthRepliesReceived == settings.bandwidthProbeCount);
+        }
+
+        now = std::chrono::steady_clock::now();
+        if (allReplied || now >= deadline || now >= hardDeadline)
+        {
+            break;
+        }
+
+        auto wakeTime = __min(roundsSent < settings.probeCount ? nextSendTime : deadline, hardDeadline);
+        auto waitMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(wakeTime - now).count();
+        waitMicroseconds = __max(waitMicroseconds, static_cast<int64_t>(0));
+
+        int ready = wait_for_readable(probeSocket.get(), waitMicroseconds);
+        if (ready < 0)
+        {
+            break;
+        }
+        if (ready == 0)
+        {
+            continue;
+        }
+
+        // Drain everything that has arrived before going back to sending
+        do
+        {
+            sockaddr_in fromAddress;
+            socklen_t fromLength = sizeof(fromAddress);
+            int received = recvfrom(probeSocket.get(), receiveBuffer.data(), static_cast<int>(receiveBuffer.size()), 0, reinterpret_cast<sockaddr*>(&fromAddress), &fromLength);
+            auto receiveTime = std::chrono::steady_clock::now();
+            if (received < static_cast<int>(sizeof(qos_probe_header)))
+            {
+                break;
+            }
+
+            qos_probe_header header;
+            memcpy(&header, receiveBuffer.data(), sizeof(header));
+            if (header.magic != QOS_PROBE_MAGIC || header.targetIndex >= states.size())
+            {
+                continue;
+            }
+
+            qos_probe_target_state& state = states[header.targetIndex];
+            qos_probe_result& result = results[header.targetIndex];
+            if (fromAddress.sin_addr.s_addr != state.address.sin_addr.s_addr || fromAddress.sin_port != state.address.sin_port)
+            {
+                continue;
+            }
+
+            if (header.kind == static_cast<uint32_t>(qos_probe_kind::latency) &&
+                header.sequence < roundsSent &&
+                !state.latencyReplied[header.sequence])
+            {
+                state.latencyReplied[header.sequence] = true;
+                state.roundTripTimes.push_back(std::chrono::duration_cast<std::chrono::microseconds>(receiveTime - state.latencySendTimes[header.sequence]));
+                ++result.probesReceived;
+            }
+            else if (header.kind == static_cast<uint32_t>(qos_probe_kind::bandwidth) &&
+                bandwidthSent &&
+                header.sequence < settings.bandwidthProbeCount &&
+                !state.bandwidthReplied[header.sequence])
+            {
+                state.bandwidthReplied[header.sequence] = true;
+                if (state.bandwidthRepliesReceived == 0)
+                {
+                    state.firstBandwidthReplyTime = receiveTime;
+                }
+                else
+                {
+                    // The first reply only marks the start of the train; the bytes after it are what crossed the link
+                    state.bandwidthBytesReceived += received;
+                }
+                state.lastBandwidthReplyTime = receiveTime;
+                ++state.bandwidthRepliesReceived;
+            }
+        } while (wait_for_readable(probeSocket.get(), 0) > 0);
+    }
+
+    for (size_t i = 0; i < states.size(); ++i)
+    {
+        qos_probe_target_state& state = states[i];
+        qos_probe_result& result = results[i];
+        if (result.probesSent > 0)
+        {
+            result.packetLoss = 1.0 - static_cast<double>(result.probesReceived) / result.probesSent;
+        }
+
+        if (!state.roundTripTimes.empty())
+        {
+            std::sort(state.roundTripTimes.begin(), state.roundTripTimes.end());
+            auto median = state.roundTripTimes[state.roundTripTimes.size() / 2];
+            result.latency = std::chrono::duration_cast<std::chrono::milliseconds>(median + std::chrono::microseconds(500));
+        }
+
+        auto trainDuration = std::chrono::duration_cast<std::chrono::microseconds>(state.lastBandwidthReplyTime - state.firstBandwidthReplyTime);
+        if (state.bandwidthRepliesReceived >= 2 && trainDuration.count() > 0)
+        {
+            // bits per microsecond is megabits per second
+            result.bandwidthKilobitsPerSecond = state.bandwidthBytesReceived * 8 * 1000 / trainDuration.count();
+        }
+    }
+
+    return results;
+}
+
+pplx::task<std::vector<qos_probe_result>>
+qos_prober::measure(
+    _In_ const std::vector<string_t>& targets,
+    _In_ const qos_probe_settings& settings
+    )
+{
+    return pplx::create_task([targets, settings]()
+    {
+        return measure_blocking(targets, settings);
+    });
+}
+
+pplx::task<std::vector<qos_probe_result>>
+qos_prober::measure_quality_of_service_servers(
+    _In_ const std::vector<game_server_platform::quality_of_service_server>& servers,
+    _In_ const qos_probe_settings& settings
+    )
+{
+    std::vector<string_t> targets;
+    targets.reserve(servers.size());
+    for (const auto& server : servers)
+    {
+        stringstream_t target;
+        target << server.server_full_qualified_domain_name() << _T(":") << QUALITY_OF_SERVICE_SERVER_PORT;
+        targets.push_back(target.str());
+    }
+
+    return measure(targets, settings);
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -0,0 +1,130 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+#include "xsapi/game_server_platform.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+struct qos_probe_settings
+{
+    qos_probe_settings() :
+        probeCount(8),
+        probeInterval(std::chrono::milliseconds(10)),
+        timeout(std::chrono::milliseconds(1000)),
+        bandwidthProbeCount(8),
+        bandwidthProbeSize(1024)
+    {
+    }
+
+    /// <summary>
+    /// Number of small probes sent to each target to measure latency and packet loss
+    /// </summary>
+    uint32_t probeCount;
+
+    /// <summary>
+    /// Spacing between successive rounds of latency probes
+    /// </summary>
+    std::chrono::milliseconds probeInterval;
+
+    /// <summary>
+    /// How long to wait for replies after the last probe is sent
+    /// </summary>
+    std::chrono::milliseconds timeout;
+
+    /// <summary>
+    /// Number of back to back padded probes sent to each target to estimate bandwidth. 0 skips the bandwidth estimate.
+    /// </summary>
+    uint32_t bandwidthProbeCount;
+    uint32_t bandwidthProbeSize;
+};
+
+struct qos_probe_result
+{
+    qos_probe_result() :
+        isResolved(false),
+        probesSent(0),
+        probesReceived(0),
+        latency(std::chrono::milliseconds::zero()),
+        packetLoss(1.0),
+        bandwidthKilobitsPerSecond(0)
+    {
+    }
+
+    string_t target;
+    bool isResolved;
+    uint32_t probesSent;
+    uint32_t probesReceived;
+
+    /// <summary>
+    /// Median round trip time of the latency probes that were answered
+    /// </summary>
+    std::chrono::milliseconds latency;
+
+    /// <summary>
+    /// Fraction of latency probes that went unanswered, from 0 to 1
+    /// </summary>
+    double packetLoss;
+
+    /// <summary>
+    /// Round trip bottleneck bandwidth estimated from how far apart the replies to the
+    /// back to back bandwidth probes arrive. 0 when too few replies came back.
+    /// </summary>
+    uint64_t bandwidthKilobitsPerSecond;
+};
+
+/// <summary>
+/// Measures latency, packet loss and bandwidth to a set of UDP echo endpoints (such as the Xbox Live
+/// quality of service servers) given as "host:port". All targets are probed at the same time from a
+/// single socket driven by one select loop, so the measurement takes about the same time for 1 or 50 targets.
+/// Each probe carries a target index and sequence number and the endpoint is expected to send it back unchanged.
+/// Only IPv4 targets are supported.
+/// </summary>
+class qos_prober
+{
+public:
+    static const uint16_t QUALITY_OF_SERVICE_SERVER_PORT = 3075;
+
+    /// <summary>
+    /// Probes the targets on a background task. Results are in the same order as the targets.
+    /// The task runs the blocking probe loop, so it holds a thread pool thread for the whole measurement:
+    /// about probeCount * probeInterval + timeout, and never more than 10 seconds whatever the settings.
+    /// </summary>
+    static pplx::task<std::vector<qos_probe_result>> measure(
+        _In_ const std::vector<string_t>& targets,
+        _In_ const qos_probe_settings& settings
+        );
+
+    /// <summary>
+    /// Probes the servers returned by game_server_platform_service::get_quality_of_service_servers
+    /// </summary>
+    static pplx::task<std::vector<qos_probe_result>> measure_quality_of_service_servers(
+        _In_ const std::vector<game_server_platform::quality_of_service_server>& servers,
+        _In_ const qos_probe_settings& settings
+        );
+
+    /// <summary>
+    /// Runs the probe loop on the calling thread, returning after at most 10 seconds
+    /// </summary>
+    static std::vector<qos_probe_result> measure_blocking(
+        _In_ const std::vector<string_t>& targets,
+        _In_ const qos_probe_settings& settings
+        );
+
+    /// <summary>
+    /// Splits "host:port" or "[host]:port" into its parts
+    /// </summary>
+    static bool parse_target(
+        _In_ const string_t& target,
+        _Out_ std::string& host,
+        _Out_ std::string& port
+        );
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -0,0 +1,442 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "service_call_metrics.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+static const utility::char_t* const s_xboxLiveApiNames[] =
+{
+    _T("unspecified"),
+    _T("allocate_cluster"),
+    _T("allocate_cluster_inline"),
+    _T("allocate_session_host"),
+    _T("browse_catalog_bundles_helper"),
+    _T("browse_catalog_helper"),
+    _T("check_multiple_permissions_with_multiple_target_users"),
+    _T("check_permission_with_target_user"),
+    _T("clear_activity"),
+    _T("clear_search_handle"),
+    _T("consume_inventory_item"),
+    _T("create_match_ticket"),
+    _T("delete_blob"),
+    _T("delete_match_ticket"),
+    _T("download_blob"),
+    _T("get_achievement"),
+    _T("get_achievements"),
+    _T("get_activities_for_social_group"),
+    _T("get_activities_for_users"),
+    _T("get_avoid_or_mute_list"),
+    _T("get_blob_metadata"),
+    _T("get_broadcasts"),
+    _T("get_catalog_item_details"),
+    _T("get_configuration"),
+    _T("get_current_session"),
+    _T("get_current_session_by_handle"),
+    _T("get_game_clips"),
+    _T("get_game_server_metadata"),
+    _T("get_hopper_statistics"),
+    _T("get_inventory_item"),
+    _T("get_inventory_items"),
+    _T("get_leaderboard_for_social_group_internal"),
+    _T("get_leaderboard_internal"),
+    _T("get_match_ticket_details"),
+    _T("get_multiple_user_statistics_for_multiple_service_configurations"),
+    _T("get_presence"),
+    _T("get_presence_for_multiple_users"),
+    _T("get_presence_for_social_group"),
+    _T("get_quality_of_service_servers"),
+    _T("get_quota"),
+    _T("get_quota_for_session_storage"),
+    _T("get_search_handles"),
+    _T("get_session_host_allocation_status"),
+    _T("get_sessions"),
+    _T("get_single_user_statistics"),
+    _T("get_social_graph"),
+    _T("get_social_relationships"),
+    _T("get_stats_value_document"),
+    _T("get_ticket_status"),
+    _T("get_tournament_instance_teams"),
+    _T("get_tournament_instances"),
+    _T("get_tournament_progress"),
+    _T("get_user_profiles"),
+    _T("get_user_profiles_for_social_group"),
+    _T("register_team"),
+    _T("send_invites"),
+    _T("set_activity"),
+    _T("set_presence_helper"),
+    _T("set_search_handle"),
+    _T("set_transfer_handle"),
+    _T("submit_batch_reputation_feedback"),
+    _T("submit_reputation_feedback"),
+    _T("subscribe_to_notifications"),
+    _T("update_achievement"),
+    _T("update_stats_value_document"),
+    _T("upload_blob"),
+    _T("verify_strings"),
+    _T("write_session_using_subpath"),
+    _T("xbox_one_pins_add_item"),
+    _T("xbox_one_pins_contains_item"),
+    _T("xbox_one_pins_remove_item")
+};
+
+static_assert(sizeof(s_xboxLiveApiNames) / sizeof(s_xboxLiveApiNames[0]) == XBOX_LIVE_API_COUNT, "xbox_live_api name table is out of date");
+
+static const utility::char_t* const s_latencyPhaseNames[] =
+{
+    _T("queue"),
+    _T("ttfb"),
+    _T("total")
+};
+
+// Values are split into 4 linear buckets per power of two, from 4us up to 2^32us (~71 minutes)
+static const uint32_t SUB_BUCKET_BITS = 2;
+static const uint64_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+static const uint32_t MAX_MAJOR_BUCKET = 31;
+
+size_t
+service_call_latency_histogram::bucket_index(
+    _In_ uint64_t valueMicroseconds
+    )
+{
+    if (valueMicroseconds < SUB_BUCKET_COUNT)
+    {
+        return static_cast<size_t>(valueMicroseconds);
+    }
+
+    uint32_t major = 0;
+    for (uint64_t remaining = valueMicroseconds >> 1; remaining != 0; remaining >>= 1)
+    {
+        ++major;
+    }
+
+    if (major > MAX_MAJOR_BUCKET)
+    {
+        return BUCKET_COUNT - 1;
+    }
+
+    uint64_t subBucket = (valueMicroseconds >> (major - SUB_BUCKET_BITS)) & (SUB_BUCKET_COUNT - 1);
+    return static_cast<size_t>(SUB_BUCKET_COUNT + (major - SUB_BUCKET_BITS) * SUB_BUCKET_COUNT + subBucket);
+}
+
+uint64_t
+service_call_latency_histogram::bucket_upper_bound(
+    _In_ size_t bucketIndex
+    )
+{
+    if (bucketIndex < SUB_BUCKET_COUNT)
+    {
+        return bucketIndex;
+    }
+
+    if (bucketIndex >= BUCKET_COUNT - 1)
+    {
+        return UINT64_MAX;
+    }
+
+    uint64_t shift = (bucketIndex - SUB_BUCKET_COUNT) / SUB_BUCKET_COUNT;
+    uint64_t subBucket = (bucketIndex - SUB_BUCKET_COUNT) % SUB_BUCKET_COUNT;
+    return ((SUB_BUCKET_COUNT + subBucket + 1) << shift) - 1;
+}
+
+std::chrono::microseconds
+service_call_latency_histogram::percentile(
+    _In_ double percentile
+    ) const
+{
+    if (count == 0)
+    {
+        return std::chrono::microseconds::zero();
+    }
+
+    percentile = __max(0.0, __min(percentile, 100.0));
+    uint64_t target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * count));
+    target = __max(target, static_cast<uint64_t>(1));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i)
+    {
+        seen += buckets[i];
+        if (seen >= target)
+        {
+            return std::chrono::microseconds(static_cast<std::chrono::microseconds::rep>(__min(bucket_upper_bound(i), static_cast<uint64_t>(INT64_MAX))));
+        }
+    }
+
+    return std::chrono::microseconds(INT64_MAX);
+}
+
+service_call_metrics::api_shard::api_shard()
+{
+    reset();
+}
+
+void
+service_call_metrics::api_shard::reset()
+{
+    for (auto& counter : counters)
+    {
+        counter.store(0, std::memory_order_relaxed);
+    }
+
+    for (size_t phase = 0; phase < SERVICE_CALL_LATENCY_PHASE_COUNT; ++phase)
+    {
+        latencyCounts[phase].store(0, std::memory_order_relaxed);
+        latencySums[phase].store(0, std::memory_order_relaxed);
+        for (auto& bucket : latencyBuckets[phase])
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+static std::mutex g_serviceCallMetricsSingletonLock;
+static std::shared_ptr<service_call_metrics> g_serviceCallMetricsSingleton;
+
+std::shared_ptr<service_call_metrics>
+service_call_metrics::get_singleton_instance()
+{
+    std::lock_guard<std::mutex> guard(g_serviceCallMetricsSingletonLock);
+    if (g_serviceCallMetricsSingleton == nullptr)
+    {
+        g_serviceCallMetricsSingleton = std::shared_ptr<service_call_metrics>(new service_call_metrics());
+    }
+
+    return g_serviceCallMetricsSingleton;
+}
+
+service_call_metrics::service_call_metrics()
+{
+    for (auto& slot : m_slots)
+    {
+        slot.store(nullptr);
+    }
+}
+
+service_call_metrics::~service_call_metrics()
+{
+    for (auto& slot : m_slots)
+    {
+        delete slot.exchange(nullptr);
+    }
+}
+
+service_call_metrics::api_shard*
+service_call_metrics::current_shard(
+    _In_ xbox_live_api xboxLiveApi
+    )
+{
+    size_t apiIndex = static_cast<size_t>(xboxLiveApi);
+    if (apiIndex >= XBOX_LIVE_API_COUNT)
+    {
+        return nullptr;
+    }
+
+    api_slot* slot = m_slots[apiIndex].load(std::memory_order_acquire);
+    if (slot == nullptr)
+    {
+        // Racing first calls each allocate a slot, and all but the one that wins the exchange free theirs
+        api_slot* newSlot = new api_slot();
+        if (m_slots[apiIndex].compare_exchange_strong(slot, newSlot, std::memory_order_acq_rel))
+        {
+            slot = newSlot;
+        }
+        else
+        {
+            delete newSlot;
+        }
+    }
+
+    size_t shardIndex = std::hash<std::thread::id>()(std::this_thread::get_id()) % SHARD_COUNT;
+    return &slot->shards[shardIndex];
+}
+
+void
+service_call_metrics::add_latency(
+    _In_ api_shard* shard,
+    _In_ service_call_latency_phase phase,
+    _In_ std::chrono::microseconds latency
+    )
+{
+    uint64_t value = latency.count() > 0 ? static_cast<uint64_t>(latency.count()) : 0;
+    size_t phaseIndex = static_cast<size_t>(phase);
+
+    shard->latencyBuckets[phaseIndex][service_call_latency_histogram::bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    shard->latencySums[phaseIndex].fetch_add(value, std::memory_order_relaxed);
+    shard->latencyCounts[phaseIndex].fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+service_call_metrics::record_attempt(
+    _In_ xbox_live_api xboxLiveApi,
+    _In_ std::chrono::microseconds timeToFirstByte,
+    _In_ uint64_t bytesSent,
+    _In_ uint64_t bytesReceived,
+    _In_ bool throttled,
+    _In_ bool willRetry
+    )
+{
+    api_shard* shard = current_shard(xboxLiveApi);
+    if (shard == nullptr) return;
+
+    add_latency(shard, service_call_latency_phase::time_to_first_byte, timeToFirstByte);
+    shard->counters[counter_bytes_sent].fetch_add(bytesSent, std::memory_order_relaxed);
+    shard->counters[counter_bytes_received].fetch_add(bytesReceived, std::memory_order_relaxed);
+    if (throttled)
+    {
+        shard->counters[counter_throttled].fetch_add(1, std::memory_order_relaxed);
+    }
+    if (willRetry)
+    {
+        shard->counters[counter_retries].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void
+service_call_metrics::record_call(
+    _In_ xbox_live_api xboxLiveApi,
+    _In_ bool failed,
+    _In_ std::chrono::microseconds queueTime,
+    _In_ std::chrono::microseconds totalTime
+    )
+{
+    api_shard* shard = current_shard(xboxLiveApi);
+    if (shard == nullptr) return;
+
+    add_latency(shard, service_call_latency_phase::queue, queueTime);
+    add_latency(shard, service_call_latency_phase::total, totalTime);
+    shard->counters[counter_calls].fetch_add(1, std::memory_order_relaxed);
+    if (failed)
+    {
+        shard->counters[counter_errors].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+std::vector<service_call_api_metrics>
+service_call_metrics::snapshot() const
+{
+    std::vector<service_call_api_metrics> result;
+    for (size_t apiIndex = 0; apiIndex < XBOX_LIVE_API_COUNT; ++apiIndex)
+    {
+        const api_slot* slot = m_slots[apiIndex].load(std::memory_order_acquire);
+        if (slot == nullptr) continue;
+
+        service_call_api_metrics metrics;
+        metrics.api = static_cast<xbox_live_api>(apiIndex);
+        for (const auto& shard : slot->shards)
+        {
+            metrics.callCount += shard.counters[counter_calls].load(std::memory_order_relaxed);
+            metrics.errorCount += shard.counters[counter_errors].load(std::memory_order_relaxed);
+            metrics.retryCount += shard.counters[counter_retries].load(std::memory_order_relaxed);
+            metrics.throttledCount += shard.counters[counter_throttled].load(std::memory_order_relaxed);
+            metrics.bytesSent += shard.counters[counter_bytes_sent].load(std::memory_order_relaxed);
+            metrics.bytesReceived += shard.counters[counter_bytes_received].load(std::memory_order_relaxed);
+
+            for (size_t phase = 0; phase < SERVICE_CALL_LATENCY_PHASE_COUNT; ++phase)
+            {
+                auto& histogram = metrics.latencies[phase];
+                histogram.count += shard.latencyCounts[phase].load(std::memory_order_relaxed);
+                histogram.sumMicroseconds += shard.latencySums[phase].load(std::memory_order_relaxed);
+                for (size_t i = 0; i < service_call_latency_histogram::BUCKET_COUNT; ++i)
+                {
+                    histogram.buckets[i] += shard.latencyBuckets[phase][i].load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        result.push_back(std::move(metrics));
+    }
+
+    return result;
+}
+
+string_t
+service_call_metrics::to_text() const
+{
+    static const double percentiles[] = { 50.0, 90.0, 99.0, 99.9 };
+
+    stringstream_t text;
+    for (const auto& metrics : snapshot())
+    {
+        string_t api = api_name(metrics.api);
+        text << _T("xsapi_service_calls{api=\"") << api << _T("\"} ") << metrics.callCount << _T("\n");
+        text << _T("xsapi_service_call_errors{api=\"") << api << _T("\"} ") << metrics.errorCount << _T("\n");
+        text << _T("xsapi_service_call_retries{api=\"") << api << _T("\"} ") << metrics.retryCount << _T("\n");
+        text << _T("xsapi_service_call_throttled{api=\"") << api << _T("\"} ") << metrics.throttledCount << _T("\n");
+        text << _T("xsapi_service_call_bytes_sent{api=\"") << api << _T("\"} ") << metrics.bytesSent << _T("\n");
+        text << _T("xsapi_service_call_bytes_received{api=\"") << api << _T("\"} ") << metrics.bytesReceived << _T("\n");
+
+        for (size_t phase = 0; phase < SERVICE_CALL_LATENCY_PHASE_COUNT; ++phase)
+        {
+            const auto& histogram = metrics.latencies[phase];
+            string_t labels = _T("{api=\"") + api + _T("\",phase=\"") + s_latencyPhaseNames[phase] + _T("\"");
+            text << _T("xsapi_service_call_latency_us_count") << labels << _T("} ") << histogram.count << _T("\n");
+            text << _T("xsapi_service_call_latency_us_sum") << labels << _T("} ") << histogram.sumMicroseconds << _T("\n");
+            if (histogram.count == 0) continue;
+
+            for (double percentile : percentiles)
+            {
+                text << _T("xsapi_service_call_latency_us") << labels << _T(",quantile=\"") << percentile / 100.0 << _T("\"} ")
+                    << histogram.percentile(percentile).count() << _T("\n");
+            }
+
+            // Cumulative buckets; empty buckets are skipped to keep the dump short
+            uint64_t cumulative = 0;
+            for (size_t i = 0; i < histogram.buckets.size(); ++i)
+            {
+                if (histogram.buckets[i] == 0) continue;
+                cumulative += histogram.buckets[i];
+                text << _T("xsapi_service_call_latency_us_bucket") << labels << _T(",le=\"");
+                if (i == histogram.buckets.size() - 1)
+                {
+                    text << _T("+Inf");
+                }
+                else
+                {
+                    text << service_call_latency_histogram::bucket_upper_bound(i);
+                }
+                text << _T("\"} ") << cumulative << _T("\n");
+            }
+        }
+    }
+
+    return text.str();
+}
+
+void
+service_call_metrics::reset()
+{
+    for (auto& slot : m_slots)
+    {
+        api_slot* apiSlot = slot.load(std::memory_order_acquire);
+        if (apiSlot == nullptr) continue;
+
+        for (auto& shard : apiSlot->shards)
+        {
+            shard.reset();
+        }
+    }
+}
+
+string_t
+service_call_metrics::api_name(
+    _In_ xbox_live_api xboxLiveApi
+    )
+{
+    size_t apiIndex = static_cast<size_t>(xboxLiveApi);
+    if (apiIndex >= XBOX_LIVE_API_COUNT)
+    {
+        return _T("unknown");
+    }
+
+    return s_xboxLiveApiNames[apiIndex];
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
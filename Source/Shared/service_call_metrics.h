@@ -0,0 +1,188 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+#include <atomic>
+#include "http_call_impl.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+enum class service_call_latency_phase
+{
+    /// <summary>
+    /// Time from the call being issued to its first request being sent, including token acquisition
+    /// and any Retry-After wait.
+    /// </summary>
+    queue,
+
+    /// <summary>
+    /// Time from a request being sent to its response headers arriving. Recorded for every attempt.
+    /// </summary>
+    time_to_first_byte,
+
+    /// <summary>
+    /// Time from the call being issued to its final response, including retries.
+    /// </summary>
+    total
+};
+
+const size_t SERVICE_CALL_LATENCY_PHASE_COUNT = 3;
+
+/// <summary>
+/// A point in time copy of a log-linear latency histogram. Each power of two range of microseconds
+/// is split into 4 linear buckets, so a bucket's bounds are within 25% of any value it holds.
+/// </summary>
+struct service_call_latency_histogram
+{
+    static const size_t BUCKET_COUNT = 125;
+
+    service_call_latency_histogram() :
+        buckets(BUCKET_COUNT, 0),
+        count(0),
+        sumMicroseconds(0)
+    {
+    }
+
+    static size_t bucket_index(_In_ uint64_t valueMicroseconds);
+
+    /// <summary>
+    /// Largest value, in microseconds, that falls into the bucket
+    /// </summary>
+    static uint64_t bucket_upper_bound(_In_ size_t bucketIndex);
+
+    /// <summary>
+    /// Returns the upper bound of the bucket holding the given percentile (0 to 100) of the samples
+    /// </summary>
+    std::chrono::microseconds percentile(_In_ double percentile) const;
+
+    std::vector<uint64_t> buckets;
+    uint64_t count;
+    uint64_t sumMicroseconds;
+};
+
+struct service_call_api_metrics
+{
+    service_call_api_metrics() :
+        api(xbox_live_api::unspecified),
+        callCount(0),
+        errorCount(0),
+        retryCount(0),
+        throttledCount(0),
+        bytesSent(0),
+        bytesReceived(0)
+    {
+    }
+
+    xbox_live_api api;
+    uint64_t callCount;
+    uint64_t errorCount;
+    uint64_t retryCount;
+    uint64_t throttledCount;
+    uint64_t bytesSent;
+    uint64_t bytesReceived;
+    service_call_latency_histogram latencies[SERVICE_CALL_LATENCY_PHASE_COUNT];
+};
+
+/// <summary>
+/// Always on counters and latency histograms for every service call, indexed by xbox_live_api.
+/// Writers only perform relaxed atomic increments on one of several shards picked by thread, so
+/// concurrent calls don't contend on a lock or a single cache line. Storage for an API is allocated
+/// the first time it is called. Snapshots sum the shards without stopping writers, so a snapshot
+/// taken while calls are completing may include part of a call's counters.
+/// Byte counts come from the Content-Length headers, so chunked responses are not counted.
+/// </summary>
+class service_call_metrics
+{
+public:
+    static std::shared_ptr<service_call_metrics> get_singleton_instance();
+
+    ~service_call_metrics();
+
+    /// <summary>
+    /// Records a single request attempt. A call that is retried records one attempt per request sent.
+    /// </summary>
+    void record_attempt(
+        _In_ xbox_live_api xboxLiveApi,
+        _In_ std::chrono::microseconds timeToFirstByte,
+        _In_ uint64_t bytesSent,
+        _In_ uint64_t bytesReceived,
+        _In_ bool throttled,
+        _In_ bool willRetry
+        );
+
+    /// <summary>
+    /// Records the completion of a call after all of its attempts
+    /// </summary>
+    void record_call(
+        _In_ xbox_live_api xboxLiveApi,
+        _In_ bool failed,
+        _In_ std::chrono::microseconds queueTime,
+        _In_ std::chrono::microseconds totalTime
+        );
+
+    /// <summary>
+    /// Returns the metrics of every API that has been called since the last reset
+    /// </summary>
+    std::vector<service_call_api_metrics> snapshot() const;
+
+    /// <summary>
+    /// Returns the snapshot as text, one "name{labels} value" sample per line
+    /// </summary>
+    string_t to_text() const;
+
+    void reset();
+
+    static string_t api_name(_In_ xbox_live_api xboxLiveApi);
+
+private:
+    enum counter_index
+    {
+        counter_calls,
+        counter_errors,
+        counter_retries,
+        counter_throttled,
+        counter_bytes_sent,
+        counter_bytes_received,
+        counter_count
+    };
+
+    static const size_t SHARD_COUNT = 4;
+
+    struct api_shard
+    {
+        api_shard();
+        void reset();
+
+        std::atomic<uint64_t> counters[counter_count];
+        std::atomic<uint64_t> latencyCounts[SERVICE_CALL_LATENCY_PHASE_COUNT];
+        std::atomic<uint64_t> latencySums[SERVICE_CALL_LATENCY_PHASE_COUNT];
+        std::atomic<uint64_t> latencyBuckets[SERVICE_CALL_LATENCY_PHASE_COUNT][service_call_latency_histogram::BUCKET_COUNT];
+    };
+
+    struct api_slot
+    {
+        api_shard shards[SHARD_COUNT];
+    };
+
+    service_call_metrics();
+    service_call_metrics(const service_call_metrics&);
+    void operator=(const service_call_metrics&);
+
+    api_shard* current_shard(_In_ xbox_live_api xboxLiveApi);
+
+    static void add_latency(
+        _In_ api_shard* shard,
+        _In_ service_call_latency_phase phase,
+        _In_ std::chrono::microseconds latency
+        );
+
+    std::atomic<api_slot*> m_slots[XBOX_LIVE_API_COUNT];
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
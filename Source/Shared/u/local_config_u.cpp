@@ -19,24 +19,57 @@
 #include "a/java_interop.h"
 #endif
 #include <fstream>
+#include <cstdio>
+#if !XSAPI_U
+#include "ppltasks_extra.h"
+#else
+#include "ppltasks_extra_unix.h"
+#endif
 
 using namespace std;
+using namespace Concurrency::extras;
 
 const string_t c_localStorageFileName = _T("XBLStoage.json");
+const string_t c_localStorageTempFileSuffix = _T(".tmp");
+
+// Writes made within this window of each other go to disk together
+const std::chrono::milliseconds c_localStorageFlushDelay(200);
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 
-void write_local_storage_helper(const string_t& filePath, const string_t& data)
+bool write_local_storage_helper(const string_t& filePath, const string_t& data)
 {
-    ofstream file(filePath, ofstream::trunc);
-    if (file.is_open())
+    // Write the whole file next to the old one and then swap it in, so a crash mid write
+    // leaves either the old or the new storage rather than a truncated file
+    string_t tempFilePath = filePath + c_localStorageTempFileSuffix;
     {
+        ofstream file(tempFilePath, ofstream::trunc);
+        if (!file.is_open())
+        {
+            LOG_ERROR("error on storage write");
+            return false;
+        }
+
         file << data;
+        file.flush();
+        if (!file)
+        {
+            LOG_ERROR("error on storage write");
+            return false;
+        }
     }
-    else
+
+#if defined(_WIN32)
+    bool renamed = MoveFileExW(tempFilePath.c_str(), filePath.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    bool renamed = std::rename(tempFilePath.c_str(), filePath.c_str()) == 0;
+#endif
+    if (!renamed)
     {
-        LOG_ERROR("error on storage write");
+        LOG_ERROR("error on storage rename");
     }
+
+    return renamed;
 }
 
 string_t file_stream_to_string(const ifstream& fileStream)
@@ -65,23 +98,106 @@ string_t read_local_storage_helper(const string_t& filePath)
     return string_t();
 }
 
-string_t local_config::get_value_from_local_storage(_In_ const string_t& name)
+string_t local_config::local_storage_file_path()
 {
-    std::lock_guard<std::mutex> guard(m_jsonLocalStorageLock);
 #if XSAPI_A
-    string_t filePath = java_interop::get_java_interop_singleton()->get_local_storage_path() + c_localStorageFileName;
+    string_t storagePath = java_interop::get_java_interop_singleton()->get_local_storage_path();
 #else
-    string_t filePath = get_local_storage_folder() + c_localStorageFileName;
+    string_t storagePath = get_local_storage_folder();
 #endif
+    return storagePath.empty() ? string_t() : storagePath + c_localStorageFileName;
+}
+
+void local_config::load_local_storage_if_needed()
+{
+    // Called with m_jsonLocalStorageLock held
+    if (m_isLocalStorageLoaded)
+    {
+        return;
+    }
+
+    string_t filePath = local_storage_file_path();
+    if (filePath.empty())
+    {
+        return;
+    }
 
-    if (!filePath.empty())
+    std::error_code errc;
+    m_jsonLocalStorage = web::json::value::parse(read_local_storage_helper(filePath), errc);
+    ++m_localStorageStats.fileReads;
+    if (errc || !m_jsonLocalStorage.is_object())
     {
-        std::error_code errc;
-        m_jsonLocalStorage = web::json::value::parse(read_local_storage_helper(filePath), errc);
-        if(errc)
+        // A missing or unreadable file starts out empty, and is replaced on the next write
+        m_jsonLocalStorage = web::json::value::object();
+    }
+
+    m_isLocalStorageLoaded = true;
+}
+
+void local_config::schedule_local_storage_flush()
+{
+    // Called with m_jsonLocalStorageLock held
+    m_isLocalStorageDirty = true;
+    if (m_isLocalStorageFlushScheduled)
+    {
+        return;
+    }
+
+    m_isLocalStorageFlushScheduled = true;
+    std::weak_ptr<local_config> thisWeakPtr = shared_from_this();
+    create_delayed_task(
+        c_localStorageFlushDelay,
+        [thisWeakPtr]()
+    {
+        // If the config is already gone, its destructor wrote the pending changes
+        std::shared_ptr<local_config> pThis(thisWeakPtr.lock());
+        if (pThis != nullptr)
         {
-            return string_t();
+            pThis->flush_local_storage();
         }
+    });
+}
+
+void local_config::flush_local_storage()
+{
+    std::lock_guard<std::mutex> fileGuard(m_localStorageFileLock);
+
+    string_t data;
+    string_t filePath;
+    {
+        std::lock_guard<std::mutex> guard(m_jsonLocalStorageLock);
+        m_isLocalStorageFlushScheduled = false;
+        if (!m_isLocalStorageDirty)
+        {
+            return;
+        }
+
+        filePath = local_storage_file_path();
+        data = m_jsonLocalStorage.serialize();
+        m_isLocalStorageDirty = false;
+    }
+
+    if (!filePath.empty() && write_local_storage_helper(filePath, data))
+    {
+        std::lock_guard<std::mutex> guard(m_jsonLocalStorageLock);
+        ++m_localStorageStats.fileWrites;
+    }
+}
+
+local_storage_stats local_config::get_local_storage_stats()
+{
+    std::lock_guard<std::mutex> guard(m_jsonLocalStorageLock);
+    return m_localStorageStats;
+}
+
+string_t local_config::get_value_from_local_storage(_In_ const string_t& name)
+{
+    std::lock_guard<std::mutex> guard(m_jsonLocalStorageLock);
+    ++m_localStorageStats.valueReads;
+    load_local_storage_if_needed();
+    if (!m_isLocalStorageLoaded)
+    {
+        return string_t();
     }
 
     return utils::extract_json_string(m_jsonLocalStorage, name);
@@ -90,46 +206,27 @@ string_t local_config::get_value_from_local_storage(_In_ const string_t& name)
 xbox_live_result<void> local_config::write_value_to_local_storage(_In_ const string_t& name, _In_ const string_t& value)
 {
     std::lock_guard<std::mutex> guard(m_jsonLocalStorageLock);
-#if XSAPI_A
-    string_t filePath = java_interop::get_java_interop_singleton()->get_local_storage_path() + c_localStorageFileName;
-#else
-    string_t filePath = get_local_storage_folder() + c_localStorageFileName;
-#endif
-
-    if (!filePath.empty())
+    ++m_localStorageStats.valueWrites;
+    load_local_storage_if_needed();
+    if (m_isLocalStorageLoaded)
     {
-        // TODO:  Take a look at this.  Seeing a crash when the filePath!="" but parse throws exception
-        std::error_code errc;
-        m_jsonLocalStorage = web::json::value::parse(read_local_storage_helper(filePath), errc);
-        if(errc)
-        {
-            LOG_INFO("Local config read faild while write_value_to_local_storage!");
-            m_jsonLocalStorage = web::json::value();
-        }
         m_jsonLocalStorage[name] = web::json::value(value);
-        write_local_storage_helper(filePath, m_jsonLocalStorage.serialize());
+        schedule_local_storage_flush();
     }
     return xbox_live_result<void>();
 }
 
 xbox_live_result<void> local_config::delete_value_from_local_storage(_In_ const string_t& name)
 {
-    std::lock_guard<std::mutex> guard(m_jsonLocalStorageLock);
-#if XSAPI_A
-    string_t filePath = java_interop::get_java_interop_singleton()->get_local_storage_path() + c_localStorageFileName;
-#else
-    string_t filePath = get_local_storage_folder() + c_localStorageFileName;
-#endif
-
-    if (!filePath.empty())
     {
-        std::error_code errc;
-        m_jsonLocalStorage = web::json::value::parse(read_local_storage_helper(filePath), errc);
-        if(errc)
+        std::lock_guard<std::mutex> guard(m_jsonLocalStorageLock);
+        ++m_localStorageStats.valueWrites;
+        load_local_storage_if_needed();
+        if (!m_isLocalStorageLoaded)
         {
-            m_jsonLocalStorage = web::json::value();
-            return xbox_live_result<void>(xbox_live_error_code::runtime_error, _T("Error parsing from local storage."));
+            return xbox_live_result<void>();
         }
+
         try
         {
             m_jsonLocalStorage.erase(name);
@@ -138,8 +235,12 @@ xbox_live_result<void> local_config::delete_value_from_local_storage(_In_ const
         {
             LOG_INFO(ex.what());
         }
-        write_local_storage_helper(filePath, m_jsonLocalStorage.serialize());
+        m_isLocalStorageDirty = true;
     }
+
+    // Deletes usually remove tokens or credentials on sign out, so they go to disk right away
+    // rather than waiting on the write-behind delay
+    flush_local_storage();
     return xbox_live_result<void>();
 }
 
@@ -164,8 +164,30 @@ pplx::task<xbox_live_result<user_context_auth_result>> user_context::get_auth_re
     _In_ bool allUsersAuthRequired
     )
 {
-    auto byteArr = ref new Array<unsigned char, 1U>(static_cast<uint32_t>(requestBody.size()));
-    memcpy(&byteArr->Data[0], &requestBody[0], requestBody.size());
+    return get_auth_result(
+        httpMethod,
+        url,
+        headers,
+        requestBody.empty() ? nullptr : &requestBody[0],
+        requestBody.size(),
+        allUsersAuthRequired
+        );
+}
+
+pplx::task<xbox_live_result<user_context_auth_result>> user_context::get_auth_result(
+    _In_ const string_t& httpMethod,
+    _In_ const string_t& url,
+    _In_ const string_t& headers,
+    _In_ const unsigned char* requestBody,
+    _In_ size_t requestBodySize,
+    _In_ bool allUsersAuthRequired
+    )
+{
+    auto byteArr = ref new Array<unsigned char, 1U>(static_cast<uint32_t>(requestBodySize));
+    if (requestBodySize > 0)
+    {
+        memcpy(&byteArr->Data[0], requestBody, requestBodySize);
+    }
     pplx::task<Windows::Xbox::System::GetTokenAndSignatureResult^> asyncTask;
 
     if(allUsersAuthRequired)
@@ -275,6 +297,25 @@ user_context::get_auth_result(
     });
 }
 
+pplx::task<xbox_live_result<user_context_auth_result>> user_context::get_auth_result(
+    _In_ const string_t& httpMethod,
+    _In_ const string_t& url,
+    _In_ const string_t& headers,
+    _In_ const unsigned char* requestBody,
+    _In_ size_t requestBodySize,
+    _In_ bool allUsersAuthRequired
+    )
+{
+    // The request signer hashes a vector, so this is the one place the body gets copied
+    return get_auth_result(
+        httpMethod,
+        url,
+        headers,
+        requestBodySize > 0 ? std::vector<unsigned char>(requestBody, requestBody + requestBodySize) : std::vector<unsigned char>(),
+        allUsersAuthRequired
+        );
+}
+
 pplx::task<xbox_live_result<user_context_auth_result>> user_context::get_auth_result(
     _In_ const string_t& httpMethod,
     _In_ const string_t& url,
@@ -417,10 +458,32 @@ pplx::task<xbox_live_result<user_context_auth_result>> user_context::get_auth_re
     _In_ const std::vector<unsigned char>& requestBody,
     _In_ bool allUsersAuthRequired
     )
+{
+    return get_auth_result(
+        httpMethod,
+        url,
+        headers,
+        requestBody.empty() ? nullptr : &requestBody[0],
+        requestBody.size(),
+        allUsersAuthRequired
+        );
+}
+
+pplx::task<xbox_live_result<user_context_auth_result>> user_context::get_auth_result(
+    _In_ const string_t& httpMethod,
+    _In_ const string_t& url,
+    _In_ const string_t& headers,
+    _In_ const unsigned char* requestBody,
+    _In_ size_t requestBodySize,
+    _In_ bool allUsersAuthRequired
+    )
 {
     UNREFERENCED_PARAMETER(allUsersAuthRequired);
-    Array<byte>^ byteArray = ref new Array<byte>(static_cast<uint32_t>(requestBody.size()));
-    memcpy(&byteArray->Data[0], &requestBody[0], requestBody.size());
+    Array<byte>^ byteArray = ref new Array<byte>(static_cast<uint32_t>(requestBodySize));
+    if (requestBodySize > 0)
+    {
+        memcpy(&byteArray->Data[0], requestBody, requestBodySize);
+    }
 
     auto asyncTask = pplx::create_task([this, httpMethod, url, headers, byteArray]()
     {
@@ -88,6 +88,15 @@ public:
         _In_ bool allUsersAuthRequired = false
         );
 
+    pplx::task<XBOX_LIVE_NAMESPACE::xbox_live_result<user_context_auth_result>> get_auth_result(
+        _In_ const string_t& httpMethod,
+        _In_ const string_t& url,
+        _In_ const string_t& headers,
+        _In_ const unsigned char* requestBody,
+        _In_ size_t requestBodySize,
+        _In_ bool allUsersAuthRequired = false
+        );
+
     pplx::task<XBOX_LIVE_NAMESPACE::xbox_live_result<void>> refresh_token();
 
     // inline helper functions
@@ -561,6 +561,11 @@ public:
     static const string_t& get_locales();
 
     static void set_locales(_In_ const string_t& locale);
+
+    /// <summary>
+    /// Changes every time the locales returned by get_locales change
+    /// </summary>
+    static uint32_t get_locales_version();
     template<typename T>
 	static XBOX_LIVE_NAMESPACE::xbox_live_result<T> generate_xbox_live_result(
 		_Inout_ XBOX_LIVE_NAMESPACE::xbox_live_result<T> deserializationResult,
@@ -9,6 +9,7 @@
 //*********************************************************
 #include "pch.h"
 #include <mutex>
+#include <atomic>
 #include "utils.h"
 #if XSAPI_A
 #include "a/java_interop.h"
@@ -19,6 +20,9 @@ NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 
 static string_t s_locales = _T("en-US");
 
+// Bumped whenever s_locales changes, so callers that cache headers built from it know to rebuild
+static std::atomic<uint32_t> s_localesVersion(0);
+
 #if XSAPI_A
 std::unordered_map<string_t, string_t> serviceLocales = 
 { 
@@ -233,6 +237,7 @@ void utils::generate_locales()
     }
     // erase the last ','
     s_locales.pop_back();
+    ++s_localesVersion;
 }
 
 static std::mutex s_locale_lock;
@@ -264,8 +269,15 @@ void utils::set_locales(
     _In_ const string_t& locale
     )
 {
+    std::lock_guard<std::mutex> guard(s_locale_lock);
     s_locales = locale;
     s_custom_locale_override = true;
+    ++s_localesVersion;
+}
+
+uint32_t utils::get_locales_version()
+{
+    return s_localesVersion;
 }
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
\ No newline at end of file
@@ -87,6 +87,7 @@ xbox_live_context_settings::xbox_live_context_settings() :
     m_httpRetryDelay(std::chrono::seconds(DEFAULT_RETRY_DELAY_SECONDS)),
     m_httpTimeoutWindow(std::chrono::seconds(DEFAULT_HTTP_RETRY_WINDOW_SECONDS)),
     m_useCoreDispatcherForEventRouting(false),
+    m_maxConcurrentBatchRequests(DEFAULT_MAX_CONCURRENT_BATCH_REQUESTS),
     m_disableAssertsForXboxLiveThrottlingInDevSandboxes(false),
     m_disableAssertsForMaxNumberOfWebsocketsActivated(false)
 {
@@ -214,6 +215,16 @@ void xbox_live_context_settings::set_use_core_dispatcher_for_event_routing(_In_
     m_useCoreDispatcherForEventRouting = value;
 }
 
+uint32_t xbox_live_context_settings::max_concurrent_batch_requests() const
+{
+    return m_maxConcurrentBatchRequests;
+}
+
+void xbox_live_context_settings::set_max_concurrent_batch_requests(_In_ uint32_t value)
+{
+    m_maxConcurrentBatchRequests = __max(value, static_cast<uint32_t>(1));
+}
+
 void xbox_live_context_settings::disable_asserts_for_xbox_live_throttling_in_dev_sandboxes(
     _In_ xbox_live_context_throttle_setting setting
     )
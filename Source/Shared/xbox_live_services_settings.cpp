@@ -15,6 +15,7 @@
 #include "Logger/debug_output.h"
 #endif
 #include "Logger/custom_output.h"
+#include "http_call_rate_limiter.h"
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
 
@@ -104,6 +105,16 @@ void xbox_live_services_settings::set_diagnostics_trace_level(_In_ xbox_services
     set_log_level_from_diagnostics_trace_level();
 }
 
+bool xbox_live_services_settings::enable_client_side_rate_limiting() const
+{
+    return http_call_rate_limiter::get_singleton_instance()->is_enabled();
+}
+
+void xbox_live_services_settings::set_enable_client_side_rate_limiting(_In_ bool value)
+{
+    http_call_rate_limiter::get_singleton_instance()->set_enabled(value);
+}
+
 void xbox_live_services_settings::_Raise_logging_event(_In_ xbox_services_diagnostics_trace_level level, _In_ const std::string& category, _In_ const std::string& message)
 {
     std::lock_guard<std::mutex> lock(m_loggingWriteLock);
@@ -88,6 +88,10 @@ const string_t xbox_service_call_routed_event_args::full_response_formatted() co
         {
             response << &m_requestBody.request_message_vector()[0];
         }
+        else if (messageType == http_request_message_type::buffer_view_message)
+        {
+            response << m_requestBody.request_message_buffer_size() << _T(" bytes");
+        }
         else
         {
             response << m_requestBody.request_message_string();
@@ -184,6 +184,16 @@ MockHttpCall::set_request_body(
     m_requestBody = http_call_request_message(value);
 }
 
+void
+MockHttpCall::set_request_body(
+    _In_ std::shared_ptr<const std::vector<BYTE>> buffer,
+    _In_ size_t offset,
+    _In_ size_t length
+    )
+{
+    m_requestBody = http_call_request_message(std::move(buffer), offset, length);
+}
+
 const http_call_request_message& MockHttpCall::request_body() const
 {
     return m_requestBody;
@@ -257,6 +257,94 @@ public:
         VERIFY_ARE_EQUAL_STR(L"/users/xuid(xboxUserId1234)/achievements?titleId=777&types=challenge&unlockedOnly=true&orderBy=unlocktime&maxItems=20&skipItems=10", httpCall->PathQueryFragment.to_string());
     }
 
+    DEFINE_TEST_CASE(TestReadAchievementsForTitleIds)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestReadAchievementsForTitleIds);
+        auto lastPageJson = web::json::value::parse(defaultAchievementResponse);
+        auto firstPageJson = web::json::value::parse(defaultAchievementResponse);
+        firstPageJson[L"pagingInfo"][L"continuationToken"] = web::json::value::string(L"page2");
+
+        auto httpCall = m_mockXboxSystemFactory->GetMockHttpCall();
+        int requestCount = 0;
+        httpCall->fRequestPostFunc = [&requestCount, firstPageJson, lastPageJson](std::shared_ptr<http_call_response>& response, const string_t& requestPost)
+        {
+            UNREFERENCED_PARAMETER(requestPost);
+            // Every title returns two pages
+            ++requestCount;
+            response = StockMocks::CreateMockHttpCallResponse(requestCount % 2 == 1 ? firstPageJson : lastPageJson);
+        };
+
+        std::vector<uint32_t> titleIds;
+        titleIds.push_back(1234);
+        titleIds.push_back(5678);
+
+        std::vector<uint32_t> pageTitleIds;
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        auto result = xboxLiveContext->achievement_service().read_achievements_for_title_ids(
+            L"xboxUserId",
+            titleIds,
+            xbox::services::achievements::achievement_type::all,
+            false,
+            xbox::services::achievements::achievement_order_by::default_order,
+            20,
+            1,
+            [&pageTitleIds](uint32_t titleId, const xbox::services::achievements::achievements_result& page)
+            {
+                VERIFY_ARE_EQUAL_INT(1, page.items().size());
+                pageTitleIds.push_back(titleId);
+            }).get();
+        httpCall->fRequestPostFunc = nullptr;
+
+        VERIFY_IS_TRUE(!result.err());
+        VERIFY_ARE_EQUAL_INT(4, httpCall->CallCounter);
+        VERIFY_ARE_EQUAL_INT(4, pageTitleIds.size());
+        VERIFY_ARE_EQUAL_INT(1234, pageTitleIds[0]);
+        VERIFY_ARE_EQUAL_INT(1234, pageTitleIds[1]);
+        VERIFY_ARE_EQUAL_INT(5678, pageTitleIds[2]);
+        VERIFY_ARE_EQUAL_INT(5678, pageTitleIds[3]);
+        VERIFY_ARE_EQUAL_STR(L"/users/xuid(xboxUserId)/achievements?titleId=5678&maxItems=20&continuationToken=page2", httpCall->PathQueryFragment.to_string());
+    }
+
+    DEFINE_TEST_CASE(TestGetAchievementSummariesForTitleIds)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestGetAchievementSummariesForTitleIds);
+        auto responseJson = web::json::value::parse(defaultAchievementResponse);
+        auto achievementJson = responseJson[L"achievements"].as_array()[0];
+
+        auto httpCall = m_mockXboxSystemFactory->GetMockHttpCall();
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(responseJson);
+
+        std::vector<uint32_t> titleIds;
+        titleIds.push_back(1234);
+        titleIds.push_back(5678);
+
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        auto result = xboxLiveContext->achievement_service().get_achievement_summaries_for_title_ids(
+            L"xboxUserId",
+            titleIds,
+            xbox::services::achievements::achievement_type::all,
+            false,
+            xbox::services::achievements::achievement_order_by::default_order
+            ).get();
+
+        VERIFY_IS_TRUE(!result.err());
+        VERIFY_ARE_EQUAL_INT(2, httpCall->CallCounter);
+        VERIFY_ARE_EQUAL_INT(2, result.payload().size());
+        for (size_t i = 0; i < titleIds.size(); ++i)
+        {
+            const auto& summary = result.payload()[i];
+            VERIFY_ARE_EQUAL_INT(titleIds[i], summary.title_id());
+            VERIFY_ARE_EQUAL(summary.id(), achievementJson[L"id"].as_string());
+            VERIFY_ARE_EQUAL(summary.name(), achievementJson[L"name"].as_string());
+            VERIFY_ARE_EQUAL(summary.service_configuration_id(), achievementJson[L"serviceConfigId"].as_string());
+            VERIFY_ARE_EQUAL(summary.is_secret(), achievementJson[L"isSecret"].as_bool());
+            VERIFY_IS_TRUE(summary.progress_state() == xbox::services::achievements::achievement_progress_state::achieved);
+        }
+
+        // Summaries share a single copy of the service configuration ID
+        VERIFY_IS_TRUE(&result.payload()[0].service_configuration_id() == &result.payload()[1].service_configuration_id());
+    }
+
     DEFINE_TEST_CASE(TestGetAchievementsEmptyResult)
     {
         DEFINE_TEST_CASE_PROPERTIES(TestGetAchievementsEmptyResult);
@@ -12,6 +12,8 @@
 #define TEST_CLASS_AREA L"GameServerPlatform"
 #include "UnitTestIncludes.h"
 #include "SocialGroupConstants_WinRT.h"
+#include "qos_prober.h"
+#include "game_server_allocation_tracker.h"
 
 using namespace Microsoft::Xbox::Services;
 using namespace Microsoft::Xbox::Services::Social;
@@ -348,6 +350,152 @@ public:
         VERIFY_ARE_EQUAL_STR(L"test_targetLocation", server1->TargetLocation->Data());
     }
 
+    DEFINE_TEST_CASE(TestQosProberMeasuresEchoServer)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestQosProberMeasuresEchoServer);
+
+        WSADATA wsaData;
+        VERIFY_ARE_EQUAL_INT(0, WSAStartup(MAKEWORD(2, 2), &wsaData));
+
+        // A local UDP echo server standing in for a QoS server
+        SOCKET echoSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        sockaddr_in echoAddress = {};
+        echoAddress.sin_family = AF_INET;
+        echoAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        VERIFY_ARE_EQUAL_INT(0, bind(echoSocket, reinterpret_cast<sockaddr*>(&echoAddress), sizeof(echoAddress)));
+        int addressLength = sizeof(echoAddress);
+        getsockname(echoSocket, reinterpret_cast<sockaddr*>(&echoAddress), &addressLength);
+
+        DWORD receiveTimeout = 100;
+        setsockopt(echoSocket, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&receiveTimeout), sizeof(receiveTimeout));
+        std::atomic<bool> stopEcho(false);
+        std::thread echoThread([echoSocket, &stopEcho]()
+        {
+            char buffer[2048];
+            while (!stopEcho)
+            {
+                sockaddr_in fromAddress;
+                int fromLength = sizeof(fromAddress);
+                int received = recvfrom(echoSocket, buffer, sizeof(buffer), 0, reinterpret_cast<sockaddr*>(&fromAddress), &fromLength);
+                if (received > 0)
+                {
+                    sendto(echoSocket, buffer, received, 0, reinterpret_cast<sockaddr*>(&fromAddress), fromLength);
+                }
+            }
+        });
+
+        xbox::services::qos_probe_settings settings;
+        settings.timeout = std::chrono::milliseconds(300);
+        std::vector<string_t> targets;
+        targets.push_back(L"127.0.0.1:" + std::to_wstring(ntohs(echoAddress.sin_port)));
+        targets.push_back(L"127.0.0.1:1");
+        targets.push_back(L"not a target");
+        auto results = xbox::services::qos_prober::measure(targets, settings).get();
+
+        stopEcho = true;
+        echoThread.join();
+        closesocket(echoSocket);
+        WSACleanup();
+
+        VERIFY_ARE_EQUAL_INT(3, results.size());
+        VERIFY_IS_TRUE(results[0].isResolved);
+        VERIFY_ARE_EQUAL_INT(settings.probeCount, results[0].probesSent);
+        VERIFY_IS_TRUE(results[0].probesReceived > 0);
+
+        // Nothing listens on the second target, so every probe is lost
+        VERIFY_IS_TRUE(results[1].isResolved);
+        VERIFY_ARE_EQUAL_INT(settings.probeCount, results[1].probesSent);
+        VERIFY_ARE_EQUAL_INT(0, results[1].probesReceived);
+        VERIFY_IS_TRUE(results[1].packetLoss == 1);
+
+        VERIFY_IS_TRUE(!results[2].isResolved);
+        VERIFY_ARE_EQUAL_INT(0, results[2].probesSent);
+    }
+
+    DEFINE_TEST_CASE(TestAllocationTrackerPolling)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestAllocationTrackerPolling);
+        using namespace xbox::services::game_server_platform;
+        typedef std::chrono::milliseconds ms;
+
+        // Doubling until the typical time is near, tight around it, backing off once it's late
+        VERIFY_ARE_EQUAL_INT(500, game_server_allocation_tracker::next_poll_delay(ms(0), 0, ms(8000), ms(500), ms(250), ms(4000)).count());
+        VERIFY_ARE_EQUAL_INT(1000, game_server_allocation_tracker::next_poll_delay(ms(500), 1, ms(8000), ms(500), ms(250), ms(4000)).count());
+        VERIFY_ARE_EQUAL_INT(2000, game_server_allocation_tracker::next_poll_delay(ms(1500), 2, ms(8000), ms(500), ms(250), ms(4000)).count());
+        VERIFY_ARE_EQUAL_INT(2500, game_server_allocation_tracker::next_poll_delay(ms(3500), 3, ms(8000), ms(500), ms(250), ms(4000)).count());
+        VERIFY_ARE_EQUAL_INT(250, game_server_allocation_tracker::next_poll_delay(ms(6000), 4, ms(8000), ms(500), ms(250), ms(4000)).count());
+        VERIFY_ARE_EQUAL_INT(250, game_server_allocation_tracker::next_poll_delay(ms(9999), 20, ms(8000), ms(500), ms(250), ms(4000)).count());
+        VERIFY_ARE_EQUAL_INT(2000, game_server_allocation_tracker::next_poll_delay(ms(14000), 30, ms(8000), ms(500), ms(250), ms(4000)).count());
+        VERIFY_ARE_EQUAL_INT(4000, game_server_allocation_tracker::next_poll_delay(ms(30000), 40, ms(8000), ms(500), ms(250), ms(4000)).count());
+
+        auto pollLock = std::make_shared<std::mutex>();
+        auto pollCounts = std::make_shared<std::map<string_t, int>>();
+        auto tracker = std::make_shared<game_server_allocation_tracker>(
+            ms(20),
+            ms(10),
+            ms(40),
+            ms(60),
+            std::chrono::seconds(5),
+            32,
+            [pollLock, pollCounts](uint32_t, const string_t& ticketId)
+            {
+                int pollCount;
+                {
+                    std::lock_guard<std::mutex> lock(*pollLock);
+                    pollCount = ++(*pollCounts)[ticketId];
+                }
+
+                if (ticketId == _T("missing"))
+                {
+                    return pplx::task_from_result(xbox_live_result<game_server_ticket_status>(xbox_live_error_code::http_status_404_not_found, "not found"));
+                }
+
+                bool isActive = pollCount >= (ticketId == _T("slow") ? 3 : 1);
+                return pplx::task_from_result(xbox_live_result<game_server_ticket_status>(game_server_ticket_status(
+                    ticketId, _T("cluster"), 1234, _T("host"),
+                    isActive ? game_server_host_status::active : game_server_host_status::queued,
+                    string_t(), string_t(), std::vector<game_server_port_mapping>(), string_t(), _T("region")
+                    )));
+            },
+            [pollLock, pollCounts](uint32_t, const string_t& sessionId)
+            {
+                int pollCount;
+                {
+                    std::lock_guard<std::mutex> lock(*pollLock);
+                    pollCount = ++(*pollCounts)[sessionId];
+                }
+
+                return pplx::task_from_result(xbox_live_result<allocation_result>(allocation_result(
+                    pollCount >= 2 ? game_server_fulfillment_state::fulfilled : game_server_fulfillment_state::queued,
+                    _T("host"), sessionId, _T("region"), std::vector<game_server_port_mapping>(), string_t()
+                    )));
+            });
+
+        auto slowTask = tracker->track_ticket(1234, _T("slow"));
+        auto slowAgainTask = tracker->track_ticket(1234, _T("slow"));
+        auto fastTask = tracker->track_ticket(1234, _T("fast"));
+        auto missingTask = tracker->track_ticket(1234, _T("missing"));
+        auto sessionHostTask = tracker->track_session_host(1234, _T("sessionhost"));
+        VERIFY_ARE_EQUAL_INT(4, tracker->tracked_count());
+
+        VERIFY_ARE_EQUAL_INT(game_server_host_status::active, slowTask.get().payload().status());
+        VERIFY_ARE_EQUAL_INT(game_server_host_status::active, slowAgainTask.get().payload().status());
+        VERIFY_ARE_EQUAL_INT(game_server_host_status::active, fastTask.get().payload().status());
+        VERIFY_IS_TRUE(missingTask.get().err() == xbox_live_error_condition::http_404_not_found);
+        VERIFY_ARE_EQUAL_INT(game_server_fulfillment_state::fulfilled, sessionHostTask.get().payload().fulfillment_state());
+
+        VERIFY_ARE_EQUAL_INT(3, (*pollCounts)[_T("slow")]);
+        VERIFY_ARE_EQUAL_INT(1, (*pollCounts)[_T("fast")]);
+        VERIFY_ARE_EQUAL_INT(1, (*pollCounts)[_T("missing")]);
+        VERIFY_ARE_EQUAL_INT(2, (*pollCounts)[_T("sessionhost")]);
+        VERIFY_ARE_EQUAL_INT(7, tracker->polls_sent());
+        VERIFY_ARE_EQUAL_INT(1, tracker->tracks_coalesced());
+        VERIFY_ARE_EQUAL_INT(0, tracker->tracked_count());
+
+        // The first polls of everything tracked together share a tick
+        VERIFY_IS_TRUE(tracker->timer_ticks() < tracker->polls_sent());
+    }
+
     DEFINE_TEST_CASE(TestInvalidArgs)
     {
         DEFINE_TEST_CASE_PROPERTIES(TestInvalidArgs);
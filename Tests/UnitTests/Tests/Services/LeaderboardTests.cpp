@@ -290,6 +290,98 @@ public:
         VerifyLeadershipResult(result, responseJson, columns);
     }
 
+    DEFINE_TEST_CASE(TestGetLeaderboardRankCache)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestGetLeaderboardRankCache);
+        auto responseJson = web::json::value::parse(defaultLeaderboardData);
+        auto httpCall = m_mockXboxSystemFactory->GetMockHttpCall();
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(responseJson);
+
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        auto& leaderboardService = xboxLiveContext->leaderboard_service();
+        leaderboardService.set_rank_cache_expiry(std::chrono::seconds(60));
+
+        auto result = leaderboardService.get_leaderboard(
+            _T("c4060100-4951-4a51-a630-dce26c15b8c5"),
+            _T("lbEncodedRecordHoleId101RecordTypeId1"),
+            1,
+            5
+            ).get();
+        VERIFY_IS_TRUE(!result.err());
+        VERIFY_ARE_EQUAL_INT(1, httpCall->CallCounter);
+
+        // Overlapping window is served from the cache
+        auto cachedResult = leaderboardService.get_leaderboard(
+            _T("c4060100-4951-4a51-a630-dce26c15b8c5"),
+            _T("lbEncodedRecordHoleId101RecordTypeId1"),
+            2,
+            3
+            ).get();
+        VERIFY_IS_TRUE(!cachedResult.err());
+        VERIFY_ARE_EQUAL_INT(1, httpCall->CallCounter);
+        VERIFY_ARE_EQUAL_INT(3, cachedResult.payload().rows().size());
+        VERIFY_ARE_EQUAL_INT(2, cachedResult.payload().rows()[0].rank());
+        VERIFY_ARE_EQUAL_INT(4, cachedResult.payload().rows()[2].rank());
+        VERIFY_ARE_EQUAL_INT(218, cachedResult.payload().total_row_count());
+        VERIFY_IS_TRUE(cachedResult.payload().has_next());
+
+        // A window that reaches past the cached ranks goes to the service
+        leaderboardService.get_leaderboard(
+            _T("c4060100-4951-4a51-a630-dce26c15b8c5"),
+            _T("lbEncodedRecordHoleId101RecordTypeId1"),
+            4,
+            5
+            ).get();
+        VERIFY_ARE_EQUAL_INT(2, httpCall->CallCounter);
+        VERIFY_ARE_EQUAL_STR(L"/scids/c4060100-4951-4a51-a630-dce26c15b8c5/leaderboards/lbEncodedRecordHoleId101RecordTypeId1?maxItems=5&skipToRank=4", httpCall->PathQueryFragment.to_string());
+
+        leaderboardService.set_rank_cache_expiry(std::chrono::seconds::zero());
+    }
+
+    void WaitForPrefetchedPages(std::shared_ptr<leaderboard_cursor> cursor, uint32_t pageCount)
+    {
+        for (int i = 0; i < 100 && cursor->prefetched_page_count() < pageCount; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    DEFINE_TEST_CASE(TestLeaderboardCursor)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestLeaderboardCursor);
+        auto responseJson = web::json::value::parse(defaultLeaderboardData);
+        auto httpCall = m_mockXboxSystemFactory->GetMockHttpCall();
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(responseJson);
+
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        auto firstPage = xboxLiveContext->leaderboard_service().get_leaderboard(
+            _T("c4060100-4951-4a51-a630-dce26c15b8c5"),
+            _T("lbEncodedRecordHoleId101RecordTypeId1")
+            ).get();
+        VERIFY_IS_TRUE(!firstPage.err());
+        VERIFY_ARE_EQUAL_INT(1, httpCall->CallCounter);
+
+        auto cursor = std::make_shared<leaderboard_cursor>(firstPage.payload(), 5, 2);
+        VERIFY_IS_TRUE(cursor->has_next());
+
+        auto nextPage = cursor->get_next().get();
+        VERIFY_IS_TRUE(!nextPage.err());
+        VERIFY_ARE_EQUAL_INT(5, nextPage.payload().rows().size());
+        VERIFY_ARE_EQUAL_STR(L"/scids/c4060100-4951-4a51-a630-dce26c15b8c5/leaderboards/lbEncodedRecordHoleId101RecordTypeId1?maxItems=5&continuationToken=6", httpCall->PathQueryFragment.to_string());
+
+        // Prefetching continues in the background until two pages are buffered
+        WaitForPrefetchedPages(cursor, 2);
+        VERIFY_ARE_EQUAL_INT(2, cursor->prefetched_page_count());
+        VERIFY_ARE_EQUAL_INT(4, httpCall->CallCounter);
+
+        // Taking a buffered page doesn't wait on the service and tops the buffer back up
+        nextPage = cursor->get_next().get();
+        VERIFY_IS_TRUE(!nextPage.err());
+        WaitForPrefetchedPages(cursor, 2);
+        VERIFY_ARE_EQUAL_INT(2, cursor->prefetched_page_count());
+        VERIFY_ARE_EQUAL_INT(5, httpCall->CallCounter);
+    }
+
     DEFINE_TEST_CASE(TestGetLearderboardSkipToUserAsync)
     {
         DEFINE_TEST_CASE_PROPERTIES(TestGetLearderboardSkipToUserAsync);
@@ -540,6 +632,103 @@ public:
         VerifyLeadershipResult(result, responseJson);
     }
 
+    leaderboard_result CreateSocialLeaderboardResult(const std::vector<std::pair<string_t, string_t>>& xuidsAndValues)
+    {
+        std::vector<leaderboard_row> rows;
+        for (const auto& xuidAndValue : xuidsAndValues)
+        {
+            rows.push_back(leaderboard_row(
+                _T("Gamertag") + xuidAndValue.first,
+                xuidAndValue.first,
+                0,
+                static_cast<uint32_t>(rows.size() + 1),
+                std::vector<string_t>(1, xuidAndValue.second),
+                string_t()
+                ));
+        }
+
+        return leaderboard_result(
+            string_t(),
+            static_cast<uint32_t>(rows.size()),
+            string_t(),
+            std::vector<leaderboard_column>(),
+            rows,
+            nullptr,
+            nullptr,
+            nullptr
+            );
+    }
+
+    DEFINE_TEST_CASE(TestGetSocialLeaderboardTable)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestGetSocialLeaderboardTable);
+        auto responseV1Json = web::json::value::parse(defaultV1LeaderboardData);
+        auto httpCall = m_mockXboxSystemFactory->GetMockHttpCall();
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(responseV1Json);
+
+        std::vector<string_t> statNames;
+        statNames.push_back(_T("Kills"));
+        statNames.push_back(_T("Wins"));
+
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        auto result = xboxLiveContext->leaderboard_service().get_social_leaderboard_table(
+            _T("98052"),
+            _T("c4060100-4951-4a51-a630-dce26c15b8c5"),
+            statNames,
+            _T("All"),
+            20
+            ).get();
+        VERIFY_IS_TRUE(!result.err());
+        VERIFY_ARE_EQUAL_INT(2, httpCall->CallCounter);
+        VERIFY_ARE_EQUAL_INT(2, result.payload().stat_names().size());
+        VERIFY_ARE_EQUAL_INT(2, result.payload().row_count());
+        VERIFY_ARE_EQUAL_STR(_T("2533275015216241"), result.payload().xbox_user_id(result.payload().sorted_rows()[0]));
+        VERIFY_IS_TRUE(result.payload().value(0, 1) == 3660);
+
+        auto emptyResult = xboxLiveContext->leaderboard_service().get_social_leaderboard_table(
+            _T("98052"),
+            _T("c4060100-4951-4a51-a630-dce26c15b8c5"),
+            std::vector<string_t>(),
+            _T("All")
+            ).get();
+        VERIFY_IS_TRUE(emptyResult.err() == xbox_live_error_code::invalid_argument);
+
+        // Players missing from a stat's leaderboard are joined with no value for it
+        social_leaderboard_table table(statNames);
+        table._Add_column_rows(0, CreateSocialLeaderboardResult({ { _T("1"), _T("30") }, { _T("2"), _T("20") }, { _T("3"), _T("10") } }));
+        table._Add_column_rows(1, CreateSocialLeaderboardResult({ { _T("3"), _T("9") }, { _T("4"), _T("5") }, { _T("1"), _T("2") } }));
+        VERIFY_ARE_EQUAL_INT(4, table.row_count());
+        VERIFY_ARE_EQUAL_INT(3, table.row_index(_T("4")));
+        VERIFY_IS_TRUE(!table.has_value(table.row_index(_T("4")), 0));
+        VERIFY_IS_TRUE(!table.has_value(table.row_index(_T("2")), 1));
+        VERIFY_IS_TRUE(table.value(table.row_index(_T("3")), 1) == 9);
+
+        table.sort_by(table.column_index(_T("Wins")));
+        std::vector<string_t> order;
+        for (auto row : table.sorted_rows())
+        {
+            order.push_back(table.xbox_user_id(row));
+        }
+        VERIFY_IS_TRUE(order == std::vector<string_t>({ _T("3"), _T("4"), _T("1"), _T("2") }));
+
+        // Updates move only the changed row, and add players the table hasn't seen
+        VERIFY_IS_TRUE(table.update_value(_T("2"), _T("Gamertag2"), _T("Wins"), 7));
+        VERIFY_IS_TRUE(table.update_value(_T("5"), _T("Gamertag5"), _T("Wins"), 100));
+        VERIFY_IS_TRUE(!table.update_value(_T("5"), _T("Gamertag5"), _T("Losses"), 1));
+        order.clear();
+        for (auto row : table.sorted_rows())
+        {
+            order.push_back(table.xbox_user_id(row));
+        }
+        VERIFY_IS_TRUE(order == std::vector<string_t>({ _T("5"), _T("3"), _T("2"), _T("4"), _T("1") }));
+        VERIFY_ARE_EQUAL_STR(_T("Gamertag5"), table.gamertag(table.row_index(_T("5"))));
+
+        table.sort_by(0, false);
+        VERIFY_ARE_EQUAL_STR(_T("3"), table.xbox_user_id(table.sorted_rows()[0]));
+        VERIFY_ARE_EQUAL_STR(_T("2"), table.xbox_user_id(table.sorted_rows()[1]));
+        VERIFY_ARE_EQUAL_STR(_T("1"), table.xbox_user_id(table.sorted_rows()[2]));
+    }
+
     DEFINE_TEST_CASE(TestGetLeaderboardAsyncInvalidArgs)
     {
         DEFINE_TEST_CASE_PROPERTIES(TestGetLeaderboardAsyncInvalidArgs);
@@ -889,6 +889,92 @@ public:
         DestructManager(xboxLiveContext);
     }
 
+    DEFINE_TEST_CASE(TestEventHandlers)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestEventHandlers);
+        InitializeManager();
+        auto xboxLiveContext = GetMockXboxLiveContext_WinRT();
+        AddLocalUserHelperWithSyncUpdate(xboxLiveContext);
+
+        auto mpInstance = MultiplayerManager::SingletonInstance;
+        auto multiplayerManager = multiplayer_manager::get_singleton_instance();
+        uint32_t invitesSent = 0;
+        auto context = multiplayerManager->add_event_handler(multiplayer_event_type::invite_sent, [&invitesSent](const multiplayer_event& multiplayerEvent)
+        {
+            VERIFY_IS_TRUE(multiplayerEvent.event_type() == multiplayer_event_type::invite_sent);
+            ++invitesSent;
+        });
+        VERIFY_IS_TRUE(context > 0);
+
+        // Handled events aren't also returned unless asked for
+        multiplayerManager->set_returned_event_types(std::vector<multiplayer_event_type>());
+
+        Vector<Platform::String^>^ xuids = ref new Vector<Platform::String^>();
+        xuids->Append(L"1234");
+#pragma warning(suppress: 6387)
+        mpInstance->LobbySession->InviteUsers(xboxLiveContext->User, xuids->GetView(), nullptr, nullptr);
+
+        while (invitesSent == 0)
+        {
+            auto events = multiplayerManager->do_work();
+            VERIFY_ARE_EQUAL_INT(0, events.size());
+        }
+        VERIFY_ARE_EQUAL_INT(1, invitesSent);
+        auto eventCounts = multiplayerManager->last_event_counts();
+        VERIFY_ARE_EQUAL_INT(1, eventCounts.size());
+        VERIFY_ARE_EQUAL_INT(1, eventCounts[multiplayer_event_type::invite_sent]);
+
+        // Session diffs of unwanted types aren't turned into events
+        std::shared_ptr<HttpResponseStruct> writeResponseStruct = std::make_shared<HttpResponseStruct>();
+        writeResponseStruct->responseList =
+        {
+            StockMocks::CreateMockHttpCallResponse(web::json::value::parse(multipleLocalUsersLobbyResponse))
+        };
+
+        std::unordered_map<xbox_live_api, std::shared_ptr<HttpResponseStruct>> responses;
+        responses[xbox_live_api::write_session_using_subpath] = writeResponseStruct;
+        m_mockXboxSystemFactory->add_http_api_state_response(responses);
+
+        auto clientManager = mpInstance->GetCppObj()->_Get_multiplayer_client_manager();
+        auto lobbyClient = clientManager->latest_pending_read()->lobby_client();
+        auto primaryContext = lobbyClient->session_writer()->get_primary_context();
+        auto mpsdSession = std::make_shared<multiplayer_session>(primaryContext->xbox_live_user_id());
+        auto result = primaryContext->multiplayer_service().write_session(mpsdSession, multiplayer::multiplayer_session_write_mode::update_existing).get();
+        lobbyClient->update_session(result.payload());
+        VERIFY_IS_TRUE(clientManager->is_update_avaialable());
+
+        for (const auto& multiplayerEvent : clientManager->do_work())
+        {
+            VERIFY_IS_TRUE(multiplayerEvent.event_type() != multiplayer_event_type::member_joined);
+        }
+        VERIFY_ARE_EQUAL_INT(2, clientManager->last_pending_read()->lobby_client()->session()->members().size());
+
+        // Removed handlers stop being called
+        multiplayerManager->remove_event_handler(context);
+        std::vector<multiplayer_event_type> allEventTypes;
+        for (uint32_t eventType = 0; eventType <= static_cast<uint32_t>(multiplayer_event_type::arbitration_complete); ++eventType)
+        {
+            allEventTypes.push_back(static_cast<multiplayer_event_type>(eventType));
+        }
+
+        // Returning every type puts back the unfiltered default the other tests run with
+        multiplayerManager->set_returned_event_types(allEventTypes);
+
+#pragma warning(suppress: 6387)
+        mpInstance->LobbySession->InviteUsers(xboxLiveContext->User, xuids->GetView(), nullptr, nullptr);
+        bool inviteSent = false;
+        while (!inviteSent)
+        {
+            for (const auto& multiplayerEvent : multiplayerManager->do_work())
+            {
+                inviteSent |= multiplayerEvent.event_type() == multiplayer_event_type::invite_sent;
+            }
+        }
+        VERIFY_ARE_EQUAL_INT(1, invitesSent);
+
+        DestructManager(xboxLiveContext);
+    }
+
     /*  Join Lobby Tests:
         1. Test with valid handleId with no transfer handle
         2. Test with invalid handleId
@@ -4255,6 +4341,117 @@ public:
         DEFINE_TEST_CASE_PROPERTIES(TestCancelMatchByService);
         CancelMatchHelper(MatchCallingPatternType::CanceledByService);
     }
+
+    DEFINE_TEST_CASE(TestSessionTapCoalescer)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestSessionTapCoalescer);
+
+        std::vector<uint64_t> dispatchedChangeNumbers;
+        std::vector<std::function<void()>> scheduledFlushes;
+        uint64_t localChangeNumber = 5;
+        auto coalescer = std::make_shared<multiplayer_session_tap_coalescer>(
+            std::chrono::milliseconds(100),
+            [&localChangeNumber](const multiplayer_session_reference&) { return localChangeNumber; },
+            [&dispatchedChangeNumbers](const multiplayer_session_change_event_args& args)
+            {
+                dispatchedChangeNumbers.push_back(args.change_number());
+            },
+            [&scheduledFlushes](std::chrono::milliseconds delay, std::function<void()> callback)
+            {
+                VERIFY_ARE_EQUAL_INT(100, delay.count());
+                scheduledFlushes.push_back(callback);
+            });
+
+        multiplayer_session_reference sessionRef(GAME_SERVICE_CONFIG_ID, LOBBY_TEMPLATE_NAME, L"MockSessionName");
+        multiplayer_session_reference sessionRefOtherCase(GAME_SERVICE_CONFIG_ID, LOBBY_TEMPLATE_NAME, L"MOCKSESSIONNAME");
+
+        // Not newer than the local session
+        coalescer->on_session_changed(multiplayer_session_change_event_args(sessionRef, L"branch", 5));
+        VERIFY_ARE_EQUAL_INT(1, coalescer->taps_skipped());
+
+        // A burst of taps is collapsed into a single dispatch of the highest change number
+        coalescer->on_session_changed(multiplayer_session_change_event_args(sessionRef, L"branch", 6));
+        coalescer->on_session_changed(multiplayer_session_change_event_args(sessionRefOtherCase, L"branch", 8));
+        coalescer->on_session_changed(multiplayer_session_change_event_args(sessionRef, L"branch", 7));
+        VERIFY_ARE_EQUAL_INT(2, coalescer->taps_coalesced());
+        VERIFY_ARE_EQUAL_INT(1, scheduledFlushes.size());
+        VERIFY_ARE_EQUAL_INT(0, dispatchedChangeNumbers.size());
+
+        // Nothing goes out until the window ends
+        scheduledFlushes[0]();
+        VERIFY_ARE_EQUAL_INT(1, dispatchedChangeNumbers.size());
+        VERIFY_ARE_EQUAL_INT(8, dispatchedChangeNumbers[0]);
+
+        // The same tap from a second local user's subscription is dropped
+        coalescer->on_session_changed(multiplayer_session_change_event_args(sessionRef, L"branch", 8));
+        VERIFY_ARE_EQUAL_INT(2, coalescer->taps_skipped());
+
+        // Skipping ahead means taps were missed, so the fetch goes out without waiting
+        coalescer->on_session_changed(multiplayer_session_change_event_args(sessionRef, L"branch", 12));
+        VERIFY_ARE_EQUAL_INT(1, coalescer->gaps_detected());
+        VERIFY_ARE_EQUAL_INT(2, dispatchedChangeNumbers.size());
+        VERIFY_ARE_EQUAL_INT(12, dispatchedChangeNumbers[1]);
+        VERIFY_ARE_EQUAL_INT(1, scheduledFlushes.size());
+
+        // With no window every new tap is dispatched right away
+        coalescer->set_coalesce_window(std::chrono::milliseconds::zero());
+        coalescer->on_session_changed(multiplayer_session_change_event_args(sessionRef, L"branch", 13));
+        VERIFY_ARE_EQUAL_INT(3, dispatchedChangeNumbers.size());
+        VERIFY_ARE_EQUAL_INT(13, dispatchedChangeNumbers[2]);
+        VERIFY_ARE_EQUAL_INT(1, scheduledFlushes.size());
+
+        VERIFY_ARE_EQUAL_INT(7, coalescer->taps_received());
+        VERIFY_ARE_EQUAL_INT(3, coalescer->taps_dispatched());
+    }
+
+    DEFINE_TEST_CASE(TestCommitQueueSerializesCommits)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestCommitQueueSerializesCommits);
+
+        auto commitQueue = std::make_shared<multiplayer_commit_queue>();
+        VERIFY_IS_TRUE(commitQueue->is_idle());
+
+        pplx::task_completion_event<void> firstCommitTce;
+        std::atomic<int> startedCount(0);
+        commitQueue->enqueue([&startedCount, firstCommitTce]()
+        {
+            ++startedCount;
+            return pplx::create_task(firstCommitTce);
+        });
+        auto secondCommit = commitQueue->enqueue([&startedCount]()
+        {
+            ++startedCount;
+            return pplx::task_from_result();
+        });
+
+        for (int i = 0; i < 100 && startedCount < 1; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        // The second commit must not start until the first has completed
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        VERIFY_ARE_EQUAL_INT(1, startedCount);
+        VERIFY_IS_TRUE(!commitQueue->is_idle());
+
+        firstCommitTce.set();
+        secondCommit.wait();
+        VERIFY_ARE_EQUAL_INT(2, startedCount);
+        VERIFY_IS_TRUE(commitQueue->is_idle());
+
+        // A failing commit doesn't block the ones queued behind it
+        commitQueue->enqueue([]() -> pplx::task<void>
+        {
+            throw std::runtime_error("commit failed");
+        });
+        commitQueue->enqueue([&startedCount]()
+        {
+            ++startedCount;
+            return pplx::task_from_result();
+        }).wait();
+        VERIFY_ARE_EQUAL_INT(3, startedCount);
+        VERIFY_IS_TRUE(commitQueue->is_idle());
+    }
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
\ No newline at end of file
@@ -261,6 +261,53 @@ public:
         }
     }
 
+    DEFINE_TEST_CASE(TestGetUserProfilesBatchChunking)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestGetUserProfilesBatchChunking);
+        std::vector<XboxUserProfileTestValues> profileList;
+        std::vector<string_t> xboxUserIds;
+        for (uint64 seed = 0; seed < 250; seed++)
+        {
+            XboxUserProfileTestValues x = CreateXboxUserProfileTestValues(seed);
+            profileList.push_back(x);
+            xboxUserIds.push_back(x.xboxUserId->Data());
+        }
+
+        auto httpCall = m_mockXboxSystemFactory->GetMockHttpCall();
+        httpCall->fRequestPostFunc = [this, &profileList](std::shared_ptr<http_call_response>& response, const string_t& requestPost)
+        {
+            // Echo back only the profiles that were asked for in this chunk
+            auto requestJson = web::json::value::parse(requestPost);
+            std::vector<XboxUserProfileTestValues> chunkProfiles;
+            for (const auto& userId : requestJson[L"userIds"].as_array())
+            {
+                for (const auto& x : profileList)
+                {
+                    if (userId.as_string() == x.xboxUserId->Data())
+                    {
+                        chunkProfiles.push_back(x);
+                        break;
+                    }
+                }
+            }
+
+            response = StockMocks::CreateMockHttpCallResponse(BuildXboxUserProfilesResultJsonResponse(chunkProfiles));
+        };
+
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        xboxLiveContext->settings()->set_max_concurrent_batch_requests(1);
+        auto result = xboxLiveContext->profile_service().get_user_profiles(xboxUserIds).get();
+        httpCall->fRequestPostFunc = nullptr;
+
+        VERIFY_IS_TRUE(!result.err());
+        VERIFY_ARE_EQUAL_INT(3, httpCall->CallCounter);
+        VERIFY_ARE_EQUAL_INT(profileList.size(), result.payload().size());
+        for (size_t i = 0; i < profileList.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL_STR(profileList[i].xboxUserId->Data(), result.payload()[i].xbox_user_id());
+        }
+    }
+
     DEFINE_TEST_CASE(TestProfileServiceInvalidArgs)
     {
         DEFINE_TEST_CASE_PROPERTIES(TestProfileServiceInvalidArgs);
@@ -16,6 +16,7 @@
 #include "WinRT/ReputationFeedbackType_WinRT.h"
 #include "xsapi\social.h"
 #include "social_internal.h"
+#include "reputation_feedback_aggregator.h"
 
 // TODO 718292: HTTP error handling
 using namespace Microsoft::Xbox::Services;
@@ -197,6 +198,78 @@ public:
         )
     }
 
+    DEFINE_TEST_CASE(TestReputationFeedbackAggregator)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestReputationFeedbackAggregator);
+
+        auto sentBatches = std::make_shared<std::vector<std::vector<reputation_feedback_item>>>();
+        auto failuresLeft = std::make_shared<int>(0);
+        auto aggregator = std::make_shared<reputation_feedback_aggregator>(
+            std::chrono::milliseconds(50),
+            3,
+            std::chrono::minutes(5),
+            2,
+            std::chrono::milliseconds(10),
+            [sentBatches, failuresLeft](const std::vector<reputation_feedback_item>& feedbackItems)
+            {
+                sentBatches->push_back(feedbackItems);
+                if (*failuresLeft > 0)
+                {
+                    --(*failuresLeft);
+                    return pplx::task_from_result(xbox_live_result<void>(xbox_live_error_code::http_status_429_too_many_requests, "throttled"));
+                }
+                return pplx::task_from_result(xbox_live_result<void>());
+            });
+
+        // A full batch goes out right away, the rest once the window passes, and repeats are only sent once
+        std::vector<pplx::task<xbox_live_result<void>>> tasks;
+        tasks.push_back(aggregator->queue_feedback(reputation_feedback_item(_T("1"), reputation_feedback_type::fair_play_quitter)));
+        tasks.push_back(aggregator->queue_feedback(reputation_feedback_item(_T("2"), reputation_feedback_type::fair_play_quitter)));
+        tasks.push_back(aggregator->queue_feedback(reputation_feedback_item(_T("1"), reputation_feedback_type::fair_play_quitter)));
+        tasks.push_back(aggregator->queue_feedback(reputation_feedback_item(_T("1"), reputation_feedback_type::fair_play_cheater)));
+        VERIFY_ARE_EQUAL_INT(1, sentBatches->size());
+        tasks.push_back(aggregator->queue_feedback(reputation_feedback_item(_T("3"), reputation_feedback_type::positive_skilled_player)));
+        for (auto& task : tasks)
+        {
+            VERIFY_IS_TRUE(!task.get().err());
+        }
+        VERIFY_ARE_EQUAL_INT(2, sentBatches->size());
+        VERIFY_ARE_EQUAL_INT(3, (*sentBatches)[0].size());
+        VERIFY_ARE_EQUAL_INT(1, (*sentBatches)[1].size());
+
+        // Already submitted within the dedup window
+        VERIFY_IS_TRUE(!aggregator->queue_feedback(reputation_feedback_item(_T("2"), reputation_feedback_type::fair_play_quitter)).get().err());
+        VERIFY_ARE_EQUAL_INT(2, sentBatches->size());
+
+        // Throttled batches are retried
+        *failuresLeft = 1;
+        auto retriedTask = aggregator->queue_feedback(reputation_feedback_item(_T("4"), reputation_feedback_type::fair_play_idler));
+        aggregator->flush();
+        VERIFY_IS_TRUE(!retriedTask.get().err());
+        VERIFY_ARE_EQUAL_INT(4, sentBatches->size());
+
+        // Once retries run out the report fails and may be queued again
+        *failuresLeft = 3;
+        auto failedTask = aggregator->queue_feedback(reputation_feedback_item(_T("5"), reputation_feedback_type::fair_play_idler));
+        aggregator->flush();
+        VERIFY_IS_TRUE(failedTask.get().err() == xbox_live_error_condition::http_429_too_many_requests);
+        VERIFY_ARE_EQUAL_INT(7, sentBatches->size());
+        auto requeuedTask = aggregator->queue_feedback(reputation_feedback_item(_T("5"), reputation_feedback_type::fair_play_idler));
+        aggregator->flush();
+        VERIFY_IS_TRUE(!requeuedTask.get().err());
+
+        auto stats = aggregator->stats();
+        VERIFY_ARE_EQUAL_INT(7, stats.itemsQueued);
+        VERIFY_ARE_EQUAL_INT(2, stats.itemsDeduplicated);
+        VERIFY_ARE_EQUAL_INT(6, stats.itemsSubmitted);
+        VERIFY_ARE_EQUAL_INT(1, stats.itemsFailed);
+        VERIFY_ARE_EQUAL_INT(8, stats.batchesSent);
+        VERIFY_ARE_EQUAL_INT(3, stats.batchesRetried);
+        VERIFY_ARE_EQUAL_INT(0, stats.pendingItems);
+        VERIFY_ARE_EQUAL_INT(0, stats.inFlightItems);
+        VERIFY_ARE_EQUAL_INT(3, stats.peakPendingItems);
+    }
+
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
@@ -162,6 +162,86 @@ public:
             httpCall->PathQueryFragment.to_string()
             );
     }
+
+    DEFINE_TEST_CASE(SimplifiedStatServicePostsDirtyStats)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(SimplifiedStatServicePostsDirtyStats);
+        auto simplifiedStatService = GetSimplifiedStatsService();
+        auto httpCall = m_mockXboxSystemFactory->GetMockHttpCall();
+        auto statsValueDoc = GetStatValueDocument(simplifiedStatService, httpCall, statValueDocumentResponse);
+
+        const uint32_t statCount = 500;
+        std::vector<string_t> statNames;
+        for (uint32_t i = 0; i < statCount; ++i)
+        {
+            statNames.push_back(_T("stat") + utils::uint32_to_string_t(i));
+        }
+
+        // Repeated sets between do_work calls keep only the last value
+        for (uint32_t pass = 0; pass < 10; ++pass)
+        {
+            for (uint32_t i = 0; i < statCount; ++i)
+            {
+                statsValueDoc.set_stat(statNames[i].c_str(), static_cast<double>(pass * statCount + i));
+            }
+        }
+        statsValueDoc.do_work();
+        VERIFY_ARE_EQUAL_INT(statCount, statsValueDoc.dirty_stat_names().size());
+        VERIFY_IS_TRUE(statsValueDoc.get_stat(_T("stat7")).payload()->as_number() == 9 * statCount + 7);
+        auto titleField = statsValueDoc.serialize_dirty_stats()[_T("stats")][_T("title")];
+        VERIFY_ARE_EQUAL_INT(statCount, titleField.size());
+        statsValueDoc.clear_dirty_state();
+
+        // Only the stat changed since the last flush is posted
+        statsValueDoc.set_stat(_T("stat42"), 1.0);
+        statsValueDoc.do_work();
+        auto updateStatResult = simplifiedStatService.update_stats_value_document(statsValueDoc).get();
+        VERIFY_IS_TRUE(!updateStatResult.err());
+        auto serializedRequest = web::json::value::parse(httpCall->request_body().request_message_string());
+        auto& postedTitleField = serializedRequest[_T("stats")][_T("title")];
+        VERIFY_ARE_EQUAL_INT(1, postedTitleField.size());
+        VERIFY_IS_TRUE(postedTitleField[_T("stat42")][_T("value")].as_double() == 1.0);
+        VERIFY_ARE_EQUAL_INT(statCount + 4, statsValueDoc.serialize()[_T("stats")][_T("title")].size());
+
+        // Stats from a failed post go out again with the next flush. The stats manager clears the dirty
+        // state once a post is sent and marks the posted stats dirty again if it fails.
+        statsValueDoc.clear_dirty_state();
+        statsValueDoc.set_stat(_T("stat42"), 5.0);
+        statsValueDoc.do_work();
+        auto flushedStatNames = statsValueDoc.dirty_stat_names();
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(web::json::value::object(), 500);
+        VERIFY_IS_TRUE(simplifiedStatService.update_stats_value_document(statsValueDoc).get().err());
+        statsValueDoc.clear_dirty_state();
+        VERIFY_IS_FALSE(statsValueDoc.is_dirty());
+
+        statsValueDoc.mark_stats_dirty(flushedStatNames);
+        VERIFY_IS_TRUE(statsValueDoc.is_dirty());
+        VERIFY_ARE_EQUAL_INT(1, statsValueDoc.dirty_stat_names().size());
+
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(web::json::value::parse(statValueDocumentResponse));
+        statsValueDoc.do_work();
+        VERIFY_IS_TRUE(!simplifiedStatService.update_stats_value_document(statsValueDoc).get().err());
+        serializedRequest = web::json::value::parse(httpCall->request_body().request_message_string());
+        VERIFY_ARE_EQUAL_INT(1, serializedRequest[_T("stats")][_T("title")].size());
+        VERIFY_IS_TRUE(serializedRequest[_T("stats")][_T("title")][_T("stat42")][_T("value")].as_double() == 5.0);
+        statsValueDoc.clear_dirty_state();
+
+        // Repeated sets between flushes post the latest value once
+        statsValueDoc.set_stat(_T("stat7"), 1.0);
+        statsValueDoc.set_stat(_T("stat7"), 2.0);
+        statsValueDoc.do_work();
+        auto dirtyStats = statsValueDoc.serialize_dirty_stats();
+        VERIFY_ARE_EQUAL_INT(1, dirtyStats[_T("stats")][_T("title")].size());
+        VERIFY_IS_TRUE(dirtyStats[_T("stats")][_T("title")][_T("stat7")][_T("value")].as_double() == 2.0);
+
+        // A serialized document is a snapshot that later sets don't change
+        auto snapshot = statsValueDoc.serialize();
+        statsValueDoc.clear_dirty_state();
+        statsValueDoc.set_stat(_T("stat7"), 3.0);
+        statsValueDoc.do_work();
+        VERIFY_IS_TRUE(snapshot[_T("stats")][_T("title")][_T("stat7")][_T("value")].as_double() == 2.0);
+        VERIFY_IS_TRUE(statsValueDoc.serialize()[_T("stats")][_T("title")][_T("stat7")][_T("value")].as_double() == 3.0);
+    }
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
\ No newline at end of file
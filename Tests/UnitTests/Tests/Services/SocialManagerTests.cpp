@@ -19,6 +19,8 @@
 #include "SocialUserGroupLoadedEventArgs_WinRT.h"
 #include "MockSocialManager.h"
 #include "SocialManagerHelper.h"
+#include "social_string_pool.h"
+#include "social_user_store.h"
 
 using namespace xbox::services;
 using namespace xbox::services::presence;
@@ -1187,6 +1189,131 @@ public:
         Cleanup(socialManagerInitializationStruct1, xboxLiveContext1);
     }
 
+    DEFINE_TEST_CASE(TestSocialManagerParallelGraphProcessing)
+    {
+        DEFINE_TEST_CASE_PROPERTIES_FOCUS(TestSocialManagerParallelGraphProcessing);
+        m_mockXboxSystemFactory->reinit();
+        auto mockSockets = m_mockXboxSystemFactory->AddMultipleMockWebSocketClients(2);
+        const std::wstring rtaConnectionIdJson =
+        LR"(
+        {
+            "ConnectionId": "d01a8c1b-2f83-4e03-9278-3048b480928f"
+        }
+        )";
+        SetMultipleClientWebSocketRTAAutoResponser(mockSockets, rtaConnectionIdJson, -1, false);
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        auto xboxLiveContext1 = GetMockXboxLiveContext_Cpp();
+        xboxLiveContext1->user()->GetUserImpl()->_Set_xbox_user_id(L"T0");
+        auto socialManagerInitializationStruct = Initialize(xboxLiveContext, false);
+        auto socialManagerInitializationStruct1 = Initialize(xboxLiveContext1, false);
+        auto socialManagerCppMock = std::dynamic_pointer_cast<MockSocialManager>(socialManagerInitializationStruct1.socialManager->GetCppObj());
+        socialManagerCppMock->set_parallel_graph_processing(true);
+
+        Platform::Collections::Vector<Platform::String^>^ vec = ref new Platform::Collections::Vector<Platform::String^>({ _T("1"), _T("2"), _T("3") });
+        Platform::Collections::Vector<Platform::String^>^ vec1 = ref new Platform::Collections::Vector<Platform::String^>({ _T("4"), _T("5"), _T("6") });
+        auto socialManager = socialManagerInitializationStruct.socialManager;
+
+        // Loads a group for each local user and returns what ended up in them, one line per user
+        auto loadGroups = [&]()
+        {
+            auto groupA = socialManager->CreateSocialUserGroupFromList(
+                xboxLiveContext->user(),
+                vec->GetView()
+                );
+
+            auto groupB = socialManager->CreateSocialUserGroupFromList(
+                xboxLiveContext1->user(),
+                vec1->GetView()
+                );
+
+            bool shouldLoop = true;
+            uint32_t counter = 0;
+            do
+            {
+                auto changeList = socialManager->DoWork();
+                LogSocialManagerEvents(changeList);
+
+                for (auto evt : changeList)
+                {
+                    if (evt->EventType == SocialEventType::SocialUserGroupLoaded)
+                    {
+                        ++counter;
+                        if (counter == 2)
+                        {
+                            shouldLoop = false;
+                        }
+                    }
+                }
+            } while (shouldLoop);
+
+            uint32_t i = 0;
+            for (auto user : groupA->Users)
+            {
+                VERIFY_IS_TRUE(utils::str_icmp(user->XboxUserId->Data(), vec->GetAt(i)->Data()) == 0);
+                ++i;
+            }
+
+            i = 0;
+            for (auto user : groupB->Users)
+            {
+                VERIFY_IS_TRUE(utils::str_icmp(user->XboxUserId->Data(), vec1->GetAt(i)->Data()) == 0);
+                ++i;
+            }
+
+            VERIFY_IS_TRUE(groupA->Users->Size == 3);
+            VERIFY_IS_TRUE(groupB->Users->Size == 3);
+
+            std::vector<string_t> groupContents;
+            for (auto group : { groupA, groupB })
+            {
+                for (auto user : group->Users)
+                {
+                    groupContents.push_back(FormatString(L"%s %s %s %d",
+                        user->XboxUserId->Data(),
+                        user->Gamertag->Data(),
+                        user->DisplayName->Data(),
+                        static_cast<int>(user->PresenceRecord->PresenceTitleRecords->Size)
+                        ));
+                }
+            }
+
+            socialManager->DestroySocialUserGroup(groupA);
+            socialManager->DestroySocialUserGroup(groupB);
+            socialManager->DoWork();
+            return groupContents;
+        };
+
+        auto parallelContents = loadGroups();
+
+        // Both graphs were processed, each on its own task
+        auto timings = socialManagerCppMock->_Graph_work_timings();
+        VERIFY_ARE_EQUAL_INT(2, timings.size());
+        for (const auto& timing : timings)
+        {
+            VERIFY_IS_TRUE(timing.processedInParallel);
+        }
+
+        socialManagerCppMock->set_parallel_graph_processing(false);
+        auto serialContents = loadGroups();
+
+        timings = socialManagerCppMock->_Graph_work_timings();
+        VERIFY_ARE_EQUAL_INT(2, timings.size());
+        for (const auto& timing : timings)
+        {
+            VERIFY_IS_FALSE(timing.processedInParallel);
+        }
+
+        // The groups come out the same either way
+        VERIFY_ARE_EQUAL_INT(serialContents.size(), parallelContents.size());
+        for (size_t i = 0; i < serialContents.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL_STR(serialContents[i], parallelContents[i]);
+        }
+
+        Cleanup(socialManagerInitializationStruct, xboxLiveContext, 1);
+        Cleanup(socialManagerInitializationStruct1, xboxLiveContext1);
+    }
+
     // Tests race condition in adding then removing a local user before adding is complete
     DEFINE_TEST_CASE(TestSocialManagerAddRemoveLocalUser)
     {
@@ -2129,6 +2256,220 @@ public:
         VERIFY_IS_TRUE(userBufferHolder.user_buffer_b().freeData.size() == 0);
     }
 
+    DEFINE_TEST_CASE(TestSocialManagerUserBufferSharesStrings)
+    {
+        DEFINE_TEST_CASE_PROPERTIES_FOCUS(TestSocialManagerUserBufferSharesStrings);
+        auto peopleHubService = SocialManagerHelper::GetPeoplehubService();
+        auto httpCall = m_mockXboxSystemFactory->GetMockHttpCall();
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(web::json::value::parse(peoplehubResponse));
+
+        std::vector<string_t> xuids;
+        xuids.push_back(_T("1"));
+        auto userGroup = peopleHubService.get_social_graph(_T("TestXboxUserId"), social_manager_extra_detail_level::preferred_color_level, xuids).get();
+        VERIFY_IS_TRUE(!userGroup.err());
+        VERIFY_IS_TRUE(!userGroup.payload().empty());
+
+        auto stringPool = social_string_pool::get_singleton_instance();
+        auto statsBefore = stringPool->stats();
+        xbox_social_user userCopy;
+        {
+            user_buffers_holder userBufferHolder;
+            userBufferHolder.initialize(userGroup.payload());
+
+            // Both buffers point at the same copy of each string
+            for (auto& user : userBufferHolder.user_buffer_a().socialUserGraph)
+            {
+                auto otherUser = userBufferHolder.user_buffer_b().socialUserGraph.at(user.first).socialUser;
+                VERIFY_IS_TRUE(user.second.socialUser->gamertag() == otherUser->gamertag());
+                VERIFY_IS_TRUE(user.second.socialUser->xbox_user_id() == otherUser->xbox_user_id());
+                VERIFY_IS_TRUE(user.second.socialUser->display_pic_url_raw() == otherUser->display_pic_url_raw());
+            }
+
+            auto statsWithBuffers = stringPool->stats();
+            VERIFY_ARE_EQUAL_INT(statsWithBuffers.stringCount, statsBefore.stringCount);
+            VERIFY_IS_TRUE(statsWithBuffers.referenceCount > statsBefore.referenceCount);
+
+            size_t userCount = userGroup.payload().size();
+            TEST_LOG(FormatString(
+                L"%u users: %u bytes per user in each buffer, %u pooled strings using %u bytes for %u references",
+                static_cast<uint32_t>(userCount),
+                static_cast<uint32_t>(sizeof(xbox_social_user)),
+                static_cast<uint32_t>(statsWithBuffers.stringCount),
+                static_cast<uint32_t>(statsWithBuffers.bytes),
+                static_cast<uint32_t>(statsWithBuffers.referenceCount)
+                ).c_str());
+
+            userCopy = *userBufferHolder.user_buffer_a().socialUserGraph.begin()->second.socialUser;
+        }
+
+        // Copies keep their strings after the buffers they came from are gone
+        auto copiedFrom = std::find_if(userGroup.payload().begin(), userGroup.payload().end(), [&userCopy](const xbox_social_user& user)
+        {
+            return user._Xbox_user_id_as_integer() == userCopy._Xbox_user_id_as_integer();
+        });
+        VERIFY_IS_TRUE(copiedFrom != userGroup.payload().end());
+        VERIFY_ARE_EQUAL_STR(userCopy.gamertag(), copiedFrom->gamertag());
+        VERIFY_ARE_EQUAL_STR(userCopy.display_name(), copiedFrom->display_name());
+        VERIFY_ARE_EQUAL_STR(userCopy.preferred_color().primary_color(), copiedFrom->preferred_color().primary_color());
+        VERIFY_ARE_EQUAL_INT(stringPool->stats().stringCount, statsBefore.stringCount);
+    }
+
+    static xbox_social_user CreateDiffTestUser(uint32_t index, const string_t& gamertag, const string_t& presenceText)
+    {
+        web::json::value presenceDetail;
+        presenceDetail[_T("Device")] = web::json::value::string(_T("XboxOne"));
+        presenceDetail[_T("PresenceText")] = web::json::value::string(presenceText);
+        presenceDetail[_T("State")] = web::json::value::string(_T("Active"));
+        presenceDetail[_T("TitleId")] = web::json::value::string(_T("1234"));
+
+        web::json::value preferredColor;
+        preferredColor[_T("primaryColor")] = web::json::value::string(_T("193e91"));
+        preferredColor[_T("secondaryColor")] = web::json::value::string(_T("2458cf"));
+        preferredColor[_T("tertiaryColor")] = web::json::value::string(_T("1f48a6"));
+
+        web::json::value json;
+        json[_T("xuid")] = web::json::value::string(utils::uint32_to_string_t(index + 1));
+        json[_T("isFavorite")] = web::json::value::boolean(false);
+        json[_T("isFollowingCaller")] = web::json::value::boolean(true);
+        json[_T("isFollowedByCaller")] = web::json::value::boolean(true);
+        json[_T("displayName")] = web::json::value::string(gamertag);
+        json[_T("gamertag")] = web::json::value::string(gamertag);
+        json[_T("gamerScore")] = web::json::value::string(_T("1000"));
+        json[_T("presenceState")] = web::json::value::string(_T("Online"));
+        json[_T("presenceDetails")][0] = presenceDetail;
+        json[_T("preferredColor")] = preferredColor;
+        return xbox_social_user::_Deserialize(json).payload();
+    }
+
+    DEFINE_TEST_CASE(TestSocialGraphDiffUsers)
+    {
+        DEFINE_TEST_CASE_PROPERTIES_FOCUS(TestSocialGraphDiffUsers);
+        const uint32_t graphSizes[] = { 20, 100 };
+        for (auto graphSize : graphSizes)
+        {
+            std::vector<xbox_social_user> previousUsers;
+            std::vector<xbox_social_user> currentUsers;
+            uint32_t expectedProfileChanges = 0;
+            uint32_t expectedPresenceChanges = 0;
+            uint32_t expectedRemovals = 0;
+            for (uint32_t i = 0; i < graphSize; ++i)
+            {
+                string_t gamertag = _T("Gamer") + utils::uint32_to_string_t(i);
+                previousUsers.push_back(CreateDiffTestUser(i, gamertag, _T("Home")));
+                if (i % 20 == 3)
+                {
+                    ++expectedRemovals;
+                }
+                else if (i % 10 == 1)
+                {
+                    ++expectedProfileChanges;
+                    currentUsers.push_back(CreateDiffTestUser(i, _T("Renamed") + utils::uint32_to_string_t(i), _T("Home")));
+                }
+                else if (i % 10 == 2)
+                {
+                    ++expectedPresenceChanges;
+                    currentUsers.push_back(CreateDiffTestUser(i, gamertag, _T("Playing a game")));
+                }
+                else
+                {
+                    // Case only differences aren't changes
+                    bool changeCase = (i % 10 == 5);
+                    currentUsers.push_back(CreateDiffTestUser(
+                        i,
+                        changeCase ? _T("GAMER") + utils::uint32_to_string_t(i) : gamertag,
+                        changeCase ? _T("HOME") : _T("Home")
+                        ));
+                }
+            }
+
+            uint32_t expectedAdditions = graphSize / 20;
+            for (uint32_t i = 0; i < expectedAdditions; ++i)
+            {
+                currentUsers.push_back(CreateDiffTestUser(graphSize + i, _T("NewGamer"), _T("Home")));
+            }
+
+            user_buffers_holder userBufferHolder;
+            userBufferHolder.initialize(previousUsers);
+
+            auto diff = social_graph::diff_users(userBufferHolder.inactive_buffer()->socialUserGraph, currentUsers);
+            VERIFY_ARE_EQUAL_INT(diff.usersAdded.size(), expectedAdditions);
+            VERIFY_ARE_EQUAL_INT(diff.usersRemoved.size(), expectedRemovals);
+            VERIFY_ARE_EQUAL_INT(diff.profilesChanged.size(), expectedProfileChanges);
+            VERIFY_ARE_EQUAL_INT(diff.presenceChanged.size(), expectedPresenceChanges);
+            VERIFY_ARE_EQUAL_INT(diff.socialRelationshipsChanged.size(), 0);
+            for (auto xuid : diff.usersRemoved)
+            {
+                // Test users' XUIDs are their index plus one
+                VERIFY_ARE_EQUAL_INT(3, (xuid - 1) % 20);
+            }
+        }
+    }
+
+    DEFINE_TEST_CASE(TestSocialUserStoreSharesUsers)
+    {
+        DEFINE_TEST_CASE_PROPERTIES_FOCUS(TestSocialUserStoreSharesUsers);
+        m_mockXboxSystemFactory->reinit();
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        auto xboxLiveContext1 = GetMockXboxLiveContext_Cpp();
+        xboxLiveContext1->user()->GetUserImpl()->_Set_xbox_user_id(L"T0");
+
+        // The store is process wide, so clear out anything earlier tests left in it
+        auto userStore = social_user_store::get_singleton_instance();
+        userStore->_Reset();
+        VERIFY_IS_TRUE(userStore->set_sharing_enabled(true));
+
+        auto graphA = std::make_shared<MockSocialGraph>(xboxLiveContext->user(), social_manager_extra_detail_level::no_extra_detail, nullptr);
+        auto graphB = std::make_shared<MockSocialGraph>(xboxLiveContext1->user(), social_manager_extra_detail_level::no_extra_detail, nullptr);
+
+        // The second local user only subscribes to the friend the first doesn't have
+        std::vector<uint64_t> usersA = { 1, 2, 3 };
+        std::vector<uint64_t> usersB = { 2, 3, 4 };
+        VERIFY_ARE_EQUAL_INT(3, userStore->add_users(graphA, usersA).size());
+        auto usersToSubscribe = userStore->add_users(graphB, usersB);
+        VERIFY_ARE_EQUAL_INT(1, usersToSubscribe.size());
+        VERIFY_IS_TRUE(usersToSubscribe[0] == 4);
+        VERIFY_IS_TRUE(!userStore->set_sharing_enabled(false));
+
+        auto stats = userStore->stats();
+        VERIFY_ARE_EQUAL_INT(4, stats.distinctUserCount);
+        VERIFY_ARE_EQUAL_INT(6, stats.userReferenceCount);
+        VERIFY_ARE_EQUAL_INT(4, stats.subscribedUserCount);
+        VERIFY_IS_TRUE(stats.user_dedup_ratio() == 1.5);
+
+        // Presence for shared users goes to the graph that didn't receive it
+        auto otherGraphs = userStore->other_graphs_with_user(graphA.get(), 2);
+        VERIFY_ARE_EQUAL_INT(1, otherGraphs.size());
+        VERIFY_IS_TRUE(otherGraphs[0] == graphB);
+        VERIFY_ARE_EQUAL_INT(0, userStore->other_graphs_with_user(graphA.get(), 1).size());
+
+        // A user polled by one graph isn't polled again by the other within the interval
+        std::vector<uint64_t> pollUsers = { 2, 3 };
+        VERIFY_ARE_EQUAL_INT(2, userStore->claim_presence_poll(pollUsers, std::chrono::milliseconds(30000)).size());
+        VERIFY_ARE_EQUAL_INT(0, userStore->claim_presence_poll(pollUsers, std::chrono::milliseconds(30000)).size());
+        stats = userStore->stats();
+        VERIFY_ARE_EQUAL_INT(4, stats.presencePollsRequested);
+        VERIFY_ARE_EQUAL_INT(2, stats.presencePollsSkipped);
+
+        // Subscriptions the first graph drops are handed to the second where it still holds the user
+        std::vector<uint64_t> removeUsers = { 1, 2 };
+        VERIFY_ARE_EQUAL_INT(2, userStore->remove_users(graphA.get(), removeUsers).size());
+        auto subscribedUsers = userStore->subscribed_users(graphB.get(), usersB);
+        VERIFY_ARE_EQUAL_INT(2, subscribedUsers.size());
+        VERIFY_IS_TRUE(subscribedUsers[0] == 2);
+        VERIFY_IS_TRUE(subscribedUsers[1] == 4);
+
+        graphA = nullptr;
+        stats = userStore->stats();
+        VERIFY_ARE_EQUAL_INT(3, stats.distinctUserCount);
+        VERIFY_ARE_EQUAL_INT(3, stats.userReferenceCount);
+        VERIFY_ARE_EQUAL_INT(3, userStore->subscribed_users(graphB.get(), usersB).size());
+
+        graphB = nullptr;
+        VERIFY_ARE_EQUAL_INT(0, userStore->stats().distinctUserCount);
+        VERIFY_IS_TRUE(userStore->set_sharing_enabled(false));
+        userStore->_Reset();
+    }
+
     // Verifies that get_user_copy API (C++ only) works properly in copying the data
     DEFINE_TEST_CASE(TestSocialManagerUserGroupCopy)
     {
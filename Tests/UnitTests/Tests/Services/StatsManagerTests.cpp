@@ -148,6 +148,87 @@ public:
 
         Cleanup(statsManager, user);
     }
+
+    void WaitForStatisticEvents(StatisticManager^ statsManager, StatisticEventType eventType, uint32_t eventCount)
+    {
+        uint32_t eventsSeen = 0;
+        while (eventsSeen < eventCount)
+        {
+            auto eventList = statsManager->DoWork();
+            for (auto evt : eventList)
+            {
+                if (evt->EventType == eventType)
+                {
+                    ++eventsSeen;
+                }
+            }
+        }
+    }
+
+    DEFINE_TEST_CASE(StatisticManagerConcurrentSetStat)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(StatisticManagerConcurrentSetStat);
+        auto statsManager = StatisticManager::SingletonInstance;
+        auto httpCall = m_mockXboxSystemFactory->GetMockHttpCall();
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(web::json::value::parse(statValueDocumentResponse));
+
+        const uint32_t userCount = 64;
+        const uint32_t threadCount = 8;
+        const uint32_t setsPerUser = 100;
+        std::vector<XboxLiveUser_t> users;
+        for (uint32_t i = 0; i < userCount; ++i)
+        {
+            auto user = GetMockXboxLiveContext_WinRT(utils::uint64_to_string_t(2533274800000000 + i))->User;
+            users.push_back(user);
+            statsManager->AddLocalUser(user);
+        }
+        WaitForStatisticEvents(statsManager, StatisticEventType::LocalUserAdded, userCount);
+
+        // Each thread plays for its own players while do_work keeps running
+        std::atomic<bool> isDone(false);
+        std::thread doWorkThread([statsManager, &isDone]()
+        {
+            while (!isDone)
+            {
+                statsManager->DoWork();
+            }
+        });
+
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < threadCount; ++t)
+        {
+            threads.push_back(std::thread([statsManager, &users, t, threadCount, userCount, setsPerUser]()
+            {
+                for (uint32_t set = 1; set <= setsPerUser; ++set)
+                {
+                    for (uint32_t i = t; i < userCount; i += threadCount)
+                    {
+                        statsManager->SetStatisticIntegerData(users[i], L"headshots", set);
+                    }
+                }
+            }));
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        isDone = true;
+        doWorkThread.join();
+
+        // Every user ends up with its own last value, whichever shard it landed in
+        statsManager->DoWork();
+        for (auto& user : users)
+        {
+            VERIFY_IS_TRUE(statsManager->GetStatistic(user, L"headshots")->AsInteger == setsPerUser);
+            VERIFY_ARE_EQUAL_INT(4, statsManager->GetStatisticNames(user)->Size);
+        }
+
+        for (auto& user : users)
+        {
+            statsManager->RemoveLocalUser(user);
+        }
+        WaitForStatisticEvents(statsManager, StatisticEventType::LocalUserRemoved, userCount);
+    }
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
\ No newline at end of file
@@ -14,6 +14,7 @@
 
 #include "Utils_WinRT.h"
 #include "RtaTestHelper.h"
+#include "statistic_change_subscription_multiplexer.h"
 
 using namespace Microsoft::Xbox::Services;
 using namespace Microsoft::Xbox::Services::System;
@@ -384,6 +385,138 @@ public:
         mockSocket->receive_rta_event(subId, updatedValue.serialize());
         VERIFY_IS_FALSE(didFire);
     }
+
+    DEFINE_TEST_CASE(TestRTAStatisticsSharedSubscription)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestRTAStatisticsSharedSubscription);
+        const int subId = 321;
+        const int subscribeCount = 4;
+        auto xboxLiveContext = GetMockXboxLiveContext_WinRT();
+        auto mockSocket = m_mockXboxSystemFactory->GetMockWebSocketClient();
+        SetWebSocketRTAAutoResponser(mockSocket, defaultRTAStat, subId);
+
+        auto helper = SetupStateChangeHelper(xboxLiveContext->RealTimeActivityService);
+        xboxLiveContext->RealTimeActivityService->Activate();
+        helper->connectedEvent.wait();
+
+        concurrency::event fireEvent;
+        std::atomic<int> fireCount(0);
+        const string_t testUser = _T("TestUser");
+        const string_t scid = _T("12345");
+        const string_t statName = DEFAULT_STAT_NAME;
+
+        auto statisticChangedHandler = xboxLiveContext->UserStatisticsService->StatisticChanged +=
+            ref new Windows::Foundation::EventHandler<StatisticChangeEventArgs^>([&fireEvent, &fireCount](Platform::Object^, StatisticChangeEventArgs^ args)
+        {
+            ++fireCount;
+            fireEvent.set();
+        });
+
+        std::vector<StatisticChangeSubscription^> subscriptions;
+        for (int i = 0; i < subscribeCount; ++i)
+        {
+            subscriptions.push_back(xboxLiveContext->UserStatisticsService->SubscribeToStatisticChange(
+                ref new Platform::String(testUser.c_str()),
+                ref new Platform::String(scid.c_str()),
+                ref new Platform::String(statName.c_str())
+                ));
+        }
+
+        TEST_LOG(L"Wait for StatisticChanged event for initial stat");
+        fireEvent.wait();
+        fireEvent.reset();
+
+        auto multiplexer = xbox::services::user_statistics::statistic_change_subscription_multiplexer::get_multiplexer(
+            xboxLiveContext->RealTimeActivityService->GetCppObj()
+            );
+        auto counts = multiplexer->counts();
+        VERIFY_ARE_EQUAL_INT(counts.realTimeActivitySubscriptionCount, 1);
+        VERIFY_ARE_EQUAL_INT(counts.handleCount, subscribeCount);
+        VERIFY_ARE_EQUAL_INT(counts.sharedSubscribeCount, subscribeCount - 1);
+        for (auto subscription : subscriptions)
+        {
+            VERIFY_IS_TRUE(subscription->State == Microsoft::Xbox::Services::RealTimeActivity::RealTimeActivitySubscriptionState::Subscribed);
+            VERIFY_ARE_EQUAL_INT(subscription->SubscriptionId, subId);
+        }
+
+        fireCount = 0;
+        mockSocket->receive_rta_event(subId, web::json::value(32).serialize());
+        fireEvent.wait();
+        fireEvent.reset();
+        VERIFY_ARE_EQUAL_INT(fireCount, 1);
+        for (auto subscription : subscriptions)
+        {
+            VERIFY_ARE_EQUAL_STR(subscription->GetCppObj()->statistic().value(), L"32");
+        }
+
+        for (auto subscription : subscriptions)
+        {
+            xboxLiveContext->UserStatisticsService->UnsubscribeFromStatisticChange(subscription);
+            VERIFY_IS_TRUE(subscription->State == Microsoft::Xbox::Services::RealTimeActivity::RealTimeActivitySubscriptionState::Closed);
+        }
+
+        // The service subscription outlives its handles for a moment in case someone subscribes again
+        counts = multiplexer->counts();
+        VERIFY_ARE_EQUAL_INT(counts.realTimeActivitySubscriptionCount, 1);
+        VERIFY_ARE_EQUAL_INT(counts.handleCount, 0);
+        VERIFY_ARE_EQUAL_INT(counts.pendingReleaseCount, 1);
+
+        fireCount = 0;
+        mockSocket->receive_rta_event(subId, web::json::value(33).serialize());
+        VERIFY_ARE_EQUAL_INT(fireCount, 0);
+
+        multiplexer->release_unused_subscriptions(true);
+        VERIFY_ARE_EQUAL_INT(multiplexer->counts().realTimeActivitySubscriptionCount, 0);
+
+        xboxLiveContext->UserStatisticsService->StatisticChanged -= statisticChangedHandler;
+    }
+
+    DEFINE_TEST_CASE(TestRTAStatisticsMultiplexerReleasesOnDestroy)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestRTAStatisticsMultiplexerReleasesOnDestroy);
+        const int subId = 321;
+        auto xboxLiveContext = GetMockXboxLiveContext_WinRT();
+        auto mockSocket = m_mockXboxSystemFactory->GetMockWebSocketClient();
+        SetWebSocketRTAAutoResponser(mockSocket, defaultRTAStat, subId);
+
+        auto helper = SetupStateChangeHelper(xboxLiveContext->RealTimeActivityService);
+        xboxLiveContext->RealTimeActivityService->Activate();
+        helper->connectedEvent.wait();
+
+        auto multiplexer = std::make_shared<xbox::services::user_statistics::statistic_change_subscription_multiplexer>(
+            xboxLiveContext->RealTimeActivityService->GetCppObj()
+            );
+
+        concurrency::event fireEvent;
+        auto listener = multiplexer->add_listener([&fireEvent](const xbox::services::user_statistics::statistic_change_event_args&)
+        {
+            fireEvent.set();
+        });
+
+        auto subscribeResult = multiplexer->subscribe(listener, _T("TestUser"), _T("12345"), DEFAULT_STAT_NAME);
+        VERIFY_IS_TRUE(!subscribeResult.err());
+        auto subscription = subscribeResult.payload();
+
+        TEST_LOG(L"Wait for StatisticChanged event for initial stat");
+        fireEvent.wait();
+
+        VERIFY_IS_TRUE(!multiplexer->unsubscribe(subscription).err());
+        VERIFY_IS_TRUE(multiplexer->unsubscribe(subscription).err() == xbox_live_error_code::invalid_argument);
+        VERIFY_ARE_EQUAL_INT(multiplexer->counts().pendingReleaseCount, 1);
+
+        std::atomic<int> unsubscribeCount(0);
+        mockSocket->set_send_handler([&unsubscribeCount](string_t message)
+        {
+            if (web::json::value::parse(message)[0].as_integer() == 2)
+            {
+                ++unsubscribeCount;
+            }
+        });
+
+        // Dropping the multiplexer within RELEASE_DELAY still unsubscribes from the service
+        multiplexer.reset();
+        VERIFY_ARE_EQUAL_INT(unsubscribeCount, 1);
+    }
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
\ No newline at end of file
@@ -13,6 +13,7 @@
 #include "UnitTestIncludes.h"
 #include "XboxLiveContext_WinRT.h"
 #include "StringService_WinRT.h"
+#include "string_verify_batcher.h"
 
 using namespace Microsoft::Xbox::Services;
 using namespace Microsoft::Xbox::Services::System;
@@ -114,6 +115,94 @@ public:
         VERIFY_ARE_EQUAL_INT(result2->ResultCode, resultArrryJson[2][L"resultCode"].as_integer());
         VERIFY_ARE_EQUAL(result2->FirstOffendingSubstring->Data(), resultArrryJson[2][L"offendingString"].as_string());
     }
+
+    DEFINE_TEST_CASE(TestVerifyStringBatchingOptIn)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestVerifyStringBatchingOptIn);
+
+        auto responseJson = web::json::value::parse(defaultStringVerifyResult);
+        auto httpCall = m_mockXboxSystemFactory->GetMockHttpCall();
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(responseJson);
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        auto& stringService = xboxLiveContext->string_service();
+
+        // Off by default, so every call goes to the service
+        VERIFY_IS_FALSE(stringService.verify_string_batching_enabled());
+        httpCall->CallCounter = 0;
+        stringService.verify_string(L"xboxUserId").wait();
+        stringService.verify_string(L"xboxUserId").wait();
+        VERIFY_ARE_EQUAL_INT(2, httpCall->CallCounter);
+
+        // Once enabled, a verified string's result is reused
+        stringService.set_verify_string_batching_enabled(true);
+        VERIFY_IS_TRUE(stringService.verify_string_batching_enabled());
+        stringService.verify_string(L"xboxUserId").wait();
+        auto result = stringService.verify_string(L"xboxUserId").get();
+        VERIFY_ARE_EQUAL_INT(3, httpCall->CallCounter);
+        VERIFY_ARE_EQUAL_INT(result.payload().result_code(), verify_string_result_code::success);
+        stringService.set_verify_string_batching_enabled(false);
+    }
+
+    DEFINE_TEST_CASE(TestVerifyStringBatching)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestVerifyStringBatching);
+
+        auto sentBatches = std::make_shared<std::vector<std::vector<string_t>>>();
+        auto batcher = std::make_shared<string_verify_batcher>(
+            std::chrono::milliseconds(50),
+            4,
+            2,
+            [sentBatches](const std::vector<string_t>& stringsToVerify)
+            {
+                sentBatches->push_back(stringsToVerify);
+                std::vector<verify_string_result> results;
+                for (const auto& stringToVerify : stringsToVerify)
+                {
+                    bool isOffensive = stringToVerify.find(_T("bad")) != string_t::npos;
+                    results.push_back(verify_string_result(
+                        isOffensive ? verify_string_result_code::offensive : verify_string_result_code::success,
+                        isOffensive ? _T("bad") : string_t()
+                        ));
+                }
+                return pplx::task_from_result(xbox_live_result<std::vector<verify_string_result>>(results));
+            });
+
+        // Calls within the window go out together, with repeated strings sent once
+        std::vector<pplx::task<xbox_live_result<verify_string_result>>> tasks;
+        tasks.push_back(batcher->verify_string(_T("hello")));
+        tasks.push_back(batcher->verify_string(_T("bad word")));
+        tasks.push_back(batcher->verify_string(_T("hello")));
+        pplx::when_all(tasks.begin(), tasks.end()).wait();
+        VERIFY_ARE_EQUAL_INT(1, sentBatches->size());
+        VERIFY_ARE_EQUAL_INT(2, (*sentBatches)[0].size());
+        VERIFY_ARE_EQUAL_INT(tasks[0].get().payload().result_code(), verify_string_result_code::success);
+        VERIFY_ARE_EQUAL_INT(tasks[1].get().payload().result_code(), verify_string_result_code::offensive);
+        VERIFY_ARE_EQUAL_STR(_T("bad"), tasks[1].get().payload().first_offending_substring());
+        VERIFY_ARE_EQUAL_INT(tasks[2].get().payload().result_code(), verify_string_result_code::success);
+
+        // Verdicts are reused
+        auto cachedResult = batcher->verify_string(_T("bad word")).get();
+        VERIFY_ARE_EQUAL_INT(cachedResult.payload().result_code(), verify_string_result_code::offensive);
+        VERIFY_ARE_EQUAL_INT(1, sentBatches->size());
+        VERIFY_ARE_EQUAL_INT(1, batcher->cache_hits());
+
+        // A full batch goes out without waiting for the window
+        tasks.clear();
+        tasks.push_back(batcher->verify_string(_T("a")));
+        tasks.push_back(batcher->verify_string(_T("b")));
+        tasks.push_back(batcher->verify_string(_T("c")));
+        tasks.push_back(batcher->verify_string(_T("d")));
+        VERIFY_ARE_EQUAL_INT(2, batcher->batches_sent());
+        pplx::when_all(tasks.begin(), tasks.end()).wait();
+
+        // Only the most recently used verdicts are kept
+        batcher->verify_string(_T("d")).wait();
+        batcher->verify_string(_T("hello")).wait();
+        VERIFY_ARE_EQUAL_INT(3, sentBatches->size());
+        VERIFY_ARE_EQUAL_INT(10, batcher->strings_requested());
+        VERIFY_ARE_EQUAL_INT(2, batcher->cache_hits());
+        VERIFY_ARE_EQUAL_INT(7, batcher->strings_sent());
+    }
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
@@ -8,6 +8,7 @@
 //
 //*********************************************************
 #include "pch.h"
+#include <fstream>
 #define TEST_CLASS_OWNER L"blgross"
 #define TEST_CLASS_AREA L"TitleStorage"
 #include "UnitTestIncludes.h"
@@ -58,6 +59,33 @@ const std::vector<unsigned char> downloadBinary = {
     55, 100, 10, 255, 101, 0, 1, 29, 50, 55, 100, 10, 255, 101, 0, 1, 29, 50, 55, 100, 10, 255, 101, 0, 1, 29, 50, 55, 100 
     };
 
+const string_t downloadFilePath = _T("TitleStorageDownloadTest.bin");
+const string_t downloadETagFilePath = _T("TitleStorageDownloadTest.bin.etag");
+
+void WriteTestFile(_In_ const string_t& filePath, _In_ const std::string& contents)
+{
+    std::ofstream file(filePath, std::ios::out | std::ios::trunc | std::ios::binary);
+    file << contents;
+}
+
+bool TestFileExists(_In_ const string_t& filePath)
+{
+    std::ifstream file(filePath, std::ios::in | std::ios::binary);
+    return file.good();
+}
+
+std::string ReadTestFile(_In_ const string_t& filePath)
+{
+    std::ifstream file(filePath, std::ios::in | std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void DeleteTestFiles()
+{
+    DeleteFileW(downloadFilePath.c_str());
+    DeleteFileW(downloadETagFilePath.c_str());
+}
+
 DEFINE_TEST_CLASS(TitleStorageTests)
 {
 public:
@@ -599,6 +627,230 @@ public:
             );
     }
 
+    DEFINE_TEST_CASE(UploadBlobSendsBlocksFromCallerBuffer)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(UploadBlobSendsBlocksFromCallerBuffer);
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        auto httpCall = m_mockXboxSystemFactory->GetMockHttpCall();
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(largeUploadJson);
+
+        const size_t blobSize = 2500;
+        auto blobBuffer = std::make_shared<std::vector<unsigned char>>(blobSize);
+        for (size_t i = 0; i < blobSize; ++i)
+        {
+            (*blobBuffer)[i] = static_cast<unsigned char>(i % UCHAR_MAX);
+        }
+
+        xbox::services::title_storage::title_storage_blob_metadata blobMetadata(
+            _T("123456789"),
+            xbox::services::title_storage::title_storage_type::universal,
+            _T("blobPath"),
+            xbox::services::title_storage::title_storage_blob_type::binary,
+            _T("TestXboxUserId")
+            );
+
+        auto result = xboxLiveContext->title_storage_service().upload_blob(
+            blobMetadata,
+            blobBuffer,
+            xbox::services::title_storage::title_storage_e_tag_match_condition::not_used,
+            1024
+            ).get();
+
+        VERIFY_IS_TRUE(!result.err());
+        VERIFY_ARE_EQUAL_INT(3, httpCall->CallCounter);
+        VERIFY_ARE_EQUAL_INT(blobSize, result.payload().length());
+
+        // The last block should point into the caller's buffer instead of a copy of it
+        const auto& requestBody = httpCall->request_body();
+        VERIFY_ARE_EQUAL_INT(http_request_message_type::buffer_view_message, requestBody.get_http_request_message_type());
+        VERIFY_ARE_EQUAL_INT(blobSize - 2048, requestBody.request_message_buffer_size());
+        VERIFY_IS_TRUE(requestBody.request_message_buffer() == &(*blobBuffer)[2048]);
+    }
+
+    DEFINE_TEST_CASE(DownloadBlobToHandlerResumesFromOffset)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(DownloadBlobToHandlerResumesFromOffset);
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        auto httpCall = m_mockXboxSystemFactory->GetMockHttpCall();
+
+        std::vector<unsigned char> lastBlock(100, 0x5a);
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(lastBlock);
+
+        xbox::services::title_storage::title_storage_blob_metadata blobMetadata(
+            _T("123456789"),
+            xbox::services::title_storage::title_storage_type::global_storage,
+            _T("blobPath"),
+            xbox::services::title_storage::title_storage_blob_type::binary,
+            _T("TestXboxUserId")
+            );
+
+        std::vector<uint64_t> offsets;
+        size_t bytesReceived = 0;
+        auto result = xboxLiveContext->title_storage_service().download_blob_to_handler(
+            blobMetadata,
+            [&offsets, &bytesReceived](uint64_t offset, const unsigned char* data, size_t length)
+            {
+                VERIFY_IS_TRUE(data != nullptr);
+                offsets.push_back(offset);
+                bytesReceived += length;
+                return true;
+            },
+            xbox::services::title_storage::title_storage_e_tag_match_condition::not_used,
+            string_t(),
+            1024,
+            5120
+            ).get();
+
+        VERIFY_IS_TRUE(!result.err());
+        VERIFY_ARE_EQUAL_INT(1, httpCall->CallCounter);
+        VERIFY_ARE_EQUAL_INT(1, offsets.size());
+        VERIFY_ARE_EQUAL_INT(5120, offsets[0]);
+        VERIFY_ARE_EQUAL_INT(lastBlock.size(), bytesReceived);
+        VERIFY_ARE_EQUAL_INT(5120 + lastBlock.size(), result.payload().length());
+        VERIFY_ARE_EQUAL_STR(L"bytes=5120-6143", httpCall->ResultValue->response_headers().find(L"Range")->second);
+
+        // A handler that fails stops the download
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(lastBlock);
+        result = xboxLiveContext->title_storage_service().download_blob_to_handler(
+            blobMetadata,
+            [](uint64_t, const unsigned char*, size_t) { return false; },
+            xbox::services::title_storage::title_storage_e_tag_match_condition::not_used
+            ).get();
+        VERIFY_IS_TRUE(result.err() == xbox_live_error_code::runtime_error);
+    }
+
+    DEFINE_TEST_CASE(DownloadBlobToFileResumesFromPartialFile)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(DownloadBlobToFileResumesFromPartialFile);
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        auto httpCall = m_mockXboxSystemFactory->GetMockHttpCall();
+
+        std::vector<unsigned char> lastBlock(100, 'b');
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(lastBlock);
+
+        xbox::services::title_storage::title_storage_blob_metadata blobMetadata(
+            _T("123456789"),
+            xbox::services::title_storage::title_storage_type::global_storage,
+            _T("blobPath"),
+            xbox::services::title_storage::title_storage_blob_type::binary,
+            _T("TestXboxUserId")
+            );
+
+        // A partial file with a matching .etag sidecar picks up where the file ends, pinned to that version
+        DeleteTestFiles();
+        WriteTestFile(downloadFilePath, std::string(1024, 'a'));
+        WriteTestFile(downloadETagFilePath, "PartialETag");
+
+        auto result = xboxLiveContext->title_storage_service().download_blob_to_file(
+            blobMetadata,
+            downloadFilePath,
+            true,
+            1024
+            ).get();
+
+        VERIFY_IS_TRUE(!result.err());
+        VERIFY_ARE_EQUAL_INT(1, httpCall->CallCounter);
+        VERIFY_ARE_EQUAL_INT(1124, result.payload().length());
+        VERIFY_ARE_EQUAL_STR(L"bytes=1024-2047", httpCall->ResultValue->response_headers().find(L"Range")->second);
+        VERIFY_ARE_EQUAL_STR(L"PartialETag", httpCall->ResultValue->response_headers().find(L"If-Match")->second);
+        VERIFY_IS_TRUE(ReadTestFile(downloadFilePath) == std::string(1024, 'a') + std::string(100, 'b'));
+        VERIFY_IS_FALSE(TestFileExists(downloadETagFilePath));
+
+        // Without a sidecar the partial file can't be trusted, so the download starts over
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(lastBlock);
+        result = xboxLiveContext->title_storage_service().download_blob_to_file(
+            blobMetadata,
+            downloadFilePath,
+            true,
+            1024
+            ).get();
+
+        VERIFY_IS_TRUE(!result.err());
+        VERIFY_ARE_EQUAL_INT(2, httpCall->CallCounter);
+        VERIFY_ARE_EQUAL_STR(L"bytes=0-1023", httpCall->ResultValue->response_headers().find(L"Range")->second);
+        VERIFY_IS_TRUE(ReadTestFile(downloadFilePath) == std::string(100, 'b'));
+
+        // A partial file that already holds the whole blob finishes without another request
+        blobMetadata._Set_e_tag_and_length(_T("PartialETag"), 1024);
+        WriteTestFile(downloadFilePath, std::string(1024, 'a'));
+        WriteTestFile(downloadETagFilePath, "PartialETag");
+
+        result = xboxLiveContext->title_storage_service().download_blob_to_file(
+            blobMetadata,
+            downloadFilePath,
+            true,
+            1024
+            ).get();
+
+        VERIFY_IS_TRUE(!result.err());
+        VERIFY_ARE_EQUAL_INT(2, httpCall->CallCounter);
+        VERIFY_ARE_EQUAL_INT(1024, result.payload().length());
+        VERIFY_IS_TRUE(ReadTestFile(downloadFilePath) == std::string(1024, 'a'));
+        VERIFY_IS_FALSE(TestFileExists(downloadETagFilePath));
+
+        DeleteTestFiles();
+    }
+
+    DEFINE_TEST_CASE(DownloadBlobToFileRestartsWhenBlobChanged)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(DownloadBlobToFileRestartsWhenBlobChanged);
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        auto httpCall = m_mockXboxSystemFactory->GetMockHttpCall();
+
+        // Each request's headers land on the current ResultValue, so record them before swapping in the next response
+        std::vector<std::shared_ptr<http_call_response>> responses = {
+            StockMocks::CreateMockHttpCallResponse(std::vector<unsigned char>(), 412),
+            StockMocks::CreateMockHttpCallResponse(std::vector<unsigned char>(1024, 'c')),
+            StockMocks::CreateMockHttpCallResponse(std::vector<unsigned char>(100, 'd'))
+            };
+        std::vector<string_t> ranges;
+        std::vector<bool> etagFileWritten;
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(std::vector<unsigned char>());
+        httpCall->fRequestPostFunc = [&](std::shared_ptr<http_call_response>& response, const string_t&)
+        {
+            ranges.push_back(response->response_headers().find(L"Range")->second);
+            etagFileWritten.push_back(ReadTestFile(downloadETagFilePath) == "MockETag");
+            response = responses[ranges.size() - 1];
+        };
+
+        xbox::services::title_storage::title_storage_blob_metadata blobMetadata(
+            _T("123456789"),
+            xbox::services::title_storage::title_storage_type::global_storage,
+            _T("blobPath"),
+            xbox::services::title_storage::title_storage_blob_type::binary,
+            _T("TestXboxUserId")
+            );
+
+        DeleteTestFiles();
+        WriteTestFile(downloadFilePath, std::string(2048, 'a'));
+        WriteTestFile(downloadETagFilePath, "StaleETag");
+
+        auto result = xboxLiveContext->title_storage_service().download_blob_to_file(
+            blobMetadata,
+            downloadFilePath,
+            true,
+            1024
+            ).get();
+
+        // The 412 throws away the stale bytes and downloads the new version from the start
+        VERIFY_IS_TRUE(!result.err());
+        VERIFY_ARE_EQUAL_INT(3, httpCall->CallCounter);
+        VERIFY_ARE_EQUAL_INT(3, ranges.size());
+        VERIFY_ARE_EQUAL_STR(L"bytes=2048-3071", ranges[0]);
+        VERIFY_ARE_EQUAL_STR(L"bytes=0-1023", ranges[1]);
+        VERIFY_ARE_EQUAL_STR(L"bytes=1024-2047", ranges[2]);
+        VERIFY_ARE_EQUAL_INT(1124, result.payload().length());
+        VERIFY_IS_TRUE(ReadTestFile(downloadFilePath) == std::string(1024, 'c') + std::string(100, 'd'));
+
+        // The sidecar holds the new version's etag while the download is in flight and goes away once it completes
+        VERIFY_IS_FALSE(etagFileWritten[1]);
+        VERIFY_IS_TRUE(etagFileWritten[2]);
+        VERIFY_IS_FALSE(TestFileExists(downloadETagFilePath));
+
+        httpCall->fRequestPostFunc = nullptr;
+        DeleteTestFiles();
+    }
+
     DEFINE_TEST_CASE(TitleStorageInvalidArgsTest)
     {
         DEFINE_TEST_CASE_PROPERTIES(TitleStorageInvalidArgsTest);
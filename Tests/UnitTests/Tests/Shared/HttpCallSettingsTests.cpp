@@ -12,6 +12,9 @@
 #define TEST_CLASS_AREA L"XboxLiveContextSettings"
 #include "UnitTestIncludes.h"
 #include <xsapi/xbox_live_context.h>
+#include "service_call_metrics.h"
+#include "http_call_rate_limiter.h"
+#include "utils.h"
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
 
@@ -205,6 +208,224 @@ public:
         VerifyDelay(g_callLog[2].m_time, g_callLog[1].m_time, 0);
     }
 
+    DEFINE_TEST_CASE(TestServiceCallMetrics)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestServiceCallMetrics);
+        auto metrics = service_call_metrics::get_singleton_instance();
+        metrics->reset();
+        http_retry_after_manager::get_http_retry_after_manager_singleton()->clear_state(xbox_live_api::verify_strings);
+
+        auto responseJson = web::json::value::parse(defaultStringVerifyResult);
+        auto httpClient = m_mockXboxSystemFactory->GetMockHttpClient();
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        xboxLiveContext->settings()->set_http_timeout_window(std::chrono::seconds(0));
+        m_mockXboxSystemFactory->setup_mock_for_http_client();
+
+        httpClient->ResultValue.set_body(responseJson);
+        httpClient->ResultValue.set_status_code(200);
+        xboxLiveContext->string_service().verify_string(L"xboxUserId").wait();
+
+        httpClient->ResultValue.set_status_code(503);
+        xboxLiveContext->string_service().verify_string(L"xboxUserId").wait();
+
+        auto snapshot = metrics->snapshot();
+        auto it = std::find_if(snapshot.begin(), snapshot.end(), [](const service_call_api_metrics& m) { return m.api == xbox_live_api::verify_strings; });
+        VERIFY_IS_TRUE(it != snapshot.end());
+        VERIFY_ARE_EQUAL_INT(2, it->callCount);
+        VERIFY_ARE_EQUAL_INT(1, it->errorCount);
+        VERIFY_ARE_EQUAL_INT(0, it->retryCount);
+        VERIFY_ARE_EQUAL_INT(0, it->throttledCount);
+        VERIFY_IS_TRUE(it->bytesSent > 0);
+        VERIFY_ARE_EQUAL_INT(2, it->latencies[static_cast<size_t>(service_call_latency_phase::queue)].count);
+        VERIFY_ARE_EQUAL_INT(2, it->latencies[static_cast<size_t>(service_call_latency_phase::time_to_first_byte)].count);
+        VERIFY_ARE_EQUAL_INT(2, it->latencies[static_cast<size_t>(service_call_latency_phase::total)].count);
+
+        string_t text = metrics->to_text();
+        VERIFY_IS_TRUE(text.find(L"xsapi_service_calls{api=\"verify_strings\"} 2") != string_t::npos);
+        VERIFY_IS_TRUE(text.find(L"xsapi_service_call_errors{api=\"verify_strings\"} 1") != string_t::npos);
+
+        // Log-linear buckets: exact below 4us, then 4 buckets per power of two
+        VERIFY_ARE_EQUAL_INT(3, service_call_latency_histogram::bucket_index(3));
+        VERIFY_ARE_EQUAL_INT(4, service_call_latency_histogram::bucket_index(4));
+        VERIFY_ARE_EQUAL_INT(8, service_call_latency_histogram::bucket_index(8));
+        VERIFY_ARE_EQUAL_INT(8, service_call_latency_histogram::bucket_index(9));
+        VERIFY_ARE_EQUAL_INT(9, service_call_latency_histogram::bucket_index(10));
+        VERIFY_ARE_EQUAL_INT(11, service_call_latency_histogram::bucket_upper_bound(service_call_latency_histogram::bucket_index(10)));
+        VERIFY_ARE_EQUAL_INT(service_call_latency_histogram::BUCKET_COUNT - 1, service_call_latency_histogram::bucket_index(UINT64_MAX));
+        for (uint64_t value = 1; value < 1000000; value = value * 3 + 1)
+        {
+            size_t index = service_call_latency_histogram::bucket_index(value);
+            VERIFY_IS_TRUE(value <= service_call_latency_histogram::bucket_upper_bound(index));
+            VERIFY_IS_TRUE(value > service_call_latency_histogram::bucket_upper_bound(index - 1));
+        }
+
+        service_call_latency_histogram histogram;
+        for (uint64_t value = 1; value <= 100; ++value)
+        {
+            histogram.buckets[service_call_latency_histogram::bucket_index(value * 1000)]++;
+            histogram.count++;
+        }
+        VERIFY_IS_TRUE(histogram.percentile(50).count() >= 50000 && histogram.percentile(50).count() < 50000 * 5 / 4);
+        VERIFY_IS_TRUE(histogram.percentile(99).count() >= 99000 && histogram.percentile(99).count() < 99000 * 5 / 4);
+    }
+
+    DEFINE_TEST_CASE(TestServiceCallMetricsRecordsExceptions)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestServiceCallMetricsRecordsExceptions);
+        auto metrics = service_call_metrics::get_singleton_instance();
+        metrics->reset();
+        http_retry_after_manager::get_http_retry_after_manager_singleton()->clear_state(xbox_live_api::set_presence_helper);
+        m_mockXboxSystemFactory->setup_mock_for_http_client();
+        m_mockXboxSystemFactory->GetMockHttpClient()->ResultValue.set_status_code(200);
+
+        auto httpCall = std::make_shared<http_call_impl>(
+            std::make_shared<xbox_live_context_settings>(),
+            L"POST",
+            L"https://presence.xboxlive.com",
+            web::uri(L"/users/xuid(1)/devices/current/titles/current"),
+            xbox_live_api::set_presence_helper
+            );
+
+        // An unsupported body type throws from the response handling
+        bool threw = false;
+        try
+        {
+            httpCall->get_response(static_cast<http_call_response_body_type>(99)).get();
+        }
+        catch (const std::exception&)
+        {
+            threw = true;
+        }
+        VERIFY_IS_TRUE(threw);
+
+        auto snapshot = metrics->snapshot();
+        auto it = std::find_if(snapshot.begin(), snapshot.end(), [](const service_call_api_metrics& m) { return m.api == xbox_live_api::set_presence_helper; });
+        VERIFY_IS_TRUE(it != snapshot.end());
+        VERIFY_ARE_EQUAL_INT(1, it->callCount);
+        VERIFY_ARE_EQUAL_INT(1, it->errorCount);
+        VERIFY_ARE_EQUAL_INT(1, it->latencies[static_cast<size_t>(service_call_latency_phase::total)].count);
+    }
+
+    DEFINE_TEST_CASE(TestClientSideRateLimiter)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestClientSideRateLimiter);
+        auto rateLimiter = std::make_shared<http_call_rate_limiter>();
+        VERIFY_IS_TRUE(!rateLimiter->is_enabled());
+        VERIFY_IS_TRUE(rateLimiter->budget(xbox_live_api::unspecified).is_unlimited());
+        VERIFY_ARE_EQUAL_INT(10, rateLimiter->budget(xbox_live_api::get_user_profiles).burstCalls);
+
+        // Disabled, nothing is held back
+        rateLimiter->acquire(xbox_live_api::get_user_profiles, L"1", http_call_priority::foreground).wait();
+        VERIFY_IS_TRUE(rateLimiter->metrics().empty());
+
+        // 2 calls per second burst, so a token comes back every 500ms
+        rateLimiter->set_enabled(true);
+        rateLimiter->set_budget(xbox_live_api::get_user_profiles, http_call_rate_limit_budget(2, std::chrono::seconds(1), 100, std::chrono::seconds(1)));
+
+        VERIFY_IS_TRUE(rateLimiter->acquire(xbox_live_api::get_user_profiles, L"1", http_call_priority::foreground).is_done());
+        VERIFY_IS_TRUE(rateLimiter->acquire(xbox_live_api::get_user_profiles, L"1", http_call_priority::foreground).is_done());
+
+        // Each user has its own budget
+        VERIFY_IS_TRUE(rateLimiter->acquire(xbox_live_api::get_user_profiles, L"2", http_call_priority::foreground).is_done());
+
+        std::mutex orderLock;
+        std::vector<int> order;
+        auto background = rateLimiter->acquire(xbox_live_api::get_user_profiles, L"1", http_call_priority::background)
+        .then([&orderLock, &order]() { std::lock_guard<std::mutex> lock(orderLock); order.push_back(2); });
+        auto foreground = rateLimiter->acquire(xbox_live_api::get_user_profiles, L"1", http_call_priority::foreground)
+        .then([&orderLock, &order]() { std::lock_guard<std::mutex> lock(orderLock); order.push_back(1); });
+        VERIFY_IS_TRUE(!background.is_done());
+        VERIFY_IS_TRUE(!foreground.is_done());
+
+        auto metrics = rateLimiter->metrics();
+        VERIFY_ARE_EQUAL_INT(1, metrics.size());
+        VERIFY_ARE_EQUAL_INT(2, metrics[0].currentlyQueuedCount);
+
+        foreground.wait();
+        background.wait();
+        {
+            // The foreground call was queued second but released first
+            std::lock_guard<std::mutex> lock(orderLock);
+            VERIFY_ARE_EQUAL_INT(2, order.size());
+            VERIFY_ARE_EQUAL_INT(1, order[0]);
+            VERIFY_ARE_EQUAL_INT(2, order[1]);
+        }
+
+        metrics = rateLimiter->metrics();
+        VERIFY_ARE_EQUAL_INT(5, metrics[0].admittedCount);
+        VERIFY_ARE_EQUAL_INT(2, metrics[0].queuedCount);
+        VERIFY_ARE_EQUAL_INT(0, metrics[0].currentlyQueuedCount);
+        VERIFY_IS_TRUE(metrics[0].maxQueueWait.count() >= 400);
+
+        // Disabling releases anything still queued
+        auto held = rateLimiter->acquire(xbox_live_api::get_user_profiles, L"1", http_call_priority::background);
+        rateLimiter->set_enabled(false);
+        held.wait();
+    }
+
+    DEFINE_TEST_CASE(TestClientSideRateLimiterEvictsIdleBuckets)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestClientSideRateLimiterEvictsIdleBuckets);
+        auto rateLimiter = std::make_shared<http_call_rate_limiter>();
+        rateLimiter->set_enabled(true);
+        rateLimiter->set_budget(xbox_live_api::get_user_profiles, http_call_rate_limit_budget(2, std::chrono::seconds(1), 2, std::chrono::seconds(1)));
+
+        const size_t userCount = http_call_rate_limiter::MIN_BUCKETS_BEFORE_EVICTION;
+        for (size_t i = 0; i < userCount; ++i)
+        {
+            rateLimiter->acquire(xbox_live_api::get_user_profiles, utils::uint32_to_string_t(static_cast<uint32_t>(i)), http_call_priority::foreground).wait();
+        }
+        VERIFY_ARE_EQUAL_INT(userCount, rateLimiter->bucket_count());
+
+        // Fully refilled after a second, so the sweep on the next new user drops them all
+        std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+        rateLimiter->acquire(xbox_live_api::get_user_profiles, L"new", http_call_priority::foreground).wait();
+        VERIFY_ARE_EQUAL_INT(1, rateLimiter->bucket_count());
+
+        // Buckets that haven't refilled are kept, and the next sweep waits until there are twice as many
+        for (size_t i = 0; i < userCount; ++i)
+        {
+            rateLimiter->acquire(xbox_live_api::get_user_profiles, utils::uint32_to_string_t(static_cast<uint32_t>(i)), http_call_priority::foreground).wait();
+        }
+        VERIFY_ARE_EQUAL_INT(userCount + 1, rateLimiter->bucket_count());
+    }
+
+    DEFINE_TEST_CASE(TestDefaultRequestHeaders)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestDefaultRequestHeaders);
+        string_t originalLocales = utils::get_locales();
+
+        auto httpCall = std::make_shared<http_call_impl>(
+            std::make_shared<xbox_live_context_settings>(),
+            L"POST",
+            L"https://presence.xboxlive.com",
+            web::uri(L"/users/xuid(1)/devices/current/titles/current"),
+            xbox_live_api::set_presence_helper
+            );
+        httpCall->set_xbox_contract_version_header_value(L"3");
+        httpCall->set_custom_header(L"content-type", L"application/custom");
+
+        auto request = httpCall->get_default_request();
+        VERIFY_ARE_EQUAL_STR(L"3", request.headers()[L"x-xbl-contract-version"]);
+        VERIFY_ARE_EQUAL_STR(L"application/custom", request.headers()[L"Content-Type"]);
+        VERIFY_ARE_EQUAL_STR(originalLocales, request.headers()[L"Accept-Language"]);
+        VERIFY_ARE_EQUAL_INT(3, request.headers().size());
+
+        // A locale change is picked up by the next request
+        utils::set_locales(L"fr-FR,fr");
+        request = httpCall->get_default_request();
+        VERIFY_ARE_EQUAL_STR(L"fr-FR,fr", request.headers()[L"Accept-Language"]);
+        utils::set_locales(originalLocales);
+
+        // Requests built from the cached template don't share headers with each other
+        request = httpCall->get_default_request();
+        auto nextRequest = httpCall->get_default_request();
+        nextRequest.headers().add(L"x-xbl-test", L"1");
+        VERIFY_ARE_EQUAL_STR(originalLocales, request.headers()[L"Accept-Language"]);
+        VERIFY_ARE_EQUAL_INT(3, request.headers().size());
+        VERIFY_ARE_EQUAL_INT(4, nextRequest.headers().size());
+    }
+
     static void LogCalls(_In_ const std::chrono::steady_clock::time_point& timeStart)
     {
         std::chrono::steady_clock::time_point timeLast = timeStart;
@@ -16,6 +16,7 @@
 #include "xbox_system_factory.h"
 #include "xsapi/multiplayer.h"
 #include "xsapi/mem.h"
+#include "xbox_live_context_startup_profiler.h"
 
 using namespace Microsoft::Xbox::Services;
 
@@ -213,6 +214,45 @@ public:
         }
     }
 
+    DEFINE_TEST_CASE(TestContextServicesCreatedOnFirstUse)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestContextServicesCreatedOnFirstUse);
+
+        auto user = SignInUserWithMocks_WinRT();
+        auto profiler = xbox::services::xbox_live_context_startup_profiler::get_singleton_instance();
+        profiler->reset();
+
+        const uint32_t c_numContexts = 10;
+        std::vector<std::shared_ptr<xbox::services::xbox_live_context>> contexts;
+        contexts.reserve(c_numContexts);
+        for (uint32_t i = 0; i < c_numContexts; ++i)
+        {
+            contexts.push_back(std::make_shared<xbox::services::xbox_live_context>(user));
+        }
+
+        // Creating a context shouldn't set up any of its services
+        auto stats = profiler->snapshot();
+        VERIFY_ARE_EQUAL_INT(1, stats.size());
+        VERIFY_IS_TRUE(stats[0].component == xbox::services::xbox_live_context_component::context);
+        VERIFY_ARE_EQUAL_INT(c_numContexts, stats[0].constructionCount);
+        VERIFY_IS_TRUE(stats[0].bytes > 0);
+        VERIFY_IS_TRUE(stats[0].bytes % c_numContexts == 0);
+
+        // Presence needs real-time activity, so both are created, once each
+        auto& presenceService = contexts[0]->presence_service();
+        VERIFY_IS_TRUE(&presenceService == &contexts[0]->presence_service());
+        contexts[0]->profile_service();
+        stats = profiler->snapshot();
+        VERIFY_ARE_EQUAL_INT(4, stats.size());
+        for (const auto& componentStats : stats)
+        {
+            if (componentStats.component != xbox::services::xbox_live_context_component::context)
+            {
+                VERIFY_ARE_EQUAL_INT(1, componentStats.constructionCount);
+            }
+        }
+    }
+
     static _Ret_maybenull_ _Post_writable_byte_size_(dwSize) void* __stdcall MemAllocHook(
         _In_ size_t dwSize
         )